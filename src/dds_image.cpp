@@ -1,13 +1,17 @@
-// Partial implementation of DDS file loading.
+// Partial implementation of DDS file loading, supporting DXT1/3/5 and the uncompressed formats that have an NV2A
+// equivalent, as 2D, cubemap, or volume textures.
 //
 // See https://docs.microsoft.com/en-us/windows/win32/direct3ddds/dx-graphics-dds-pguide
 // Use https://developer.nvidia.com/gpu-accelerated-texture-compression to create files
 
 #include "dds_image.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <vector>
 
 #include "debug_output.h"
+#include "swizzle.h"
 
 #define FOURCC(a, b, c, d) (((a)&0xFF) | (((b)&0xFF) << 8) | (((c)&0xFF) << 16) | (((d)&0xFF) << 24))
 
@@ -19,6 +23,15 @@ static const uint32_t kDXT2Magic = FOURCC('D', 'X', 'T', '2');
 static const uint32_t kDXT3Magic = FOURCC('D', 'X', 'T', '3');
 static const uint32_t kDXT4Magic = FOURCC('D', 'X', 'T', '4');
 static const uint32_t kDXT5Magic = FOURCC('D', 'X', 'T', '5');
+static const uint32_t kYUY2Magic = FOURCC('Y', 'U', 'Y', '2');
+static const uint32_t kUYVYMagic = FOURCC('U', 'Y', 'V', 'Y');
+
+// Formats without a DDS pixel format description are identified by their D3DFORMAT value in place of a FourCC.
+static const uint32_t kD3DFMTD24S8 = 75;
+static const uint32_t kD3DFMTD16 = 80;
+static const uint32_t kD3DFMTD24FS8 = 83;
+// The NV2A 16-bit floating point depth format has no D3DFORMAT, so a private FourCC is used.
+static const uint32_t kZ16FloatMagic = FOURCC('Z', '1', '6', 'F');
 
 enum DDH_FLAGS {
   DDSD_CAPS = 0x1,
@@ -48,10 +61,15 @@ enum DDH_CAPS2 {
   DDSCAPS2_VOLUME = 0x200000,
 };
 
+static constexpr uint32_t kAllCubemapFaces = DDSCAPS2_CUBEMAP_POSITIVEX | DDSCAPS2_CUBEMAP_NEGATIVEX |
+                                             DDSCAPS2_CUBEMAP_POSITIVEY | DDSCAPS2_CUBEMAP_NEGATIVEY |
+                                             DDSCAPS2_CUBEMAP_POSITIVEZ | DDSCAPS2_CUBEMAP_NEGATIVEZ;
+
 enum DDPF_FLAGS {
   DDPF_ALPHAPIXELS = 0x1,
   DDPF_ALPHA = 0x2,
   DDPF_FOURCC = 0x4,
+  DDPF_PALETTEINDEXED8 = 0x20,
   DDPF_RGB = 0x40,
   DDPF_YUV = 0x200,
   DDPF_LUMINANCE = 0x20000,
@@ -93,6 +111,59 @@ struct DDS_FILE {
 };
 #pragma pack(pop)
 
+struct PixelFormat {
+  DDSImage::Format format;
+  // DDPF_FOURCC for formats identified by `fourcc`, otherwise the DDPF flags that must be set.
+  uint32_t flags;
+  uint32_t fourcc;
+  // Size of a 4x4 block in bytes for compressed formats, 0 otherwise.
+  uint32_t block_size;
+  uint32_t bytes_per_pixel;
+  uint32_t r_mask;
+  uint32_t g_mask;
+  uint32_t b_mask;
+  // Ignored when reading if 0, as some writers populate the alpha mask of formats without alpha.
+  uint32_t a_mask;
+};
+
+static constexpr uint32_t kRGBA = DDPF_RGB | DDPF_ALPHAPIXELS;
+
+static constexpr PixelFormat kPixelFormats[] = {
+    {DDSImage::Format::DXT1, DDPF_FOURCC, kDXT1Magic, 8, 3, 0, 0, 0, 0},
+    {DDSImage::Format::DXT3, DDPF_FOURCC, kDXT3Magic, 16, 4, 0, 0, 0, 0},
+    {DDSImage::Format::DXT5, DDPF_FOURCC, kDXT5Magic, 16, 4, 0, 0, 0, 0},
+    {DDSImage::Format::A8R8G8B8, kRGBA, 0, 0, 4, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000},
+    {DDSImage::Format::X8R8G8B8, DDPF_RGB, 0, 0, 4, 0x00FF0000, 0x0000FF00, 0x000000FF, 0},
+    {DDSImage::Format::A8B8G8R8, kRGBA, 0, 0, 4, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000},
+    {DDSImage::Format::X8B8G8R8, DDPF_RGB, 0, 0, 4, 0x000000FF, 0x0000FF00, 0x00FF0000, 0},
+    {DDSImage::Format::R8G8B8A8, kRGBA, 0, 0, 4, 0xFF000000, 0x00FF0000, 0x0000FF00, 0x000000FF},
+    {DDSImage::Format::B8G8R8A8, kRGBA, 0, 0, 4, 0x0000FF00, 0x00FF0000, 0xFF000000, 0x000000FF},
+    {DDSImage::Format::R5G6B5, DDPF_RGB, 0, 0, 2, 0xF800, 0x07E0, 0x001F, 0},
+    {DDSImage::Format::A1R5G5B5, kRGBA, 0, 0, 2, 0x7C00, 0x03E0, 0x001F, 0x8000},
+    {DDSImage::Format::X1R5G5B5, DDPF_RGB, 0, 0, 2, 0x7C00, 0x03E0, 0x001F, 0},
+    {DDSImage::Format::A4R4G4B4, kRGBA, 0, 0, 2, 0x0F00, 0x00F0, 0x000F, 0xF000},
+    {DDSImage::Format::L8, DDPF_LUMINANCE, 0, 0, 1, 0xFF, 0, 0, 0},
+    {DDSImage::Format::A8L8, DDPF_LUMINANCE | DDPF_ALPHAPIXELS, 0, 0, 2, 0x00FF, 0, 0, 0xFF00},
+    {DDSImage::Format::L16, DDPF_LUMINANCE, 0, 0, 2, 0xFFFF, 0, 0, 0},
+    {DDSImage::Format::A8, DDPF_ALPHA, 0, 0, 1, 0, 0, 0, 0xFF},
+    {DDSImage::Format::P8, DDPF_PALETTEINDEXED8, 0, 0, 1, 0, 0, 0, 0},
+    {DDSImage::Format::YUY2, DDPF_FOURCC, kYUY2Magic, 0, 2, 0, 0, 0, 0},
+    {DDSImage::Format::UYVY, DDPF_FOURCC, kUYVYMagic, 0, 2, 0, 0, 0, 0},
+    {DDSImage::Format::D16, DDPF_FOURCC, kD3DFMTD16, 0, 2, 0, 0, 0, 0},
+    {DDSImage::Format::D16F, DDPF_FOURCC, kZ16FloatMagic, 0, 2, 0, 0, 0, 0},
+    {DDSImage::Format::D24S8, DDPF_FOURCC, kD3DFMTD24S8, 0, 4, 0, 0, 0, 0},
+    {DDSImage::Format::D24FS8, DDPF_FOURCC, kD3DFMTD24FS8, 0, 4, 0, 0, 0, 0},
+};
+
+static const PixelFormat *FindPixelFormat(DDSImage::Format format) {
+  for (auto &candidate : kPixelFormats) {
+    if (candidate.format == format) {
+      return &candidate;
+    }
+  }
+  return nullptr;
+}
+
 static inline uint32_t compressed_size(uint32_t uncompressed_size) {
   uint32_t ret = (uncompressed_size + 3) / 4;
   if (ret < 1) {
@@ -101,129 +172,285 @@ static inline uint32_t compressed_size(uint32_t uncompressed_size) {
   return ret;
 }
 
-bool DDSImage::LoadFile(const char *filename, bool load_mipmaps) {
+static DDSImage::LevelInfo MakeLevelInfo(const PixelFormat &pixel_format, uint32_t width, uint32_t height,
+                                         uint32_t depth, uint32_t level, uint32_t face) {
+  DDSImage::LevelInfo info{};
+  info.level = level;
+  info.face = face;
+  info.width = std::max(width >> level, 1U);
+  info.height = std::max(height >> level, 1U);
+  info.depth = std::max(depth >> level, 1U);
+  if (pixel_format.block_size) {
+    info.compressed_width = compressed_size(info.width);
+    info.compressed_height = compressed_size(info.height);
+    info.pitch = info.compressed_width * pixel_format.block_size;
+  } else {
+    info.compressed_width = info.width;
+    info.compressed_height = info.height;
+    info.pitch = info.width * pixel_format.bytes_per_pixel;
+  }
+  info.size = info.pitch * info.compressed_height * info.depth;
+  return info;
+}
+
+static const PixelFormat *ParsePixelFormat(const DDS_PIXELFORMAT &pixelformat) {
+  if (pixelformat.dwFlags & DDPF_FOURCC) {
+    ASSERT((pixelformat.dwFourCC != kDX10Magic) && "DX10 format not supported.");
+
+    for (auto &candidate : kPixelFormats) {
+      if (candidate.flags == DDPF_FOURCC && candidate.fourcc == pixelformat.dwFourCC) {
+        return &candidate;
+      }
+    }
+
+    PrintMsg("Unsupported FourCC format: 0x%X\n", pixelformat.dwFourCC);
+    ASSERT(!"Unsupported FourCC format");
+    return nullptr;
+  }
+
+  const uint32_t flags =
+      pixelformat.dwFlags & (DDPF_RGB | DDPF_LUMINANCE | DDPF_ALPHA | DDPF_ALPHAPIXELS | DDPF_PALETTEINDEXED8);
+  for (auto &candidate : kPixelFormats) {
+    if (flags == candidate.flags && pixelformat.dwRGBBitCount == candidate.bytes_per_pixel * 8 &&
+        pixelformat.dwRBitMask == candidate.r_mask && pixelformat.dwGBitMask == candidate.g_mask &&
+        pixelformat.dwBBitMask == candidate.b_mask &&
+        (!candidate.a_mask || pixelformat.dwABitMask == candidate.a_mask)) {
+      return &candidate;
+    }
+  }
+
+  PrintMsg("Unsupported uncompressed format: flags 0x%X, %u bpp, masks 0x%X 0x%X 0x%X 0x%X\n", pixelformat.dwFlags,
+           pixelformat.dwRGBBitCount, pixelformat.dwRBitMask, pixelformat.dwGBitMask, pixelformat.dwBBitMask,
+           pixelformat.dwABitMask);
+  ASSERT(!"Unsupported uncompressed format");
+  return nullptr;
+}
+
+bool DDSImage::Open(const char *filename) {
+  Close();
+  levels_.clear();
+  num_file_levels_ = 0;
+  num_faces_ = 0;
+
   FILE *f = fopen(filename, "rb");
   if (!f) {
     return false;
   }
+  std::shared_ptr<FILE> file(f, fclose);
 
-  DDS_FILE file{};
-  if (fread(&file, sizeof(file), 1, f) != 1) {
-    fclose(f);
+  DDS_FILE dds_file{};
+  if (fread(&dds_file, sizeof(dds_file), 1, f) != 1) {
     return false;
   }
 
-  ASSERT(file.dwMagic == kDDSMagic && "Invalid DDS file - bad fourcc");
-  if (file.header.dwDepth == 0) {
-    file.header.dwDepth = 1;
+  ASSERT(dds_file.dwMagic == kDDSMagic && "Invalid DDS file - bad fourcc");
+  const DDS_HEADER &header = dds_file.header;
+  ASSERT(header.dwSize == 124);
+
+  auto pixel_format = ParsePixelFormat(header.ddspf);
+  if (!pixel_format) {
+    return false;
+  }
+  format_ = pixel_format->format;
+  block_size_ = pixel_format->block_size;
+  bytes_per_pixel_ = pixel_format->bytes_per_pixel;
+
+  num_faces_ = 1;
+  if (header.dwCaps2 & DDSCAPS2_CUBEMAP) {
+    if ((header.dwCaps2 & kAllCubemapFaces) != kAllCubemapFaces) {
+      PrintMsg("Cubemaps without all six faces are not supported.\n");
+      ASSERT(!"Partial cubemap not supported");
+      return false;
+    }
+    num_faces_ = 6;
   }
 
-  const DDS_HEADER &header = file.header;
-  ASSERT(header.dwSize == 124);
-  ASSERT(header.dwCaps2 == 0 && "Multidimensional textures not supported.");
+  volume_ = (header.dwCaps2 & DDSCAPS2_VOLUME) != 0;
+  const uint32_t depth = volume_ && header.dwDepth ? header.dwDepth : 1;
+  num_file_levels_ = header.dwMipMapCount ? header.dwMipMapCount : 1;
+
+  // Faces are stored consecutively, each with its complete mipmap chain. Each level of a volume texture holds all of
+  // its depth slices.
+  levels_.reserve(num_faces_ * num_file_levels_);
+  uint32_t file_offset = sizeof(DDS_FILE);
+  for (uint32_t face = 0; face < num_faces_; ++face) {
+    for (uint32_t level = 0; level < num_file_levels_; ++level) {
+      LevelInfo info = MakeLevelInfo(*pixel_format, header.dwWidth, header.dwHeight, depth, level, face);
+      info.file_offset = file_offset;
+      file_offset += info.size;
+      levels_.push_back(info);
+    }
+  }
 
-  const DDS_PIXELFORMAT &pixelformat = header.ddspf;
+  file_ = std::move(file);
+  return true;
+}
 
-  if (pixelformat.dwFlags & DDPF_FOURCC) {
-    ASSERT((pixelformat.dwFourCC != kDX10Magic) && "DX10 format not supported.");
+uint32_t DDSImage::GetFaceSize(uint32_t num_levels) const {
+  uint32_t size = 0;
+  for (uint32_t level = 0; level < num_levels && level < num_file_levels_; ++level) {
+    size += levels_[level].size;
+  }
+  return size;
+}
 
-    uint32_t block_size = 0;
-    SubImage::Format format = SubImage::Format::NONE;
-    uint32_t bytes_per_pixel = 0;
-    uint32_t compressed_width = compressed_size(header.dwWidth);
-    uint32_t compressed_height = compressed_size(header.dwHeight);
-
-    switch (pixelformat.dwFourCC) {
-      case kDXT1Magic:
-        block_size = 8;
-        bytes_per_pixel = 3;
-        format = SubImage::Format::DXT1;
-        break;
-
-      case kDXT3Magic:
-        block_size = 16;
-        bytes_per_pixel = 4;
-        format = SubImage::Format::DXT3;
-        break;
-
-      case kDXT5Magic:
-        block_size = 16;
-        bytes_per_pixel = 4;
-        format = SubImage::Format::DXT5;
-        break;
-
-      default:
-        PrintMsg("Unsupported FourCC format: 0x%X\n", pixelformat.dwFourCC);
-        ASSERT(!"Unsupported FourCC format");
-        fclose(f);
-        return false;
-    }
+bool DDSImage::ReadLevels(void *dest, uint32_t first_level, uint32_t num_levels, uint32_t face) const {
+  if (!file_ || !num_levels || first_level + num_levels > num_file_levels_ || face >= num_faces_) {
+    return false;
+  }
 
-    auto read_image = [block_size, format, &f, bytes_per_pixel](
-                          uint32_t width, uint32_t height, uint32_t depth, uint32_t compressed_width,
-                          uint32_t compressed_height) -> std::shared_ptr<SubImage> {
-      uint32_t pitch = compressed_width * block_size;
-      uint32_t compressed_bytes = pitch * compressed_height * depth;
-
-      std::shared_ptr<SubImage> ret = std::make_shared<SubImage>();
-      ret->level = 0;
-      ret->format = format;
-      ret->width = width;
-      ret->height = height;
-      ret->compressed_width = compressed_width;
-      ret->compressed_height = compressed_height;
-      ret->depth = depth;
-      ret->pitch = pitch;
-      ret->bytes_per_pixel = bytes_per_pixel;
-
-      ret->data.resize(compressed_bytes);
-      if (fread(ret->data.data(), compressed_bytes, 1, f) != 1) {
-        return {};
-      }
+  const LevelInfo &first = GetLevelInfo(first_level, face);
+  const LevelInfo &last = GetLevelInfo(first_level + num_levels - 1, face);
+  const uint32_t size = last.file_offset + last.size - first.file_offset;
 
-      return ret;
-    };
+  FILE *f = file_.get();
+  if (fseek(f, static_cast<long>(first.file_offset), SEEK_SET)) {
+    return false;
+  }
+  return fread(dest, size, 1, f) == 1;
+}
 
-    auto primary_image =
-        read_image(header.dwWidth, header.dwHeight, header.dwDepth, compressed_width, compressed_height);
-    if (!primary_image) {
-      ASSERT(!"Failed to read image data.");
-      fclose(f);
-      return false;
-    }
-    sub_images_.push_back(primary_image);
+bool DDSImage::SaveFile(const char *filename, const void *texture, const TextureDescription &description) {
+  static constexpr uint32_t kCubemapFaceAlignment = 128;
 
-    if (load_mipmaps) {
-      uint32_t width = header.dwWidth;
-      uint32_t height = header.dwHeight;
+  auto pixel_format = FindPixelFormat(description.format);
+  if (!pixel_format) {
+    PrintMsg("Unsupported DDS output format %d\n", static_cast<int>(description.format));
+    return false;
+  }
 
-      for (auto i = 1; i < header.dwMipMapCount; ++i) {
-        width >>= 1;
-        if (width < 1) {
-          width = 1;
-        }
-        height >>= 1;
-        if (height < 1) {
-          height = 1;
-        }
+  const uint32_t depth = std::max(description.depth, 1U);
+  const uint32_t levels = std::max(description.levels, 1U);
+  const uint32_t num_faces = description.cubemap ? 6 : 1;
+  const bool volume = depth > 1;
+  ASSERT(!(volume && description.cubemap) && "Volume cubemaps are not supported");
+  ASSERT((!description.pitch || (levels == 1 && num_faces == 1 && !volume)) && "Pitch requires a single 2D level");
+
+  DDS_FILE dds_file{};
+  dds_file.dwMagic = kDDSMagic;
+  DDS_HEADER &header = dds_file.header;
+  header.dwSize = sizeof(DDS_HEADER);
+  header.dwFlags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT;
+  header.dwWidth = description.width;
+  header.dwHeight = description.height;
+
+  const LevelInfo base = MakeLevelInfo(*pixel_format, description.width, description.height, depth, 0, 0);
+  if (pixel_format->block_size) {
+    header.dwFlags |= DDSD_LINEARSIZE;
+    header.dwPitchOrLinearSize = base.pitch * base.compressed_height;
+  } else {
+    header.dwFlags |= DDSD_PITCH;
+    header.dwPitchOrLinearSize = base.pitch;
+  }
+
+  header.dwCaps = DDSCAPS_TEXTURE;
+  if (levels > 1) {
+    header.dwFlags |= DDSD_MIPMAPCOUNT;
+    header.dwMipMapCount = levels;
+    header.dwCaps |= DDSCAPS_MIPMAP | DDSCAPS_COMPLEX;
+  }
+  if (volume) {
+    header.dwFlags |= DDSD_DEPTH;
+    header.dwDepth = depth;
+    header.dwCaps |= DDSCAPS_COMPLEX;
+    header.dwCaps2 = DDSCAPS2_VOLUME;
+  } else if (description.cubemap) {
+    header.dwCaps |= DDSCAPS_COMPLEX;
+    header.dwCaps2 = DDSCAPS2_CUBEMAP | kAllCubemapFaces;
+  }
+
+  DDS_PIXELFORMAT &pixelformat = header.ddspf;
+  pixelformat.dwSize = sizeof(DDS_PIXELFORMAT);
+  pixelformat.dwFlags = pixel_format->flags;
+  if (pixel_format->flags == DDPF_FOURCC) {
+    pixelformat.dwFourCC = pixel_format->fourcc;
+  } else {
+    pixelformat.dwRGBBitCount = pixel_format->bytes_per_pixel * 8;
+    pixelformat.dwRBitMask = pixel_format->r_mask;
+    pixelformat.dwGBitMask = pixel_format->g_mask;
+    pixelformat.dwBBitMask = pixel_format->b_mask;
+    pixelformat.dwABitMask = pixel_format->a_mask;
+  }
+
+  FILE *f = fopen(filename, "wb");
+  if (!f) {
+    return false;
+  }
+  std::shared_ptr<FILE> file(f, fclose);
 
-        auto subimage = read_image(width, height, header.dwDepth, compressed_size(width), compressed_size(height));
-        if (!subimage) {
-          ASSERT(!"Failed to read mipmap data.");
-          fclose(f);
-          return false;
+  if (fwrite(&dds_file, sizeof(dds_file), 1, f) != 1) {
+    return false;
+  }
+
+  const bool unswizzle = description.swizzled && !pixel_format->block_size;
+  std::vector<uint8_t> scratch;
+  if (unswizzle) {
+    scratch.resize(base.size);
+  }
+
+  uint32_t face_size = 0;
+  for (uint32_t level = 0; level < levels; ++level) {
+    face_size += MakeLevelInfo(*pixel_format, description.width, description.height, depth, level, 0).size;
+  }
+  const uint32_t face_stride = (face_size + kCubemapFaceAlignment - 1) & ~(kCubemapFaceAlignment - 1);
+
+  auto face_source = static_cast<const uint8_t *>(texture);
+  for (uint32_t face = 0; face < num_faces; ++face, face_source += face_stride) {
+    auto source = face_source;
+    for (uint32_t level = 0; level < levels; ++level) {
+      const LevelInfo info = MakeLevelInfo(*pixel_format, description.width, description.height, depth, level, face);
+
+      if (description.pitch) {
+        for (uint32_t y = 0; y < info.compressed_height; ++y) {
+          if (fwrite(source + y * description.pitch, info.pitch, 1, f) != 1) {
+            return false;
+          }
         }
+        continue;
+      }
 
-        sub_images_.push_back(subimage);
+      const uint8_t *level_data = source;
+      if (unswizzle) {
+        unswizzle_box(source, info.width, info.height, info.depth, scratch.data(), info.pitch,
+                      info.pitch * info.height, pixel_format->bytes_per_pixel);
+        level_data = scratch.data();
       }
+
+      if (fwrite(level_data, info.size, 1, f) != 1) {
+        return false;
+      }
+      source += info.size;
     }
-  } else {
-    ASSERT((header.dwFlags & DDSD_PITCH) && (pixelformat.dwFlags & DDPF_RGB) && "Texture not flagged as uncompressed");
-    // TODO: Implement if necessary.
-    ASSERT(!"Uncompressed texture formats not implemented");
   }
 
-  fclose(f);
+  return !fflush(f);
+}
+
+bool DDSImage::LoadFile(const char *filename, bool load_mipmaps) {
+  sub_images_.clear();
+  loaded_ = false;
+
+  if (!Open(filename)) {
+    return false;
+  }
+
+  const uint32_t num_levels = load_mipmaps ? num_file_levels_ : 1;
+  for (uint32_t level = 0; level < num_levels; ++level) {
+    auto sub_image = std::make_shared<SubImage>();
+    static_cast<LevelInfo &>(*sub_image) = GetLevelInfo(level);
+    sub_image->format = format_;
+    sub_image->bytes_per_pixel = bytes_per_pixel_;
+    sub_image->data.resize(sub_image->size);
+
+    if (!ReadLevel(sub_image->data.data(), level)) {
+      ASSERT(!"Failed to read image data.");
+      Close();
+      return false;
+    }
+    sub_images_.push_back(sub_image);
+  }
+
+  Close();
   loaded_ = true;
   return true;
 }
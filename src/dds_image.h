@@ -2,22 +2,90 @@
 #define NXDK_PGRAPH_TESTS_DDS_IMAGE_H
 
 #include <cstdint>
+#include <cstdio>
 #include <memory>
 #include <vector>
 
+// Reads DDS files, either all at once via LoadFile or incrementally via Open and ReadLevels, which copy mipmap levels
+// directly into a caller provided buffer (e.g., texture memory). SaveFile writes texture memory back out unconverted.
 class DDSImage {
  public:
-  struct SubImage {
-    enum class Format { NONE, DXT1, DXT3, DXT5 };
+  enum class Format {
+    NONE,
+    DXT1,
+    DXT3,
+    DXT5,
+    A8R8G8B8,
+    X8R8G8B8,
+    A8B8G8R8,
+    X8B8G8R8,
+    R8G8B8A8,
+    B8G8R8A8,
+    R5G6B5,
+    A1R5G5B5,
+    X1R5G5B5,
+    A4R4G4B4,
+    L8,
+    A8L8,
+    L16,
+    A8,
+    // Palette indices, the palette itself is not stored.
+    P8,
+    YUY2,
+    UYVY,
+    // Depth formats, using D3DFORMAT values as the FourCC. D16F is specific to the NV2A and uses the FourCC "Z16F".
+    D16,
+    D16F,
+    D24S8,
+    D24FS8,
+  };
+
+  // Order in which the faces of a cubemap are stored, in both DDS files and NV2A texture memory.
+  enum CubemapFace {
+    FACE_POSITIVE_X,
+    FACE_NEGATIVE_X,
+    FACE_POSITIVE_Y,
+    FACE_NEGATIVE_Y,
+    FACE_POSITIVE_Z,
+    FACE_NEGATIVE_Z,
+  };
 
+  // Describes a single mipmap level of a single face.
+  struct LevelInfo {
     uint32_t level;
-    Format format;
+    uint32_t face;
     uint32_t width;
     uint32_t height;
+    // Dimensions in 4x4 blocks for compressed formats, otherwise identical to width and height.
     uint32_t compressed_width;
     uint32_t compressed_height;
     uint32_t depth;
     uint32_t pitch;
+    // Total size of the level including all depth slices.
+    uint32_t size;
+    // Offset of the level from the start of the file.
+    uint32_t file_offset;
+  };
+
+  // Describes a texture in NV2A memory layout: each face holds its mipmap chain with levels packed back to back, and
+  // cubemap faces begin at 128 byte aligned offsets.
+  struct TextureDescription {
+    Format format{Format::NONE};
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t depth{1};
+    uint32_t levels{1};
+    bool cubemap{false};
+    // Row pitch in bytes if rows are not tightly packed. Only valid for single level 2D textures.
+    uint32_t pitch{0};
+    // Whether uncompressed levels are swizzled in memory, in which case they are unswizzled when written.
+    bool swizzled{false};
+  };
+
+  struct SubImage : LevelInfo {
+    typedef DDSImage::Format Format;
+
+    Format format;
     uint32_t bytes_per_pixel;
     std::vector<uint8_t> data;
   };
@@ -25,17 +93,59 @@ class DDSImage {
  public:
   DDSImage() = default;
 
+  // Reads the header and every level of face 0 (just the base level unless `load_mipmaps` is true) into sub-images.
   bool LoadFile(const char *filename, bool load_mipmaps = false);
 
   inline std::shared_ptr<SubImage> GetPrimaryImage() const { return GetSubImage(0); }
   std::shared_ptr<SubImage> GetSubImage(uint32_t mipmap_level = 0) const;
   const std::vector<std::shared_ptr<SubImage>> &GetSubImages() const { return sub_images_; }
 
+  // Returns the number of sub-images loaded by LoadFile.
   uint32_t NumLevels() const { return sub_images_.size(); }
 
+  // Reads only the header of the given file, leaving it open so that levels may be read on demand.
+  bool Open(const char *filename);
+  void Close() { file_.reset(); }
+  bool IsOpen() const { return file_ != nullptr; }
+
+  Format GetFormat() const { return format_; }
+  // Returns the size of a 4x4 block in bytes for compressed formats, 0 otherwise.
+  uint32_t GetBlockSize() const { return block_size_; }
+  uint32_t GetBytesPerPixel() const { return bytes_per_pixel_; }
+  bool IsCubemap() const { return num_faces_ == 6; }
+  bool IsVolume() const { return volume_; }
+
+  // Returns the number of mipmap levels stored in the file for each face.
+  uint32_t NumFileLevels() const { return num_file_levels_; }
+  uint32_t NumFaces() const { return num_faces_; }
+  const LevelInfo &GetLevelInfo(uint32_t level, uint32_t face = 0) const {
+    return levels_[face * num_file_levels_ + level];
+  }
+
+  // Returns the combined size of levels [0, num_levels) of a single face.
+  uint32_t GetFaceSize(uint32_t num_levels) const;
+
+  // Reads `num_levels` consecutive levels of `face`, starting at `first_level`, into `dest` with a single read. Levels
+  // are packed without padding, matching the NV2A mipmap layout for swizzled and compressed textures.
+  bool ReadLevels(void *dest, uint32_t first_level, uint32_t num_levels, uint32_t face = 0) const;
+  bool ReadLevel(void *dest, uint32_t level, uint32_t face = 0) const { return ReadLevels(dest, level, 1, face); }
+
+  // Writes the texture at `texture` to a DDS file with the pixel format of `description.format`, such that reading it
+  // back yields the same bytes (after unswizzling, if requested).
+  static bool SaveFile(const char *filename, const void *texture, const TextureDescription &description);
+
  private:
   bool loaded_{false};
   std::vector<std::shared_ptr<SubImage>> sub_images_{};
+
+  std::shared_ptr<FILE> file_{};
+  Format format_{Format::NONE};
+  uint32_t block_size_{0};
+  uint32_t bytes_per_pixel_{0};
+  bool volume_{false};
+  uint32_t num_file_levels_{0};
+  uint32_t num_faces_{0};
+  std::vector<LevelInfo> levels_{};
 };
 
 #endif  // NXDK_PGRAPH_TESTS_DDS_IMAGE_H
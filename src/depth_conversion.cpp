@@ -0,0 +1,191 @@
+#include "depth_conversion.h"
+
+#include <cstring>
+
+// Y16 float values are the IEEE single precision bit pattern offset by kZ16FloatBias (2^-7) and shifted right by 11.
+static constexpr uint32_t kZ16FloatBias = 0x3C000000;
+// Bit pattern of the largest Y16 float value when expressed as an IEEE single precision value.
+static constexpr uint32_t kZ16FloatMaxBits = 0x43FFF800;
+// Bit pattern of the largest Y24 float value when expressed as an IEEE single precision value.
+static constexpr uint32_t kZ24FloatMaxBits = 0x7F7FFF80;
+
+static constexpr float kZ16FixedMax = 65535.0f;
+static constexpr float kZ24FixedMax = 16777215.0f;
+
+static inline uint32_t FloatBits(float value) {
+  uint32_t ret;
+  memcpy(&ret, &value, sizeof(ret));
+  return ret;
+}
+
+static inline float BitsToFloat(uint32_t value) {
+  float ret;
+  memcpy(&ret, &value, sizeof(ret));
+  return ret;
+}
+
+uint16_t EncodeZ16Float(float value) {
+  const uint32_t bits = FloatBits(value);
+  // Negative values (sign bit set) and NaNs compare above the max as integers, so they must be handled first.
+  if ((bits & 0x80000000) || (bits & 0x7FFFFFFF) > 0x7F800000) {
+    return 0;
+  }
+  if (bits <= kZ16FloatBias) {
+    return 0;
+  }
+  if (bits >= kZ16FloatMaxBits) {
+    return 0xFFFF;
+  }
+  return static_cast<uint16_t>((bits - kZ16FloatBias) >> 11);
+}
+
+float DecodeZ16Float(uint16_t value) {
+  if (!value) {
+    return 0.0f;
+  }
+  return BitsToFloat((static_cast<uint32_t>(value) << 11) + kZ16FloatBias);
+}
+
+uint32_t EncodeZ24Float(float value) {
+  const uint32_t bits = FloatBits(value);
+  if ((bits & 0x80000000) || (bits & 0x7FFFFFFF) > 0x7F800000) {
+    return 0;
+  }
+  if (bits >= kZ24FloatMaxBits) {
+    return kZ24FloatMaxBits >> 7;
+  }
+  return bits >> 7;
+}
+
+float DecodeZ24Float(uint32_t value) { return BitsToFloat((value & 0x00FFFFFF) << 7); }
+
+uint32_t GetDepthTextureBytesPerPixel(DepthTextureFormat format) {
+  switch (format) {
+    case DEPTH_TEXTURE_Y16_FIXED:
+    case DEPTH_TEXTURE_Y16_FLOAT:
+      return 2;
+
+    case DEPTH_TEXTURE_X8_Y24_FIXED:
+    case DEPTH_TEXTURE_X8_Y24_FLOAT:
+      return 4;
+  }
+  return 0;
+}
+
+// Encodes a value in the units of the destination format.
+static uint32_t EncodeDepth(float value, DepthTextureFormat format) {
+  switch (format) {
+    case DEPTH_TEXTURE_Y16_FIXED:
+      if (!(value > 0.0f)) {
+        return 0;
+      }
+      return value >= kZ16FixedMax ? 0xFFFF : static_cast<uint32_t>(value);
+
+    case DEPTH_TEXTURE_Y16_FLOAT:
+      return EncodeZ16Float(value);
+
+    case DEPTH_TEXTURE_X8_Y24_FIXED:
+      if (!(value > 0.0f)) {
+        return 0;
+      }
+      return (value >= kZ24FixedMax ? 0xFFFFFF : static_cast<uint32_t>(value)) << 8;
+
+    case DEPTH_TEXTURE_X8_Y24_FLOAT:
+      return EncodeZ24Float(value) << 8;
+  }
+  return 0;
+}
+
+// Encodes a normalized value with `bits` significant bits.
+static uint32_t EncodeNormalized(uint32_t value, uint32_t bits, DepthTextureFormat format) {
+  switch (format) {
+    case DEPTH_TEXTURE_Y16_FIXED:
+      // Replicate the high bits into the low bits, so that the maximum input maps to the maximum output.
+      if (bits == 8) {
+        return value * 0x101;
+      }
+      return bits == 16 ? value : value >> 16;
+
+    case DEPTH_TEXTURE_X8_Y24_FIXED:
+      if (bits == 8) {
+        return (value * 0x10101) << 8;
+      }
+      if (bits == 16) {
+        return ((value << 8) | (value >> 8)) << 8;
+      }
+      return value & 0xFFFFFF00;
+
+    case DEPTH_TEXTURE_Y16_FLOAT:
+    case DEPTH_TEXTURE_X8_Y24_FLOAT: {
+      const double max_input = bits == 32 ? 4294967295.0 : static_cast<double>((1u << bits) - 1);
+      const double max_output = format == DEPTH_TEXTURE_Y16_FLOAT ? kZ16FloatMax : BitsToFloat(kZ24FloatMaxBits);
+      return EncodeDepth(static_cast<float>(static_cast<double>(value) / max_input * max_output), format);
+    }
+  }
+  return 0;
+}
+
+template <typename SourceType, typename DestType, typename Encode>
+static void ConvertImage(uint8_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t source_pitch,
+                         uint32_t width, uint32_t height, Encode encode) {
+  for (uint32_t y = 0; y < height; ++y, dest += dest_pitch, source += source_pitch) {
+    auto in = reinterpret_cast<const SourceType *>(source);
+    auto out = reinterpret_cast<DestType *>(dest);
+    for (uint32_t x = 0; x < width; ++x) {
+      out[x] = static_cast<DestType>(encode(in[x]));
+    }
+  }
+}
+
+template <typename DestType>
+static void ConvertToDepthType(uint8_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t source_pitch,
+                               uint32_t width, uint32_t height, DepthSourceFormat source_format,
+                               DepthTextureFormat dest_format) {
+  switch (source_format) {
+    case DEPTH_SOURCE_UNORM8: {
+      // There are only 256 possible inputs, so encode each once.
+      DestType table[256];
+      for (uint32_t i = 0; i < 256; ++i) {
+        table[i] = static_cast<DestType>(EncodeNormalized(i, 8, dest_format));
+      }
+      ConvertImage<uint8_t, DestType>(dest, dest_pitch, source, source_pitch, width, height,
+                                      [&table](uint8_t value) { return table[value]; });
+    } break;
+
+    case DEPTH_SOURCE_UNORM16:
+      if (dest_format == DEPTH_TEXTURE_Y16_FIXED) {
+        for (uint32_t y = 0; y < height; ++y) {
+          memcpy(dest + y * dest_pitch, source + y * source_pitch, width * sizeof(uint16_t));
+        }
+        break;
+      }
+      ConvertImage<uint16_t, DestType>(
+          dest, dest_pitch, source, source_pitch, width, height,
+          [dest_format](uint16_t value) { return EncodeNormalized(value, 16, dest_format); });
+      break;
+
+    case DEPTH_SOURCE_UNORM32:
+      ConvertImage<uint32_t, DestType>(
+          dest, dest_pitch, source, source_pitch, width, height,
+          [dest_format](uint32_t value) { return EncodeNormalized(value, 32, dest_format); });
+      break;
+
+    case DEPTH_SOURCE_FLOAT:
+      ConvertImage<float, DestType>(dest, dest_pitch, source, source_pitch, width, height,
+                                    [dest_format](float value) { return EncodeDepth(value, dest_format); });
+      break;
+  }
+}
+
+void ConvertToDepth(void *dest, uint32_t dest_pitch, const void *source, uint32_t source_pitch, uint32_t width,
+                    uint32_t height, DepthSourceFormat source_format, DepthTextureFormat dest_format) {
+  auto dest_bytes = static_cast<uint8_t *>(dest);
+  auto source_bytes = static_cast<const uint8_t *>(source);
+  if (GetDepthTextureBytesPerPixel(dest_format) == 2) {
+    ConvertToDepthType<uint16_t>(dest_bytes, dest_pitch, source_bytes, source_pitch, width, height, source_format,
+                                 dest_format);
+  } else {
+    ConvertToDepthType<uint32_t>(dest_bytes, dest_pitch, source_bytes, source_pitch, width, height, source_format,
+                                 dest_format);
+  }
+}
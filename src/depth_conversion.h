@@ -0,0 +1,53 @@
+#ifndef NXDK_PGRAPH_TESTS_DEPTH_CONVERSION_H
+#define NXDK_PGRAPH_TESTS_DEPTH_CONVERSION_H
+
+#include <cstdint>
+
+// Conversion of luminance and depth values into the encodings used by NV2A depth textures and zeta buffers.
+//
+// Y16 formats hold one little endian 16-bit value per texel. X8_Y24 formats hold the 24-bit depth in the upper bits of
+// each 32-bit texel; the low 8 bits correspond to the stencil value of a Z24S8 surface and are written as 0.
+//
+// The float encodings are unsigned and have no infinities or NaNs, and 0 is reserved for 0.0:
+//   Y16 float: 4-bit exponent and 12-bit mantissa, representing 2^(exponent - 7) * (1 + mantissa / 4096). The largest
+//              value is 511.9375 and values below 2^-7 are flushed to 0.
+//   Y24 float: 8-bit exponent and 16-bit mantissa, i.e., an IEEE single precision value without its sign bit and low 7
+//              mantissa bits. The largest value is 0xFEFFFF (3.40282e+38).
+// Mantissa bits that do not fit are truncated. Negative and NaN inputs encode as 0, inputs above the largest
+// representable value encode as that value.
+
+// Largest representable Y16 float depth value.
+static constexpr float kZ16FloatMax = 511.9375f;
+
+uint16_t EncodeZ16Float(float value);
+float DecodeZ16Float(uint16_t value);
+
+// The 24-bit encoding occupies the low bits of the returned value.
+uint32_t EncodeZ24Float(float value);
+float DecodeZ24Float(uint32_t value);
+
+enum DepthSourceFormat {
+  // Unsigned normalized values, mapped onto the full range of the destination format.
+  DEPTH_SOURCE_UNORM8,
+  DEPTH_SOURCE_UNORM16,
+  DEPTH_SOURCE_UNORM32,
+  // Single precision values in the units of the destination format (e.g., [0, 0xFFFF] for Y16 fixed and
+  // [0, kZ16FloatMax] for Y16 float). Fixed point destinations are clamped and truncated.
+  DEPTH_SOURCE_FLOAT,
+};
+
+enum DepthTextureFormat {
+  DEPTH_TEXTURE_Y16_FIXED,
+  DEPTH_TEXTURE_Y16_FLOAT,
+  DEPTH_TEXTURE_X8_Y24_FIXED,
+  DEPTH_TEXTURE_X8_Y24_FLOAT,
+};
+
+// Returns the number of bytes per texel of the given format.
+uint32_t GetDepthTextureBytesPerPixel(DepthTextureFormat format);
+
+// Converts a `width` x `height` image of `source_format` values into `dest_format`. Pitches are in bytes.
+void ConvertToDepth(void *dest, uint32_t dest_pitch, const void *source, uint32_t source_pitch, uint32_t width,
+                    uint32_t height, DepthSourceFormat source_format, DepthTextureFormat dest_format);
+
+#endif  // NXDK_PGRAPH_TESTS_DEPTH_CONVERSION_H
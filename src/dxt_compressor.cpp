@@ -0,0 +1,545 @@
+#include "dxt_compressor.h"
+
+#include <cmath>
+
+// Blocks are unpacked into separate component arrays so that the per-pixel loops are straight-line code over 16
+// elements. The Xbox CPU has no integer SIMD beyond MMX, so these compile to scalar code there, but hosts are able to
+// vectorize them.
+
+static constexpr int32_t kDXT1AlphaThreshold = 128;
+
+struct PixelBlock {
+  int32_t r[16];
+  int32_t g[16];
+  int32_t b[16];
+  int32_t a[16];
+};
+
+struct ColorFit {
+  uint16_t color0{0};
+  uint16_t color1{0};
+  uint8_t indices[16]{0};
+  uint32_t error{0xFFFFFFFF};
+};
+
+static inline int32_t Clamp(int32_t value, int32_t low, int32_t high) {
+  if (value < low) {
+    return low;
+  }
+  if (value > high) {
+    return high;
+  }
+  return value;
+}
+
+static inline uint16_t PackRGB565(int32_t red, int32_t green, int32_t blue) {
+  red = Clamp(red, 0, 255);
+  green = Clamp(green, 0, 255);
+  blue = Clamp(blue, 0, 255);
+  return static_cast<uint16_t>((((red * 31 + 127) / 255) << 11) | (((green * 63 + 127) / 255) << 5) |
+                               ((blue * 31 + 127) / 255));
+}
+
+static inline void UnpackRGB565(uint16_t color, int32_t *rgb) {
+  const int32_t red = color >> 11;
+  const int32_t green = (color >> 5) & 0x3F;
+  const int32_t blue = color & 0x1F;
+  rgb[0] = (red << 3) | (red >> 2);
+  rgb[1] = (green << 2) | (green >> 4);
+  rgb[2] = (blue << 3) | (blue >> 2);
+}
+
+static void LoadBlock(PixelBlock &block, const uint8_t *source, uint32_t source_pitch, uint32_t width,
+                      uint32_t height, uint32_t left, uint32_t top, uint32_t red_shift, uint32_t green_shift,
+                      uint32_t blue_shift, uint32_t alpha_shift) {
+  for (uint32_t y = 0; y < 4; ++y) {
+    const uint32_t row = top + y < height ? top + y : height - 1;
+    auto pixels = reinterpret_cast<const uint32_t *>(source + row * source_pitch);
+    for (uint32_t x = 0; x < 4; ++x) {
+      const uint32_t column = left + x < width ? left + x : width - 1;
+      const uint32_t pixel = pixels[column];
+      const uint32_t i = y * 4 + x;
+      block.r[i] = static_cast<int32_t>((pixel >> red_shift) & 0xFF);
+      block.g[i] = static_cast<int32_t>((pixel >> green_shift) & 0xFF);
+      block.b[i] = static_cast<int32_t>((pixel >> blue_shift) & 0xFF);
+      block.a[i] = static_cast<int32_t>((pixel >> alpha_shift) & 0xFF);
+    }
+  }
+}
+
+// Evaluates the given endpoints, assigning each pixel to the closest palette entry. In 3-color mode, pixels flagged in
+// `transparent` are assigned to the transparent entry. The endpoints are reordered to select the requested mode.
+static void EvaluateColorFit(ColorFit &fit, const PixelBlock &block, uint16_t color0, uint16_t color1,
+                             bool three_color, const bool *transparent) {
+  // The decoder selects 4-color mode when color0 > color1.
+  if ((three_color && color0 > color1) || (!three_color && color0 < color1)) {
+    uint16_t temp = color0;
+    color0 = color1;
+    color1 = temp;
+  }
+
+  int32_t palette[4][3];
+  UnpackRGB565(color0, palette[0]);
+  UnpackRGB565(color1, palette[1]);
+  uint32_t palette_size;
+  if (three_color) {
+    for (uint32_t c = 0; c < 3; ++c) {
+      palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+    }
+    palette_size = 3;
+  } else {
+    for (uint32_t c = 0; c < 3; ++c) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+    palette_size = 4;
+  }
+
+  fit.color0 = color0;
+  fit.color1 = color1;
+  fit.error = 0;
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (transparent && transparent[i]) {
+      fit.indices[i] = 3;
+      continue;
+    }
+
+    uint32_t best_index = 0;
+    uint32_t best_error = 0xFFFFFFFF;
+    for (uint32_t p = 0; p < palette_size; ++p) {
+      const int32_t dr = block.r[i] - palette[p][0];
+      const int32_t dg = block.g[i] - palette[p][1];
+      const int32_t db = block.b[i] - palette[p][2];
+      const auto error = static_cast<uint32_t>(dr * dr + dg * dg + db * db);
+      if (error < best_error) {
+        best_error = error;
+        best_index = p;
+      }
+    }
+    fit.indices[i] = static_cast<uint8_t>(best_index);
+    fit.error += best_error;
+  }
+}
+
+static void KeepBestFit(ColorFit &best, const ColorFit &candidate) {
+  if (candidate.error < best.error) {
+    best = candidate;
+  }
+}
+
+// Uses the corners of the bounding box of the block's colors as endpoints. The diagonal is chosen based on the sign of
+// the covariance between the widest channel and the other two.
+static void FitBoundingBox(ColorFit &fit, const PixelBlock &block, bool three_color, const bool *transparent) {
+  int32_t min[3] = {255, 255, 255};
+  int32_t max[3] = {0, 0, 0};
+  int32_t sum[3] = {0, 0, 0};
+  int32_t count = 0;
+  const int32_t *channels[3] = {block.r, block.g, block.b};
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (transparent && transparent[i]) {
+      continue;
+    }
+    for (uint32_t c = 0; c < 3; ++c) {
+      const int32_t value = channels[c][i];
+      min[c] = value < min[c] ? value : min[c];
+      max[c] = value > max[c] ? value : max[c];
+      sum[c] += value;
+    }
+    ++count;
+  }
+
+  uint32_t major = 0;
+  for (uint32_t c = 1; c < 3; ++c) {
+    if (max[c] - min[c] > max[major] - min[major]) {
+      major = c;
+    }
+  }
+
+  int32_t start[3];
+  int32_t end[3];
+  for (uint32_t c = 0; c < 3; ++c) {
+    // Inset the box slightly, as the extremes are rarely the best endpoints.
+    const int32_t inset = (max[c] - min[c]) >> 4;
+    start[c] = min[c] + inset;
+    end[c] = max[c] - inset;
+  }
+
+  for (uint32_t c = 0; c < 3; ++c) {
+    if (c == major) {
+      continue;
+    }
+    int32_t covariance = 0;
+    for (uint32_t i = 0; i < 16; ++i) {
+      if (transparent && transparent[i]) {
+        continue;
+      }
+      covariance += (channels[major][i] * count - sum[major]) * (channels[c][i] * count - sum[c]) / 256;
+    }
+    if (covariance < 0) {
+      int32_t temp = start[c];
+      start[c] = end[c];
+      end[c] = temp;
+    }
+  }
+
+  EvaluateColorFit(fit, block, PackRGB565(end[0], end[1], end[2]), PackRGB565(start[0], start[1], start[2]),
+                   three_color, transparent);
+}
+
+// Uses the extent of the block's colors along their principal axis as endpoints.
+static void FitPrincipalAxis(ColorFit &fit, const PixelBlock &block, bool three_color, const bool *transparent) {
+  float mean[3] = {0.0f, 0.0f, 0.0f};
+  float count = 0.0f;
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (transparent && transparent[i]) {
+      continue;
+    }
+    mean[0] += static_cast<float>(block.r[i]);
+    mean[1] += static_cast<float>(block.g[i]);
+    mean[2] += static_cast<float>(block.b[i]);
+    count += 1.0f;
+  }
+  for (auto &m : mean) {
+    m /= count;
+  }
+
+  // Covariance matrix: rr, rg, rb, gg, gb, bb.
+  float covariance[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (transparent && transparent[i]) {
+      continue;
+    }
+    const float r = static_cast<float>(block.r[i]) - mean[0];
+    const float g = static_cast<float>(block.g[i]) - mean[1];
+    const float b = static_cast<float>(block.b[i]) - mean[2];
+    covariance[0] += r * r;
+    covariance[1] += r * g;
+    covariance[2] += r * b;
+    covariance[3] += g * g;
+    covariance[4] += g * b;
+    covariance[5] += b * b;
+  }
+
+  // Power iteration, starting from the row with the largest variance.
+  float axis[3];
+  if (covariance[0] >= covariance[3] && covariance[0] >= covariance[5]) {
+    axis[0] = covariance[0];
+    axis[1] = covariance[1];
+    axis[2] = covariance[2];
+  } else if (covariance[3] >= covariance[5]) {
+    axis[0] = covariance[1];
+    axis[1] = covariance[3];
+    axis[2] = covariance[4];
+  } else {
+    axis[0] = covariance[2];
+    axis[1] = covariance[4];
+    axis[2] = covariance[5];
+  }
+
+  for (uint32_t iteration = 0; iteration < 8; ++iteration) {
+    const float x = axis[0] * covariance[0] + axis[1] * covariance[1] + axis[2] * covariance[2];
+    const float y = axis[0] * covariance[1] + axis[1] * covariance[3] + axis[2] * covariance[4];
+    const float z = axis[0] * covariance[2] + axis[1] * covariance[4] + axis[2] * covariance[5];
+    float largest = fabsf(x) > fabsf(y) ? fabsf(x) : fabsf(y);
+    largest = fabsf(z) > largest ? fabsf(z) : largest;
+    if (largest < 1e-6f) {
+      break;
+    }
+    axis[0] = x / largest;
+    axis[1] = y / largest;
+    axis[2] = z / largest;
+  }
+
+  const float length_squared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+  if (length_squared < 1e-6f) {
+    // Solid color.
+    const uint16_t color = PackRGB565(static_cast<int32_t>(mean[0] + 0.5f), static_cast<int32_t>(mean[1] + 0.5f),
+                                      static_cast<int32_t>(mean[2] + 0.5f));
+    EvaluateColorFit(fit, block, color, color, three_color, transparent);
+    return;
+  }
+
+  float min_projection = 1e10f;
+  float max_projection = -1e10f;
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (transparent && transparent[i]) {
+      continue;
+    }
+    const float projection = (static_cast<float>(block.r[i]) - mean[0]) * axis[0] +
+                             (static_cast<float>(block.g[i]) - mean[1]) * axis[1] +
+                             (static_cast<float>(block.b[i]) - mean[2]) * axis[2];
+    min_projection = projection < min_projection ? projection : min_projection;
+    max_projection = projection > max_projection ? projection : max_projection;
+  }
+  min_projection /= length_squared;
+  max_projection /= length_squared;
+
+  int32_t start[3];
+  int32_t end[3];
+  for (uint32_t c = 0; c < 3; ++c) {
+    start[c] = static_cast<int32_t>(mean[c] + axis[c] * min_projection + 0.5f);
+    end[c] = static_cast<int32_t>(mean[c] + axis[c] * max_projection + 0.5f);
+  }
+
+  EvaluateColorFit(fit, block, PackRGB565(end[0], end[1], end[2]), PackRGB565(start[0], start[1], start[2]),
+                   three_color, transparent);
+}
+
+// Solves for the endpoints that minimize the squared error given the current index assignment.
+static bool RefineColorFit(ColorFit &fit, const PixelBlock &block, bool three_color, const bool *transparent) {
+  // Weight of color0 for each index; the weight of color1 is the complement.
+  static constexpr float kFourColorWeights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+  static constexpr float kThreeColorWeights[4] = {1.0f, 0.0f, 0.5f, 0.0f};
+  const float *weights = three_color ? kThreeColorWeights : kFourColorWeights;
+
+  float aa = 0.0f;
+  float ab = 0.0f;
+  float bb = 0.0f;
+  float ap[3] = {0.0f, 0.0f, 0.0f};
+  float bp[3] = {0.0f, 0.0f, 0.0f};
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (transparent && transparent[i]) {
+      continue;
+    }
+    const float alpha = weights[fit.indices[i]];
+    const float beta = 1.0f - alpha;
+    aa += alpha * alpha;
+    ab += alpha * beta;
+    bb += beta * beta;
+
+    const float pixel[3] = {static_cast<float>(block.r[i]), static_cast<float>(block.g[i]),
+                            static_cast<float>(block.b[i])};
+    for (uint32_t c = 0; c < 3; ++c) {
+      ap[c] += alpha * pixel[c];
+      bp[c] += beta * pixel[c];
+    }
+  }
+
+  const float determinant = aa * bb - ab * ab;
+  if (fabsf(determinant) < 1e-6f) {
+    return false;
+  }
+
+  int32_t color0[3];
+  int32_t color1[3];
+  for (uint32_t c = 0; c < 3; ++c) {
+    color0[c] = static_cast<int32_t>((bb * ap[c] - ab * bp[c]) / determinant + 0.5f);
+    color1[c] = static_cast<int32_t>((aa * bp[c] - ab * ap[c]) / determinant + 0.5f);
+  }
+
+  ColorFit candidate;
+  EvaluateColorFit(candidate, block, PackRGB565(color0[0], color0[1], color0[2]),
+                   PackRGB565(color1[0], color1[1], color1[2]), three_color, transparent);
+  if (candidate.error >= fit.error) {
+    return false;
+  }
+  fit = candidate;
+  return true;
+}
+
+static void FitQuality(ColorFit &fit, const PixelBlock &block, bool three_color, const bool *transparent) {
+  FitPrincipalAxis(fit, block, three_color, transparent);
+  for (uint32_t iteration = 0; iteration < 2 && fit.error; ++iteration) {
+    if (!RefineColorFit(fit, block, three_color, transparent)) {
+      break;
+    }
+  }
+}
+
+static void WriteColorBlock(uint8_t *dest, const ColorFit &fit) {
+  uint32_t indices = 0;
+  for (uint32_t i = 0; i < 16; ++i) {
+    indices |= static_cast<uint32_t>(fit.indices[i]) << (i * 2);
+  }
+
+  dest[0] = fit.color0 & 0xFF;
+  dest[1] = fit.color0 >> 8;
+  dest[2] = fit.color1 & 0xFF;
+  dest[3] = fit.color1 >> 8;
+  dest[4] = indices & 0xFF;
+  dest[5] = (indices >> 8) & 0xFF;
+  dest[6] = (indices >> 16) & 0xFF;
+  dest[7] = (indices >> 24) & 0xFF;
+}
+
+static void EncodeColorBlock(uint8_t *dest, const PixelBlock &block, DXTCompressionMode mode, bool allow_alpha) {
+  bool transparent[16];
+  bool has_transparency = false;
+  bool has_opaque = false;
+  if (allow_alpha) {
+    for (uint32_t i = 0; i < 16; ++i) {
+      transparent[i] = block.a[i] < kDXT1AlphaThreshold;
+      has_transparency |= transparent[i];
+      has_opaque |= !transparent[i];
+    }
+  }
+
+  ColorFit best;
+  if (has_transparency) {
+    if (!has_opaque) {
+      // All pixels use the transparent entry.
+      best.color0 = best.color1 = 0;
+      for (auto &index : best.indices) {
+        index = 3;
+      }
+    } else if (mode == DXT_COMPRESS_FAST) {
+      FitBoundingBox(best, block, true, transparent);
+    } else {
+      FitQuality(best, block, true, transparent);
+    }
+  } else if (mode == DXT_COMPRESS_FAST) {
+    FitBoundingBox(best, block, false, nullptr);
+  } else {
+    FitQuality(best, block, false, nullptr);
+
+    // DXT3 and DXT5 color blocks are always decoded in 4-color mode, so 3-color mode is only an option for DXT1.
+    if (allow_alpha && best.error) {
+      ColorFit three_color;
+      FitQuality(three_color, block, true, nullptr);
+      KeepBestFit(best, three_color);
+    }
+  }
+
+  WriteColorBlock(dest, best);
+}
+
+static void EncodeExplicitAlphaBlock(uint8_t *dest, const PixelBlock &block) {
+  for (uint32_t i = 0; i < 16; i += 2) {
+    const int32_t low = (block.a[i] * 15 + 127) / 255;
+    const int32_t high = (block.a[i + 1] * 15 + 127) / 255;
+    *dest++ = static_cast<uint8_t>(low | (high << 4));
+  }
+}
+
+// Assigns each pixel to the closest of the interpolated alpha values. Returns the total squared error.
+static uint32_t FitAlpha(uint8_t *indices, const PixelBlock &block, int32_t alpha0, int32_t alpha1) {
+  int32_t palette[8];
+  palette[0] = alpha0;
+  palette[1] = alpha1;
+  if (alpha0 > alpha1) {
+    for (int32_t i = 1; i < 7; ++i) {
+      palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+    }
+  } else {
+    for (int32_t i = 1; i < 5; ++i) {
+      palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < 16; ++i) {
+    uint32_t best_index = 0;
+    uint32_t best_error = 0xFFFFFFFF;
+    for (uint32_t p = 0; p < 8; ++p) {
+      const int32_t delta = block.a[i] - palette[p];
+      const auto error = static_cast<uint32_t>(delta * delta);
+      if (error < best_error) {
+        best_error = error;
+        best_index = p;
+      }
+    }
+    indices[i] = static_cast<uint8_t>(best_index);
+    total += best_error;
+  }
+
+  return total;
+}
+
+static void EncodeInterpolatedAlphaBlock(uint8_t *dest, const PixelBlock &block, DXTCompressionMode mode) {
+  int32_t min = 255;
+  int32_t max = 0;
+  int32_t inner_min = 255;
+  int32_t inner_max = 0;
+  for (int32_t alpha : block.a) {
+    min = alpha < min ? alpha : min;
+    max = alpha > max ? alpha : max;
+    if (alpha != 0 && alpha != 255) {
+      inner_min = alpha < inner_min ? alpha : inner_min;
+      inner_max = alpha > inner_max ? alpha : inner_max;
+    }
+  }
+
+  // 8-value mode, which is selected by alpha0 > alpha1. If the block is a single value, alpha0 == alpha1 selects the
+  // 6-value mode but index 0 still decodes exactly.
+  int32_t alpha0 = max;
+  int32_t alpha1 = min;
+  uint8_t indices[16];
+  uint32_t error = FitAlpha(indices, block, alpha0, alpha1);
+
+  // 6-value mode, where 0 and 255 are available explicitly and the endpoints only need to cover the other values.
+  if (mode == DXT_COMPRESS_QUALITY && error && inner_min <= inner_max) {
+    uint8_t six_value_indices[16];
+    const uint32_t six_value_error = FitAlpha(six_value_indices, block, inner_min, inner_max);
+    if (six_value_error < error) {
+      alpha0 = inner_min;
+      alpha1 = inner_max;
+      error = six_value_error;
+      for (uint32_t i = 0; i < 16; ++i) {
+        indices[i] = six_value_indices[i];
+      }
+    }
+  }
+
+  uint64_t packed = 0;
+  for (uint32_t i = 0; i < 16; ++i) {
+    packed |= static_cast<uint64_t>(indices[i]) << (i * 3);
+  }
+
+  dest[0] = static_cast<uint8_t>(alpha0);
+  dest[1] = static_cast<uint8_t>(alpha1);
+  for (uint32_t i = 0; i < 6; ++i) {
+    dest[2 + i] = static_cast<uint8_t>(packed >> (i * 8));
+  }
+}
+
+template <typename EncodeBlock>
+static void CompressImage(uint8_t *dest, const uint32_t *source, uint32_t source_pitch, uint32_t width,
+                          uint32_t height, uint32_t block_size, uint32_t red_shift, uint32_t green_shift,
+                          uint32_t blue_shift, uint32_t alpha_shift, EncodeBlock encode) {
+  auto source_bytes = reinterpret_cast<const uint8_t *>(source);
+  PixelBlock block;
+  for (uint32_t y = 0; y < height; y += 4) {
+    for (uint32_t x = 0; x < width; x += 4, dest += block_size) {
+      LoadBlock(block, source_bytes, source_pitch, width, height, x, y, red_shift, green_shift, blue_shift,
+                alpha_shift);
+      encode(dest, block);
+    }
+  }
+}
+
+static uint32_t GetNumBlocks(uint32_t width, uint32_t height) { return ((width + 3) / 4) * ((height + 3) / 4); }
+
+uint32_t GetDXT1CompressedSize(uint32_t width, uint32_t height) { return GetNumBlocks(width, height) * 8; }
+
+uint32_t GetDXT3CompressedSize(uint32_t width, uint32_t height) { return GetNumBlocks(width, height) * 16; }
+
+uint32_t GetDXT5CompressedSize(uint32_t width, uint32_t height) { return GetNumBlocks(width, height) * 16; }
+
+void CompressDXT1(uint8_t *dest, const uint32_t *source, uint32_t source_pitch, uint32_t width, uint32_t height,
+                  DXTCompressionMode mode, uint32_t red_shift, uint32_t green_shift, uint32_t blue_shift,
+                  uint32_t alpha_shift) {
+  CompressImage(dest, source, source_pitch, width, height, 8, red_shift, green_shift, blue_shift, alpha_shift,
+                [mode](uint8_t *out, const PixelBlock &block) { EncodeColorBlock(out, block, mode, true); });
+}
+
+void CompressDXT3(uint8_t *dest, const uint32_t *source, uint32_t source_pitch, uint32_t width, uint32_t height,
+                  DXTCompressionMode mode, uint32_t red_shift, uint32_t green_shift, uint32_t blue_shift,
+                  uint32_t alpha_shift) {
+  CompressImage(dest, source, source_pitch, width, height, 16, red_shift, green_shift, blue_shift, alpha_shift,
+                [mode](uint8_t *out, const PixelBlock &block) {
+                  EncodeExplicitAlphaBlock(out, block);
+                  EncodeColorBlock(out + 8, block, mode, false);
+                });
+}
+
+void CompressDXT5(uint8_t *dest, const uint32_t *source, uint32_t source_pitch, uint32_t width, uint32_t height,
+                  DXTCompressionMode mode, uint32_t red_shift, uint32_t green_shift, uint32_t blue_shift,
+                  uint32_t alpha_shift) {
+  CompressImage(dest, source, source_pitch, width, height, 16, red_shift, green_shift, blue_shift, alpha_shift,
+                [mode](uint8_t *out, const PixelBlock &block) {
+                  EncodeInterpolatedAlphaBlock(out, block, mode);
+                  EncodeColorBlock(out + 8, block, mode, false);
+                });
+}
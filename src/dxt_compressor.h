@@ -0,0 +1,42 @@
+#ifndef NXDK_PGRAPH_TESTS_DXT_COMPRESSOR_H
+#define NXDK_PGRAPH_TESTS_DXT_COMPRESSOR_H
+
+#include <cstdint>
+
+// S3TC block compression of 32bpp images into DXT1 (with 1-bit alpha), DXT3, and DXT5.
+//
+// Source pixels are 32-bit values with 8-bit components at the given bit shifts (the defaults describe
+// SDL_PIXELFORMAT_ABGR8888, i.e., R, G, B, A in memory order). The source pitch is in bytes. Images whose dimensions
+// are not multiples of 4 are padded by repeating the last row/column. Compressed blocks are written contiguously in
+// row-major block order.
+
+enum DXTCompressionMode {
+  // Uses the bounding box of each block as the endpoints.
+  DXT_COMPRESS_FAST,
+  // Fits endpoints to the principal axis of each block and refines them with a least squares solve. DXT1 blocks also
+  // try the 3-color mode and DXT5 alpha blocks try the 6-value mode.
+  DXT_COMPRESS_QUALITY,
+};
+
+// Returns the number of bytes needed to hold a compressed image of the given dimensions.
+uint32_t GetDXT1CompressedSize(uint32_t width, uint32_t height);
+uint32_t GetDXT3CompressedSize(uint32_t width, uint32_t height);
+uint32_t GetDXT5CompressedSize(uint32_t width, uint32_t height);
+
+// Writes DXT1 data (NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT1_A1R5G5B5). Pixels with alpha below 128 are encoded as
+// transparent.
+void CompressDXT1(uint8_t *dest, const uint32_t *source, uint32_t source_pitch, uint32_t width, uint32_t height,
+                  DXTCompressionMode mode = DXT_COMPRESS_QUALITY, uint32_t red_shift = 0, uint32_t green_shift = 8,
+                  uint32_t blue_shift = 16, uint32_t alpha_shift = 24);
+
+// Writes DXT3 data (NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8) with explicit 4-bit alpha.
+void CompressDXT3(uint8_t *dest, const uint32_t *source, uint32_t source_pitch, uint32_t width, uint32_t height,
+                  DXTCompressionMode mode = DXT_COMPRESS_QUALITY, uint32_t red_shift = 0, uint32_t green_shift = 8,
+                  uint32_t blue_shift = 16, uint32_t alpha_shift = 24);
+
+// Writes DXT5 data (NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8) with interpolated alpha.
+void CompressDXT5(uint8_t *dest, const uint32_t *source, uint32_t source_pitch, uint32_t width, uint32_t height,
+                  DXTCompressionMode mode = DXT_COMPRESS_QUALITY, uint32_t red_shift = 0, uint32_t green_shift = 8,
+                  uint32_t blue_shift = 16, uint32_t alpha_shift = 24);
+
+#endif  // NXDK_PGRAPH_TESTS_DXT_COMPRESSOR_H
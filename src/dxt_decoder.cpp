@@ -0,0 +1,177 @@
+#include "dxt_decoder.h"
+
+// Each block is decoded by building its (at most 8 entry) palettes once and then expanding the 16 indices with table
+// lookups, so decoding cost is dominated by memory traffic rather than arithmetic.
+
+struct PixelLayout {
+  uint32_t red_shift;
+  uint32_t green_shift;
+  uint32_t blue_shift;
+  uint32_t alpha_shift;
+};
+
+static inline uint32_t Pack(const PixelLayout &layout, uint32_t red, uint32_t green, uint32_t blue, uint32_t alpha) {
+  return (red << layout.red_shift) | (green << layout.green_shift) | (blue << layout.blue_shift) |
+         (alpha << layout.alpha_shift);
+}
+
+// Builds the color palette for a block, with alpha set to 0xFF for opaque entries and 0 for the transparent entry.
+static void BuildColorPalette(uint32_t *palette, const uint8_t *block, bool allow_three_color,
+                              DXTInterpolation interpolation, const PixelLayout &layout) {
+  const uint32_t color0 = block[0] | (block[1] << 8);
+  const uint32_t color1 = block[2] | (block[3] << 8);
+
+  const int32_t r0 = static_cast<int32_t>(color0 >> 11);
+  const int32_t g0 = static_cast<int32_t>((color0 >> 5) & 0x3F);
+  const int32_t b0 = static_cast<int32_t>(color0 & 0x1F);
+  const int32_t r1 = static_cast<int32_t>(color1 >> 11);
+  const int32_t g1 = static_cast<int32_t>((color1 >> 5) & 0x3F);
+  const int32_t b1 = static_cast<int32_t>(color1 & 0x1F);
+
+  int32_t red[4];
+  int32_t green[4];
+  int32_t blue[4];
+  red[0] = (r0 << 3) | (r0 >> 2);
+  green[0] = (g0 << 2) | (g0 >> 4);
+  blue[0] = (b0 << 3) | (b0 >> 2);
+  red[1] = (r1 << 3) | (r1 >> 2);
+  green[1] = (g1 << 2) | (g1 >> 4);
+  blue[1] = (b1 << 3) | (b1 >> 2);
+
+  const bool three_color = allow_three_color && color0 <= color1;
+  if (interpolation == DXT_INTERPOLATE_NV2A) {
+    const int32_t green_delta = green[1] - green[0];
+    if (three_color) {
+      red[2] = ((r0 + r1) * 33) / 8;
+      green[2] = (256 * green[0] + green_delta / 4 + 128 + green_delta * 128) / 256;
+      blue[2] = ((b0 + b1) * 33) / 8;
+    } else {
+      red[2] = ((2 * r0 + r1) * 22) / 8;
+      green[2] = (256 * green[0] + green_delta / 4 + 128 + green_delta * 80) / 256;
+      blue[2] = ((2 * b0 + b1) * 22) / 8;
+      red[3] = ((r0 + 2 * r1) * 22) / 8;
+      green[3] = (256 * green[1] - green_delta / 4 + 128 - green_delta * 80) / 256;
+      blue[3] = ((b0 + 2 * b1) * 22) / 8;
+    }
+  } else if (three_color) {
+    red[2] = (red[0] + red[1]) / 2;
+    green[2] = (green[0] + green[1]) / 2;
+    blue[2] = (blue[0] + blue[1]) / 2;
+  } else {
+    red[2] = (2 * red[0] + red[1]) / 3;
+    green[2] = (2 * green[0] + green[1]) / 3;
+    blue[2] = (2 * blue[0] + blue[1]) / 3;
+    red[3] = (red[0] + 2 * red[1]) / 3;
+    green[3] = (green[0] + 2 * green[1]) / 3;
+    blue[3] = (blue[0] + 2 * blue[1]) / 3;
+  }
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    palette[i] = Pack(layout, red[i], green[i], blue[i], 0xFF);
+  }
+  palette[3] = three_color ? 0 : Pack(layout, red[3], green[3], blue[3], 0xFF);
+}
+
+// Builds the 8 entry DXT5 alpha palette, pre-shifted into position.
+static void BuildAlphaPalette(uint32_t *palette, const uint8_t *block, const PixelLayout &layout) {
+  const uint32_t alpha0 = block[0];
+  const uint32_t alpha1 = block[1];
+  palette[0] = alpha0;
+  palette[1] = alpha1;
+  if (alpha0 > alpha1) {
+    for (uint32_t i = 1; i < 7; ++i) {
+      palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+    }
+  } else {
+    for (uint32_t i = 1; i < 5; ++i) {
+      palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+    }
+    palette[6] = 0;
+    palette[7] = 0xFF;
+  }
+
+  for (uint32_t i = 0; i < 8; ++i) {
+    palette[i] <<= layout.alpha_shift;
+  }
+}
+
+// Expands the 2-bit color indices of a block into `pixels`.
+static inline void DecodeColorIndices(uint32_t *pixels, const uint8_t *block, const uint32_t *palette) {
+  const uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+  for (uint32_t i = 0; i < 16; ++i) {
+    pixels[i] = palette[(indices >> (i * 2)) & 0x03];
+  }
+}
+
+template <typename DecodeBlock>
+static void DecompressImage(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t width,
+                            uint32_t height, uint32_t block_size, DecodeBlock decode) {
+  auto dest_bytes = reinterpret_cast<uint8_t *>(dest);
+  uint32_t pixels[16];
+  for (uint32_t y = 0; y < height; y += 4) {
+    const uint32_t rows = height - y < 4 ? height - y : 4;
+    for (uint32_t x = 0; x < width; x += 4, source += block_size) {
+      decode(pixels, source);
+
+      const uint32_t columns = width - x < 4 ? width - x : 4;
+      for (uint32_t row = 0; row < rows; ++row) {
+        auto out = reinterpret_cast<uint32_t *>(dest_bytes + (y + row) * dest_pitch) + x;
+        const uint32_t *in = pixels + row * 4;
+        for (uint32_t column = 0; column < columns; ++column) {
+          out[column] = in[column];
+        }
+      }
+    }
+  }
+}
+
+void DecompressDXT1(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t width, uint32_t height,
+                    DXTInterpolation interpolation, uint32_t red_shift, uint32_t green_shift, uint32_t blue_shift,
+                    uint32_t alpha_shift) {
+  const PixelLayout layout{red_shift, green_shift, blue_shift, alpha_shift};
+  DecompressImage(dest, dest_pitch, source, width, height, 8, [&](uint32_t *pixels, const uint8_t *block) {
+    uint32_t palette[4];
+    BuildColorPalette(palette, block, true, interpolation, layout);
+    DecodeColorIndices(pixels, block, palette);
+  });
+}
+
+void DecompressDXT3(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t width, uint32_t height,
+                    DXTInterpolation interpolation, uint32_t red_shift, uint32_t green_shift, uint32_t blue_shift,
+                    uint32_t alpha_shift) {
+  const PixelLayout layout{red_shift, green_shift, blue_shift, alpha_shift};
+  const uint32_t alpha_mask = ~(0xFFu << alpha_shift);
+  DecompressImage(dest, dest_pitch, source, width, height, 16, [&](uint32_t *pixels, const uint8_t *block) {
+    uint32_t palette[4];
+    BuildColorPalette(palette, block + 8, false, interpolation, layout);
+    DecodeColorIndices(pixels, block + 8, palette);
+
+    for (uint32_t i = 0; i < 16; ++i) {
+      const uint32_t alpha = (block[i >> 1] >> ((i & 1) * 4)) & 0x0F;
+      pixels[i] = (pixels[i] & alpha_mask) | ((alpha * 17) << alpha_shift);
+    }
+  });
+}
+
+void DecompressDXT5(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t width, uint32_t height,
+                    DXTInterpolation interpolation, uint32_t red_shift, uint32_t green_shift, uint32_t blue_shift,
+                    uint32_t alpha_shift) {
+  const PixelLayout layout{red_shift, green_shift, blue_shift, alpha_shift};
+  const uint32_t alpha_mask = ~(0xFFu << alpha_shift);
+  DecompressImage(dest, dest_pitch, source, width, height, 16, [&](uint32_t *pixels, const uint8_t *block) {
+    uint32_t palette[4];
+    BuildColorPalette(palette, block + 8, false, interpolation, layout);
+    DecodeColorIndices(pixels, block + 8, palette);
+
+    uint32_t alpha_palette[8];
+    BuildAlphaPalette(alpha_palette, block, layout);
+
+    // 16 3-bit indices packed little endian into 6 bytes.
+    const uint32_t low = block[2] | (block[3] << 8) | (block[4] << 16);
+    const uint32_t high = block[5] | (block[6] << 8) | (block[7] << 16);
+    for (uint32_t i = 0; i < 8; ++i) {
+      pixels[i] = (pixels[i] & alpha_mask) | alpha_palette[(low >> (i * 3)) & 0x07];
+      pixels[i + 8] = (pixels[i + 8] & alpha_mask) | alpha_palette[(high >> (i * 3)) & 0x07];
+    }
+  });
+}
@@ -0,0 +1,35 @@
+#ifndef NXDK_PGRAPH_TESTS_DXT_DECODER_H
+#define NXDK_PGRAPH_TESTS_DXT_DECODER_H
+
+#include <cstdint>
+
+// S3TC block decompression of DXT1, DXT3, and DXT5 data into 32bpp images.
+//
+// Destination pixels are 32-bit values with 8-bit components at the given bit shifts (the defaults describe
+// SDL_PIXELFORMAT_ABGR8888, i.e., R, G, B, A in memory order). The destination pitch is in bytes. Compressed blocks are
+// read contiguously in row-major block order; partial blocks at the right and bottom edges are clipped.
+
+enum DXTInterpolation {
+  // Interpolates the 8-bit expansions of the endpoints, truncating the result (e.g., (2 * c0 + c1) / 3).
+  DXT_INTERPOLATE_REFERENCE,
+  // Matches the fixed-point interpolation performed by nvidia hardware, which operates on the 5-bit red/blue and the
+  // expanded 8-bit green components and differs from the reference by up to a few units.
+  DXT_INTERPOLATE_NV2A,
+};
+
+// Decodes DXT1 data. Blocks with color0 <= color1 use the 3-color mode, in which index 3 is transparent black.
+void DecompressDXT1(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t width, uint32_t height,
+                    DXTInterpolation interpolation = DXT_INTERPOLATE_NV2A, uint32_t red_shift = 0,
+                    uint32_t green_shift = 8, uint32_t blue_shift = 16, uint32_t alpha_shift = 24);
+
+// Decodes DXT3 data (explicit 4-bit alpha). Color blocks are always decoded in 4-color mode.
+void DecompressDXT3(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t width, uint32_t height,
+                    DXTInterpolation interpolation = DXT_INTERPOLATE_NV2A, uint32_t red_shift = 0,
+                    uint32_t green_shift = 8, uint32_t blue_shift = 16, uint32_t alpha_shift = 24);
+
+// Decodes DXT5 data (interpolated alpha). Color blocks are always decoded in 4-color mode.
+void DecompressDXT5(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t width, uint32_t height,
+                    DXTInterpolation interpolation = DXT_INTERPOLATE_NV2A, uint32_t red_shift = 0,
+                    uint32_t green_shift = 8, uint32_t blue_shift = 16, uint32_t alpha_shift = 24);
+
+#endif  // NXDK_PGRAPH_TESTS_DXT_DECODER_H
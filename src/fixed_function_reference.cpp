@@ -0,0 +1,532 @@
+#include "fixed_function_reference.h"
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "vertex_buffer.h"
+
+FixedFunctionState::FixedFunctionState() {
+  matrix_unit(model_view);
+  matrix_unit(composite);
+  matrix_unit(inverse_model_view);
+  for (auto &stage : texgen) {
+    matrix_unit(stage.texture_matrix);
+  }
+}
+
+namespace {
+
+// Lanes hold one value for each of the four vertices of a batch. Both implementations perform the same single precision
+// operations in the same order, so they produce identical results.
+#ifdef __SSE__
+struct Lanes {
+  __m128 v;
+};
+
+// The result of a comparison, all bits are set in the lanes where it holds.
+struct Mask {
+  __m128 v;
+};
+
+inline Lanes Splat(float value) { return {_mm_set1_ps(value)}; }
+inline Lanes Make(float a, float b, float c, float d) { return {_mm_setr_ps(a, b, c, d)}; }
+inline void Store(float *out, Lanes a) { _mm_storeu_ps(out, a.v); }
+
+inline Lanes operator+(Lanes a, Lanes b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Lanes operator-(Lanes a, Lanes b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Lanes operator*(Lanes a, Lanes b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Lanes operator/(Lanes a, Lanes b) { return {_mm_div_ps(a.v, b.v)}; }
+inline Lanes Min(Lanes a, Lanes b) { return {_mm_min_ps(a.v, b.v)}; }
+inline Lanes Max(Lanes a, Lanes b) { return {_mm_max_ps(a.v, b.v)}; }
+inline Lanes Sqrt(Lanes a) { return {_mm_sqrt_ps(a.v)}; }
+inline Lanes Abs(Lanes a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+
+inline Mask Greater(Lanes a, Lanes b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+inline Mask LessEqual(Lanes a, Lanes b) { return {_mm_cmple_ps(a.v, b.v)}; }
+inline Mask Equal(Lanes a, Lanes b) { return {_mm_cmpeq_ps(a.v, b.v)}; }
+// Returns `a` in the lanes where `mask` is set and `b` elsewhere.
+inline Lanes Select(Mask mask, Lanes a, Lanes b) {
+  return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+}
+#else
+struct Lanes {
+  float v[4];
+};
+
+struct Mask {
+  bool v[4];
+};
+
+template <typename Function>
+inline Lanes Generate(Function function) {
+  return {{function(0), function(1), function(2), function(3)}};
+}
+
+template <typename Function>
+inline Mask Compare(Function function) {
+  return {{function(0), function(1), function(2), function(3)}};
+}
+
+inline Lanes Splat(float value) { return {{value, value, value, value}}; }
+inline Lanes Make(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+inline void Store(float *out, Lanes a) { std::copy(a.v, a.v + 4, out); }
+
+inline Lanes operator+(Lanes a, Lanes b) {
+  return Generate([&](int i) { return a.v[i] + b.v[i]; });
+}
+inline Lanes operator-(Lanes a, Lanes b) {
+  return Generate([&](int i) { return a.v[i] - b.v[i]; });
+}
+inline Lanes operator*(Lanes a, Lanes b) {
+  return Generate([&](int i) { return a.v[i] * b.v[i]; });
+}
+inline Lanes operator/(Lanes a, Lanes b) {
+  return Generate([&](int i) { return a.v[i] / b.v[i]; });
+}
+// Min and Max return `b` if either value is NaN, as minps and maxps do.
+inline Lanes Min(Lanes a, Lanes b) {
+  return Generate([&](int i) { return a.v[i] < b.v[i] ? a.v[i] : b.v[i]; });
+}
+inline Lanes Max(Lanes a, Lanes b) {
+  return Generate([&](int i) { return a.v[i] > b.v[i] ? a.v[i] : b.v[i]; });
+}
+inline Lanes Sqrt(Lanes a) {
+  return Generate([&](int i) { return std::sqrt(a.v[i]); });
+}
+inline Lanes Abs(Lanes a) {
+  return Generate([&](int i) { return std::fabs(a.v[i]); });
+}
+
+inline Mask Greater(Lanes a, Lanes b) {
+  return Compare([&](int i) { return a.v[i] > b.v[i]; });
+}
+inline Mask LessEqual(Lanes a, Lanes b) {
+  return Compare([&](int i) { return a.v[i] <= b.v[i]; });
+}
+inline Mask Equal(Lanes a, Lanes b) {
+  return Compare([&](int i) { return a.v[i] == b.v[i]; });
+}
+// Returns `a` in the lanes where `mask` is set and `b` elsewhere.
+inline Lanes Select(Mask mask, Lanes a, Lanes b) {
+  return Generate([&](int i) { return mask.v[i] ? a.v[i] : b.v[i]; });
+}
+#endif
+
+// Applies a scalar function to each lane, for operations without a vector form.
+template <typename Function>
+inline Lanes PerLane(Lanes a, Function function) {
+  float values[4];
+  Store(values, a);
+  return Make(function(values[0]), function(values[1]), function(values[2]), function(values[3]));
+}
+
+inline Lanes Clamp01(Lanes a) { return Min(Max(a, Splat(0.0f)), Splat(1.0f)); }
+
+// A 3 component vector for each vertex of a batch.
+struct Lanes3 {
+  Lanes x;
+  Lanes y;
+  Lanes z;
+
+  const Lanes &operator[](int index) const { return index == 0 ? x : (index == 1 ? y : z); }
+};
+
+inline Lanes3 Splat3(float x, float y, float z) { return {Splat(x), Splat(y), Splat(z)}; }
+inline Lanes3 Splat3(const VECTOR value) { return Splat3(value[_X], value[_Y], value[_Z]); }
+inline Lanes3 operator+(const Lanes3 &a, const Lanes3 &b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+inline Lanes3 operator-(const Lanes3 &a, const Lanes3 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+inline Lanes3 operator*(const Lanes3 &a, const Lanes3 &b) { return {a.x * b.x, a.y * b.y, a.z * b.z}; }
+inline Lanes3 operator*(const Lanes3 &a, Lanes b) { return {a.x * b, a.y * b, a.z * b}; }
+inline Lanes Dot(const Lanes3 &a, const Lanes3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+// Returns `a` scaled to unit length, zero length vectors are returned unchanged.
+inline Lanes3 Normalize(const Lanes3 &a) {
+  const Lanes length = Sqrt(Dot(a, a));
+  const Lanes divisor = Select(Equal(length, Splat(0.0f)), Splat(1.0f), length);
+  return {a.x / divisor, a.y / divisor, a.z / divisor};
+}
+
+}  // namespace
+
+// Loads the float at `offset` bytes into each vertex of a batch.
+static inline Lanes Gather(const Vertex *const *batch, size_t offset) {
+  auto value = [&](int i) {
+    return *reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(batch[i]) + offset);
+  };
+  return Make(value(0), value(1), value(2), value(3));
+}
+
+static inline void Gather4(Lanes *out, const Vertex *const *batch, size_t offset) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    out[i] = Gather(batch, offset + i * sizeof(float));
+  }
+}
+
+// Stores the first `count` lanes of `value` at `offset` bytes into each result.
+static inline void Scatter(FixedFunctionVertex *results, uint32_t count, size_t offset, Lanes value) {
+  float values[4];
+  Store(values, value);
+  for (uint32_t i = 0; i < count; ++i) {
+    *reinterpret_cast<float *>(reinterpret_cast<uint8_t *>(results + i) + offset) = values[i];
+  }
+}
+
+static inline void Scatter4(FixedFunctionVertex *results, uint32_t count, size_t offset, const Lanes *values) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    Scatter(results, count, offset + i * sizeof(float), values[i]);
+  }
+}
+
+// Transforms row vectors by a matrix in the layout held by TestHost (output = input * matrix).
+static inline void TransformRows(Lanes *output, const Lanes *input, const float *matrix) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    output[i] = input[0] * Splat(matrix[i]) + input[1] * Splat(matrix[4 + i]) + input[2] * Splat(matrix[8 + i]) +
+                input[3] * Splat(matrix[12 + i]);
+  }
+}
+
+// Transforms column vectors as vector_apply does (output = matrix * input).
+static inline void TransformColumns(Lanes *output, const Lanes *input, const float *matrix) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    const float *row = matrix + i * 4;
+    output[i] =
+        input[0] * Splat(row[0]) + input[1] * Splat(row[1]) + input[2] * Splat(row[2]) + input[3] * Splat(row[3]);
+  }
+}
+
+static inline Lanes PlaneDistance(const VECTOR plane, const Lanes *point) {
+  return point[0] * Splat(plane[0]) + point[1] * Splat(plane[1]) + point[2] * Splat(plane[2]) +
+         point[3] * Splat(plane[3]);
+}
+
+// Returns the vertex color used by `source`, or `material` if the color comes from the material.
+static inline Lanes3 SourceColor(FixedFunctionState::ColorSource source, const Lanes3 &material, const Lanes3 &diffuse,
+                                 const Lanes3 &specular) {
+  switch (source) {
+    case FixedFunctionState::SOURCE_VERTEX_DIFFUSE:
+      return diffuse;
+    case FixedFunctionState::SOURCE_VERTEX_SPECULAR:
+      return specular;
+    default:
+      return material;
+  }
+}
+
+// Returns the spot light cone factor for the normalized vertex to light vectors `vp`.
+static inline Lanes SpotFactor(const FixedFunctionState::Light &light, const Lanes3 &vp) {
+  const float *direction = light.spot_direction;
+  const float inverse_scale = 1.0f / std::sqrt(direction[_X] * direction[_X] + direction[_Y] * direction[_Y] +
+                                               direction[_Z] * direction[_Z]);
+  const float cos_half_phi = -inverse_scale * direction[_W];
+  const float cos_half_theta = inverse_scale + cos_half_phi;
+
+  const Lanes direction_dot_vp = Dot(Splat3(direction), vp);
+  const Lanes rho = Splat(inverse_scale) * direction_dot_vp;
+  const Lanes penumbra =
+      Select(LessEqual(rho, Splat(cos_half_phi)), Splat(0.0f), direction_dot_vp + Splat(direction[_W]));
+  return Select(Greater(rho, Splat(cos_half_theta)), Splat(1.0f), penumbra);
+}
+
+static void Light(const FixedFunctionState &state, const Lanes *eye, const Lanes3 &normal, const Lanes *diffuse,
+                  const Lanes *specular, Lanes *out_diffuse, Lanes *out_specular) {
+  const Lanes3 vertex_diffuse{diffuse[0], diffuse[1], diffuse[2]};
+  const Lanes3 vertex_specular{specular[0], specular[1], specular[2]};
+  const Lanes3 scene_ambient = Splat3(state.scene_ambient_color);
+  const Lanes3 white = Splat3(1.0f, 1.0f, 1.0f);
+
+  // The ambient color is scaled by the material emission and the emissive color added to it, both of them use the
+  // scene ambient color when taken from the material.
+  const Lanes3 ambient = SourceColor(state.GetAmbientSource(), scene_ambient, vertex_diffuse, vertex_specular);
+  const Lanes3 emission = SourceColor(state.GetEmissionSource(), scene_ambient, vertex_diffuse, vertex_specular);
+  Lanes3 color = ambient * Splat3(state.material_emission) + emission;
+
+  // The light colors already include the material colors, so they are only scaled by colors taken from the vertex.
+  const Lanes3 diffuse_scale = SourceColor(state.GetDiffuseSource(), white, vertex_diffuse, vertex_specular);
+  const Lanes3 specular_scale = SourceColor(state.GetSpecularSource(), white, vertex_diffuse, vertex_specular);
+  Lanes3 specular_color = Splat3(0.0f, 0.0f, 0.0f);
+
+  const Lanes3 position{eye[0] / eye[3], eye[1] / eye[3], eye[2] / eye[3]};
+  Lanes3 viewer;
+  if (state.IsLocalEye()) {
+    const float *eye_position = state.eye_position;
+    const Lanes3 eye_point = Splat3(eye_position[_X] / eye_position[_W], eye_position[_Y] / eye_position[_W],
+                                    eye_position[_Z] / eye_position[_W]);
+    viewer = Normalize(eye_point - position);
+  } else {
+    // The view space of D3D style model view matrices looks down +z.
+    viewer = Splat3(0.0f, 0.0f, -1.0f);
+  }
+
+  for (uint32_t i = 0; i < FixedFunctionState::kMaxLights; ++i) {
+    const auto type = state.GetLightType(i);
+    if (type == FixedFunctionState::LIGHT_OFF) {
+      continue;
+    }
+
+    const auto &light = state.lights[i];
+    Lanes attenuation;
+    Lanes n_dot_vp;
+    Lanes n_dot_hv;
+    if (type == FixedFunctionState::LIGHT_INFINITE) {
+      // The direction is normalized but the half vector is used as given.
+      const float *direction = light.infinite_direction;
+      const float length = std::sqrt(direction[_X] * direction[_X] + direction[_Y] * direction[_Y] +
+                                     direction[_Z] * direction[_Z]);
+      const Lanes3 vp = length == 0.0f ? Splat3(0.0f, 0.0f, 0.0f)
+                                       : Splat3(direction[_X] / length, direction[_Y] / length, direction[_Z] / length);
+      attenuation = Splat(1.0f);
+      n_dot_vp = Max(Dot(normal, vp), Splat(0.0f));
+      n_dot_hv = Max(Dot(normal, Splat3(light.infinite_half_vector)), Splat(0.0f));
+    } else {
+      Lanes3 vp = Splat3(light.local_position) - position;
+      const Lanes distance = Sqrt(Dot(vp, vp));
+      vp = Normalize(vp);
+
+      const float *factors = light.local_attenuation;
+      attenuation =
+          Splat(1.0f) / (Splat(factors[0]) + Splat(factors[1]) * distance + Splat(factors[2]) * distance * distance);
+      attenuation = Select(Greater(distance, Splat(light.local_range)), Splat(0.0f), attenuation);
+      if (type == FixedFunctionState::LIGHT_SPOT) {
+        attenuation = attenuation * SpotFactor(light, vp);
+      }
+
+      const Lanes3 half_vector = Normalize(vp + viewer);
+      n_dot_vp = Max(Dot(normal, vp), Splat(0.0f));
+      n_dot_hv = Max(Dot(normal, half_vector), Splat(0.0f));
+    }
+
+    color = color + Splat3(light.ambient) * attenuation;
+    color = color + diffuse_scale * Splat3(light.diffuse) * (attenuation * n_dot_vp);
+
+    if (state.specular_enable) {
+      // There is no specular highlight on faces pointing away from the light.
+      const float power = state.specular_power;
+      Lanes specular_factor = PerLane(n_dot_hv, [power](float value) { return std::pow(value, power); });
+      specular_factor = Select(Equal(n_dot_vp, Splat(0.0f)), Splat(0.0f), specular_factor);
+      specular_color = specular_color + specular_scale * Splat3(light.specular) * (attenuation * specular_factor);
+    }
+  }
+
+  switch (state.GetDiffuseSource()) {
+    case FixedFunctionState::SOURCE_VERTEX_DIFFUSE:
+      out_diffuse[3] = diffuse[3];
+      break;
+    case FixedFunctionState::SOURCE_VERTEX_SPECULAR:
+      out_diffuse[3] = specular[3];
+      break;
+    default:
+      out_diffuse[3] = Splat(state.material_alpha);
+      break;
+  }
+  out_specular[3] = specular[3];
+
+  for (int i = 0; i < 3; ++i) {
+    out_diffuse[i] = color[i];
+    out_specular[i] = specular_color[i];
+  }
+}
+
+static Lanes FogCoordinate(const FixedFunctionState &state, const Vertex *const *batch, const Lanes *eye,
+                           const Lanes *specular) {
+  switch (state.fog_gen_mode) {
+    case FixedFunctionState::FOG_GEN_SPEC_ALPHA:
+      return Clamp01(specular[3]);
+
+    case FixedFunctionState::FOG_GEN_RADIAL: {
+      const Lanes3 position{eye[0], eye[1], eye[2]};
+      return Sqrt(Dot(position, position));
+    }
+
+    case FixedFunctionState::FOG_GEN_PLANAR:
+    case FixedFunctionState::FOG_GEN_ABS_PLANAR: {
+      const float *plane = state.fog_plane;
+      const Lanes distance = Dot(Splat3(plane), {eye[0], eye[1], eye[2]}) + Splat(plane[_W]);
+      return state.fog_gen_mode == FixedFunctionState::FOG_GEN_ABS_PLANAR ? Abs(distance) : distance;
+    }
+
+    default:
+      return Gather(batch, offsetof(Vertex, fog_coord));
+  }
+}
+
+static Lanes FogFactor(const FixedFunctionState &state, Lanes coordinate) {
+  const Lanes bias = Splat(state.fog_params[0]);
+  const Lanes multiplier = Splat(state.fog_params[1]);
+  auto exp2 = [](float value) { return std::exp2(value); };
+
+  const auto mode = state.fog_mode;
+  if (mode == FixedFunctionState::FOG_LINEAR_ABS || mode == FixedFunctionState::FOG_EXP_ABS ||
+      mode == FixedFunctionState::FOG_EXP2_ABS) {
+    coordinate = Abs(coordinate);
+  }
+
+  Lanes factor;
+  switch (mode) {
+    case FixedFunctionState::FOG_EXP:
+    case FixedFunctionState::FOG_EXP_ABS:
+      factor = bias + PerLane(coordinate * multiplier * Splat(16.0f), exp2) - Splat(1.5f);
+      break;
+
+    case FixedFunctionState::FOG_EXP2:
+    case FixedFunctionState::FOG_EXP2_ABS:
+      factor = bias + PerLane(Splat(0.0f) - coordinate * coordinate * multiplier * multiplier * Splat(32.0f), exp2) -
+               Splat(1.5f);
+      break;
+
+    default:
+      factor = bias + coordinate * multiplier - Splat(1.0f);
+      break;
+  }
+
+  return Clamp01(factor);
+}
+
+static void GenerateTexcoords(const FixedFunctionState::Texgen &texgen, const Lanes *input, const Lanes *position,
+                              const Lanes *eye, const Lanes3 &normal, const Lanes3 &reflection, Lanes *output) {
+  Lanes generated[4];
+  for (int i = 0; i < 4; ++i) {
+    generated[i] = input[i];
+    switch (texgen.mode[i]) {
+      case FixedFunctionState::TEXGEN_EYE_LINEAR:
+        generated[i] = PlaneDistance(texgen.plane[i], eye);
+        break;
+
+      case FixedFunctionState::TEXGEN_OBJECT_LINEAR:
+        generated[i] = PlaneDistance(texgen.plane[i], position);
+        break;
+
+      case FixedFunctionState::TEXGEN_SPHERE_MAP:
+        if (i < 2) {
+          const Lanes3 offset = reflection + Splat3(0.0f, 0.0f, 1.0f);
+          const Lanes scale = Splat(1.0f) / (Splat(2.0f) * Sqrt(Dot(offset, offset)));
+          generated[i] = reflection[i] * scale + Splat(0.5f);
+        }
+        break;
+
+      case FixedFunctionState::TEXGEN_NORMAL_MAP:
+        if (i < 3) {
+          generated[i] = normal[i];
+        }
+        break;
+
+      case FixedFunctionState::TEXGEN_REFLECTION_MAP:
+        if (i < 3) {
+          generated[i] = reflection[i];
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  if (texgen.texture_matrix_enable) {
+    TransformColumns(output, generated, texgen.texture_matrix);
+  } else {
+    std::copy(generated, generated + 4, output);
+  }
+}
+
+static bool UsesReflection(const FixedFunctionState &state) {
+  for (const auto &stage : state.texgen) {
+    for (auto mode : stage.mode) {
+      if (mode == FixedFunctionState::TEXGEN_SPHERE_MAP || mode == FixedFunctionState::TEXGEN_REFLECTION_MAP) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void ProcessBatch(const FixedFunctionState &state, bool uses_reflection, const Vertex *const *batch,
+                         uint32_t count, FixedFunctionVertex *results) {
+  Lanes position[4];
+  Gather4(position, batch, offsetof(Vertex, pos));
+
+  Lanes clip[4];
+  TransformRows(clip, position, state.composite);
+  Scatter4(results, count, offsetof(FixedFunctionVertex, position), clip);
+
+  Lanes eye[4];
+  TransformRows(eye, position, state.model_view);
+
+  const float *inverse = state.inverse_model_view;
+  Lanes3 normal;
+  {
+    const Lanes x = Gather(batch, offsetof(Vertex, normal));
+    const Lanes y = Gather(batch, offsetof(Vertex, normal) + sizeof(float));
+    const Lanes z = Gather(batch, offsetof(Vertex, normal) + 2 * sizeof(float));
+    normal.x = x * Splat(inverse[0]) + y * Splat(inverse[1]) + z * Splat(inverse[2]);
+    normal.y = x * Splat(inverse[4]) + y * Splat(inverse[5]) + z * Splat(inverse[6]);
+    normal.z = x * Splat(inverse[8]) + y * Splat(inverse[9]) + z * Splat(inverse[10]);
+    if (state.normalization_enable) {
+      normal = Normalize(normal);
+    }
+  }
+
+  Lanes diffuse[4];
+  Lanes specular[4];
+  Gather4(diffuse, batch, offsetof(Vertex, diffuse));
+  Gather4(specular, batch, offsetof(Vertex, specular));
+
+  Lanes out_diffuse[4];
+  Lanes out_specular[4];
+  if (state.lighting_enable) {
+    Light(state, eye, normal, diffuse, specular, out_diffuse, out_specular);
+  } else {
+    std::copy(diffuse, diffuse + 4, out_diffuse);
+    std::copy(specular, specular + 4, out_specular);
+  }
+  for (uint32_t i = 0; i < 4; ++i) {
+    out_diffuse[i] = Clamp01(out_diffuse[i]);
+    out_specular[i] = Clamp01(out_specular[i]);
+  }
+  Scatter4(results, count, offsetof(FixedFunctionVertex, diffuse), out_diffuse);
+  Scatter4(results, count, offsetof(FixedFunctionVertex, specular), out_specular);
+
+  const Lanes fog_coord = FogCoordinate(state, batch, eye, specular);
+  Scatter(results, count, offsetof(FixedFunctionVertex, fog_coord), fog_coord);
+  Scatter(results, count, offsetof(FixedFunctionVertex, fog_factor), FogFactor(state, fog_coord));
+
+  // The reflection of the direction from the eye to the vertex, shared by the sphere and reflection map modes.
+  Lanes3 reflection = Splat3(0.0f, 0.0f, 0.0f);
+  if (uses_reflection) {
+    const Lanes3 direction = Normalize({eye[0], eye[1], eye[2]});
+    reflection = direction - normal * (Splat(2.0f) * Dot(normal, direction));
+  }
+
+  static constexpr size_t kTexcoordOffsets[FixedFunctionState::kNumTextureStages] = {
+      offsetof(Vertex, texcoord0),
+      offsetof(Vertex, texcoord1),
+      offsetof(Vertex, texcoord2),
+      offsetof(Vertex, texcoord3),
+  };
+  for (uint32_t stage = 0; stage < FixedFunctionState::kNumTextureStages; ++stage) {
+    Lanes input[4];
+    Gather4(input, batch, kTexcoordOffsets[stage]);
+    Lanes texcoord[4];
+    GenerateTexcoords(state.texgen[stage], input, position, eye, normal, reflection, texcoord);
+    Scatter4(results, count, offsetof(FixedFunctionVertex, texcoord) + stage * sizeof(results->texcoord[0]), texcoord);
+  }
+}
+
+void ApplyFixedFunctionPipeline(const FixedFunctionState &state, const Vertex *vertices, uint32_t count,
+                                FixedFunctionVertex *results) {
+  const bool uses_reflection = UsesReflection(state);
+
+  for (uint32_t first = 0; first < count; first += 4) {
+    const uint32_t batch_size = std::min(count - first, 4u);
+
+    // Short batches repeat their last vertex, the results for the repeats are discarded.
+    const Vertex *batch[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      batch[i] = vertices + first + std::min(i, batch_size - 1);
+    }
+    ProcessBatch(state, uses_reflection, batch, batch_size, results + first);
+  }
+}
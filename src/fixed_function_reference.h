@@ -0,0 +1,174 @@
+#ifndef NXDK_PGRAPH_TESTS_FIXED_FUNCTION_REFERENCE_H
+#define NXDK_PGRAPH_TESTS_FIXED_FUNCTION_REFERENCE_H
+
+#include <cstdint>
+
+#include "math3d.h"
+
+struct Vertex;
+
+// CPU reference model of the NV2A fixed function transform and lighting pipeline. The state is kept in the form it is
+// sent to the hardware, each member names the NV097 method that it mirrors, so tests can fill it in alongside their
+// pb_push calls (see TestHost::CopyFixedFunctionState for the parts managed by the host).
+//
+// The lighting, fog and texgen equations follow xemu's fixed function vertex program, including its interpretation of
+// the scene ambient and material emission registers. Not modelled: NV097_SET_SPECULAR_PARAMS (the specular exponent is
+// given directly instead), spot light falloff, back face colors, vertex blending and point parameters.
+struct FixedFunctionState {
+  static constexpr uint32_t kMaxLights = 8;
+  static constexpr uint32_t kNumTextureStages = 4;
+
+  // Per light NV097_SET_LIGHT_ENABLE_MASK values.
+  enum LightType {
+    LIGHT_OFF = 0,
+    LIGHT_INFINITE = 1,
+    LIGHT_LOCAL = 2,
+    LIGHT_SPOT = 3,
+  };
+
+  // Per color NV097_SET_COLOR_MATERIAL values.
+  enum ColorSource {
+    SOURCE_MATERIAL = 0,
+    SOURCE_VERTEX_DIFFUSE = 1,
+    SOURCE_VERTEX_SPECULAR = 2,
+  };
+
+  // NV097_SET_FOG_GEN_MODE_V_* values.
+  enum FogGenMode {
+    FOG_GEN_SPEC_ALPHA = 0,
+    FOG_GEN_RADIAL = 1,
+    FOG_GEN_PLANAR = 2,
+    FOG_GEN_ABS_PLANAR = 3,
+    FOG_GEN_FOG_X = 6,
+  };
+
+  // NV097_SET_FOG_MODE_V_* values.
+  enum FogMode {
+    FOG_LINEAR = 0x2601,
+    FOG_EXP = 0x800,
+    FOG_EXP2 = 0x801,
+    FOG_EXP_ABS = 0x802,
+    FOG_EXP2_ABS = 0x803,
+    FOG_LINEAR_ABS = 0x804,
+  };
+
+  // NV097_SET_TEXGEN_S_* values (see TextureStage::TexGen).
+  enum TexGen {
+    TEXGEN_DISABLE = 0,
+    TEXGEN_EYE_LINEAR = 0x2400,
+    TEXGEN_OBJECT_LINEAR = 0x2401,
+    // Generates S and T only.
+    TEXGEN_SPHERE_MAP = 0x2402,
+    // Generates S, T and R only.
+    TEXGEN_NORMAL_MAP = 0x8511,
+    // Generates S, T and R only.
+    TEXGEN_REFLECTION_MAP = 0x8512,
+  };
+
+  struct Light {
+    // NV097_SET_LIGHT_AMBIENT_COLOR, NV097_SET_LIGHT_DIFFUSE_COLOR and NV097_SET_LIGHT_SPECULAR_COLOR, which already
+    // include the material colors.
+    VECTOR ambient{0.0f, 0.0f, 0.0f, 0.0f};
+    VECTOR diffuse{0.0f, 0.0f, 0.0f, 0.0f};
+    VECTOR specular{0.0f, 0.0f, 0.0f, 0.0f};
+    // NV097_SET_LIGHT_LOCAL_RANGE. Local lights do not affect vertices further away than this.
+    float local_range{1e30f};
+    // NV097_SET_LIGHT_INFINITE_HALF_VECTOR
+    VECTOR infinite_half_vector{0.0f, 0.0f, 0.0f, 0.0f};
+    // NV097_SET_LIGHT_INFINITE_DIRECTION, the eye space direction towards the light.
+    VECTOR infinite_direction{0.0f, 0.0f, 1.0f, 0.0f};
+    // NV097_SET_LIGHT_SPOT_DIRECTION, the scaled direction in xyz and the offset of the cone in w.
+    VECTOR spot_direction{0.0f, 0.0f, 0.0f, 0.0f};
+    // NV097_SET_LIGHT_LOCAL_POSITION, in eye space.
+    VECTOR local_position{0.0f, 0.0f, 0.0f, 1.0f};
+    // NV097_SET_LIGHT_LOCAL_ATTENUATION, the constant, linear and quadratic factors.
+    VECTOR local_attenuation{1.0f, 0.0f, 0.0f, 0.0f};
+  };
+
+  struct Texgen {
+    // NV097_SET_TEXGEN_S, _T, _R and _Q.
+    TexGen mode[4]{TEXGEN_DISABLE, TEXGEN_DISABLE, TEXGEN_DISABLE, TEXGEN_DISABLE};
+    // NV097_SET_TEXGEN_SPLANE, _TPLANE, _RPLANE and _QPLANE, used by the linear modes.
+    VECTOR plane[4]{
+        {1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}};
+    // NV097_SET_TEXTURE_MATRIX_ENABLE
+    bool texture_matrix_enable{false};
+    // NV097_SET_TEXTURE_MATRIX, in the layout used by TextureStage::SetTextureMatrix (applied as by vector_apply).
+    MATRIX texture_matrix;
+  };
+
+  FixedFunctionState();
+
+  LightType GetLightType(uint32_t light) const {
+    return static_cast<LightType>((light_enable_mask >> (light * 2)) & 0x03);
+  }
+  ColorSource GetEmissionSource() const { return static_cast<ColorSource>(color_material & 0x03); }
+  ColorSource GetAmbientSource() const { return static_cast<ColorSource>((color_material >> 2) & 0x03); }
+  ColorSource GetDiffuseSource() const { return static_cast<ColorSource>((color_material >> 4) & 0x03); }
+  ColorSource GetSpecularSource() const { return static_cast<ColorSource>((color_material >> 6) & 0x03); }
+  // Whether the direction to the viewer is computed per vertex from eye_position.
+  bool IsLocalEye() const { return (light_control & 0x10000) != 0; }
+
+  // NV097_SET_MODEL_VIEW_MATRIX and NV097_SET_COMPOSITE_MATRIX in the layout held by TestHost (before it transposes
+  // them), so that positions are transformed as row vectors.
+  MATRIX model_view;
+  MATRIX composite;
+  // NV097_SET_INVERSE_MODEL_VIEW_MATRIX. Normals are transformed by its transpose.
+  MATRIX inverse_model_view;
+
+  // NV097_SET_NORMALIZATION_ENABLE
+  bool normalization_enable{false};
+  // NV097_SET_LIGHTING_ENABLE
+  bool lighting_enable{false};
+  // NV097_SET_SPECULAR_ENABLE. The specular color of lit vertices is black when disabled.
+  bool specular_enable{false};
+  // NV097_SET_LIGHT_CONTROL
+  uint32_t light_control{0x10001};
+  // NV097_SET_LIGHT_ENABLE_MASK
+  uint32_t light_enable_mask{0};
+  // NV097_SET_COLOR_MATERIAL
+  uint32_t color_material{0};
+  // NV097_SET_SCENE_AMBIENT_COLOR
+  VECTOR scene_ambient_color{0.0f, 0.0f, 0.0f, 0.0f};
+  // NV097_SET_MATERIAL_EMISSION
+  VECTOR material_emission{0.0f, 0.0f, 0.0f, 0.0f};
+  // NV097_SET_MATERIAL_ALPHA
+  float material_alpha{1.0f};
+  // The D3D material power that NV097_SET_SPECULAR_PARAMS approximates.
+  float specular_power{0.0f};
+  // NV097_SET_EYE_POSITION, in eye space.
+  VECTOR eye_position{0.0f, 0.0f, 0.0f, 1.0f};
+  Light lights[kMaxLights];
+
+  // NV097_SET_FOG_GEN_MODE
+  FogGenMode fog_gen_mode{FOG_GEN_SPEC_ALPHA};
+  // NV097_SET_FOG_MODE
+  FogMode fog_mode{FOG_LINEAR};
+  // NV097_SET_FOG_PARAMS, the bias and the multiplier.
+  float fog_params[2]{0.0f, 1.0f};
+  // NV097_SET_FOG_PLANE
+  VECTOR fog_plane{0.0f, 0.0f, 1.0f, 0.0f};
+
+  Texgen texgen[kNumTextureStages];
+};
+
+// The outputs of the fixed function pipeline for a single vertex.
+struct FixedFunctionVertex {
+  // Clip space position, before the divide by w.
+  float position[4];
+  // Colors clamped to [0, 1].
+  float diffuse[4];
+  float specular[4];
+  float fog_coord;
+  // Fog factor clamped to [0, 1], 1 being unfogged.
+  float fog_factor;
+  float texcoord[FixedFunctionState::kNumTextureStages][4];
+};
+
+// Runs `count` vertices through the fixed function pipeline described by `state`, writing one result per vertex. Only
+// the position, normal, color, fog coordinate and texture coordinate attributes of the vertices are used. Vertices are
+// processed four at a time and the results do not depend on whether SSE is available.
+void ApplyFixedFunctionPipeline(const FixedFunctionState &state, const Vertex *vertices, uint32_t count,
+                                FixedFunctionVertex *results);
+
+#endif  // NXDK_PGRAPH_TESTS_FIXED_FUNCTION_REFERENCE_H
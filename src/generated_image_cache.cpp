@@ -0,0 +1,74 @@
+#include "generated_image_cache.h"
+
+#include <cstring>
+
+bool GeneratedImageCache::Key::operator==(const Key &other) const {
+  return generator == other.generator && width == other.width && height == other.height &&
+         !memcmp(params, other.params, sizeof(params));
+}
+
+GeneratedImageCache &GeneratedImageCache::Shared() {
+  static GeneratedImageCache cache;
+  return cache;
+}
+
+std::shared_ptr<const GeneratedImageCache::Image> GeneratedImageCache::Get(const Key &key, const Generator &generate) {
+  for (auto &entry : entries_) {
+    if (entry.key == key) {
+      entry.last_used = ++clock_;
+      ++stats_.hits;
+      return entry.image;
+    }
+  }
+
+  ++stats_.misses;
+
+  auto image = std::make_shared<Image>();
+  image->width = key.width;
+  image->height = key.height;
+  image->pixels.resize(key.width * key.height);
+  generate(image->pixels.data(), key.width, key.height);
+
+  const uint32_t size = image->GetSize();
+  if (MakeRoom(size)) {
+    entries_.push_back({key, image, ++clock_});
+    memory_usage_ += size;
+  }
+
+  return image;
+}
+
+void GeneratedImageCache::Clear() {
+  entries_.clear();
+  memory_usage_ = 0;
+}
+
+void GeneratedImageCache::SetMemoryLimit(uint32_t memory_limit) {
+  memory_limit_ = memory_limit;
+  MakeRoom(0);
+}
+
+bool GeneratedImageCache::MakeRoom(uint32_t size) {
+  if (size > memory_limit_) {
+    return false;
+  }
+
+  while (memory_usage_ > memory_limit_ - size) {
+    // Evicting an image that is still referenced would not release its memory.
+    auto oldest = entries_.end();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->image.use_count() == 1 && (oldest == entries_.end() || it->last_used < oldest->last_used)) {
+        oldest = it;
+      }
+    }
+    if (oldest == entries_.end()) {
+      return false;
+    }
+
+    memory_usage_ -= oldest->image->GetSize();
+    entries_.erase(oldest);
+    ++stats_.evictions;
+  }
+
+  return true;
+}
@@ -0,0 +1,89 @@
+#ifndef NXDK_PGRAPH_TESTS_GENERATED_IMAGE_CACHE_H
+#define NXDK_PGRAPH_TESTS_GENERATED_IMAGE_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Holds procedurally generated source images so that suites which repeatedly build the same image (e.g., the gradient
+// used by every texture format test) generate it once.
+//
+// Images are identified by a caller-provided key describing the generator and every parameter that affects its output.
+// Returned images are immutable and reference counted; callers may hold them for as long as they need. The cache keeps
+// the total size of the images it holds at or below its memory limit by evicting the least recently used images that
+// are not referenced elsewhere. An image that cannot fit is returned without being cached.
+class GeneratedImageCache {
+ public:
+  // A tightly packed 32bpp ABGR8888 image (red in the low byte).
+  struct Image {
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint32_t> pixels;
+
+    uint32_t GetPitch() const { return width * 4; }
+    uint32_t GetSize() const { return width * height * 4; }
+  };
+
+  struct Key {
+    // Identifies the generator, unique per caller.
+    uint32_t generator;
+    uint32_t width;
+    uint32_t height;
+    uint32_t params[4];
+
+    bool operator==(const Key &other) const;
+  };
+
+  // Fills the `width` x `height` pixels of a new image.
+  typedef std::function<void(uint32_t *pixels, uint32_t width, uint32_t height)> Generator;
+
+  struct Stats {
+    uint32_t hits{0};
+    uint32_t misses{0};
+    uint32_t evictions{0};
+  };
+
+  static constexpr uint32_t kDefaultMemoryLimit = 4 * 1024 * 1024;
+
+ public:
+  explicit GeneratedImageCache(uint32_t memory_limit = kDefaultMemoryLimit) : memory_limit_(memory_limit) {}
+
+  // Returns the cache shared by all test suites.
+  static GeneratedImageCache &Shared();
+
+  // Returns the image identified by `key`, invoking `generate` to create it if it is not cached.
+  std::shared_ptr<const Image> Get(const Key &key, const Generator &generate);
+
+  // Discards all cached images. Images that are still referenced remain valid.
+  void Clear();
+
+  // Changes the memory limit, evicting unreferenced images as needed. Images that are still referenced are kept even if
+  // the cache remains above the new limit.
+  void SetMemoryLimit(uint32_t memory_limit);
+
+  uint32_t GetMemoryLimit() const { return memory_limit_; }
+  uint32_t GetMemoryUsage() const { return memory_usage_; }
+  uint32_t NumEntries() const { return entries_.size(); }
+
+  const Stats &GetStats() const { return stats_; }
+  void ResetStats() { stats_ = {}; }
+
+ private:
+  struct Entry {
+    Key key;
+    std::shared_ptr<const Image> image;
+    uint32_t last_used;
+  };
+
+  // Evicts unreferenced images in least recently used order until `size` more bytes fit. Returns false if they cannot.
+  bool MakeRoom(uint32_t size);
+
+  uint32_t memory_limit_;
+  uint32_t memory_usage_{0};
+  uint32_t clock_{0};
+  std::vector<Entry> entries_;
+  Stats stats_;
+};
+
+#endif  // NXDK_PGRAPH_TESTS_GENERATED_IMAGE_CACHE_H
@@ -0,0 +1,99 @@
+#include "index_generator.h"
+
+void GenerateSequentialIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex) {
+  indices.reserve(indices.size() + num_vertices);
+  for (uint32_t i = 0; i < num_vertices; ++i) {
+    indices.push_back(first_vertex + i);
+  }
+}
+
+void GenerateLineStripIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex) {
+  if (num_vertices < 2) {
+    return;
+  }
+
+  indices.reserve(indices.size() + (num_vertices - 1) * 2);
+  for (uint32_t i = 1; i < num_vertices; ++i) {
+    indices.push_back(first_vertex + i - 1);
+    indices.push_back(first_vertex + i);
+  }
+}
+
+void GenerateLineLoopIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex) {
+  if (num_vertices < 2) {
+    return;
+  }
+
+  GenerateLineStripIndices(indices, num_vertices, first_vertex);
+  indices.push_back(first_vertex + num_vertices - 1);
+  indices.push_back(first_vertex);
+}
+
+void GenerateTriangleStripIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex) {
+  if (num_vertices < 3) {
+    return;
+  }
+
+  const uint32_t num_triangles = num_vertices - 2;
+  indices.reserve(indices.size() + num_triangles * 3);
+  for (uint32_t i = 0; i < num_triangles; ++i) {
+    const uint32_t base = first_vertex + i;
+    if (i & 0x01) {
+      indices.push_back(base + 1);
+      indices.push_back(base);
+    } else {
+      indices.push_back(base);
+      indices.push_back(base + 1);
+    }
+    indices.push_back(base + 2);
+  }
+}
+
+void GenerateTriangleFanIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex) {
+  if (num_vertices < 3) {
+    return;
+  }
+
+  const uint32_t num_triangles = num_vertices - 2;
+  indices.reserve(indices.size() + num_triangles * 3);
+  for (uint32_t i = 1; i <= num_triangles; ++i) {
+    indices.push_back(first_vertex);
+    indices.push_back(first_vertex + i);
+    indices.push_back(first_vertex + i + 1);
+  }
+}
+
+void GenerateQuadIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex) {
+  const uint32_t num_quads = num_vertices / 4;
+  indices.reserve(indices.size() + num_quads * 6);
+  for (uint32_t i = 0; i < num_quads; ++i) {
+    const uint32_t base = first_vertex + i * 4;
+    indices.push_back(base);
+    indices.push_back(base + 1);
+    indices.push_back(base + 2);
+
+    indices.push_back(base);
+    indices.push_back(base + 2);
+    indices.push_back(base + 3);
+  }
+}
+
+void GenerateQuadStripIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex) {
+  if (num_vertices < 4) {
+    return;
+  }
+
+  // Quad N of a strip is made up of vertices 2N, 2N+1, 2N+3, 2N+2 (in winding order).
+  const uint32_t num_quads = (num_vertices - 2) / 2;
+  indices.reserve(indices.size() + num_quads * 6);
+  for (uint32_t i = 0; i < num_quads; ++i) {
+    const uint32_t base = first_vertex + i * 2;
+    indices.push_back(base);
+    indices.push_back(base + 1);
+    indices.push_back(base + 3);
+
+    indices.push_back(base);
+    indices.push_back(base + 3);
+    indices.push_back(base + 2);
+  }
+}
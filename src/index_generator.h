@@ -0,0 +1,36 @@
+#ifndef NXDK_PGRAPH_TESTS_INDEX_GENERATOR_H
+#define NXDK_PGRAPH_TESTS_INDEX_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+// Helpers that expand composite primitives (strips, fans, loops, quads) into index lists of independent primitives.
+// The generated indices reference the original vertices, so a single vertex buffer may be drawn as either the
+// composite primitive or the expanded list without duplicating any vertex data.
+//
+// Each method appends to `indices` and treats `num_vertices` vertices beginning at `first_vertex` as the composite
+// primitive. Trailing vertices that do not form a complete primitive are ignored, matching hardware behavior.
+
+// Appends `num_vertices` sequential indices (used for primitives that need no expansion).
+void GenerateSequentialIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex = 0);
+
+// Appends pairs of indices that render a line strip as independent lines.
+void GenerateLineStripIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex = 0);
+
+// Appends pairs of indices that render a line loop as independent lines, including the closing segment.
+void GenerateLineLoopIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex = 0);
+
+// Appends triplets of indices that render a triangle strip as independent triangles. Odd triangles have their first two
+// vertices swapped so that every triangle retains the winding of the first.
+void GenerateTriangleStripIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex = 0);
+
+// Appends triplets of indices that render a triangle fan (or convex polygon) as independent triangles.
+void GenerateTriangleFanIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex = 0);
+
+// Appends triplets of indices that render each quad as two triangles sharing the first and third vertices.
+void GenerateQuadIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex = 0);
+
+// Appends triplets of indices that render a quad strip as independent triangles, two per quad.
+void GenerateQuadStripIndices(std::vector<uint32_t>& indices, uint32_t num_vertices, uint32_t first_vertex = 0);
+
+#endif  // NXDK_PGRAPH_TESTS_INDEX_GENERATOR_H
@@ -0,0 +1,94 @@
+#ifndef NXDK_PGRAPH_TESTS_LAZY_MATRIX_H
+#define NXDK_PGRAPH_TESTS_LAZY_MATRIX_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+#include "math3d.h"
+
+// A matrix that is either an input (set directly) or derived from other LazyMatrix instances. Changing an input marks
+// everything derived from it, directly or indirectly, as dirty, and a dirty matrix is only recomputed when it is next
+// read. LazyMatrix instances reference each other and so cannot be copied. The storage is 16 byte aligned, so both Get
+// and the `result` passed to a Compute may be used with the *_aligned math3d functions.
+class LazyMatrix {
+ public:
+  // Computes the matrix into `result`, reading its inputs through their Get methods.
+  typedef std::function<void(MATRIX result)> Compute;
+
+  LazyMatrix() = default;
+  LazyMatrix(const LazyMatrix &) = delete;
+  LazyMatrix &operator=(const LazyMatrix &) = delete;
+
+  // Makes this a derived matrix that is recomputed by `compute` whenever any of `inputs` changes.
+  void Derive(std::initializer_list<LazyMatrix *> inputs, Compute compute) {
+    for (auto input : inputs) {
+      input->dependents_.push_back(this);
+    }
+    compute_ = std::move(compute);
+    Invalidate();
+  }
+
+  // Returns the matrix, recomputing it first if any of its inputs changed since it was last computed.
+  const float *Get() const {
+    if (dirty_) {
+      compute_(matrix_);
+      dirty_ = false;
+      ++compute_count_;
+    }
+    return matrix_;
+  }
+
+  // Replaces the value of the matrix. Dependents are only invalidated if the value actually changed.
+  void Set(const MATRIX value) {
+    if (!dirty_ && !memcmp(matrix_, value, sizeof(matrix_))) {
+      return;
+    }
+    memcpy(matrix_, value, sizeof(matrix_));
+    dirty_ = false;
+    InvalidateDependents();
+  }
+
+  // Returns the matrix for modification and invalidates its dependents. A derived matrix keeps the modified value until
+  // one of its inputs changes. Modifications must be complete before any dependent is read.
+  MATRIX &Modify() {
+    Get();
+    InvalidateDependents();
+    return matrix_;
+  }
+
+  // Marks the matrix as changed. Derived matrices are recomputed when next read, which is used when the parameters a
+  // derivation depends on (rather than its input matrices) change.
+  void Invalidate() {
+    if (compute_) {
+      if (dirty_) {
+        // Dependents of a dirty matrix are always dirty themselves.
+        return;
+      }
+      dirty_ = true;
+    }
+    InvalidateDependents();
+  }
+
+  bool IsDirty() const { return dirty_; }
+
+  // Returns the number of times the matrix has been computed.
+  uint32_t GetComputeCount() const { return compute_count_; }
+
+ private:
+  void InvalidateDependents() {
+    for (auto dependent : dependents_) {
+      dependent->Invalidate();
+    }
+  }
+
+  mutable ALIGNED_MATRIX matrix_{};
+  mutable bool dirty_{false};
+  mutable uint32_t compute_count_{0};
+  Compute compute_;
+  std::vector<LazyMatrix *> dependents_;
+};
+
+#endif  // NXDK_PGRAPH_TESTS_LAZY_MATRIX_H
@@ -49,6 +49,7 @@
 #include "tests/shade_model_tests.h"
 #include "tests/smoothing_tests.h"
 #include "tests/stencil_tests.h"
+#include "tests/surface_capture_tests.h"
 #include "tests/surface_clip_tests.h"
 #include "tests/surface_pitch_tests.h"
 #include "tests/texgen_matrix_tests.h"
@@ -66,6 +67,7 @@
 #include "tests/texture_signed_component_tests.h"
 #include "tests/three_d_primitive_tests.h"
 #include "tests/two_d_line_tests.h"
+#include "tests/vertex_cache_tests.h"
 #include "tests/vertex_shader_independence_tests.h"
 #include "tests/vertex_shader_rounding_tests.h"
 #include "tests/vertex_shader_swizzle_tests.h"
@@ -84,6 +86,7 @@ static constexpr int kTextureWidth = 256;
 static constexpr int kTextureHeight = 256;
 
 static constexpr const char* kLogFileName = "pgraph_progress_log.txt";
+static constexpr const char* kResourcePackPath = "D:\\resources.pack";
 
 static void register_suites(TestHost& host, std::vector<std::shared_ptr<TestSuite>>& test_suites,
                             const std::string& output_directory);
@@ -133,6 +136,13 @@ int main() {
   pb_show_front_screen();
 
   TestHost host(kFramebufferWidth, kFramebufferHeight, kTextureWidth, kTextureHeight);
+  if (!host.LoadResourcePack(kResourcePackPath)) {
+    debugPrint("Failed to load %s.\n", kResourcePackPath);
+    debugPrint("It is generated from resources/ by the Makefile and must be copied next to default.xbe.\n");
+    pb_show_debug_screen();
+    Sleep(2000);
+    return 1;
+  }
 
   std::vector<std::shared_ptr<TestSuite>> test_suites;
   register_suites(host, test_suites, test_output_directory);
@@ -530,6 +540,10 @@ static void register_suites(TestHost& host, std::vector<std::shared_ptr<TestSuit
     auto suite = std::make_shared<SmoothingTests>(host, output_directory);
     test_suites.push_back(suite);
   }
+  {
+    auto suite = std::make_shared<SurfaceCaptureTests>(host, output_directory);
+    test_suites.push_back(suite);
+  }
   {
     auto suite = std::make_shared<SurfaceClipTests>(host, output_directory);
     test_suites.push_back(suite);
@@ -602,6 +616,10 @@ static void register_suites(TestHost& host, std::vector<std::shared_ptr<TestSuit
     auto suite = std::make_shared<TwoDLineTests>(host, output_directory);
     test_suites.push_back(suite);
   }
+  {
+    auto suite = std::make_shared<VertexCacheTests>(host, output_directory);
+    test_suites.push_back(suite);
+  }
   {
     auto suite = std::make_shared<VertexShaderIndependenceTests>(host, output_directory);
     test_suites.push_back(suite);
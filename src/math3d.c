@@ -10,9 +10,159 @@
 unsigned long times(void *);
 #define cpu_ticks() times(0)
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+
+// The SSE implementations perform the same multiplies and additions in the same order as the scalar expressions they
+// replace, so their results are bit identical. Only 4-wide float operations are used, so SSE1 is sufficient.
+#define SSE_INLINE static inline __attribute__((always_inline))
+
+SSE_INLINE __m128 load4(const float *p, int aligned) { return aligned ? _mm_load_ps(p) : _mm_loadu_ps(p); }
+
+SSE_INLINE void store4(float *p, __m128 value, int aligned) {
+  if (aligned) {
+    _mm_store_ps(p, value);
+  } else {
+    _mm_storeu_ps(p, value);
+  }
+}
+
+#define SPLAT(v, i) _mm_shuffle_ps((v), (v), _MM_SHUFFLE((i), (i), (i), (i)))
+
+// Returns row0 * v[0] + row1 * v[1] + row2 * v[2] + row3 * v[3], accumulated left to right.
+SSE_INLINE __m128 combine_rows(__m128 v, __m128 row0, __m128 row1, __m128 row2, __m128 row3) {
+  __m128 result = _mm_mul_ps(SPLAT(v, 0), row0);
+  result = _mm_add_ps(result, _mm_mul_ps(SPLAT(v, 1), row1));
+  result = _mm_add_ps(result, _mm_mul_ps(SPLAT(v, 2), row2));
+  return _mm_add_ps(result, _mm_mul_ps(SPLAT(v, 3), row3));
+}
+
+SSE_INLINE void sse_vector_apply(VECTOR output, const VECTOR input0, const MATRIX input1, int aligned) {
+  __m128 c0 = load4(input1, aligned);
+  __m128 c1 = load4(input1 + 4, aligned);
+  __m128 c2 = load4(input1 + 8, aligned);
+  __m128 c3 = load4(input1 + 12, aligned);
+  _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+  store4(output, combine_rows(load4(input0, aligned), c0, c1, c2, c3), aligned);
+}
+
+SSE_INLINE void sse_matrix_multiply(MATRIX output, const MATRIX input0, const MATRIX input1, int aligned) {
+  const __m128 b0 = load4(input1, aligned);
+  const __m128 b1 = load4(input1 + 4, aligned);
+  const __m128 b2 = load4(input1 + 8, aligned);
+  const __m128 b3 = load4(input1 + 12, aligned);
+
+  // All rows are computed before any are stored, as the output may alias either input.
+  const __m128 r0 = combine_rows(load4(input0, aligned), b0, b1, b2, b3);
+  const __m128 r1 = combine_rows(load4(input0 + 4, aligned), b0, b1, b2, b3);
+  const __m128 r2 = combine_rows(load4(input0 + 8, aligned), b0, b1, b2, b3);
+  const __m128 r3 = combine_rows(load4(input0 + 12, aligned), b0, b1, b2, b3);
+  store4(output, r0, aligned);
+  store4(output + 4, r1, aligned);
+  store4(output + 8, r2, aligned);
+  store4(output + 12, r3, aligned);
+}
+
+SSE_INLINE void sse_matrix_transpose(MATRIX output, const MATRIX input0, int aligned) {
+  __m128 r0 = load4(input0, aligned);
+  __m128 r1 = load4(input0 + 4, aligned);
+  __m128 r2 = load4(input0 + 8, aligned);
+  __m128 r3 = load4(input0 + 12, aligned);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  store4(output, r0, aligned);
+  store4(output + 4, r1, aligned);
+  store4(output + 8, r2, aligned);
+  store4(output + 12, r3, aligned);
+}
+
+// Flips the sign of the lanes whose mask is set, which is exact.
+SSE_INLINE __m128 negate_lanes(__m128 value, __m128 mask) { return _mm_xor_ps(value, mask); }
+
+SSE_INLINE __m128 sign_mask(int l0, int l1, int l2, int l3) {
+  union {
+    unsigned int u[4];
+    __m128 v;
+  } mask = {{l0 ? 0x80000000 : 0, l1 ? 0x80000000 : 0, l2 ? 0x80000000 : 0, l3 ? 0x80000000 : 0}};
+  return mask.v;
+}
+
+// Each element (i, j) of the adjoint is a sum of six products of three elements taken from the rows other than j and
+// the columns other than i (see the scalar expressions in matrix_adjoint). For a row of the output, lane j draws its
+// first, second and third factors from rows (2, 1, 1, 1)[j], (3, 3, 2, 2)[j] and (4, 4, 4, 3)[j] respectively, so
+// with a, b and c holding those rows of each column, every lane evaluates the same expression and the six terms only
+// differ by the order in which the three remaining columns are used.
+SSE_INLINE __m128 adjoint_row(const __m128 *a, const __m128 *b, const __m128 *c, int c1, int c2, int c3,
+                              __m128 lane_signs) {
+  const __m128 t0 = _mm_mul_ps(_mm_mul_ps(a[c3], b[c2]), c[c1]);
+  const __m128 t1 = _mm_mul_ps(_mm_mul_ps(a[c2], b[c3]), c[c1]);
+  const __m128 t2 = _mm_mul_ps(_mm_mul_ps(a[c3], b[c1]), c[c2]);
+  const __m128 t3 = _mm_mul_ps(_mm_mul_ps(a[c1], b[c3]), c[c2]);
+  const __m128 t4 = _mm_mul_ps(_mm_mul_ps(a[c2], b[c1]), c[c3]);
+  const __m128 t5 = _mm_mul_ps(_mm_mul_ps(a[c1], b[c2]), c[c3]);
+
+  // Terms alternate in sign as +, -, -, +, +, - relative to the first. Adding a negated term is identical to
+  // subtracting it.
+  const __m128 first = negate_lanes(t0, lane_signs);
+  const __m128 opposite = _mm_xor_ps(lane_signs, sign_mask(1, 1, 1, 1));
+  __m128 result = _mm_add_ps(first, negate_lanes(t1, opposite));
+  result = _mm_add_ps(result, negate_lanes(t2, opposite));
+  result = _mm_add_ps(result, negate_lanes(t3, lane_signs));
+  result = _mm_add_ps(result, negate_lanes(t4, lane_signs));
+  return _mm_add_ps(result, negate_lanes(t5, opposite));
+}
+
+SSE_INLINE void sse_matrix_adjoint(MATRIX output, const MATRIX m, int aligned) {
+  __m128 col[4] = {load4(m, aligned), load4(m + 4, aligned), load4(m + 8, aligned), load4(m + 12, aligned)};
+  _MM_TRANSPOSE4_PS(col[0], col[1], col[2], col[3]);
+
+  __m128 a[4];
+  __m128 b[4];
+  __m128 c[4];
+  for (int i = 0; i < 4; ++i) {
+    a[i] = _mm_shuffle_ps(col[i], col[i], _MM_SHUFFLE(0, 0, 0, 1));
+    b[i] = _mm_shuffle_ps(col[i], col[i], _MM_SHUFFLE(1, 1, 2, 2));
+    c[i] = _mm_shuffle_ps(col[i], col[i], _MM_SHUFFLE(2, 3, 3, 3));
+  }
+
+  // Element (i, j) is negated when i + j is even.
+  const __m128 even_row_signs = sign_mask(1, 0, 1, 0);
+  const __m128 odd_row_signs = sign_mask(0, 1, 0, 1);
+  const __m128 r0 = adjoint_row(a, b, c, 1, 2, 3, even_row_signs);
+  const __m128 r1 = adjoint_row(a, b, c, 0, 2, 3, odd_row_signs);
+  const __m128 r2 = adjoint_row(a, b, c, 0, 1, 3, even_row_signs);
+  const __m128 r3 = adjoint_row(a, b, c, 0, 1, 2, odd_row_signs);
+  store4(output, r0, aligned);
+  store4(output + 4, r1, aligned);
+  store4(output + 8, r2, aligned);
+  store4(output + 12, r3, aligned);
+}
+
+SSE_INLINE void sse_matrix_scalar_multiply(MATRIX output, const MATRIX input, float m, int aligned) {
+  const __m128 scale = _mm_set1_ps(m);
+  for (int i = 0; i < 16; i += 4) {
+    store4(output + i, _mm_mul_ps(load4(input + i, aligned), scale), aligned);
+  }
+}
+
+SSE_INLINE int sse_matrix_general_inverse(MATRIX output, const MATRIX input, int aligned) {
+  // The determinant is a single left to right sum of 24 terms and is left scalar.
+  float det = matrix_determinant(input);
+  if (det == 0.0f) {
+    return 0;
+  }
+
+  sse_matrix_adjoint(output, input, aligned);
+  sse_matrix_scalar_multiply(output, output, 1.0f / det, aligned);
+  return 1;
+}
+#endif  // __SSE__
+
 // vector functions
 
 void vector_apply(VECTOR output, const VECTOR input0, const MATRIX input1) {
+#ifdef __SSE__
+  sse_vector_apply(output, input0, input1, 0);
+#else
   output[_X] =
       input0[_X] * input1[_11] + input0[_Y] * input1[_12] + input0[_Z] * input1[_13] + input0[_W] * input1[_14];
   output[_Y] =
@@ -21,6 +171,15 @@ void vector_apply(VECTOR output, const VECTOR input0, const MATRIX input1) {
       input0[_X] * input1[_31] + input0[_Y] * input1[_32] + input0[_Z] * input1[_33] + input0[_W] * input1[_34];
   output[_W] =
       input0[_X] * input1[_41] + input0[_Y] * input1[_42] + input0[_Z] * input1[_43] + input0[_W] * input1[_44];
+#endif
+}
+
+void vector_apply_aligned(VECTOR output, const VECTOR input0, const MATRIX input1) {
+#ifdef __SSE__
+  sse_vector_apply(output, input0, input1, 1);
+#else
+  vector_apply(output, input0, input1);
+#endif
 }
 
 void vector_clamp(VECTOR output, const VECTOR input0, float min, float max) {
@@ -156,6 +315,155 @@ void vector_euclidean(VECTOR output, const VECTOR input) {
   output[_W] = 1.0f;
 }
 
+// vector array functions
+
+#define ARRAY_ELEMENT(base, stride, i) ((float *)((char *)(base) + (size_t)(stride) * (i)))
+#define CONST_ARRAY_ELEMENT(base, stride, i) ((const float *)((const char *)(base) + (size_t)(stride) * (i)))
+
+#ifdef __SSE__
+SSE_INLINE void load_columns(const MATRIX matrix, __m128 *c0, __m128 *c1, __m128 *c2, __m128 *c3) {
+  *c0 = _mm_loadu_ps(matrix);
+  *c1 = _mm_loadu_ps(matrix + 4);
+  *c2 = _mm_loadu_ps(matrix + 8);
+  *c3 = _mm_loadu_ps(matrix + 12);
+  _MM_TRANSPOSE4_PS(*c0, *c1, *c2, *c3);
+}
+
+// Returns the x and y lanes of `xy` followed by lanes 0 and 2 of `zw`.
+SSE_INLINE __m128 replace_zw(__m128 xy, __m128 zw) { return _mm_shuffle_ps(xy, zw, _MM_SHUFFLE(2, 0, 1, 0)); }
+
+// Matches vector_euclidean in the x, y and z lanes.
+SSE_INLINE __m128 sse_euclidean(__m128 value, __m128 infinity) {
+  const __m128 w = SPLAT(value, 3);
+  const __m128 w_is_zero = _mm_cmpeq_ps(w, _mm_setzero_ps());
+  return _mm_or_ps(_mm_andnot_ps(w_is_zero, _mm_div_ps(value, w)), _mm_and_ps(w_is_zero, infinity));
+}
+#endif  // __SSE__
+
+void vector_apply_array(float *output, unsigned int output_stride, const float *input, unsigned int input_stride,
+                        unsigned int count, const MATRIX matrix) {
+#ifdef __SSE__
+  __m128 c0, c1, c2, c3;
+  load_columns(matrix, &c0, &c1, &c2, &c3);
+  for (unsigned int i = 0; i < count; ++i) {
+    const __m128 v = _mm_loadu_ps(CONST_ARRAY_ELEMENT(input, input_stride, i));
+    _mm_storeu_ps(ARRAY_ELEMENT(output, output_stride, i), combine_rows(v, c0, c1, c2, c3));
+  }
+#else
+  for (unsigned int i = 0; i < count; ++i) {
+    VECTOR result;
+    vector_apply(result, CONST_ARRAY_ELEMENT(input, input_stride, i), matrix);
+    vector_copy(ARRAY_ELEMENT(output, output_stride, i), result);
+  }
+#endif
+}
+
+void vector_project_array(float *output, unsigned int output_stride, const float *input, unsigned int input_stride,
+                          unsigned int count, const MATRIX matrix) {
+#ifdef __SSE__
+  __m128 c0, c1, c2, c3;
+  load_columns(matrix, &c0, &c1, &c2, &c3);
+  const __m128 unit_w = _mm_set1_ps(1.0f);
+  for (unsigned int i = 0; i < count; ++i) {
+    const __m128 v = combine_rows(_mm_loadu_ps(CONST_ARRAY_ELEMENT(input, input_stride, i)), c0, c1, c2, c3);
+    const __m128 projected = _mm_div_ps(v, SPLAT(v, 3));
+    const __m128 zw = _mm_shuffle_ps(projected, unit_w, _MM_SHUFFLE(0, 0, 2, 2));
+    _mm_storeu_ps(ARRAY_ELEMENT(output, output_stride, i), replace_zw(projected, zw));
+  }
+#else
+  for (unsigned int i = 0; i < count; ++i) {
+    VECTOR result;
+    vector_apply(result, CONST_ARRAY_ELEMENT(input, input_stride, i), matrix);
+    float *out = ARRAY_ELEMENT(output, output_stride, i);
+    out[_X] = result[_X] / result[_W];
+    out[_Y] = result[_Y] / result[_W];
+    out[_Z] = result[_Z] / result[_W];
+    out[_W] = 1.0f;
+  }
+#endif
+}
+
+void vector_unproject_array(float *output, unsigned int output_stride, const float *input, unsigned int input_stride,
+                            unsigned int count, const MATRIX inverse, float near_z, float far_z, float world_z) {
+#ifdef __SSE__
+  __m128 c0, c1, c2, c3;
+  load_columns(inverse, &c0, &c1, &c2, &c3);
+  const __m128 near_z_vec = _mm_set1_ps(near_z);
+  const __m128 far_z_vec = _mm_set1_ps(far_z);
+  const __m128 world_z_vec = _mm_set1_ps(world_z);
+  const __m128 result_zw = _mm_set_ps(1.0f, 1.0f, world_z, world_z);
+  const __m128 infinity = _mm_set1_ps(INFINITY);
+  for (unsigned int i = 0; i < count; ++i) {
+    const __m128 v = _mm_loadu_ps(CONST_ARRAY_ELEMENT(input, input_stride, i));
+    const __m128 near_in = replace_zw(v, _mm_shuffle_ps(near_z_vec, v, _MM_SHUFFLE(3, 3, 0, 0)));
+    const __m128 far_in = replace_zw(v, _mm_shuffle_ps(far_z_vec, v, _MM_SHUFFLE(3, 3, 0, 0)));
+    const __m128 near_plane = sse_euclidean(combine_rows(near_in, c0, c1, c2, c3), infinity);
+    const __m128 far_plane = sse_euclidean(combine_rows(far_in, c0, c1, c2, c3), infinity);
+
+    const __m128 delta = _mm_sub_ps(far_plane, near_plane);
+    const __m128 t = _mm_div_ps(_mm_sub_ps(world_z_vec, SPLAT(near_plane, 2)), SPLAT(delta, 2));
+    const __m128 result = _mm_add_ps(near_plane, _mm_mul_ps(delta, t));
+    _mm_storeu_ps(ARRAY_ELEMENT(output, output_stride, i), replace_zw(result, result_zw));
+  }
+#else
+  for (unsigned int i = 0; i < count; ++i) {
+    VECTOR work;
+    vector_copy(work, CONST_ARRAY_ELEMENT(input, input_stride, i));
+
+    work[_Z] = near_z;
+    VECTOR near_plane;
+    vector_apply(near_plane, work, inverse);
+    vector_euclidean(near_plane, near_plane);
+
+    work[_Z] = far_z;
+    VECTOR far_plane;
+    vector_apply(far_plane, work, inverse);
+    vector_euclidean(far_plane, far_plane);
+
+    float t = (world_z - near_plane[_Z]) / (far_plane[_Z] - near_plane[_Z]);
+    float *out = ARRAY_ELEMENT(output, output_stride, i);
+    out[_X] = near_plane[_X] + (far_plane[_X] - near_plane[_X]) * t;
+    out[_Y] = near_plane[_Y] + (far_plane[_Y] - near_plane[_Y]) * t;
+    out[_Z] = world_z;
+    out[_W] = 1.0f;
+  }
+#endif
+}
+
+void vector_round_xy_array(float *points, unsigned int stride, unsigned int count, float threshold) {
+#ifdef __SSE__
+  // Adding and subtracting 2^23 (with the sign of the value) rounds values smaller than 2^23 in magnitude to an
+  // integer, which is then corrected to the floor. Larger values are already integral.
+  const __m128 magic = _mm_set1_ps(8388608.0f);
+  const __m128 sign = sign_mask(1, 1, 1, 1);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 threshold_vec = _mm_set1_ps(threshold);
+  for (unsigned int i = 0; i < count; ++i) {
+    float *point = ARRAY_ELEMENT(points, stride, i);
+    const __m128 v = _mm_loadu_ps(point);
+    const __m128 signed_magic = _mm_or_ps(magic, _mm_and_ps(v, sign));
+    const __m128 rounded = _mm_sub_ps(_mm_add_ps(v, signed_magic), signed_magic);
+    // The sign is restored so that -0 stays -0, as with floorf.
+    const __m128 floored =
+        _mm_or_ps(_mm_sub_ps(rounded, _mm_and_ps(_mm_cmpgt_ps(rounded, v), one)), _mm_and_ps(v, sign));
+    const __m128 is_small = _mm_cmplt_ps(_mm_andnot_ps(sign, v), magic);
+    const __m128 whole = _mm_or_ps(_mm_and_ps(is_small, floored), _mm_andnot_ps(is_small, v));
+    const __m128 fraction = _mm_sub_ps(v, whole);
+    const __m128 round_up = _mm_cmpge_ps(fraction, threshold_vec);
+    const __m128 result = _mm_or_ps(_mm_andnot_ps(round_up, whole), _mm_and_ps(round_up, _mm_add_ps(whole, one)));
+    _mm_storeu_ps(point, _mm_shuffle_ps(result, v, _MM_SHUFFLE(3, 2, 1, 0)));
+  }
+#else
+  for (unsigned int i = 0; i < count; ++i) {
+    float *point = ARRAY_ELEMENT(points, stride, i);
+    for (int axis = _X; axis <= _Y; ++axis) {
+      const float whole = floorf(point[axis]);
+      point[axis] = point[axis] - whole >= threshold ? whole + 1.0f : whole;
+    }
+  }
+#endif
+}
+
 // matrices function
 
 void matrix_copy(MATRIX output, const MATRIX input0) { memcpy(output, input0, sizeof(MATRIX)); }
@@ -178,6 +486,9 @@ void matrix_inverse(MATRIX output, const MATRIX input0) {
 }
 
 void matrix_multiply(MATRIX output, const MATRIX input0, const MATRIX input1) {
+#ifdef __SSE__
+  sse_matrix_multiply(output, input0, input1, 0);
+#else
   MATRIX work;
 
   work[_11] =
@@ -215,6 +526,15 @@ void matrix_multiply(MATRIX output, const MATRIX input0, const MATRIX input1) {
 
   // Output the result.
   matrix_copy(output, work);
+#endif
+}
+
+void matrix_multiply_aligned(MATRIX output, const MATRIX input0, const MATRIX input1) {
+#ifdef __SSE__
+  sse_matrix_multiply(output, input0, input1, 1);
+#else
+  matrix_multiply(output, input0, input1);
+#endif
 }
 
 void matrix_rotate(MATRIX output, const MATRIX input0, const VECTOR input1) {
@@ -268,6 +588,9 @@ void matrix_translate(MATRIX output, const MATRIX input0, const VECTOR input1) {
 }
 
 void matrix_transpose(MATRIX output, const MATRIX input0) {
+#ifdef __SSE__
+  sse_matrix_transpose(output, input0, 0);
+#else
   MATRIX work;
 
   // Transpose the matrix.
@@ -290,6 +613,15 @@ void matrix_transpose(MATRIX output, const MATRIX input0) {
 
   // Output the result.
   matrix_copy(output, work);
+#endif
+}
+
+void matrix_transpose_aligned(MATRIX output, const MATRIX input0) {
+#ifdef __SSE__
+  sse_matrix_transpose(output, input0, 1);
+#else
+  matrix_transpose(output, input0);
+#endif
 }
 
 void matrix_unit(MATRIX output) {
@@ -466,7 +798,8 @@ void create_d3d_standard_viewport_16(MATRIX ret, float width, float height) {
 
 void create_d3d_standard_viewport_16_float(MATRIX ret, float width, float height) {
   unsigned int max_value_int = 0x43FFF800;
-  float max_value = *(float*)&max_value_int;
+  float max_value;
+  memcpy(&max_value, &max_value_int, sizeof(max_value));
   create_d3d_viewport(ret, width, height, (float)max_value, 0.0f, 1.0f);
 }
 
@@ -476,7 +809,8 @@ void create_d3d_standard_viewport_24(MATRIX ret, float width, float height) {
 
 void create_d3d_standard_viewport_24_float(MATRIX ret, float width, float height) {
   unsigned int max_value_int = 0x7149F2CA;
-  float max_value = *(float*)&max_value_int;
+  float max_value;
+  memcpy(&max_value, &max_value_int, sizeof(max_value));
   create_d3d_viewport(ret, width, height, max_value, 0.0f, 1.0f);
 }
 
@@ -492,6 +826,9 @@ float matrix_determinant(const MATRIX m) {
 }
 
 void matrix_adjoint(MATRIX output, const MATRIX m) {
+#ifdef __SSE__
+  sse_matrix_adjoint(output, m, 0);
+#else
   output[_11] = -(m[_24] * m[_33] * m[_42]) + m[_23] * m[_34] * m[_42] + m[_24] * m[_32] * m[_43] -
                 m[_22] * m[_34] * m[_43] - m[_23] * m[_32] * m[_44] + m[_22] * m[_33] * m[_44];
   output[_12] = m[_14] * m[_33] * m[_42] - m[_13] * m[_34] * m[_42] - m[_14] * m[_32] * m[_43] +
@@ -527,12 +864,17 @@ void matrix_adjoint(MATRIX output, const MATRIX m) {
                 m[_11] * m[_23] * m[_42] + m[_12] * m[_21] * m[_43] - m[_11] * m[_22] * m[_43];
   output[_44] = -(m[_13] * m[_22] * m[_31]) + m[_12] * m[_23] * m[_31] + m[_13] * m[_21] * m[_32] -
                 m[_11] * m[_23] * m[_32] - m[_12] * m[_21] * m[_33] + m[_11] * m[_22] * m[_33];
+#endif
 }
 
 void matrix_scalar_multiply(MATRIX output, const MATRIX input, float m) {
+#ifdef __SSE__
+  sse_matrix_scalar_multiply(output, input, m, 0);
+#else
   for (int i = 0; i < 16; ++i) {
     output[i] = input[i] * m;
   }
+#endif
 }
 
 int matrix_general_inverse(MATRIX output, const MATRIX input) {
@@ -545,3 +887,11 @@ int matrix_general_inverse(MATRIX output, const MATRIX input) {
   matrix_scalar_multiply(output, output, 1.0f / det);
   return 1;
 }
+
+int matrix_general_inverse_aligned(MATRIX output, const MATRIX input) {
+#ifdef __SSE__
+  return sse_matrix_general_inverse(output, input, 1);
+#else
+  return matrix_general_inverse(output, input);
+#endif
+}
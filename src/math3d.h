@@ -10,6 +10,10 @@ extern "C" {
 typedef float VECTOR[4];
 typedef float MATRIX[16];
 
+// 16 byte aligned storage for use with the *_aligned functions, which require every argument to be 16 byte aligned.
+typedef float ALIGNED_VECTOR[4] __attribute__((aligned(16)));
+typedef float ALIGNED_MATRIX[16] __attribute__((aligned(16)));
+
 // vector indices
 #define _X 0
 #define _Y 1
@@ -39,6 +43,7 @@ typedef float MATRIX[16];
 
 // Multiply a vector by a matrix, returning a vector.
 void vector_apply(VECTOR output, const VECTOR input0, const MATRIX input1);
+void vector_apply_aligned(VECTOR output, const VECTOR input0, const MATRIX input1);
 
 // Clamp a vector's values by cutting them off at a minimum and maximum value.
 void vector_clamp(VECTOR output, const VECTOR input0, float min, float max);
@@ -72,6 +77,35 @@ void vector_crossproduct(VECTOR output, const VECTOR input0, const VECTOR input1
 // Divide by w to convert to a 3-dimensional vector.
 void vector_euclidean(VECTOR output, const VECTOR input);
 
+// vector array functions
+//
+// These operate on `count` 4-component vectors whose starting addresses are `stride` bytes apart, so they may be used
+// directly on the positions of interleaved vertices. The matrix is only read once. The output may alias the input if
+// the strides are equal. Results are identical to applying the single vector functions to each element.
+
+// Multiply each vector by a matrix (see vector_apply).
+void vector_apply_array(float *output, unsigned int output_stride, const float *input, unsigned int input_stride,
+                        unsigned int count, const MATRIX matrix);
+
+// Multiply each vector by a matrix and divide x, y and z by the resulting w, setting w to 1.
+void vector_project_array(float *output, unsigned int output_stride, const float *input, unsigned int input_stride,
+                          unsigned int count, const MATRIX matrix);
+
+// Unproject each screen space vector onto the plane z = world_z. The vector is unprojected through `inverse` with its z
+// replaced by near_z and by far_z, and the ray between the two results is intersected with the plane.
+void vector_unproject_array(float *output, unsigned int output_stride, const float *input, unsigned int input_stride,
+                            unsigned int count, const MATRIX inverse, float near_z, float far_z, float world_z);
+
+#ifdef __cplusplus
+// The screen depths between which TestHost and ProjectionVertexShader cast rays when unprojecting onto a world z.
+// TODO: Get the near and far plane mappings from the viewport matrix.
+static constexpr float kUnprojectNearZ = 0.0f;
+static constexpr float kUnprojectFarZ = 64000.0f;
+#endif
+
+// Round the x and y components of each vector down, or up if their fractional part is at least `threshold`.
+void vector_round_xy_array(float *points, unsigned int stride, unsigned int count, float threshold);
+
 // matrices functions
 
 // Copy a matrix.
@@ -84,9 +118,11 @@ void matrix_inverse(MATRIX output, const MATRIX input0);
 // Calculate the inverse of a generic matrix.
 // Return 0 if the matrix is not invertible.
 int matrix_general_inverse(MATRIX output, const MATRIX input);
+int matrix_general_inverse_aligned(MATRIX output, const MATRIX input);
 
 // Multiply two matrices together.
 void matrix_multiply(MATRIX output, const MATRIX input0, const MATRIX input1);
+void matrix_multiply_aligned(MATRIX output, const MATRIX input0, const MATRIX input1);
 
 // Create a rotation matrix and apply it to the specified input matrix.
 void matrix_rotate(MATRIX output, const MATRIX input0, const VECTOR input1);
@@ -99,6 +135,7 @@ void matrix_translate(MATRIX output, const MATRIX input0, const VECTOR input1);
 
 // Transpose a matrix.
 void matrix_transpose(MATRIX output, const MATRIX input0);
+void matrix_transpose_aligned(MATRIX output, const MATRIX input0);
 
 // Create a unit matrix.
 void matrix_unit(MATRIX output);
@@ -0,0 +1,304 @@
+#include "mesh_generator.h"
+
+// clang-format off
+#define _USE_MATH_DEFINES
+#include <cmath>
+// clang-format on
+
+#include <cstring>
+
+// All meshes are built from a (rows + 1) x (columns + 1) lattice of vertices. The first and last columns share a
+// position on closed surfaces but have distinct texture coordinates.
+//
+// Trigonometry is hoisted out of the per-vertex loops into per-column/per-row tables, and each vertex is assembled in
+// a local staging copy that is then written out in a single sequential store. VertexBuffer memory is write-combined,
+// so writing complete vertices in order (rather than field by field) is significantly faster for large meshes.
+
+static inline uint32_t LatticeVertexCount(uint32_t columns, uint32_t rows) { return (columns + 1) * (rows + 1); }
+
+static inline void Lerp(float* out, const Color& a, const Color& b, float t) {
+  out[0] = a.r + (b.r - a.r) * t;
+  out[1] = a.g + (b.g - a.g) * t;
+  out[2] = a.b + (b.b - a.b) * t;
+  out[3] = a.a + (b.a - a.a) * t;
+}
+
+// Generates the lattice vertices, calling `evaluate(row, column, vertex)` to populate the position and normal of each.
+template <typename Evaluator>
+static void GenerateLattice(Vertex* vertices, uint32_t columns, uint32_t rows, const MeshStyle& style,
+                            Evaluator&& evaluate) {
+  std::vector<float> u_values(columns + 1);
+  const float column_step = 1.0f / static_cast<float>(columns);
+  for (uint32_t column = 0; column <= columns; ++column) {
+    u_values[column] = static_cast<float>(column) * column_step;
+  }
+
+  Vertex staging;
+  memset(&staging, 0, sizeof(staging));
+  staging.pos[3] = 1.0f;
+  staging.texcoord0[3] = 1.0f;
+
+  const float row_step = 1.0f / static_cast<float>(rows);
+  for (uint32_t row = 0; row <= rows; ++row) {
+    const float v = static_cast<float>(row) * row_step;
+    staging.texcoord0[1] = v;
+    Lerp(staging.diffuse, style.diffuse_start, style.diffuse_end, v);
+
+    for (uint32_t column = 0; column <= columns; ++column) {
+      staging.texcoord0[0] = u_values[column];
+      evaluate(row, column, staging);
+      *vertices++ = staging;
+    }
+  }
+}
+
+// Appends indices for the quads of a lattice. Quad (a, b, c, d) is made up of vertices (row, column),
+// (row, column + 1), (row + 1, column), and (row + 1, column + 1), emitted as triangles (a, b, c) and (b, d, c).
+// The first and last rows may omit the triangle that would be degenerate at a pole.
+static void GenerateLatticeIndices(std::vector<uint32_t>& indices, uint32_t columns, uint32_t rows,
+                                   uint32_t first_vertex, bool skip_first_row_upper = false,
+                                   bool skip_last_row_lower = false) {
+  const uint32_t stride = columns + 1;
+  indices.reserve(indices.size() + columns * rows * 6);
+
+  for (uint32_t row = 0; row < rows; ++row) {
+    const bool emit_upper = !(skip_first_row_upper && row == 0);
+    const bool emit_lower = !(skip_last_row_lower && row == rows - 1);
+    const uint32_t row_start = first_vertex + row * stride;
+
+    for (uint32_t column = 0; column < columns; ++column) {
+      const uint32_t a = row_start + column;
+      const uint32_t b = a + 1;
+      const uint32_t c = a + stride;
+      const uint32_t d = c + 1;
+
+      if (emit_upper) {
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+      }
+      if (emit_lower) {
+        indices.push_back(b);
+        indices.push_back(d);
+        indices.push_back(c);
+      }
+    }
+  }
+}
+
+// Fills `cos_values` and `sin_values` with `divisions` + 1 samples covering [0, 2 * PI].
+static void BuildCircleTable(std::vector<float>& cos_values, std::vector<float>& sin_values, uint32_t divisions) {
+  cos_values.resize(divisions + 1);
+  sin_values.resize(divisions + 1);
+
+  const double step = (2.0 * M_PI) / static_cast<double>(divisions);
+  for (uint32_t i = 0; i < divisions; ++i) {
+    const double angle = step * static_cast<double>(i);
+    cos_values[i] = static_cast<float>(cos(angle));
+    sin_values[i] = static_cast<float>(sin(angle));
+  }
+
+  // Close the loop exactly so that the seam vertices share a position.
+  cos_values[divisions] = cos_values[0];
+  sin_values[divisions] = sin_values[0];
+}
+
+MeshSize GetGridMeshSize(uint32_t columns, uint32_t rows) {
+  return {LatticeVertexCount(columns, rows), columns * rows * 6};
+}
+
+void GenerateGridMesh(Vertex* vertices, std::vector<uint32_t>& indices, float left, float top, float right,
+                      float bottom, float z, uint32_t columns, uint32_t rows, const MeshStyle& style,
+                      uint32_t first_vertex) {
+  const float x_step = (right - left) / static_cast<float>(columns);
+  const float y_step = (bottom - top) / static_cast<float>(rows);
+
+  GenerateLattice(vertices, columns, rows, style, [=](uint32_t row, uint32_t column, Vertex& vertex) {
+    vertex.pos[0] = left + x_step * static_cast<float>(column);
+    vertex.pos[1] = top + y_step * static_cast<float>(row);
+    vertex.pos[2] = z;
+
+    vertex.normal[0] = 0.0f;
+    vertex.normal[1] = 0.0f;
+    vertex.normal[2] = -1.0f;
+  });
+
+  GenerateLatticeIndices(indices, columns, rows, first_vertex);
+}
+
+void GenerateFloorMesh(Vertex* vertices, std::vector<uint32_t>& indices, float left, float right, float near_z,
+                       float far_z, float y, uint32_t columns, uint32_t rows, const MeshStyle& style,
+                       uint32_t first_vertex) {
+  const float x_step = (right - left) / static_cast<float>(columns);
+  // Rows proceed from the far edge toward the viewer to maintain outward facing winding.
+  const float z_step = (near_z - far_z) / static_cast<float>(rows);
+
+  GenerateLattice(vertices, columns, rows, style, [=](uint32_t row, uint32_t column, Vertex& vertex) {
+    vertex.pos[0] = left + x_step * static_cast<float>(column);
+    vertex.pos[1] = y;
+    vertex.pos[2] = far_z + z_step * static_cast<float>(row);
+
+    vertex.normal[0] = 0.0f;
+    vertex.normal[1] = 1.0f;
+    vertex.normal[2] = 0.0f;
+  });
+
+  GenerateLatticeIndices(indices, columns, rows, first_vertex);
+}
+
+MeshSize GetSphereMeshSize(uint32_t segments, uint32_t rings) {
+  return {LatticeVertexCount(segments, rings), segments * (rings - 1) * 6};
+}
+
+void GenerateSphereMesh(Vertex* vertices, std::vector<uint32_t>& indices, const float* center, float radius,
+                        uint32_t segments, uint32_t rings, const MeshStyle& style, uint32_t first_vertex) {
+  std::vector<float> cos_phi;
+  std::vector<float> sin_phi;
+  BuildCircleTable(cos_phi, sin_phi, segments);
+
+  // Theta covers [0, PI], from the +Y pole to the -Y pole.
+  std::vector<float> cos_theta(rings + 1);
+  std::vector<float> sin_theta(rings + 1);
+  const double theta_step = M_PI / static_cast<double>(rings);
+  for (uint32_t i = 0; i <= rings; ++i) {
+    const double theta = theta_step * static_cast<double>(i);
+    cos_theta[i] = static_cast<float>(cos(theta));
+    sin_theta[i] = static_cast<float>(sin(theta));
+  }
+  sin_theta[0] = sin_theta[rings] = 0.0f;
+
+  const float cx = center[0];
+  const float cy = center[1];
+  const float cz = center[2];
+  GenerateLattice(vertices, segments, rings, style, [&](uint32_t row, uint32_t column, Vertex& vertex) {
+    const float nx = sin_theta[row] * cos_phi[column];
+    const float ny = cos_theta[row];
+    const float nz = sin_theta[row] * sin_phi[column];
+
+    vertex.pos[0] = cx + nx * radius;
+    vertex.pos[1] = cy + ny * radius;
+    vertex.pos[2] = cz + nz * radius;
+
+    vertex.normal[0] = nx;
+    vertex.normal[1] = ny;
+    vertex.normal[2] = nz;
+  });
+
+  // The triangles touching the poles would be degenerate, so only the one with a non-zero area is emitted.
+  GenerateLatticeIndices(indices, segments, rings, first_vertex, true, true);
+}
+
+MeshSize GetCylinderMeshSize(uint32_t segments, uint32_t stacks) {
+  const uint32_t cap_vertices = 1 + segments + 1;
+  return {LatticeVertexCount(segments, stacks) + cap_vertices * 2, segments * stacks * 6 + segments * 3 * 2};
+}
+
+void GenerateCylinderMesh(Vertex* vertices, std::vector<uint32_t>& indices, const float* center, float radius,
+                          float height, uint32_t segments, uint32_t stacks, const MeshStyle& style,
+                          uint32_t first_vertex) {
+  std::vector<float> cos_phi;
+  std::vector<float> sin_phi;
+  BuildCircleTable(cos_phi, sin_phi, segments);
+
+  const float cx = center[0];
+  const float cz = center[2];
+  const float top = center[1] + height * 0.5f;
+  const float y_step = -height / static_cast<float>(stacks);
+
+  GenerateLattice(vertices, segments, stacks, style, [&](uint32_t row, uint32_t column, Vertex& vertex) {
+    vertex.pos[0] = cx + cos_phi[column] * radius;
+    vertex.pos[1] = top + y_step * static_cast<float>(row);
+    vertex.pos[2] = cz + sin_phi[column] * radius;
+
+    vertex.normal[0] = cos_phi[column];
+    vertex.normal[1] = 0.0f;
+    vertex.normal[2] = sin_phi[column];
+  });
+  GenerateLatticeIndices(indices, segments, stacks, first_vertex);
+
+  // Caps are a center vertex followed by a ring of vertices with a normal along the axis.
+  Vertex* cap = vertices + LatticeVertexCount(segments, stacks);
+  uint32_t cap_start = first_vertex + LatticeVertexCount(segments, stacks);
+
+  auto generate_cap = [&](float y, float normal_y, const Color& color) {
+    Vertex staging;
+    memset(&staging, 0, sizeof(staging));
+    staging.pos[1] = y;
+    staging.pos[3] = 1.0f;
+    staging.normal[1] = normal_y;
+    staging.diffuse[0] = color.r;
+    staging.diffuse[1] = color.g;
+    staging.diffuse[2] = color.b;
+    staging.diffuse[3] = color.a;
+    staging.texcoord0[3] = 1.0f;
+
+    staging.pos[0] = cx;
+    staging.pos[2] = cz;
+    staging.texcoord0[0] = 0.5f;
+    staging.texcoord0[1] = 0.5f;
+    *cap++ = staging;
+
+    for (uint32_t i = 0; i <= segments; ++i) {
+      staging.pos[0] = cx + cos_phi[i] * radius;
+      staging.pos[2] = cz + sin_phi[i] * radius;
+      staging.texcoord0[0] = 0.5f + cos_phi[i] * 0.5f;
+      staging.texcoord0[1] = 0.5f + sin_phi[i] * 0.5f;
+      *cap++ = staging;
+    }
+
+    const uint32_t center_index = cap_start;
+    const uint32_t ring_start = cap_start + 1;
+    for (uint32_t i = 0; i < segments; ++i) {
+      indices.push_back(center_index);
+      if (normal_y > 0.0f) {
+        indices.push_back(ring_start + i + 1);
+        indices.push_back(ring_start + i);
+      } else {
+        indices.push_back(ring_start + i);
+        indices.push_back(ring_start + i + 1);
+      }
+    }
+
+    cap_start += segments + 2;
+  };
+
+  generate_cap(top, 1.0f, style.diffuse_start);
+  generate_cap(center[1] - height * 0.5f, -1.0f, style.diffuse_end);
+}
+
+MeshSize GetTorusMeshSize(uint32_t segments, uint32_t sides) {
+  return {LatticeVertexCount(segments, sides), segments * sides * 6};
+}
+
+void GenerateTorusMesh(Vertex* vertices, std::vector<uint32_t>& indices, const float* center, float major_radius,
+                       float minor_radius, uint32_t segments, uint32_t sides, const MeshStyle& style,
+                       uint32_t first_vertex) {
+  std::vector<float> cos_phi;
+  std::vector<float> sin_phi;
+  BuildCircleTable(cos_phi, sin_phi, segments);
+
+  std::vector<float> cos_theta;
+  std::vector<float> sin_theta;
+  BuildCircleTable(cos_theta, sin_theta, sides);
+
+  const float cx = center[0];
+  const float cy = center[1];
+  const float cz = center[2];
+  GenerateLattice(vertices, segments, sides, style, [&](uint32_t row, uint32_t column, Vertex& vertex) {
+    // The tube is traversed from the outer equator over the bottom of the ring so that rows advance in the same
+    // direction relative to the outward normal as the other lattice based meshes.
+    const float tube_cos = cos_theta[row];
+    const float tube_sin = -sin_theta[row];
+    const float ring_radius = major_radius + minor_radius * tube_cos;
+
+    vertex.pos[0] = cx + ring_radius * cos_phi[column];
+    vertex.pos[1] = cy + minor_radius * tube_sin;
+    vertex.pos[2] = cz + ring_radius * sin_phi[column];
+
+    vertex.normal[0] = tube_cos * cos_phi[column];
+    vertex.normal[1] = tube_sin;
+    vertex.normal[2] = tube_cos * sin_phi[column];
+  });
+
+  GenerateLatticeIndices(indices, segments, sides, first_vertex);
+}
@@ -0,0 +1,60 @@
+#ifndef NXDK_PGRAPH_TESTS_MESH_GENERATOR_H
+#define NXDK_PGRAPH_TESTS_MESH_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "vertex_buffer.h"
+
+// Procedural generation of tessellated meshes.
+//
+// Generators fill a caller provided vertex array (typically from VertexBuffer::Lock) with position, normal, diffuse,
+// and texcoord0 and append an index list to be drawn as PRIMITIVE_TRIANGLES. All other vertex attributes are zeroed.
+//
+// Triangles are wound such that cross(b - a, c - a) points along the outward facing normal (i.e., clockwise when
+// viewed from outside with the default left-handed XDK camera). Indices are offset by `first_vertex` so that multiple
+// meshes may share a single VertexBuffer.
+
+// The number of vertices and indices needed by a particular mesh.
+struct MeshSize {
+  uint32_t num_vertices{0};
+  uint32_t num_indices{0};
+};
+
+// Attributes shared by all generated meshes.
+struct MeshStyle {
+  // Diffuse color is interpolated from `diffuse_start` at texcoord v == 0 to `diffuse_end` at v == 1.
+  Color diffuse_start{1.0f, 1.0f, 1.0f, 1.0f};
+  Color diffuse_end{1.0f, 1.0f, 1.0f, 1.0f};
+};
+
+// Flat grid of `columns` x `rows` quads in the plane z = `z`, facing -Z (toward the default camera).
+MeshSize GetGridMeshSize(uint32_t columns, uint32_t rows);
+void GenerateGridMesh(Vertex* vertices, std::vector<uint32_t>& indices, float left, float top, float right,
+                      float bottom, float z, uint32_t columns, uint32_t rows, const MeshStyle& style = {},
+                      uint32_t first_vertex = 0);
+
+// Flat grid of `columns` x `rows` quads in the plane y = `y`, facing +Y, extending from z = `near_z` to `far_z`.
+// Useful for depth dependent effects such as fog.
+void GenerateFloorMesh(Vertex* vertices, std::vector<uint32_t>& indices, float left, float right, float near_z,
+                       float far_z, float y, uint32_t columns, uint32_t rows, const MeshStyle& style = {},
+                       uint32_t first_vertex = 0);
+
+// UV sphere with `segments` divisions around the Y axis and `rings` divisions from the +Y pole to the -Y pole.
+MeshSize GetSphereMeshSize(uint32_t segments, uint32_t rings);
+void GenerateSphereMesh(Vertex* vertices, std::vector<uint32_t>& indices, const float* center, float radius,
+                        uint32_t segments, uint32_t rings, const MeshStyle& style = {}, uint32_t first_vertex = 0);
+
+// Capped cylinder aligned with the Y axis with `segments` divisions around the axis and `stacks` divisions along it.
+MeshSize GetCylinderMeshSize(uint32_t segments, uint32_t stacks);
+void GenerateCylinderMesh(Vertex* vertices, std::vector<uint32_t>& indices, const float* center, float radius,
+                          float height, uint32_t segments, uint32_t stacks, const MeshStyle& style = {},
+                          uint32_t first_vertex = 0);
+
+// Torus around the Y axis with `segments` divisions around the main ring and `sides` divisions around the tube.
+MeshSize GetTorusMeshSize(uint32_t segments, uint32_t sides);
+void GenerateTorusMesh(Vertex* vertices, std::vector<uint32_t>& indices, const float* center, float major_radius,
+                       float minor_radius, uint32_t segments, uint32_t sides, const MeshStyle& style = {},
+                       uint32_t first_vertex = 0);
+
+#endif  // NXDK_PGRAPH_TESTS_MESH_GENERATOR_H
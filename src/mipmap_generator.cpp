@@ -0,0 +1,291 @@
+#include "mipmap_generator.h"
+
+// clang-format off
+#define _USE_MATH_DEFINES
+#include <cmath>
+// clang-format on
+
+#include <algorithm>
+#include <vector>
+
+// Filtering that needs more than 8 bits of precision (gamma correction and the Kaiser filter) is performed on 12-bit
+// fixed-point "working" values, converted to and from the 8-bit components via lookup tables.
+static constexpr uint32_t kWorkingMax = 4095;
+
+// Kaiser filter parameters. The kernel covers 3 destination texels on each side of the sample point, which is 12 source
+// texels for a 2:1 reduction. Weights are fixed point with kKaiserWeightBits fractional bits.
+static constexpr uint32_t kKaiserTaps = 12;
+static constexpr float kKaiserWidth = 3.0f;
+static constexpr float kKaiserAlpha = 4.0f;
+static constexpr uint32_t kKaiserWeightBits = 12;
+// Fractional bits retained between the vertical and horizontal passes.
+static constexpr uint32_t kKaiserIntermediateBits = 4;
+
+struct ComponentTables {
+  uint16_t to_working[256];
+  uint8_t from_working[kWorkingMax + 1];
+};
+
+static const ComponentTables &GetLinearTables() {
+  static const ComponentTables tables = []() {
+    ComponentTables ret{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      ret.to_working[i] = static_cast<uint16_t>((i * kWorkingMax + 127) / 255);
+    }
+    for (uint32_t i = 0; i <= kWorkingMax; ++i) {
+      ret.from_working[i] = static_cast<uint8_t>((i * 255 + kWorkingMax / 2) / kWorkingMax);
+    }
+    return ret;
+  }();
+  return tables;
+}
+
+static const ComponentTables &GetGammaTables() {
+  static const ComponentTables tables = []() {
+    ComponentTables ret{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      float value = static_cast<float>(i) / 255.0f;
+      value = value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+      ret.to_working[i] = static_cast<uint16_t>(lrintf(value * static_cast<float>(kWorkingMax)));
+    }
+    for (uint32_t i = 0; i <= kWorkingMax; ++i) {
+      float value = static_cast<float>(i) / static_cast<float>(kWorkingMax);
+      value = value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+      ret.from_working[i] = static_cast<uint8_t>(lrintf(value * 255.0f));
+    }
+    return ret;
+  }();
+  return tables;
+}
+
+// Returns the tables to be used for each of the 4 components, in order of increasing shift.
+static void GetComponentTables(const ComponentTables **tables, bool gamma_correct, uint32_t alpha_shift) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    tables[i] = (gamma_correct && i * 8 != alpha_shift) ? &GetGammaTables() : &GetLinearTables();
+  }
+}
+
+static float BesselI0(float x) {
+  float sum = 1.0f;
+  float term = 1.0f;
+  const float half_x = x * 0.5f;
+  for (uint32_t k = 1; k < 32 && term > sum * 1e-8f; ++k) {
+    const float factor = half_x / static_cast<float>(k);
+    term *= factor * factor;
+    sum += term;
+  }
+  return sum;
+}
+
+static const int32_t *GetKaiserWeights() {
+  static const struct Weights {
+    int32_t values[kKaiserTaps];
+  } weights = []() {
+    float raw[kKaiserTaps];
+    float total = 0.0f;
+    for (uint32_t i = 0; i < kKaiserTaps; ++i) {
+      // Distance from the sample point, in destination texels.
+      const float x = (static_cast<float>(i) - (kKaiserTaps / 2 - 0.5f)) * 0.5f;
+      const float pi_x = static_cast<float>(M_PI) * x;
+      const float sinc = sinf(pi_x) / pi_x;
+      const float t = x / kKaiserWidth;
+      const float window = BesselI0(kKaiserAlpha * sqrtf(1.0f - t * t)) / BesselI0(kKaiserAlpha);
+      raw[i] = sinc * window;
+      total += raw[i];
+    }
+
+    Weights ret{};
+    int32_t sum = 0;
+    for (uint32_t i = 0; i < kKaiserTaps; ++i) {
+      ret.values[i] = static_cast<int32_t>(lrintf(raw[i] / total * static_cast<float>(1 << kKaiserWeightBits)));
+      sum += ret.values[i];
+    }
+    // Ensure that the weights sum to exactly 1.0 so that flat regions are preserved.
+    ret.values[kKaiserTaps / 2 - 1] += ((1 << kKaiserWeightBits) - sum) / 2;
+    ret.values[kKaiserTaps / 2] += (1 << kKaiserWeightBits) - sum - ((1 << kKaiserWeightBits) - sum) / 2;
+    return ret;
+  }();
+  return weights.values;
+}
+
+static inline uint32_t Clamp(int32_t value, uint32_t max) {
+  if (value < 0) {
+    return 0;
+  }
+  return static_cast<uint32_t>(value) > max ? max : static_cast<uint32_t>(value);
+}
+
+// Rounded average of the four components of 4 pixels, computed two components at a time in 16-bit lanes.
+static inline uint32_t Average4(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+  const uint32_t even = (a & 0x00FF00FF) + (b & 0x00FF00FF) + (c & 0x00FF00FF) + (d & 0x00FF00FF) + 0x00020002;
+  const uint32_t odd = ((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF) + ((c >> 8) & 0x00FF00FF) +
+                       ((d >> 8) & 0x00FF00FF) + 0x00020002;
+  return ((even >> 2) & 0x00FF00FF) | ((odd << 6) & 0xFF00FF00);
+}
+
+static void DownsampleBox(uint32_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch,
+                          uint32_t width, uint32_t height, bool gamma_correct, uint32_t alpha_shift) {
+  const uint32_t dest_width = width > 1 ? width / 2 : 1;
+  const uint32_t dest_height = height > 1 ? height / 2 : 1;
+  const uint32_t x_step = width > 1 ? 1 : 0;
+  auto source_bytes = reinterpret_cast<const uint8_t *>(source);
+  auto dest_bytes = reinterpret_cast<uint8_t *>(dest);
+
+  const ComponentTables *tables[4];
+  GetComponentTables(tables, gamma_correct, alpha_shift);
+
+  for (uint32_t y = 0; y < dest_height; ++y) {
+    auto row0 = reinterpret_cast<const uint32_t *>(source_bytes + y * 2 * source_pitch);
+    auto row1 = height > 1 ? reinterpret_cast<const uint32_t *>(source_bytes + (y * 2 + 1) * source_pitch) : row0;
+    auto out = reinterpret_cast<uint32_t *>(dest_bytes + y * dest_pitch);
+
+    if (!gamma_correct) {
+      for (uint32_t x = 0; x < dest_width; ++x, row0 += 2, row1 += 2) {
+        out[x] = Average4(row0[0], row0[x_step], row1[0], row1[x_step]);
+      }
+      continue;
+    }
+
+    for (uint32_t x = 0; x < dest_width; ++x, row0 += 2, row1 += 2) {
+      uint32_t pixel = 0;
+      for (uint32_t c = 0; c < 4; ++c) {
+        const uint32_t shift = c * 8;
+        const uint16_t *to_working = tables[c]->to_working;
+        const uint32_t sum = to_working[(row0[0] >> shift) & 0xFF] + to_working[(row0[x_step] >> shift) & 0xFF] +
+                             to_working[(row1[0] >> shift) & 0xFF] + to_working[(row1[x_step] >> shift) & 0xFF];
+        pixel |= static_cast<uint32_t>(tables[c]->from_working[(sum + 2) >> 2]) << shift;
+      }
+      out[x] = pixel;
+    }
+  }
+}
+
+static void DownsampleKaiser(uint32_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch,
+                             uint32_t width, uint32_t height, bool gamma_correct, uint32_t alpha_shift) {
+  const uint32_t dest_width = width > 1 ? width / 2 : 1;
+  const uint32_t dest_height = height > 1 ? height / 2 : 1;
+  auto source_bytes = reinterpret_cast<const uint8_t *>(source);
+  auto dest_bytes = reinterpret_cast<uint8_t *>(dest);
+  const int32_t *weights = GetKaiserWeights();
+  static constexpr int32_t kFirstTap = -static_cast<int32_t>(kKaiserTaps / 2 - 1);
+
+  const ComponentTables *tables[4];
+  GetComponentTables(tables, gamma_correct, alpha_shift);
+
+  // Expand the source into working values once, as each texel contributes to several destination texels.
+  std::vector<uint16_t> working(width * height * 4);
+  {
+    uint16_t *out = working.data();
+    for (uint32_t y = 0; y < height; ++y) {
+      auto row = reinterpret_cast<const uint32_t *>(source_bytes + y * source_pitch);
+      for (uint32_t x = 0; x < width; ++x) {
+        for (uint32_t c = 0; c < 4; ++c) {
+          *out++ = tables[c]->to_working[(row[x] >> (c * 8)) & 0xFF];
+        }
+      }
+    }
+  }
+
+  // Vertically filtered source row, with kKaiserIntermediateBits fractional bits.
+  std::vector<int32_t> filtered(width * 4);
+  const uint32_t row_values = width * 4;
+  for (uint32_t y = 0; y < dest_height; ++y) {
+    if (height == 1) {
+      for (uint32_t i = 0; i < row_values; ++i) {
+        filtered[i] = static_cast<int32_t>(working[i]) << kKaiserIntermediateBits;
+      }
+    } else {
+      std::fill(filtered.begin(), filtered.end(), 0);
+      for (uint32_t tap = 0; tap < kKaiserTaps; ++tap) {
+        const uint32_t source_y =
+            Clamp(static_cast<int32_t>(y * 2) + kFirstTap + static_cast<int32_t>(tap), height - 1);
+        const uint16_t *in = working.data() + source_y * row_values;
+        const int32_t weight = weights[tap];
+        for (uint32_t i = 0; i < row_values; ++i) {
+          filtered[i] += weight * in[i];
+        }
+      }
+
+      static constexpr int32_t kShift = kKaiserWeightBits - kKaiserIntermediateBits;
+      for (uint32_t i = 0; i < row_values; ++i) {
+        filtered[i] = (filtered[i] + (1 << (kShift - 1))) >> kShift;
+      }
+    }
+
+    auto out = reinterpret_cast<uint32_t *>(dest_bytes + y * dest_pitch);
+    static constexpr uint32_t kFinalShift = kKaiserWeightBits + kKaiserIntermediateBits;
+    for (uint32_t x = 0; x < dest_width; ++x) {
+      int32_t sums[4];
+      if (width == 1) {
+        for (uint32_t c = 0; c < 4; ++c) {
+          sums[c] = filtered[c] << kKaiserWeightBits;
+        }
+      } else {
+        sums[0] = sums[1] = sums[2] = sums[3] = 0;
+        for (uint32_t tap = 0; tap < kKaiserTaps; ++tap) {
+          const uint32_t source_x =
+              Clamp(static_cast<int32_t>(x * 2) + kFirstTap + static_cast<int32_t>(tap), width - 1);
+          const int32_t *in = filtered.data() + source_x * 4;
+          const int32_t weight = weights[tap];
+          sums[0] += weight * in[0];
+          sums[1] += weight * in[1];
+          sums[2] += weight * in[2];
+          sums[3] += weight * in[3];
+        }
+      }
+
+      uint32_t pixel = 0;
+      for (uint32_t c = 0; c < 4; ++c) {
+        const uint32_t value = Clamp((sums[c] + (1 << (kFinalShift - 1))) >> kFinalShift, kWorkingMax);
+        pixel |= static_cast<uint32_t>(tables[c]->from_working[value]) << (c * 8);
+      }
+      out[x] = pixel;
+    }
+  }
+}
+
+uint32_t GetMipmapLevelCount(uint32_t width, uint32_t height) {
+  uint32_t levels = 1;
+  while (width > 1 || height > 1) {
+    width = width > 1 ? width / 2 : 1;
+    height = height > 1 ? height / 2 : 1;
+    ++levels;
+  }
+  return levels;
+}
+
+uint32_t GetMipmapLevelSize(uint32_t width, uint32_t height, uint32_t level, uint32_t bits_per_pixel,
+                            uint32_t block_size) {
+  width >>= level;
+  height >>= level;
+  if (!width) {
+    width = 1;
+  }
+  if (!height) {
+    height = 1;
+  }
+
+  if (block_size) {
+    return ((width + 3) / 4) * ((height + 3) / 4) * block_size;
+  }
+  return (width * height * bits_per_pixel + 7) / 8;
+}
+
+uint32_t GetMipmapLevelOffset(uint32_t width, uint32_t height, uint32_t level, uint32_t bits_per_pixel,
+                              uint32_t block_size) {
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < level; ++i) {
+    offset += GetMipmapLevelSize(width, height, i, bits_per_pixel, block_size);
+  }
+  return offset;
+}
+
+void DownsampleMipmapLevel(uint32_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch,
+                           uint32_t width, uint32_t height, MipmapFilter filter, bool gamma_correct,
+                           uint32_t alpha_shift) {
+  if (filter == MIPMAP_FILTER_KAISER) {
+    DownsampleKaiser(dest, dest_pitch, source, source_pitch, width, height, gamma_correct, alpha_shift);
+  } else {
+    DownsampleBox(dest, dest_pitch, source, source_pitch, width, height, gamma_correct, alpha_shift);
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef NXDK_PGRAPH_TESTS_MIPMAP_GENERATOR_H
+#define NXDK_PGRAPH_TESTS_MIPMAP_GENERATOR_H
+
+#include <cstdint>
+
+// Generation of mipmap levels from 32bpp images and computation of the NV2A mipmap chain layout.
+//
+// Pixels are 32-bit values with four 8-bit components. All components are filtered identically, except that the
+// component at `alpha_shift` is never gamma corrected (the default describes SDL_PIXELFORMAT_ABGR8888). Pitches are in
+// bytes.
+
+enum MipmapFilter {
+  // Averages each 2x2 block of source texels.
+  MIPMAP_FILTER_BOX,
+  // Kaiser windowed sinc with 12 taps per axis, which retains more detail than the box filter at a higher cost.
+  MIPMAP_FILTER_KAISER,
+};
+
+// Returns the number of levels in a complete mipmap chain for an image of the given dimensions, down to 1x1.
+uint32_t GetMipmapLevelCount(uint32_t width, uint32_t height);
+
+// Returns the number of bytes occupied by `level` of a swizzled or compressed texture whose base level has the given
+// dimensions. `block_size` is the size in bytes of a 4x4 compressed block (0 for uncompressed formats).
+uint32_t GetMipmapLevelSize(uint32_t width, uint32_t height, uint32_t level, uint32_t bits_per_pixel,
+                            uint32_t block_size = 0);
+
+// Returns the offset of `level` from the start of the texture. The NV2A stores levels contiguously, starting with the
+// base level.
+uint32_t GetMipmapLevelOffset(uint32_t width, uint32_t height, uint32_t level, uint32_t bits_per_pixel,
+                              uint32_t block_size = 0);
+
+// Writes the level following the given `width` x `height` image into `dest`, whose dimensions must be
+// max(1, width / 2) x max(1, height / 2). If `gamma_correct` is true, color components are treated as sRGB encoded and
+// filtered in linear space.
+void DownsampleMipmapLevel(uint32_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch,
+                           uint32_t width, uint32_t height, MipmapFilter filter = MIPMAP_FILTER_BOX,
+                           bool gamma_correct = false, uint32_t alpha_shift = 24);
+
+#endif  // NXDK_PGRAPH_TESTS_MIPMAP_GENERATOR_H
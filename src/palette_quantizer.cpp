@@ -0,0 +1,276 @@
+#include "palette_quantizer.h"
+
+#include <algorithm>
+#include <vector>
+
+static constexpr uint32_t kNumChannels = 4;
+static constexpr uint32_t kMaxPaletteSize = 256;
+
+// Nearest color lookups are memoized in a direct mapped table, as test images typically contain far fewer distinct
+// colors than pixels.
+static constexpr uint32_t kCacheSize = 4096;
+
+static inline int Channel(uint32_t color, uint32_t channel) {
+  return static_cast<int>((color >> (channel * 8)) & 0xFF);
+}
+
+namespace {
+
+struct Box {
+  uint32_t begin;
+  uint32_t end;
+  uint32_t widest_channel;
+  int range;
+};
+
+class NearestColorFinder {
+ public:
+  NearestColorFinder(const int (*palette)[kNumChannels], uint32_t palette_size)
+      : palette_(palette), palette_size_(palette_size), cache_color_(kCacheSize), cache_index_(kCacheSize, -1) {}
+
+  uint32_t Find(uint32_t color) {
+    const uint32_t slot = ((color * 0x9E3779B1) >> 20) & (kCacheSize - 1);
+    if (cache_index_[slot] >= 0 && cache_color_[slot] == color) {
+      return cache_index_[slot];
+    }
+
+    const int c0 = Channel(color, 0);
+    const int c1 = Channel(color, 1);
+    const int c2 = Channel(color, 2);
+    const int c3 = Channel(color, 3);
+
+    uint32_t best = 0;
+    int best_distance = 0x7FFFFFFF;
+    for (uint32_t i = 0; i < palette_size_; ++i) {
+      // Partial distances allow most candidates to be rejected before all channels are examined.
+      const int *entry = palette_[i];
+      int delta = entry[0] - c0;
+      int distance = delta * delta;
+      if (distance >= best_distance) {
+        continue;
+      }
+      delta = entry[1] - c1;
+      distance += delta * delta;
+      if (distance >= best_distance) {
+        continue;
+      }
+      delta = entry[2] - c2;
+      distance += delta * delta;
+      if (distance >= best_distance) {
+        continue;
+      }
+      delta = entry[3] - c3;
+      distance += delta * delta;
+      if (distance < best_distance) {
+        best_distance = distance;
+        best = i;
+      }
+    }
+
+    cache_color_[slot] = color;
+    cache_index_[slot] = static_cast<int16_t>(best);
+    return best;
+  }
+
+ private:
+  const int (*palette_)[kNumChannels];
+  uint32_t palette_size_;
+  std::vector<uint32_t> cache_color_;
+  std::vector<int16_t> cache_index_;
+};
+
+}  // namespace
+
+static void MeasureBox(Box &box, const uint32_t *pixels) {
+  int min[kNumChannels] = {255, 255, 255, 255};
+  int max[kNumChannels] = {0, 0, 0, 0};
+  for (uint32_t i = box.begin; i < box.end; ++i) {
+    for (uint32_t c = 0; c < kNumChannels; ++c) {
+      const int value = Channel(pixels[i], c);
+      min[c] = std::min(min[c], value);
+      max[c] = std::max(max[c], value);
+    }
+  }
+
+  box.widest_channel = 0;
+  box.range = -1;
+  for (uint32_t c = 0; c < kNumChannels; ++c) {
+    if (max[c] - min[c] > box.range) {
+      box.range = max[c] - min[c];
+      box.widest_channel = c;
+    }
+  }
+}
+
+// Repeatedly splits the box with the largest extent (weighted by its population) at the median of its widest channel.
+static uint32_t MedianCut(int (*palette)[kNumChannels], uint32_t palette_size, std::vector<uint32_t> &pixels) {
+  std::vector<Box> boxes;
+  boxes.reserve(palette_size);
+  boxes.push_back({0, static_cast<uint32_t>(pixels.size()), 0, 0});
+  MeasureBox(boxes.back(), pixels.data());
+
+  while (boxes.size() < palette_size) {
+    Box *split = nullptr;
+    uint64_t best_score = 0;
+    for (auto &box : boxes) {
+      const uint64_t score = static_cast<uint64_t>(box.range) * (box.end - box.begin);
+      if (box.end - box.begin > 1 && score > best_score) {
+        best_score = score;
+        split = &box;
+      }
+    }
+    if (!split) {
+      break;
+    }
+
+    const uint32_t channel = split->widest_channel;
+    const uint32_t middle = split->begin + (split->end - split->begin) / 2;
+    std::nth_element(pixels.begin() + split->begin, pixels.begin() + middle, pixels.begin() + split->end,
+                     [channel](uint32_t a, uint32_t b) { return Channel(a, channel) < Channel(b, channel); });
+
+    Box upper{middle, split->end, 0, 0};
+    split->end = middle;
+    MeasureBox(*split, pixels.data());
+    MeasureBox(upper, pixels.data());
+    boxes.push_back(upper);
+  }
+
+  for (uint32_t i = 0; i < boxes.size(); ++i) {
+    const Box &box = boxes[i];
+    uint32_t sum[kNumChannels] = {0, 0, 0, 0};
+    for (uint32_t p = box.begin; p < box.end; ++p) {
+      for (uint32_t c = 0; c < kNumChannels; ++c) {
+        sum[c] += Channel(pixels[p], c);
+      }
+    }
+    const uint32_t count = box.end - box.begin;
+    for (uint32_t c = 0; c < kNumChannels; ++c) {
+      palette[i][c] = static_cast<int>((sum[c] + count / 2) / count);
+    }
+  }
+
+  return boxes.size();
+}
+
+static void RefinePalette(int (*palette)[kNumChannels], uint32_t palette_size, const std::vector<uint32_t> &pixels) {
+  NearestColorFinder finder(palette, palette_size);
+  uint32_t sum[kMaxPaletteSize][kNumChannels] = {};
+  uint32_t count[kMaxPaletteSize] = {};
+
+  for (auto color : pixels) {
+    const uint32_t index = finder.Find(color);
+    for (uint32_t c = 0; c < kNumChannels; ++c) {
+      sum[index][c] += Channel(color, c);
+    }
+    ++count[index];
+  }
+
+  // Entries that attracted no pixels keep their previous color.
+  for (uint32_t i = 0; i < palette_size; ++i) {
+    if (!count[i]) {
+      continue;
+    }
+    for (uint32_t c = 0; c < kNumChannels; ++c) {
+      palette[i][c] = static_cast<int>((sum[i][c] + count[i] / 2) / count[i]);
+    }
+  }
+}
+
+static void MapPixels(uint8_t *indices, uint32_t indices_pitch, const int (*palette)[kNumChannels],
+                      uint32_t palette_size, const uint32_t *source, uint32_t source_pitch, uint32_t width,
+                      uint32_t height) {
+  NearestColorFinder finder(palette, palette_size);
+  auto row = reinterpret_cast<const uint8_t *>(source);
+  for (uint32_t y = 0; y < height; ++y, row += source_pitch, indices += indices_pitch) {
+    auto pixel = reinterpret_cast<const uint32_t *>(row);
+    for (uint32_t x = 0; x < width; ++x) {
+      indices[x] = static_cast<uint8_t>(finder.Find(pixel[x]));
+    }
+  }
+}
+
+static void MapPixelsDithered(uint8_t *indices, uint32_t indices_pitch, const int (*palette)[kNumChannels],
+                              uint32_t palette_size, const uint32_t *source, uint32_t source_pitch, uint32_t width,
+                              uint32_t height) {
+  NearestColorFinder finder(palette, palette_size);
+
+  // Accumulated error (in 16ths) for the current and next rows, with a pixel of padding on either side.
+  const uint32_t error_row_size = (width + 2) * kNumChannels;
+  std::vector<int> current_error(error_row_size, 0);
+  std::vector<int> next_error(error_row_size, 0);
+
+  auto row = reinterpret_cast<const uint8_t *>(source);
+  for (uint32_t y = 0; y < height; ++y, row += source_pitch, indices += indices_pitch) {
+    auto pixel = reinterpret_cast<const uint32_t *>(row);
+    std::fill(next_error.begin(), next_error.end(), 0);
+
+    for (uint32_t x = 0; x < width; ++x) {
+      int *error = &current_error[(x + 1) * kNumChannels];
+      int target[kNumChannels];
+      uint32_t adjusted = 0;
+      for (uint32_t c = 0; c < kNumChannels; ++c) {
+        target[c] = std::min(255, std::max(0, Channel(pixel[x], c) + (error[c] + 8) / 16));
+        adjusted |= static_cast<uint32_t>(target[c]) << (c * 8);
+      }
+
+      const uint32_t index = finder.Find(adjusted);
+      indices[x] = static_cast<uint8_t>(index);
+
+      int *right = error + kNumChannels;
+      int *below_left = &next_error[x * kNumChannels];
+      int *below = below_left + kNumChannels;
+      int *below_right = below + kNumChannels;
+      for (uint32_t c = 0; c < kNumChannels; ++c) {
+        const int delta = target[c] - palette[index][c];
+        right[c] += delta * 7;
+        below_left[c] += delta * 3;
+        below[c] += delta * 5;
+        below_right[c] += delta;
+      }
+    }
+
+    std::swap(current_error, next_error);
+  }
+}
+
+int QuantizeImage(uint32_t *palette, uint32_t palette_size, uint8_t *indices, uint32_t indices_pitch,
+                  const uint32_t *source, uint32_t source_pitch, uint32_t width, uint32_t height, bool dither,
+                  uint32_t refinement_passes) {
+  if (!palette_size || palette_size > kMaxPaletteSize || !width || !height) {
+    return 1;
+  }
+
+  std::vector<uint32_t> pixels;
+  pixels.reserve(width * height);
+  auto row = reinterpret_cast<const uint8_t *>(source);
+  for (uint32_t y = 0; y < height; ++y, row += source_pitch) {
+    auto pixel = reinterpret_cast<const uint32_t *>(row);
+    pixels.insert(pixels.end(), pixel, pixel + width);
+  }
+
+  int working_palette[kMaxPaletteSize][kNumChannels];
+  const uint32_t num_colors = MedianCut(working_palette, palette_size, pixels);
+  for (uint32_t pass = 0; pass < refinement_passes; ++pass) {
+    RefinePalette(working_palette, num_colors, pixels);
+  }
+
+  if (dither) {
+    MapPixelsDithered(indices, indices_pitch, working_palette, num_colors, source, source_pitch, width, height);
+  } else {
+    MapPixels(indices, indices_pitch, working_palette, num_colors, source, source_pitch, width, height);
+  }
+
+  for (uint32_t i = 0; i < palette_size; ++i) {
+    if (i >= num_colors) {
+      palette[i] = 0;
+      continue;
+    }
+    uint32_t color = 0;
+    for (uint32_t c = 0; c < kNumChannels; ++c) {
+      color |= static_cast<uint32_t>(working_palette[i][c]) << (c * 8);
+    }
+    palette[i] = color;
+  }
+
+  return 0;
+}
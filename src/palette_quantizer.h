@@ -0,0 +1,18 @@
+#ifndef NXDK_PGRAPH_TESTS_PALETTE_QUANTIZER_H
+#define NXDK_PGRAPH_TESTS_PALETTE_QUANTIZER_H
+
+#include <cstdint>
+
+// Reduces a `width` x `height` A8R8G8B8 image to at most `palette_size` (<= 256) colors for use with the
+// SZ_I8_A8R8G8B8 texture format. `palette` receives `palette_size` A8R8G8B8 entries (unused entries are zeroed) and
+// `indices` receives one byte per pixel, rows `indices_pitch` bytes apart. `source_pitch` is in bytes.
+//
+// The palette is seeded by median cut and refined by `refinement_passes` rounds of k-means. If `dither` is true,
+// Floyd-Steinberg error diffusion is applied when mapping pixels to the palette.
+//
+// Returns 0 on success.
+int QuantizeImage(uint32_t *palette, uint32_t palette_size, uint8_t *indices, uint32_t indices_pitch,
+                  const uint32_t *source, uint32_t source_pitch, uint32_t width, uint32_t height, bool dither = false,
+                  uint32_t refinement_passes = 2);
+
+#endif  // NXDK_PGRAPH_TESTS_PALETTE_QUANTIZER_H
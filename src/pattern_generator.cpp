@@ -0,0 +1,180 @@
+#include "pattern_generator.h"
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+#include "swizzle.h"
+
+// Stores `count` copies of `color`, 128 bits at a time where possible.
+static inline void FillSpan(uint32_t *dest, uint32_t color, uint32_t count) {
+#ifdef __SSE__
+  for (; count && (reinterpret_cast<uintptr_t>(dest) & 0x0F); --count) {
+    *dest++ = color;
+  }
+  // Only moves are performed on the float typed registers, so the bit pattern of the color is preserved.
+  const __m128 value = _mm_load1_ps(reinterpret_cast<const float *>(&color));
+  for (; count >= 4; count -= 4, dest += 4) {
+    _mm_store_ps(reinterpret_cast<float *>(dest), value);
+  }
+#endif
+  for (; count; --count) {
+    *dest++ = color;
+  }
+}
+
+// Copies `count` pixels from `source`, 128 bits at a time where possible.
+static inline void CopySpan(uint32_t *dest, const uint32_t *source, uint32_t count) {
+#ifdef __SSE__
+  for (; count && (reinterpret_cast<uintptr_t>(dest) & 0x0F); --count) {
+    *dest++ = *source++;
+  }
+  for (; count >= 4; count -= 4, dest += 4, source += 4) {
+    _mm_store_ps(reinterpret_cast<float *>(dest), _mm_loadu_ps(reinterpret_cast<const float *>(source)));
+  }
+#endif
+  for (; count; --count) {
+    *dest++ = *source++;
+  }
+}
+
+// Stores the (wrapping) sum of each of `count` pixels of `source` and `term`.
+static inline void AddSpan(uint32_t *dest, const uint32_t *source, uint32_t term, uint32_t count) {
+#ifdef __SSE__
+  // SSE1 has no packed integer arithmetic on the 128-bit registers, so the sums are done two pixels at a time in MMX.
+  const __m64 terms = _mm_set1_pi32(static_cast<int>(term));
+  for (; count >= 2; count -= 2, dest += 2, source += 2) {
+    __m64 pixels;
+    memcpy(&pixels, source, sizeof(pixels));
+    pixels = _mm_add_pi32(pixels, terms);
+    memcpy(dest, &pixels, sizeof(pixels));
+  }
+  _mm_empty();
+#endif
+  for (; count; --count) {
+    *dest++ = *source++ + term;
+  }
+}
+
+CheckerboardRowGenerator::CheckerboardRowGenerator(uint32_t width, const uint32_t *colors, uint32_t num_colors,
+                                                   uint32_t checker_size)
+    : width_(width),
+      num_colors_(num_colors),
+      checker_size_(checker_size),
+      pattern_(width + (num_colors - 1) * checker_size) {
+  const auto length = static_cast<uint32_t>(pattern_.size());
+  uint32_t color_index = 0;
+  for (uint32_t x = 0; x < length; x += checker_size) {
+    FillSpan(pattern_.data() + x, colors[color_index], std::min(checker_size, length - x));
+    color_index = (color_index + 1) % num_colors;
+  }
+}
+
+void CheckerboardRowGenerator::operator()(uint32_t y, uint32_t *row) const {
+  const uint32_t shift = ((y / checker_size_) % num_colors_) * checker_size_;
+  CopySpan(row, pattern_.data() + shift, width_);
+}
+
+GradientRowGenerator::GradientRowGenerator(uint32_t width, uint32_t height)
+    : width_(width), height_(height), column_terms_(width) {
+  for (uint32_t x = 0; x < width; ++x) {
+    const auto x_normal = static_cast<uint32_t>(static_cast<float>(x) * 255.0f / static_cast<float>(width));
+    column_terms_[x] = (x_normal << 8) + (x_normal << 24);
+  }
+}
+
+void GradientRowGenerator::operator()(uint32_t y, uint32_t *row) const {
+  // The column term occupies green and alpha, the row term red, blue and alpha, so only alpha is summed and any carry
+  // out of it is discarded.
+  const auto y_normal = static_cast<uint32_t>(static_cast<float>(y) * 255.0f / static_cast<float>(height_));
+  const uint32_t row_term = y_normal + ((255 - y_normal) << 16) + (y_normal << 24);
+  AddSpan(row, column_terms_.data(), row_term, width_);
+}
+
+// Writes the rows produced by `generate_row` into a rectangle of a 32bpp buffer.
+template <typename RowGenerator>
+static void WriteRows(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t height, uint32_t pitch,
+                      const RowGenerator &generate_row) {
+  auto buffer = reinterpret_cast<uint8_t *>(target) + y_offset * pitch;
+  for (uint32_t y = 0; y < height; ++y, buffer += pitch) {
+    generate_row(y, reinterpret_cast<uint32_t *>(buffer) + x_offset);
+  }
+}
+
+void GenerateRGBACheckerboard(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                              uint32_t pitch, uint32_t first_color, uint32_t second_color, uint32_t checker_size) {
+  const uint32_t colors[] = {first_color, second_color};
+  WriteRows(target, x_offset, y_offset, height, pitch, CheckerboardRowGenerator(width, colors, 2, checker_size));
+}
+
+void GenerateColoredCheckerboard(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                                 uint32_t pitch, const uint32_t *colors, uint32_t num_colors, uint32_t checker_size) {
+  WriteRows(target, x_offset, y_offset, height, pitch,
+            CheckerboardRowGenerator(width, colors, num_colors, checker_size));
+}
+
+void GenerateSwizzledRGBACheckerboard(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width,
+                                      uint32_t height, uint32_t pitch, uint32_t first_color, uint32_t second_color,
+                                      uint32_t checker_size) {
+  const uint32_t size = height * pitch;
+  auto temp_buffer = new uint8_t[size];
+
+  // The swizzle only reads the generated pixels unless the checkerboard is offset, in which case the surrounding
+  // content of the target is preserved.
+  if (x_offset || y_offset) {
+    memcpy(temp_buffer, target, size);
+  }
+
+  GenerateRGBACheckerboard(temp_buffer, x_offset, y_offset, width, height, pitch, first_color, second_color,
+                           checker_size);
+  swizzle_rect(temp_buffer, width, height, reinterpret_cast<uint8_t *>(target), pitch, 4);
+  delete[] temp_buffer;
+}
+
+void GenerateRGBATestPattern(void *target, uint32_t width, uint32_t height) {
+  GenerateRGBATestPattern(target, 0, 0, width, height, width * 4);
+}
+
+void GenerateRGBATestPattern(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                             uint32_t pitch) {
+  WriteRows(target, x_offset, y_offset, height, pitch, GradientRowGenerator(width, height));
+}
+
+void GenerateRGBABands(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                       uint32_t pitch, const uint32_t *colors, uint32_t num_colors, uint32_t band_size, bool vertical) {
+  if (vertical) {
+    // Every row is the first row of a checkerboard with the same colors.
+    const CheckerboardRowGenerator generate_row(width, colors, num_colors, band_size);
+    WriteRows(target, x_offset, y_offset, height, pitch, [&generate_row](uint32_t, uint32_t *row) {
+      generate_row(0, row);
+    });
+    return;
+  }
+
+  WriteRows(target, x_offset, y_offset, height, pitch, [=](uint32_t y, uint32_t *row) {
+    FillSpan(row, colors[(y / band_size) % num_colors], width);
+  });
+}
+
+void GenerateRGBANoise(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                       uint32_t pitch, uint32_t seed, bool opaque) {
+  const uint32_t alpha = opaque ? 0xFF000000 : 0;
+  auto buffer = reinterpret_cast<uint8_t *>(target) + y_offset * pitch;
+  for (uint32_t y = 0; y < height; ++y, buffer += pitch) {
+    auto row = reinterpret_cast<uint32_t *>(buffer) + x_offset;
+    const uint32_t row_seed = seed ^ (y * 0x9E3779B1);
+    // SSE1 has no packed integer multiply, so the hash is computed one pixel at a time.
+    for (uint32_t x = 0; x < width; ++x) {
+      uint32_t value = row_seed ^ (x * 0x85EBCA77);
+      value ^= value >> 16;
+      value *= 0x7FEB352D;
+      value ^= value >> 15;
+      value *= 0x846CA68B;
+      value ^= value >> 16;
+      row[x] = value | alpha;
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#ifndef NXDK_PGRAPH_TESTS_PATTERN_GENERATOR_H
+#define NXDK_PGRAPH_TESTS_PATTERN_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+// Inserts a rectangular checkerboard pattern into the given 32bpp texture buffer.
+void GenerateRGBACheckerboard(void *buffer, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                              uint32_t pitch, uint32_t first_color = 0xFF00FFFF, uint32_t second_color = 0xFF000000,
+                              uint32_t checker_size = 8);
+
+void GenerateColoredCheckerboard(void *buffer, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                                 uint32_t pitch, const uint32_t *colors, uint32_t num_colors,
+                                 uint32_t checker_size = 8);
+
+void GenerateSwizzledRGBACheckerboard(void *buffer, uint32_t x_offset, uint32_t y_offset, uint32_t width,
+                                      uint32_t height, uint32_t pitch, uint32_t first_color = 0xFF00FFFF,
+                                      uint32_t second_color = 0xFF000000, uint32_t checker_size = 8);
+
+void GenerateRGBATestPattern(void *target, uint32_t width, uint32_t height);
+// Inserts the test pattern into a rectangle of the given 32bpp texture buffer.
+void GenerateRGBATestPattern(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                             uint32_t pitch);
+
+// Inserts `band_size` wide bands cycling through `colors` into the given 32bpp texture buffer. Bands are horizontal
+// unless `vertical` is true.
+void GenerateRGBABands(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                       uint32_t pitch, const uint32_t *colors, uint32_t num_colors, uint32_t band_size,
+                       bool vertical = false);
+
+// Inserts deterministic white noise into the given 32bpp texture buffer. Each pixel is a hash of `seed` and its
+// position within the rectangle, so the noise does not depend on the pitch or the order in which rows are generated.
+void GenerateRGBANoise(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                       uint32_t pitch, uint32_t seed = 0, bool opaque = true);
+
+// Produces `width` pixel rows of a checkerboard cycling through `colors`, shifting by one color every `checker_size`
+// rows. Each row is a window into a single precomputed row that is `num_colors - 1` checkers longer than `width`.
+class CheckerboardRowGenerator {
+ public:
+  CheckerboardRowGenerator(uint32_t width, const uint32_t *colors, uint32_t num_colors, uint32_t checker_size);
+
+  void operator()(uint32_t y, uint32_t *row) const;
+
+ private:
+  uint32_t width_;
+  uint32_t num_colors_;
+  uint32_t checker_size_;
+  std::vector<uint32_t> pattern_;
+};
+
+// Produces `width` pixel rows of the gradient built by GenerateRGBATestPattern (in ABGR8888: red follows y, green
+// follows x, blue is the inverse of red and alpha is the wrapped sum of red and green). Each pixel is the sum of a
+// precomputed column term and a per-row term.
+class GradientRowGenerator {
+ public:
+  GradientRowGenerator(uint32_t width, uint32_t height);
+
+  void operator()(uint32_t y, uint32_t *row) const;
+
+ private:
+  uint32_t width_;
+  uint32_t height_;
+  std::vector<uint32_t> column_terms_;
+};
+
+#endif  // NXDK_PGRAPH_TESTS_PATTERN_GENERATOR_H
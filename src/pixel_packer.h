@@ -0,0 +1,158 @@
+#ifndef NXDK_PGRAPH_TESTS_PIXEL_PACKER_H
+#define NXDK_PGRAPH_TESTS_PIXEL_PACKER_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "texture_codec.h"
+
+// Packs 32-bit ABGR8888 colors (red in the low byte) into a single pixel of a fixed layout. Components are truncated to
+// their width, matching SDL's surface blitters, and components with a width of 0 are discarded.
+template <typename PixelT, uint32_t kRBits, uint32_t kRShift, uint32_t kGBits, uint32_t kGShift, uint32_t kBBits,
+          uint32_t kBShift, uint32_t kABits, uint32_t kAShift>
+struct PixelPacker {
+  typedef PixelT Pixel;
+
+  static inline Pixel Pack(uint32_t color) {
+    return static_cast<Pixel>(Component<kRBits, kRShift>(color) | Component<kGBits, kGShift>(color >> 8) |
+                              Component<kBBits, kBShift>(color >> 16) | Component<kABits, kAShift>(color >> 24));
+  }
+
+  // Expands a pixel back into an ABGR8888 color, replicating the high bits of each component into its low bits.
+  // Missing color components are 0 and a missing alpha component is 0xFF.
+  static inline uint32_t Unpack(Pixel pixel) {
+    return Expand<kRBits, kRShift>(pixel) | (Expand<kGBits, kGShift>(pixel) << 8) |
+           (Expand<kBBits, kBShift>(pixel) << 16) | ((kABits ? Expand<kABits, kAShift>(pixel) : 0xFF) << 24);
+  }
+
+ private:
+  template <uint32_t kBits, uint32_t kShift>
+  static inline uint32_t Component(uint32_t value) {
+    return kBits ? ((value & 0xFF) >> (8 - kBits)) << kShift : 0;
+  }
+
+  template <uint32_t kBits, uint32_t kShift>
+  static inline uint32_t Expand(uint32_t pixel) {
+    if (!kBits) {
+      return 0;
+    }
+    uint32_t value = ((pixel >> kShift) & ((1u << kBits) - 1)) << (8 - kBits);
+    for (uint32_t filled = kBits; filled < 8; filled *= 2) {
+      value |= value >> filled;
+    }
+    return value;
+  }
+};
+
+// Packers named after the SDL_PixelFormatEnum they produce.
+typedef PixelPacker<uint32_t, 8, 0, 8, 8, 8, 16, 8, 24> PackABGR8888;
+typedef PixelPacker<uint32_t, 8, 24, 8, 16, 8, 8, 8, 0> PackRGBA8888;
+typedef PixelPacker<uint32_t, 8, 16, 8, 8, 8, 0, 8, 24> PackARGB8888;
+typedef PixelPacker<uint32_t, 8, 8, 8, 16, 8, 24, 8, 0> PackBGRA8888;
+typedef PixelPacker<uint16_t, 5, 11, 6, 5, 5, 0, 0, 0> PackRGB565;
+typedef PixelPacker<uint16_t, 5, 10, 5, 5, 5, 0, 1, 15> PackARGB1555;
+typedef PixelPacker<uint16_t, 4, 8, 4, 4, 4, 0, 4, 12> PackARGB4444;
+
+// Calls `fn` with a PixelPacker instance for the layout of the given texture format, e.g.
+// `[&](auto packer) { WritePackedImage<decltype(packer)>(...); }`. Formats without an alpha channel share the packer of
+// their alpha variant. Returns false without calling `fn` if the format is not a packed RGB layout.
+template <typename Function>
+inline bool WithPixelPacker(TextureCodecFormat format, Function &&fn) {
+  switch (format) {
+    case TEXTURE_CODEC_A8B8G8R8:
+      fn(PackABGR8888());
+      return true;
+
+    case TEXTURE_CODEC_R8G8B8A8:
+      fn(PackRGBA8888());
+      return true;
+
+    case TEXTURE_CODEC_A8R8G8B8:
+    case TEXTURE_CODEC_X8R8G8B8:
+      fn(PackARGB8888());
+      return true;
+
+    case TEXTURE_CODEC_B8G8R8A8:
+      fn(PackBGRA8888());
+      return true;
+
+    case TEXTURE_CODEC_R5G6B5:
+      fn(PackRGB565());
+      return true;
+
+    case TEXTURE_CODEC_A1R5G5B5:
+    case TEXTURE_CODEC_X1R5G5B5:
+      fn(PackARGB1555());
+      return true;
+
+    case TEXTURE_CODEC_A4R4G4B4:
+      fn(PackARGB4444());
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// Builds the masks used to interleave x and y coordinates into an NV2A swizzled offset (see third_party/swizzle.c).
+inline void GenerateSwizzleMasks(uint32_t width, uint32_t height, uint32_t *mask_x, uint32_t *mask_y) {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t mask_bit = 1;
+  for (uint32_t bit = 1; bit < width || bit < height; bit <<= 1) {
+    if (bit < width) {
+      x |= mask_bit;
+      mask_bit <<= 1;
+    }
+    if (bit < height) {
+      y |= mask_bit;
+      mask_bit <<= 1;
+    }
+  }
+  *mask_x = x;
+  *mask_y = y;
+}
+
+// Returns the swizzled representation of v + 1 given that of v.
+inline uint32_t NextSwizzled(uint32_t swizzled, uint32_t mask) { return ((swizzled | ~mask) + 1) & mask; }
+
+// Writes a `width` x `height` image into `dest` in the layout described by `Packer`, either swizzled or linear with
+// rows padded to 4 bytes (the pitch of an SDL surface). `generate_row(y, colors)` must fill `colors` with the `width`
+// ABGR8888 colors of row `y`.
+template <typename Packer, typename RowGenerator>
+void WritePackedImage(uint8_t *dest, uint32_t width, uint32_t height, bool swizzle, RowGenerator generate_row) {
+  typedef typename Packer::Pixel Pixel;
+
+  auto colors = new uint32_t[width];
+
+  if (!swizzle) {
+    const uint32_t row_size = width * sizeof(Pixel);
+    const uint32_t pitch = (row_size + 3) & ~3;
+    for (uint32_t y = 0; y < height; ++y, dest += pitch) {
+      generate_row(y, colors);
+      auto pixel = reinterpret_cast<Pixel *>(dest);
+      for (uint32_t x = 0; x < width; ++x) {
+        pixel[x] = Packer::Pack(colors[x]);
+      }
+      memset(dest + row_size, 0, pitch - row_size);
+    }
+  } else {
+    uint32_t mask_x;
+    uint32_t mask_y;
+    GenerateSwizzleMasks(width, height, &mask_x, &mask_y);
+
+    auto pixels = reinterpret_cast<Pixel *>(dest);
+    uint32_t offset_y = 0;
+    for (uint32_t y = 0; y < height; ++y, offset_y = NextSwizzled(offset_y, mask_y)) {
+      generate_row(y, colors);
+      uint32_t offset_x = 0;
+      for (uint32_t x = 0; x < width; ++x, offset_x = NextSwizzled(offset_x, mask_x)) {
+        pixels[offset_x | offset_y] = Packer::Pack(colors[x]);
+      }
+    }
+  }
+
+  delete[] colors;
+}
+
+#endif  // NXDK_PGRAPH_TESTS_PIXEL_PACKER_H
@@ -0,0 +1,73 @@
+#include "resource_pack.h"
+
+#include <cstdio>
+#include <cstring>
+
+bool ResourcePack::LoadFile(const char *filename) {
+  FILE *f = fopen(filename, "rb");
+  if (!f) {
+    return false;
+  }
+
+  fseek(f, 0, SEEK_END);
+  const long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if (size <= 0) {
+    fclose(f);
+    return false;
+  }
+
+  std::vector<uint8_t> data(size);
+  const size_t read = fread(data.data(), 1, size, f);
+  fclose(f);
+  if (read != static_cast<size_t>(size)) {
+    return false;
+  }
+
+  return Load(std::move(data));
+}
+
+bool ResourcePack::Load(std::vector<uint8_t> &&data) {
+  data_.clear();
+  entries_ = nullptr;
+  num_entries_ = 0;
+
+  if (data.size() < sizeof(Header)) {
+    return false;
+  }
+
+  Header header;
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != kMagic || header.version != kVersion || header.total_size != data.size()) {
+    return false;
+  }
+
+  const uint64_t index_end = sizeof(Header) + static_cast<uint64_t>(header.num_entries) * sizeof(Entry);
+  if (index_end > data.size()) {
+    return false;
+  }
+
+  auto entries = reinterpret_cast<const Entry *>(data.data() + sizeof(Header));
+  for (uint32_t i = 0; i < header.num_entries; ++i) {
+    const Entry &entry = entries[i];
+    if (entry.offset % kAlignment || entry.offset < index_end ||
+        static_cast<uint64_t>(entry.offset) + entry.size > data.size() ||
+        !memchr(entry.name, 0, sizeof(entry.name))) {
+      return false;
+    }
+  }
+
+  data_ = std::move(data);
+  entries_ = reinterpret_cast<const Entry *>(data_.data() + sizeof(Header));
+  num_entries_ = header.num_entries;
+  return true;
+}
+
+const ResourcePack::Entry *ResourcePack::Find(const char *name) const {
+  for (uint32_t i = 0; i < num_entries_; ++i) {
+    if (!strcmp(entries_[i].name, name)) {
+      return entries_ + i;
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,80 @@
+#ifndef NXDK_PGRAPH_TESTS_RESOURCE_PACK_H
+#define NXDK_PGRAPH_TESTS_RESOURCE_PACK_H
+
+#include <cstdint>
+#include <vector>
+
+// A single file holding the contents of the resources directory, converted ahead of time (by tools/resource_packer)
+// into the exact bytes that are copied into texture memory, so that no image decoding or format conversion happens at
+// runtime.
+//
+// Layout: a ResourcePack::Header, followed by `num_entries` ResourcePack::Entry records, followed by the blobs. Each
+// blob begins at a multiple of kAlignment from the start of the file. All values are little endian.
+class ResourcePack {
+ public:
+  static constexpr uint32_t kMagic = 0x5052584E;  // "NXRP"
+  static constexpr uint32_t kVersion = 1;
+  static constexpr uint32_t kAlignment = 128;
+  static constexpr uint32_t kMaxNameLength = 64;
+
+  enum Format {
+    // 32bpp with bytes in R, G, B, A order (SDL_PIXELFORMAT_ABGR8888).
+    FORMAT_ABGR8888 = 1,
+    // 32bpp with bytes in B, G, R, A order (SDL_PIXELFORMAT_ARGB8888).
+    FORMAT_ARGB8888 = 2,
+    // Compressed formats, with every mipmap level from the source file stored contiguously in the NV2A layout.
+    FORMAT_DXT1 = 3,
+    FORMAT_DXT3 = 4,
+    FORMAT_DXT5 = 5,
+  };
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_entries;
+    uint32_t total_size;
+  };
+
+  struct Entry {
+    // Path relative to the resources directory, using '/' as the separator. Always null terminated.
+    char name[kMaxNameLength];
+    uint32_t format;
+    uint32_t swizzled;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levels;
+    // Row pitch of the base level in bytes (for compressed formats, a row of 4x4 blocks).
+    uint32_t pitch;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+ public:
+  ResourcePack() = default;
+
+  // Reads the pack at `filename` with a single read. Returns false if the file is missing or malformed.
+  bool LoadFile(const char *filename);
+
+  // Takes ownership of an in-memory pack. Returns false if it is malformed.
+  bool Load(std::vector<uint8_t> &&data);
+
+  bool IsLoaded() const { return !data_.empty(); }
+
+  // Returns the entry with the given name, or nullptr if it does not exist.
+  const Entry *Find(const char *name) const;
+
+  const Entry *GetEntries() const { return entries_; }
+  uint32_t NumEntries() const { return num_entries_; }
+
+  const uint8_t *GetData(const Entry &entry) const { return data_.data() + entry.offset; }
+
+ private:
+  std::vector<uint8_t> data_;
+  const Entry *entries_{nullptr};
+  uint32_t num_entries_{0};
+};
+
+static_assert(sizeof(ResourcePack::Header) == 16, "Header layout must match the packer");
+static_assert(sizeof(ResourcePack::Entry) == ResourcePack::kMaxNameLength + 32, "Entry layout must match the packer");
+
+#endif  // NXDK_PGRAPH_TESTS_RESOURCE_PACK_H
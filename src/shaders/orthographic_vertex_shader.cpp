@@ -10,11 +10,11 @@ OrthographicVertexShader::OrthographicVertexShader(uint32_t framebuffer_width, u
   far_plus_near_ = far + near;
 }
 
-void OrthographicVertexShader::CalculateProjectionMatrix() {
-  matrix_unit(projection_matrix_);
-  projection_matrix_[0] = 2.0f / width_;
-  projection_matrix_[5] = 2.0f / height_;
-  projection_matrix_[10] = -2.0f / far_minus_near_;
-  projection_matrix_[14] = -1.0f * (far_plus_near_ / far_minus_near_);
-  projection_matrix_[15] = 1.0;
+void OrthographicVertexShader::CalculateProjectionMatrix(MATRIX projection) const {
+  matrix_unit(projection);
+  projection[0] = 2.0f / width_;
+  projection[5] = 2.0f / height_;
+  projection[10] = -2.0f / far_minus_near_;
+  projection[14] = -1.0f * (far_plus_near_ / far_minus_near_);
+  projection[15] = 1.0;
 }
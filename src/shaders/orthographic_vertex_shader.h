@@ -9,7 +9,7 @@ class OrthographicVertexShader : public ProjectionVertexShader {
                            float bottom, float top, float near, float far, float z_min = 0, float z_max = 0x7FFF);
 
  protected:
-  void CalculateProjectionMatrix() override;
+  void CalculateProjectionMatrix(MATRIX projection) const override;
 
  private:
   float width_;
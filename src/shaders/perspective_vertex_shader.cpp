@@ -17,17 +17,17 @@ PerspectiveVertexShader::PerspectiveVertexShader(uint32_t framebuffer_width, uin
       fov_y_(fov_y),
       aspect_ratio_(framebuffer_width_ / framebuffer_height_) {}
 
-void PerspectiveVertexShader::CalculateProjectionMatrix() {
-  memset(projection_matrix_, 0, sizeof(projection_matrix_));
+void PerspectiveVertexShader::CalculateProjectionMatrix(MATRIX projection) const {
+  memset(projection, 0, sizeof(MATRIX));
 
   float y_scale = 1.0f / tanf(fov_y_ * 0.5f);
   float far_over_distance = far_ / (far_ - near_);
 
-  projection_matrix_[_11] = y_scale / aspect_ratio_;
-  projection_matrix_[_22] = y_scale;
-  projection_matrix_[_33] = far_over_distance;
-  projection_matrix_[_34] = 1.0f;
-  projection_matrix_[_43] = -near_ * far_over_distance;
+  projection[_11] = y_scale / aspect_ratio_;
+  projection[_22] = y_scale;
+  projection[_33] = far_over_distance;
+  projection[_34] = 1.0f;
+  projection[_43] = -near_ * far_over_distance;
 
-  //  create_view_screen(projection_matrix_, aspect_ratio_, left_, right_, bottom_, top_, near_, far_);
+  //  create_view_screen(projection, aspect_ratio_, left_, right_, bottom_, top_, near_, far_);
 }
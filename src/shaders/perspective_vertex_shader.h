@@ -13,11 +13,17 @@ class PerspectiveVertexShader : public ProjectionVertexShader {
                           float z_max = 0x7FFF, float fov_y = M_PI * 0.25f, float left = -1.0f, float right = 1.0f,
                           float bottom = 1.0f, float top = -1.0f, float near = 1.0f, float far = 10.0f);
 
-  inline void SetNear(float val) { near_ = val; }
-  inline void SetFar(float val) { far_ = val; }
+  inline void SetNear(float val) {
+    near_ = val;
+    InvalidateProjectionMatrix();
+  }
+  inline void SetFar(float val) {
+    far_ = val;
+    InvalidateProjectionMatrix();
+  }
 
  protected:
-  void CalculateProjectionMatrix() override;
+  void CalculateProjectionMatrix(MATRIX projection) const override;
 
  private:
   float fov_y_;
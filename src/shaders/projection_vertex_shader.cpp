@@ -31,11 +31,28 @@ ProjectionVertexShader::ProjectionVertexShader(uint32_t framebuffer_width, uint3
       z_max_(z_max),
       enable_lighting_{enable_lighting},
       use_4_component_texcoords_{use_4_component_texcoords} {
-  matrix_unit(model_matrix_);
-  matrix_unit(view_matrix_);
+  matrix_unit(model_matrix_.Modify());
+  MATRIX &view_matrix = view_matrix_.Modify();
+  matrix_unit(view_matrix);
 
   VECTOR rot = {0, 0, 0, 1};
-  create_world_view(view_matrix_, camera_position_, rot);
+  create_world_view(view_matrix, camera_position_, rot);
+
+  projection_matrix_.Derive({}, [this](MATRIX result) { CalculateProjectionMatrix(result); });
+  viewport_matrix_.Derive({}, [this](MATRIX result) { CalculateViewportMatrix(result); });
+  projection_viewport_matrix_.Derive({&projection_matrix_, &viewport_matrix_}, [this](MATRIX result) {
+    matrix_multiply_aligned(result, projection_matrix_.Get(), viewport_matrix_.Get());
+  });
+  model_view_matrix_.Derive({&model_matrix_, &view_matrix_}, [this](MATRIX result) {
+    matrix_multiply_aligned(result, model_matrix_.Get(), view_matrix_.Get());
+  });
+  composite_matrix_.Derive({&model_view_matrix_, &projection_viewport_matrix_}, [this](MATRIX result) {
+    matrix_multiply_aligned(result, model_view_matrix_.Get(), projection_viewport_matrix_.Get());
+    matrix_transpose_aligned(result, result);
+  });
+  inverse_composite_matrix_.Derive({&composite_matrix_}, [this](MATRIX result) {
+    matrix_general_inverse_aligned(result, composite_matrix_.Get());
+  });
 }
 
 void ProjectionVertexShader::LookAt(const float *camera_position, const float *look_at_point, const float *up) {
@@ -65,57 +82,43 @@ void ProjectionVertexShader::LookTo(const float *camera_position, const float *c
   y_axis[3] = 1.0f;
   vector_outerproduct(y_axis, z_axis, x_axis_work);
 
-  memset(view_matrix_, 0, sizeof(view_matrix_));
-  view_matrix_[_11] = x_axis_work[0];
-  view_matrix_[_12] = y_axis[0];
-  view_matrix_[_13] = z_axis[0];
-  view_matrix_[_14] = 0.0f;
+  MATRIX view_matrix = {0.0f};
+  view_matrix[_11] = x_axis_work[0];
+  view_matrix[_12] = y_axis[0];
+  view_matrix[_13] = z_axis[0];
+  view_matrix[_14] = 0.0f;
 
-  view_matrix_[_21] = x_axis_work[1];
-  view_matrix_[_22] = y_axis[1];
-  view_matrix_[_23] = z_axis[1];
-  view_matrix_[_24] = 0.0f;
+  view_matrix[_21] = x_axis_work[1];
+  view_matrix[_22] = y_axis[1];
+  view_matrix[_23] = z_axis[1];
+  view_matrix[_24] = 0.0f;
 
-  view_matrix_[_31] = x_axis_work[2];
-  view_matrix_[_32] = y_axis[2];
-  view_matrix_[_33] = z_axis[2];
-  view_matrix_[_34] = 0.0f;
+  view_matrix[_31] = x_axis_work[2];
+  view_matrix[_32] = y_axis[2];
+  view_matrix[_33] = z_axis[2];
+  view_matrix[_34] = 0.0f;
 
-  view_matrix_[_41] = -vector_innerproduct(x_axis_work, const_cast<float *>(camera_position));
-  view_matrix_[_42] = -vector_innerproduct(y_axis, const_cast<float *>(camera_position));
-  view_matrix_[_43] = -vector_innerproduct(z_axis, const_cast<float *>(camera_position));
-  view_matrix_[_44] = 1.0f;
+  view_matrix[_41] = -vector_innerproduct(x_axis_work, const_cast<float *>(camera_position));
+  view_matrix[_42] = -vector_innerproduct(y_axis, const_cast<float *>(camera_position));
+  view_matrix[_43] = -vector_innerproduct(z_axis, const_cast<float *>(camera_position));
+  view_matrix[_44] = 1.0f;
 
-  UpdateMatrices();
+  view_matrix_.Set(view_matrix);
 }
 
 void ProjectionVertexShader::SetCamera(const VECTOR position, const VECTOR rotation) {
   memcpy(camera_position_, position, sizeof(camera_position_));
 
-  matrix_unit(view_matrix_);
-  create_world_view(view_matrix_, camera_position_, rotation);
-  UpdateMatrices();
+  MATRIX view_matrix;
+  matrix_unit(view_matrix);
+  create_world_view(view_matrix, camera_position_, rotation);
+  view_matrix_.Set(view_matrix);
 }
 
 void ProjectionVertexShader::SetDirectionalLightDirection(const VECTOR &direction) {
   memcpy(light_direction_, direction, sizeof(light_direction_));
 }
 
-void ProjectionVertexShader::UpdateMatrices() {
-  CalculateProjectionMatrix();
-  CalculateViewportMatrix();
-  matrix_multiply(projection_viewport_matrix_, projection_matrix_, viewport_matrix_);
-
-  MATRIX model_view_matrix;
-  matrix_multiply(model_view_matrix, model_matrix_, view_matrix_);
-
-  matrix_multiply(composite_matrix_, model_view_matrix, projection_viewport_matrix_);
-  matrix_transpose(composite_matrix_, composite_matrix_);
-  matrix_general_inverse(inverse_composite_matrix_, composite_matrix_);
-}
-
-void ProjectionVertexShader::OnActivate() { UpdateMatrices(); }
-
 void ProjectionVertexShader::OnLoadShader() {
   if (enable_lighting_) {
     LoadShaderProgram(kVertexShaderLighting, sizeof(kVertexShaderLighting));
@@ -137,11 +140,11 @@ void ProjectionVertexShader::OnLoadConstants() {
    */
 
   int index = 0;
-  SetBaseUniform4x4F(index, model_matrix_);
+  SetBaseUniform4x4F(index, model_matrix_.Get());
   index += 4;
-  SetBaseUniform4x4F(index, view_matrix_);
+  SetBaseUniform4x4F(index, view_matrix_.Get());
   index += 4;
-  SetBaseUniform4x4F(index, projection_viewport_matrix_);
+  SetBaseUniform4x4F(index, projection_viewport_matrix_.Get());
   index += 4;
   SetBaseUniform4F(index, camera_position_);
   ++index;
@@ -157,28 +160,28 @@ void ProjectionVertexShader::OnLoadConstants() {
   ++index;
 }
 
-void ProjectionVertexShader::CalculateViewportMatrix() {
+void ProjectionVertexShader::CalculateViewportMatrix(MATRIX viewport) const {
   if (use_d3d_style_viewport_) {
     // TODO: Support alternative screen space Z range and take in the max depthbuffer value separately.
     // This should mirror the `create_d3d_viewport` parameters. In practice none of the tests use a range other than
     // 0..1 so this is not currently implemented and z_far is understood to contain the maximum depthbuffer value.
     ASSERT(z_min_ == 0.0f && "Viewport z-range only implemented for 0..1");
-    create_d3d_viewport(viewport_matrix_, framebuffer_width_, framebuffer_height_, z_max_, 0.0f, 1.0f);
+    create_d3d_viewport(viewport, framebuffer_width_, framebuffer_height_, z_max_, 0.0f, 1.0f);
   } else {
-    matrix_unit(viewport_matrix_);
-    viewport_matrix_[_11] = framebuffer_width_ * 0.5f;
-    viewport_matrix_[_41] = viewport_matrix_[_11];
-    viewport_matrix_[_42] = framebuffer_height_ * 0.5f;
-    viewport_matrix_[_22] = -1.0f * viewport_matrix_[_42];
-
-    viewport_matrix_[_33] = (z_max_ - z_min_) * 0.5f;
-    viewport_matrix_[_43] = (z_min_ + z_max_) * 0.5f;
+    matrix_unit(viewport);
+    viewport[_11] = framebuffer_width_ * 0.5f;
+    viewport[_41] = viewport[_11];
+    viewport[_42] = framebuffer_height_ * 0.5f;
+    viewport[_22] = -1.0f * viewport[_42];
+
+    viewport[_33] = (z_max_ - z_min_) * 0.5f;
+    viewport[_43] = (z_min_ + z_max_) * 0.5f;
   }
 }
 
 void ProjectionVertexShader::ProjectPoint(VECTOR result, const VECTOR world_point) const {
   VECTOR screen_point;
-  vector_apply(screen_point, world_point, composite_matrix_);
+  vector_apply(screen_point, world_point, composite_matrix_.Get());
 
   result[_X] = screen_point[_X] / screen_point[_W];
   result[_Y] = screen_point[_Y] / screen_point[_W];
@@ -187,22 +190,22 @@ void ProjectionVertexShader::ProjectPoint(VECTOR result, const VECTOR world_poin
 }
 
 void ProjectionVertexShader::UnprojectPoint(VECTOR result, const VECTOR screen_point) const {
-  vector_apply(result, screen_point, inverse_composite_matrix_);
+  vector_apply(result, screen_point, inverse_composite_matrix_.Get());
 }
 
 void ProjectionVertexShader::UnprojectPoint(VECTOR result, const VECTOR screen_point, float world_z) const {
-  VECTOR work;
+  auto inverse_composite_matrix = inverse_composite_matrix_.Get();
+  ALIGNED_VECTOR work;
   vector_copy(work, screen_point);
 
-  // TODO: Get the near and far plane mappings from the viewport matrix.
-  work[_Z] = 0.0f;
-  VECTOR near_plane;
-  vector_apply(near_plane, work, inverse_composite_matrix_);
+  work[_Z] = kUnprojectNearZ;
+  ALIGNED_VECTOR near_plane;
+  vector_apply_aligned(near_plane, work, inverse_composite_matrix);
   vector_euclidean(near_plane, near_plane);
 
-  work[_Z] = 64000.0f;
-  VECTOR far_plane;
-  vector_apply(far_plane, work, inverse_composite_matrix_);
+  work[_Z] = kUnprojectFarZ;
+  ALIGNED_VECTOR far_plane;
+  vector_apply_aligned(far_plane, work, inverse_composite_matrix);
   vector_euclidean(far_plane, far_plane);
 
   float t = (world_z - near_plane[_Z]) / (far_plane[_Z] - near_plane[_Z]);
@@ -211,3 +214,18 @@ void ProjectionVertexShader::UnprojectPoint(VECTOR result, const VECTOR screen_p
   result[_Z] = world_z;
   result[_W] = 1.0f;
 }
+
+void ProjectionVertexShader::ProjectPoints(VECTOR *results, const VECTOR *world_points, uint32_t count) const {
+  vector_project_array(results[0], sizeof(VECTOR), world_points[0], sizeof(VECTOR), count, composite_matrix_.Get());
+}
+
+void ProjectionVertexShader::UnprojectPoints(VECTOR *results, const VECTOR *screen_points, uint32_t count) const {
+  vector_apply_array(results[0], sizeof(VECTOR), screen_points[0], sizeof(VECTOR), count,
+                     inverse_composite_matrix_.Get());
+}
+
+void ProjectionVertexShader::UnprojectPoints(VECTOR *results, const VECTOR *screen_points, uint32_t count,
+                                             float world_z) const {
+  vector_unproject_array(results[0], sizeof(VECTOR), screen_points[0], sizeof(VECTOR), count,
+                         inverse_composite_matrix_.Get(), kUnprojectNearZ, kUnprojectFarZ, world_z);
+}
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 
+#include "lazy_matrix.h"
 #include "math3d.h"
 #include "vertex_shader_program.h"
 
@@ -16,11 +17,17 @@ class ProjectionVertexShader : public VertexShaderProgram {
   inline void SetUse4ComponentTexcoords(bool enable = true) { use_4_component_texcoords_ = enable; }
   inline void SetUseD3DStyleViewport(bool enable = true) {
     use_d3d_style_viewport_ = enable;
-    UpdateMatrices();
+    viewport_matrix_.Invalidate();
   }
 
-  inline void SetZMin(float val) { z_min_ = val; }
-  inline void SetZMax(float val) { z_max_ = val; }
+  inline void SetZMin(float val) {
+    z_min_ = val;
+    viewport_matrix_.Invalidate();
+  }
+  inline void SetZMax(float val) {
+    z_max_ = val;
+    viewport_matrix_.Invalidate();
+  }
 
   inline float GetZMin() const { return z_min_; }
   inline float GetZMax() const { return z_max_; }
@@ -35,11 +42,12 @@ class ProjectionVertexShader : public VertexShaderProgram {
   void SetCamera(const VECTOR position, const VECTOR rotation);
   void SetDirectionalLightDirection(const VECTOR &direction);
 
-  MATRIX &GetModelMatrix() { return model_matrix_; }
-  MATRIX &GetViewMatrix() { return view_matrix_; }
-  MATRIX &GetProjectionMatrix() { return projection_matrix_; }
-  MATRIX &GetViewportMatrix() { return viewport_matrix_; }
-  MATRIX &GetProjectionViewportMatrix() { return projection_viewport_matrix_; }
+  // The returned matrices may be modified, the matrices derived from them are recomputed the next time they are used.
+  MATRIX &GetModelMatrix() { return model_matrix_.Modify(); }
+  MATRIX &GetViewMatrix() { return view_matrix_.Modify(); }
+  MATRIX &GetProjectionMatrix() { return projection_matrix_.Modify(); }
+  MATRIX &GetViewportMatrix() { return viewport_matrix_.Modify(); }
+  MATRIX &GetProjectionViewportMatrix() { return projection_viewport_matrix_.Modify(); }
 
   // Projects the given point (on the CPU), placing the resulting screen coordinates into `result`.
   void ProjectPoint(VECTOR result, const VECTOR world_point) const;
@@ -47,15 +55,21 @@ class ProjectionVertexShader : public VertexShaderProgram {
   void UnprojectPoint(VECTOR result, const VECTOR screen_point) const;
   void UnprojectPoint(VECTOR result, const VECTOR screen_point, float world_z) const;
 
+  // Batched versions of ProjectPoint and UnprojectPoint that produce identical results.
+  void ProjectPoints(VECTOR *results, const VECTOR *world_points, uint32_t count) const;
+  void UnprojectPoints(VECTOR *results, const VECTOR *screen_points, uint32_t count) const;
+  void UnprojectPoints(VECTOR *results, const VECTOR *screen_points, uint32_t count, float world_z) const;
+
  protected:
-  void OnActivate() override;
   void OnLoadShader() override;
   void OnLoadConstants() override;
-  virtual void CalculateProjectionMatrix() = 0;
+  virtual void CalculateProjectionMatrix(MATRIX projection) const = 0;
+
+  // Must be called when a parameter used by CalculateProjectionMatrix changes.
+  void InvalidateProjectionMatrix() { projection_matrix_.Invalidate(); }
 
  private:
-  void UpdateMatrices();
-  void CalculateViewportMatrix();
+  void CalculateViewportMatrix(MATRIX viewport) const;
 
  protected:
   float framebuffer_width_{0.0};
@@ -68,14 +82,16 @@ class ProjectionVertexShader : public VertexShaderProgram {
   // Generate a viewport matrix that matches XDK/D3D behavior.
   bool use_d3d_style_viewport_{false};
 
-  MATRIX model_matrix_{};
-  MATRIX view_matrix_{};
-  MATRIX projection_matrix_{};
-  MATRIX viewport_matrix_{};
-  MATRIX projection_viewport_matrix_{};
+  LazyMatrix model_matrix_;
+  LazyMatrix view_matrix_;
+  LazyMatrix projection_matrix_;
+  LazyMatrix viewport_matrix_;
 
-  MATRIX composite_matrix_{};
-  MATRIX inverse_composite_matrix_{};
+  // Derived from the matrices above.
+  LazyMatrix projection_viewport_matrix_;
+  LazyMatrix model_view_matrix_;
+  LazyMatrix composite_matrix_;
+  LazyMatrix inverse_composite_matrix_;
 
   VECTOR camera_position_ = {0, 0, -2.25, 1};
   VECTOR light_direction_ = {0, 0, 1, 1};
@@ -14,20 +14,30 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
+#include "dds_image.h"
 #include "debug_output.h"
+#include "fixed_function_reference.h"
+#include "index_generator.h"
 #include "math3d.h"
 #include "nxdk_ext.h"
+#include "palette_quantizer.h"
 #include "pbkit_ext.h"
+#include "pixel_packer.h"
 #include "shaders/vertex_shader_program.h"
+#include "swizzle.h"
 #include "vertex_buffer.h"
 
 #define SAVE_Z_AS_PNG
 
 #define MAX_FILE_PATH_SIZE 248
+
+// The hardware rounding boundary is 1/16th of a pixel past 0.5.
+static constexpr float kNV2ARoundingThreshold = 0.5625f;
+
 static void SetVertexAttribute(uint32_t index, uint32_t format, uint32_t size, uint32_t stride, const void *data);
 static void ClearVertexAttribute(uint32_t index);
-static void GetCompositeMatrix(MATRIX result, const MATRIX model_view, const MATRIX projection);
 
 TestHost::TestHost(uint32_t framebuffer_width, uint32_t framebuffer_height, uint32_t max_texture_width,
                    uint32_t max_texture_height, uint32_t max_texture_depth)
@@ -47,16 +57,33 @@ TestHost::TestHost(uint32_t framebuffer_width, uint32_t framebuffer_height, uint
   texture_memory_size_ = max_single_texture_size_ * kMaxTextures;
   uint32_t total_size = texture_memory_size_ + palette_size;
 
+  static constexpr uint32_t kTextureArenaTextures = 4;
+  texture_arena_offset_ = total_size;
+  texture_arena_.Reset(max_single_texture_size_ * kTextureArenaTextures);
+  total_size += texture_arena_.GetRegionSize();
+
   texture_memory_ = static_cast<uint8_t *>(
       MmAllocateContiguousMemoryEx(total_size, 0, MAXRAM, 0, PAGE_WRITECOMBINE | PAGE_READWRITE));
   ASSERT(texture_memory_ && "Failed to allocate texture memory.");
 
   texture_palette_memory_ = texture_memory_ + max_single_texture_size_;
 
-  matrix_unit(fixed_function_model_view_matrix_);
-  matrix_unit(fixed_function_projection_matrix_);
-  matrix_unit(fixed_function_composite_matrix_);
-  matrix_unit(fixed_function_inverse_composite_matrix_);
+  matrix_unit(fixed_function_model_view_matrix_.Modify());
+  matrix_unit(fixed_function_projection_matrix_.Modify());
+  fixed_function_inverse_model_view_matrix_.Derive({&fixed_function_model_view_matrix_}, [this](MATRIX result) {
+    matrix_inverse(result, fixed_function_model_view_matrix_.Get());
+  });
+  fixed_function_hardware_composite_matrix_.Derive(
+      {&fixed_function_model_view_matrix_, &fixed_function_projection_matrix_}, [this](MATRIX result) {
+        matrix_multiply_aligned(result, fixed_function_model_view_matrix_.Get(),
+                                fixed_function_projection_matrix_.Get());
+      });
+  fixed_function_composite_matrix_.Derive({&fixed_function_hardware_composite_matrix_}, [this](MATRIX result) {
+    matrix_transpose_aligned(result, fixed_function_hardware_composite_matrix_.Get());
+  });
+  fixed_function_inverse_composite_matrix_.Derive({&fixed_function_composite_matrix_}, [this](MATRIX result) {
+    matrix_general_inverse_aligned(result, fixed_function_composite_matrix_.Get());
+  });
 
   uint32_t texture_offset = 0;
   uint32_t palette_offset = 0;
@@ -163,6 +190,18 @@ void TestHost::CommitSurfaceFormat() const {
   SetDepthClip(0.0f, max_depth);
 }
 
+uint32_t *TestHost::PushSurfaceColorOffset(uint32_t *p, uint32_t offset) {
+  surface_color_offset_ = offset;
+  texture_upload_cache_.Invalidate();
+  return pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, offset);
+}
+
+uint32_t *TestHost::PushSurfaceZetaOffset(uint32_t *p, uint32_t offset) {
+  surface_zeta_offset_ = offset;
+  texture_upload_cache_.Invalidate();
+  return pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, offset);
+}
+
 void TestHost::SetDepthClip(float min, float max) const {
   auto p = pb_begin();
   p = pb_push1f(p, NV097_SET_CLIP_MIN, min);
@@ -536,6 +575,21 @@ void TestHost::DrawInlineElements32(const std::vector<uint32_t> &indices, uint32
   pb_end(p);
 }
 
+void TestHost::DrawInlineElementsExpanded(uint32_t enabled_vertex_fields, DrawPrimitive primitive) {
+  ASSERT(vertex_buffer_ && "Vertex buffer must be set before calling DrawInlineElementsExpanded.");
+
+  std::vector<uint32_t> indices;
+  const auto num_vertices = vertex_buffer_->GetNumVertices();
+  auto expanded_primitive = GenerateExpandedIndices(indices, primitive, num_vertices);
+
+  // ARRAY_ELEMENT16 packs two indices per command, so prefer it whenever the indices fit.
+  if (num_vertices <= 0xFFFF) {
+    DrawInlineElements16(indices, enabled_vertex_fields, expanded_primitive);
+  } else {
+    DrawInlineElements32(indices, enabled_vertex_fields, expanded_primitive);
+  }
+}
+
 void TestHost::SetVertex(float x, float y, float z) const {
   auto p = pb_begin();
   p = pb_push3f(p, NV097_SET_VERTEX3F, x, y, z);
@@ -772,31 +826,107 @@ std::string TestHost::PrepareSaveFile(std::string output_directory, const std::s
   return output_directory;
 }
 
-void TestHost::SaveBackBuffer(const std::string &output_directory, const std::string &name) {
+// Returns the number of bytes per pixel of a color surface.
+static uint32_t SurfaceBytesPerPixel(TestHost::SurfaceColorFormat format) {
+  switch (format) {
+    case TestHost::SCF_B8:
+      return 1;
+    case TestHost::SCF_X1R5G5B5_Z1R5G5B5:
+    case TestHost::SCF_X1R5G5B5_O1R5G5B5:
+    case TestHost::SCF_R5G6B5:
+    case TestHost::SCF_G8B8:
+      return 2;
+    default:
+      return 4;
+  }
+}
+
+// Expands `num_pixels` packed surface pixels into ABGR8888 for PNG encoding.
+template <typename Packer>
+static void UnpackSurface(uint32_t *dest, const uint8_t *source, uint32_t num_pixels) {
+  auto pixel = reinterpret_cast<const typename Packer::Pixel *>(source);
+  for (uint32_t i = 0; i < num_pixels; ++i) {
+    dest[i] = Packer::Unpack(pixel[i]);
+  }
+}
+
+static void UnpackSurface(uint32_t *dest, const uint8_t *source, uint32_t num_pixels,
+                          TestHost::SurfaceColorFormat format) {
+  switch (format) {
+    case TestHost::SCF_X1R5G5B5_Z1R5G5B5:
+    case TestHost::SCF_X1R5G5B5_O1R5G5B5:
+      UnpackSurface<PixelPacker<uint16_t, 5, 10, 5, 5, 5, 0, 0, 0>>(dest, source, num_pixels);
+      break;
+    case TestHost::SCF_R5G6B5:
+      UnpackSurface<PackRGB565>(dest, source, num_pixels);
+      break;
+    case TestHost::SCF_B8:
+      UnpackSurface<PixelPacker<uint8_t, 0, 0, 0, 0, 8, 0, 0, 0>>(dest, source, num_pixels);
+      break;
+    case TestHost::SCF_G8B8:
+      UnpackSurface<PixelPacker<uint16_t, 0, 0, 8, 8, 8, 0, 0, 0>>(dest, source, num_pixels);
+      break;
+    default:
+      // The X8 byte is kept as alpha, matching captures of linear surfaces.
+      UnpackSurface<PackARGB8888>(dest, source, num_pixels);
+      break;
+  }
+}
+
+void TestHost::SaveBackBuffer(const std::string &output_directory, const std::string &name) const {
   auto target_file = PrepareSaveFile(output_directory, name);
 
-  auto buffer = pb_agp_access(pb_back_buffer());
-  auto width = static_cast<int>(pb_back_buffer_width());
-  auto height = static_cast<int>(pb_back_buffer_height());
-  auto pitch = static_cast<int>(pb_back_buffer_pitch());
+  auto buffer = static_cast<const uint8_t *>(pb_agp_access(pb_back_buffer()));
+  auto width = static_cast<uint32_t>(pb_back_buffer_width());
+  auto height = static_cast<uint32_t>(pb_back_buffer_height());
+  auto pitch = static_cast<uint32_t>(pb_back_buffer_pitch());
 
-  // FIXME: Support 16bpp surfaces
-  ASSERT((pitch == width * 4) && "Expected packed 32bpp surface");
+  const uint32_t bytes_per_pixel = SurfaceBytesPerPixel(surface_color_format_);
+  std::vector<uint32_t> pre_enc_buf;
+  if (surface_swizzle_) {
+    // CommitSurfaceFormat truncates the dimensions of swizzled surfaces to powers of two.
+    const uint32_t swizzled_width = 1 << (31 - __builtin_clz(surface_width_));
+    const uint32_t swizzled_height = 1 << (31 - __builtin_clz(surface_height_));
+    const uint32_t num_pixels = swizzled_width * swizzled_height;
+    const uint32_t size = num_pixels * bytes_per_pixel;
+
+    // An offset of 0 addresses the back buffer through the default color DMA channel, anything else is the VRAM
+    // address of a render target (e.g., in texture memory).
+    const uint8_t *surface = buffer;
+    if (surface_color_offset_) {
+      surface = static_cast<const uint8_t *>(pb_agp_access(reinterpret_cast<void *>(surface_color_offset_)));
+    } else {
+      ASSERT(size <= pitch * height && "Swizzled surface exceeds the back buffer");
+    }
 
-  // Swizzle color channels ARGB -> ABGR
-  unsigned int num_pixels = width * height;
-  uint32_t *pre_enc_buf = (uint32_t *)malloc(num_pixels * 4);
-  ASSERT(pre_enc_buf && "Failed to allocate pre-encode buffer");
-  for (unsigned int i = 0; i < num_pixels; i++) {
-    uint32_t c = static_cast<uint32_t *>(buffer)[i];
-    pre_enc_buf[i] = (c & 0xff00ff00) | ((c >> 16) & 0xff) | ((c & 0xff) << 16);
+    // The surface is uncached, so it is read sequentially into a staging copy rather than unswizzled in place.
+    std::vector<uint8_t> swizzled(surface, surface + size);
+    std::vector<uint8_t> linear(size);
+    unswizzle_rect(swizzled.data(), swizzled_width, swizzled_height, linear.data(), swizzled_width * bytes_per_pixel,
+                   bytes_per_pixel);
+
+    width = swizzled_width;
+    height = swizzled_height;
+    pre_enc_buf.resize(num_pixels);
+    UnpackSurface(pre_enc_buf.data(), linear.data(), num_pixels, surface_color_format_);
+  } else {
+    // Linear surfaces are captured from the back buffer, whose pitch is kept when rendering at lower bit depths, so
+    // 8 and 16bpp rows only fill the start of each line.
+    const uint32_t row_size = width * bytes_per_pixel;
+    ASSERT(row_size <= pitch && "Surface rows exceed the back buffer pitch");
+
+    pre_enc_buf.resize(width * height);
+    std::vector<uint8_t> row(row_size);
+    for (uint32_t y = 0; y < height; ++y) {
+      memcpy(row.data(), buffer + y * pitch, row_size);
+      UnpackSurface(pre_enc_buf.data() + y * width, row.data(), width, surface_color_format_);
+    }
   }
 
   std::vector<uint8_t> out_buf;
-  if (!fpng::fpng_encode_image_to_memory((void *)pre_enc_buf, width, height, 4, out_buf)) {
+  if (!fpng::fpng_encode_image_to_memory((void *)pre_enc_buf.data(), width, height, 4, out_buf)) {
     ASSERT(!"Failed to encode PNG image");
   }
-  free(pre_enc_buf);
 
   FILE *pFile = fopen(target_file.c_str(), "wb");
   ASSERT(pFile && "Failed to open output PNG image");
@@ -821,6 +951,16 @@ void TestHost::SaveZBuffer(const std::string &output_directory, const std::strin
 #endif
 }
 
+void TestHost::SaveText(const std::string &output_directory, const std::string &name, const std::string &text) {
+  auto target_file = PrepareSaveFile(output_directory, name, ".txt");
+
+  FILE *f = fopen(target_file.c_str(), "wb");
+  ASSERT(f && "Failed to open text output file.");
+  auto written = fwrite(text.data(), 1, text.size(), f);
+  ASSERT(written == text.size() && "Failed to write text output file.");
+  fclose(f);
+}
+
 void TestHost::SaveTexture(const std::string &output_directory, const std::string &name, const uint8_t *texture,
                            uint32_t width, uint32_t height, uint32_t pitch, uint32_t bits_per_pixel,
                            SDL_PixelFormatEnum format) {
@@ -866,6 +1006,97 @@ void TestHost::SaveRawTexture(const std::string &output_directory, const std::st
   fclose(f);
 }
 
+static DDSImage::Format GetDDSFormat(uint32_t xbox_format) {
+  switch (xbox_format) {
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8B8G8R8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_A8B8G8R8:
+      return DDSImage::Format::A8B8G8R8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_R8G8B8A8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_R8G8B8A8:
+      return DDSImage::Format::R8G8B8A8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8R8G8B8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_A8R8G8B8:
+      return DDSImage::Format::A8R8G8B8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_X8R8G8B8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_X8R8G8B8:
+      return DDSImage::Format::X8R8G8B8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_B8G8R8A8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_B8G8R8A8:
+      return DDSImage::Format::B8G8R8A8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_R5G6B5:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_R5G6B5:
+      return DDSImage::Format::R5G6B5;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A1R5G5B5:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_A1R5G5B5:
+      return DDSImage::Format::A1R5G5B5;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_X1R5G5B5:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_X1R5G5B5:
+      return DDSImage::Format::X1R5G5B5;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A4R4G4B4:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_A4R4G4B4:
+      return DDSImage::Format::A4R4G4B4;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_Y8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_Y8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_AY8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_AY8:
+      return DDSImage::Format::L8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8Y8:
+      return DDSImage::Format::A8L8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_Y16:
+      return DDSImage::Format::L16;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_I8_A8R8G8B8:
+      return DDSImage::Format::P8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LC_IMAGE_CR8YB8CB8YA8:
+      return DDSImage::Format::YUY2;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LC_IMAGE_YB8CR8YA8CB8:
+      return DDSImage::Format::UYVY;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FIXED:
+      return DDSImage::Format::D16;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FLOAT:
+      return DDSImage::Format::D16F;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FIXED:
+      return DDSImage::Format::D24S8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FLOAT:
+      return DDSImage::Format::D24FS8;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT1_A1R5G5B5:
+      return DDSImage::Format::DXT1;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8:
+      return DDSImage::Format::DXT3;
+    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8:
+      return DDSImage::Format::DXT5;
+    default:
+      return DDSImage::Format::NONE;
+  }
+}
+
+int TestHost::SaveTextureDDS(const std::string &output_directory, const std::string &name, const uint8_t *texture,
+                             uint32_t xbox_format, uint32_t width, uint32_t height, uint32_t depth, uint32_t levels,
+                             bool cubemap, uint32_t pitch) {
+  DDSImage::TextureDescription description;
+  description.format = GetDDSFormat(xbox_format);
+  if (description.format == DDSImage::Format::NONE) {
+    PrintMsg("No DDS equivalent for texture format 0x%X\n", xbox_format);
+    return 1;
+  }
+
+  description.width = width;
+  description.height = height;
+  description.depth = depth;
+  description.levels = levels;
+  description.cubemap = cubemap;
+  description.pitch = pitch;
+  description.swizzled = GetTextureFormatInfo(xbox_format).xbox_swizzled;
+
+  auto target_file = PrepareSaveFile(output_directory, name, ".dds");
+  auto buffer = pb_agp_access(const_cast<void *>(static_cast<const void *>(texture)));
+  PrintMsg("Saving to %s.\n", target_file.c_str());
+  if (!DDSImage::SaveFile(target_file.c_str(), buffer, description)) {
+    PrintMsg("Failed to save DDS file '%s'\n", target_file.c_str());
+    return 2;
+  }
+  return 0;
+}
+
 void TestHost::SetupControl0(bool enable_stencil_write) const {
   // FIXME: Figure out what to do in cases where there are multiple stages with different conversion needs.
   // Is this supported by hardware?
@@ -925,33 +1156,249 @@ void TestHost::SetDepthBufferFloatMode(bool enabled) {
   HandleDepthBufferFormatChange();
 }
 
+// Kinds of uploads tracked by the texture upload cache, used to keep keys from different paths distinct.
+enum TextureUploadKind {
+  UPLOAD_SURFACE = 1,
+  UPLOAD_RAW = 2,
+  UPLOAD_MIPMAPPED_SURFACE = 3,
+};
+
 int TestHost::SetTexture(SDL_Surface *surface, uint32_t stage) {
-  return texture_stage_[stage].SetTexture(surface, texture_memory_);
+  auto &texture_stage = texture_stage_[stage];
+  const uint32_t offset = texture_stage.GetTextureOffset();
+  const uint32_t upload_size = GetStageTextureUploadSize(stage, surface->w, surface->h);
+
+  // The converted content depends on the source pixels and layout as well as the target format.
+  const TextureFormatInfo &format = texture_stage.GetFormat();
+  uint64_t key = TextureUploadCache::Hash(surface->pixels, surface->pitch * surface->h);
+  key = TextureUploadCache::Hash(UPLOAD_SURFACE, key);
+  key = TextureUploadCache::Hash(surface->format->format, key);
+  key = TextureUploadCache::Hash(surface->w, key);
+  key = TextureUploadCache::Hash(surface->h, key);
+  key = TextureUploadCache::Hash(surface->pitch, key);
+  key = TextureUploadCache::Hash(format.xbox_format, key);
+  key = TextureUploadCache::Hash(format.sdl_format, key);
+  key = TextureUploadCache::Hash(format.xbox_swizzled, key);
+  const bool cache_active = IsTextureUploadCacheActive();
+  if (cache_active && texture_upload_cache_.Lookup(offset, key)) {
+    return 0;
+  }
+
+  int ret = texture_stage.SetTexture(surface, texture_memory_);
+  if (ret || !cache_active) {
+    texture_upload_cache_.Invalidate(offset, upload_size);
+  } else {
+    texture_upload_cache_.Insert(offset, upload_size, key);
+  }
+  return ret;
 }
 
 int TestHost::SetVolumetricTexture(const SDL_Surface **surface, uint32_t depth, uint32_t stage) {
+  texture_upload_cache_.Invalidate(texture_stage_[stage].GetTextureOffset(), GetStageTextureRegionSize(stage));
   return texture_stage_[stage].SetVolumetricTexture(surface, depth, texture_memory_);
 }
 
+int TestHost::SetVolumetricTexture(uint32_t width, uint32_t height, uint32_t depth, uint32_t bytes_per_pixel,
+                                   const TextureStage::VolumeLayerGenerator &generate_layer, uint32_t stage) {
+  auto &texture_stage = texture_stage_[stage];
+  const uint32_t region_size = GetStageTextureRegionSize(stage);
+  ASSERT(width * height * depth * bytes_per_pixel <= region_size && "Texture too large.");
+
+  texture_upload_cache_.Invalidate(texture_stage.GetTextureOffset(), region_size);
+  return texture_stage.SetVolumetricTexture(width, height, depth, bytes_per_pixel, generate_layer, texture_memory_);
+}
+
 int TestHost::SetRawTexture(const uint8_t *source, uint32_t width, uint32_t height, uint32_t depth, uint32_t pitch,
                             uint32_t bytes_per_pixel, bool swizzle, uint32_t stage) {
-  const uint32_t max_stride = max_texture_width_ * 4;
-  const uint32_t max_texture_size = max_stride * max_texture_height_ * max_texture_depth_;
-
   const uint32_t layer_size = pitch * height;
   const uint32_t surface_size = layer_size * depth;
-  ASSERT(surface_size < max_texture_size && "Texture too large.");
+  const uint32_t region_size = GetStageTextureRegionSize(stage);
+  ASSERT(surface_size <= region_size && "Texture too large.");
+
+  auto &texture_stage = texture_stage_[stage];
+  const uint32_t offset = texture_stage.GetTextureOffset();
+
+  // Linear uploads are a plain copy, which costs about as much as hashing the source, so only swizzled uploads are
+  // cached.
+  if (!swizzle) {
+    texture_upload_cache_.Invalidate(offset, surface_size);
+    return texture_stage.SetRawTexture(source, width, height, depth, pitch, bytes_per_pixel, swizzle,
+                                       texture_memory_);
+  }
 
-  return texture_stage_[stage].SetRawTexture(source, width, height, depth, pitch, bytes_per_pixel, swizzle,
-                                             texture_memory_);
+  uint64_t key = TextureUploadCache::Hash(source, surface_size);
+  key = TextureUploadCache::Hash(UPLOAD_RAW, key);
+  key = TextureUploadCache::Hash(width, key);
+  key = TextureUploadCache::Hash(height, key);
+  key = TextureUploadCache::Hash(depth, key);
+  key = TextureUploadCache::Hash(pitch, key);
+  key = TextureUploadCache::Hash(bytes_per_pixel, key);
+  const bool cache_active = IsTextureUploadCacheActive();
+  if (cache_active && texture_upload_cache_.Lookup(offset, key)) {
+    return 0;
+  }
+
+  int ret = texture_stage.SetRawTexture(source, width, height, depth, pitch, bytes_per_pixel, swizzle, texture_memory_);
+  if (ret || !cache_active) {
+    texture_upload_cache_.Invalidate(offset, surface_size);
+  } else {
+    texture_upload_cache_.Insert(offset, surface_size, key);
+  }
+  return ret;
+}
+
+int TestHost::SetMipmappedTexture(SDL_Surface *surface, uint32_t levels, MipmapFilter filter, bool gamma_correct,
+                                  uint32_t stage) {
+  auto &texture_stage = texture_stage_[stage];
+  const uint32_t offset = texture_stage.GetTextureOffset();
+  const uint32_t region_size = GetStageTextureRegionSize(stage);
+
+  const uint32_t max_levels = GetMipmapLevelCount(surface->w, surface->h);
+  if (!levels || levels > max_levels) {
+    levels = max_levels;
+  }
+  const uint32_t upload_size = texture_stage.GetMipmapLevelOffset(surface->w, surface->h, levels);
+  ASSERT(upload_size <= region_size && "Texture too large.");
+
+  const TextureFormatInfo &format = texture_stage.GetFormat();
+  uint64_t key = TextureUploadCache::Hash(surface->pixels, surface->pitch * surface->h);
+  key = TextureUploadCache::Hash(UPLOAD_MIPMAPPED_SURFACE, key);
+  key = TextureUploadCache::Hash(surface->format->format, key);
+  key = TextureUploadCache::Hash(surface->w, key);
+  key = TextureUploadCache::Hash(surface->h, key);
+  key = TextureUploadCache::Hash(surface->pitch, key);
+  key = TextureUploadCache::Hash(format.xbox_format, key);
+  key = TextureUploadCache::Hash(format.sdl_format, key);
+  key = TextureUploadCache::Hash(format.xbox_swizzled, key);
+  key = TextureUploadCache::Hash(levels, key);
+  key = TextureUploadCache::Hash(filter, key);
+  key = TextureUploadCache::Hash(gamma_correct, key);
+  const bool cache_active = IsTextureUploadCacheActive();
+  if (cache_active && texture_upload_cache_.Lookup(offset, key)) {
+    texture_stage.SetMipMapLevels(levels);
+    return 0;
+  }
+
+  int ret = texture_stage.SetMipmappedTexture(surface, levels, filter, gamma_correct, texture_memory_);
+  if (ret || !cache_active) {
+    texture_upload_cache_.Invalidate(offset, upload_size);
+  } else {
+    texture_upload_cache_.Insert(offset, upload_size, key);
+  }
+  return ret;
+}
+
+bool TestHost::LoadResourcePack(const char *path) { return resource_pack_.LoadFile(path); }
+
+int TestHost::SetResourceTexture(const ResourcePack::Entry &entry, uint32_t stage) {
+  const uint32_t region_size = GetStageTextureRegionSize(stage);
+  ASSERT(entry.size <= region_size && "Texture too large.");
+
+  const uint32_t offset = texture_stage_[stage].GetTextureOffset();
+  texture_upload_cache_.Invalidate(offset, region_size);
+  memcpy(texture_memory_ + offset, resource_pack_.GetData(entry), entry.size);
+  return 0;
 }
 
 int TestHost::SetPalette(const uint32_t *palette, PaletteSize size, uint32_t stage) {
+  // The palette region overlaps the texture region of stage 1.
+  const uint32_t palette_offset = texture_palette_memory_ - texture_memory_ + texture_stage_[stage].GetPaletteOffset();
+  texture_upload_cache_.Invalidate(palette_offset, size * 4);
   return texture_stage_[stage].SetPalette(palette, size, texture_palette_memory_);
 }
 
+int TestHost::SetPalettizedTexture(const uint32_t *source, uint32_t width, uint32_t height, uint32_t pitch,
+                                   PaletteSize size, bool dither, uint32_t stage) {
+  uint32_t palette[PALETTE_256];
+  std::vector<uint8_t> indices(width * height);
+  if (QuantizeImage(palette, size, indices.data(), width, source, pitch, width, height, dither)) {
+    return 1;
+  }
+
+  const bool swizzle = texture_stage_[stage].GetFormat().xbox_swizzled;
+  int err = SetRawTexture(indices.data(), width, height, 1, width, 1, swizzle, stage);
+  if (err) {
+    return err;
+  }
+  return SetPalette(palette, size, stage);
+}
+
 void TestHost::SetPaletteSize(PaletteSize size, uint32_t stage) { texture_stage_[stage].SetPaletteSize(size); }
 
+TestHost::TextureHandle TestHost::AllocateTexture(uint32_t size, uint32_t alignment) {
+  return texture_arena_.Allocate(size, alignment);
+}
+
+void TestHost::FreeTexture(TextureHandle handle) {
+  if (!texture_arena_.IsValid(handle)) {
+    return;
+  }
+
+  for (auto stage = 0; stage < 4; ++stage) {
+    if (stage_texture_handle_[stage] == handle) {
+      UnbindTexture(stage);
+    }
+  }
+
+  texture_upload_cache_.Invalidate(texture_arena_offset_ + texture_arena_.GetOffset(handle),
+                                   texture_arena_.GetSize(handle));
+  texture_arena_.Free(handle);
+}
+
+void TestHost::BindTexture(TextureHandle handle, uint32_t stage) {
+  ASSERT(texture_arena_.IsValid(handle) && "Invalid texture handle.");
+  stage_texture_handle_[stage] = handle;
+  texture_stage_[stage].SetTextureOffset(texture_arena_offset_ + texture_arena_.GetOffset(handle));
+}
+
+void TestHost::UnbindTexture(uint32_t stage) {
+  stage_texture_handle_[stage] = TextureMemoryAllocator::kInvalidHandle;
+  texture_stage_[stage].SetTextureOffset(stage * max_single_texture_size_);
+}
+
+uint8_t *TestHost::GetTextureMemoryForHandle(TextureHandle handle) {
+  ASSERT(texture_arena_.IsValid(handle) && "Invalid texture handle.");
+  const uint32_t offset = texture_arena_offset_ + texture_arena_.GetOffset(handle);
+  texture_upload_cache_.Invalidate(offset, texture_arena_.GetSize(handle));
+  return texture_memory_ + offset;
+}
+
+void TestHost::CompactTextureMemory() {
+  uint8_t *arena = texture_memory_ + texture_arena_offset_;
+  uint32_t num_moved = texture_arena_.Compact([this, arena](uint32_t dest, uint32_t source, uint32_t size) {
+    memmove(arena + dest, arena + source, size);
+    texture_upload_cache_.Invalidate(texture_arena_offset_ + source, size);
+    texture_upload_cache_.Invalidate(texture_arena_offset_ + dest, size);
+  });
+  if (!num_moved) {
+    return;
+  }
+
+  for (auto stage = 0; stage < 4; ++stage) {
+    if (stage_texture_handle_[stage] != TextureMemoryAllocator::kInvalidHandle) {
+      BindTexture(stage_texture_handle_[stage], stage);
+    }
+  }
+}
+
+uint32_t TestHost::GetStageTextureRegionSize(uint32_t stage) const {
+  const TextureHandle handle = stage_texture_handle_[stage];
+  if (handle == TextureMemoryAllocator::kInvalidHandle) {
+    return max_single_texture_size_;
+  }
+  return texture_arena_.GetSize(handle);
+}
+
+uint32_t TestHost::GetStageTextureUploadSize(uint32_t stage, uint32_t width, uint32_t height) const {
+  const auto &texture_stage = texture_stage_[stage];
+  const TextureFormatInfo &format = texture_stage.GetFormat();
+  if (format.xbox_linear) {
+    // Rows of linear uploads are padded to 4 bytes by SDL.
+    return ((width * format.xbox_bpp / 8 + 3) & ~3) * height;
+  }
+  return texture_stage.GetMipmapLevelOffset(width, height, 1);
+}
+
 void TestHost::FinishDraw(bool allow_saving, const std::string &output_directory, const std::string &name,
                           const std::string &z_buffer_name) {
   bool perform_save = allow_saving && save_results_;
@@ -1102,7 +1549,7 @@ void TestHost::BuildDefaultXDKProjectionMatrix(MATRIX matrix) const {
 
 void TestHost::ProjectPoint(VECTOR result, const VECTOR world_point) const {
   VECTOR screen_point;
-  vector_apply(screen_point, world_point, fixed_function_composite_matrix_);
+  vector_apply(screen_point, world_point, fixed_function_composite_matrix_.Get());
 
   result[_X] = screen_point[_X] / screen_point[_W];
   result[_Y] = screen_point[_Y] / screen_point[_W];
@@ -1111,22 +1558,22 @@ void TestHost::ProjectPoint(VECTOR result, const VECTOR world_point) const {
 }
 
 void TestHost::UnprojectPoint(VECTOR result, const VECTOR screen_point) const {
-  vector_apply(result, screen_point, fixed_function_inverse_composite_matrix_);
+  vector_apply(result, screen_point, fixed_function_inverse_composite_matrix_.Get());
 }
 
 void TestHost::UnprojectPoint(VECTOR result, const VECTOR screen_point, float world_z) const {
-  VECTOR work;
+  auto inverse_composite_matrix = fixed_function_inverse_composite_matrix_.Get();
+  ALIGNED_VECTOR work;
   vector_copy(work, screen_point);
 
-  // TODO: Get the near and far plane mappings from the viewport matrix.
-  work[_Z] = 0.0f;
-  VECTOR near_plane;
-  vector_apply(near_plane, work, fixed_function_inverse_composite_matrix_);
+  work[_Z] = kUnprojectNearZ;
+  ALIGNED_VECTOR near_plane;
+  vector_apply_aligned(near_plane, work, inverse_composite_matrix);
   vector_euclidean(near_plane, near_plane);
 
-  work[_Z] = 64000.0f;
-  VECTOR far_plane;
-  vector_apply(far_plane, work, fixed_function_inverse_composite_matrix_);
+  work[_Z] = kUnprojectFarZ;
+  ALIGNED_VECTOR far_plane;
+  vector_apply_aligned(far_plane, work, inverse_composite_matrix);
   vector_euclidean(far_plane, far_plane);
 
   float t = (world_z - near_plane[_Z]) / (far_plane[_Z] - near_plane[_Z]);
@@ -1136,6 +1583,41 @@ void TestHost::UnprojectPoint(VECTOR result, const VECTOR screen_point, float wo
   result[_W] = 1.0f;
 }
 
+void TestHost::ProjectPoints(VECTOR *results, const VECTOR *world_points, uint32_t count, bool round_to_pixel) const {
+  vector_project_array(results[0], sizeof(VECTOR), world_points[0], sizeof(VECTOR), count,
+                       fixed_function_composite_matrix_.Get());
+  if (round_to_pixel) {
+    vector_round_xy_array(results[0], sizeof(VECTOR), count, kNV2ARoundingThreshold);
+  }
+}
+
+void TestHost::UnprojectPoints(VECTOR *results, const VECTOR *screen_points, uint32_t count) const {
+  vector_apply_array(results[0], sizeof(VECTOR), screen_points[0], sizeof(VECTOR), count,
+                     fixed_function_inverse_composite_matrix_.Get());
+}
+
+void TestHost::UnprojectPoints(VECTOR *results, const VECTOR *screen_points, uint32_t count, float world_z) const {
+  vector_unproject_array(results[0], sizeof(VECTOR), screen_points[0], sizeof(VECTOR), count,
+                         fixed_function_inverse_composite_matrix_.Get(), kUnprojectNearZ, kUnprojectFarZ, world_z);
+}
+
+void TestHost::ProjectVertexBuffer(VertexBuffer &buffer, bool round_to_pixel) const {
+  auto vertex = buffer.Lock();
+  vector_project_array(vertex->pos, sizeof(Vertex), vertex->pos, sizeof(Vertex), buffer.GetNumVertices(),
+                       fixed_function_composite_matrix_.Get());
+  if (round_to_pixel) {
+    vector_round_xy_array(vertex->pos, sizeof(Vertex), buffer.GetNumVertices(), kNV2ARoundingThreshold);
+  }
+  buffer.Unlock();
+}
+
+void TestHost::UnprojectVertexBuffer(VertexBuffer &buffer, float world_z) const {
+  auto vertex = buffer.Lock();
+  vector_unproject_array(vertex->pos, sizeof(Vertex), vertex->pos, sizeof(Vertex), buffer.GetNumVertices(),
+                         fixed_function_inverse_composite_matrix_.Get(), kUnprojectNearZ, kUnprojectFarZ, world_z);
+  buffer.Unlock();
+}
+
 void TestHost::SetWindowClipExclusive(bool exclusive) {
   auto p = pb_begin();
   p = pb_push1(p, NV097_SET_WINDOW_CLIP_TYPE, exclusive);
@@ -1163,34 +1645,47 @@ void TestHost::SetViewportScale(float x, float y, float z, float w) {
 }
 
 void TestHost::SetFixedFunctionModelViewMatrix(const MATRIX model_matrix) {
-  memcpy(fixed_function_model_view_matrix_, model_matrix, sizeof(fixed_function_model_view_matrix_));
+  fixed_function_model_view_matrix_.Set(model_matrix);
 
   auto p = pb_begin();
-  p = pb_push_transposed_matrix(p, NV097_SET_MODEL_VIEW_MATRIX, fixed_function_model_view_matrix_);
-  MATRIX inverse;
-  matrix_inverse(inverse, fixed_function_model_view_matrix_);
-  p = pb_push_4x3_matrix(p, NV097_SET_INVERSE_MODEL_VIEW_MATRIX, inverse);
+  p = pb_push_transposed_matrix(p, NV097_SET_MODEL_VIEW_MATRIX,
+                                const_cast<float *>(fixed_function_model_view_matrix_.Get()));
+  p = pb_push_4x3_matrix(p, NV097_SET_INVERSE_MODEL_VIEW_MATRIX, fixed_function_inverse_model_view_matrix_.Get());
   pb_end(p);
 
+  PushFixedFunctionCompositeMatrix();
   fixed_function_matrix_mode_ = MATRIX_MODE_USER;
-
-  // Update the composite matrix.
-  SetFixedFunctionProjectionMatrix(fixed_function_projection_matrix_);
 }
 
 void TestHost::SetFixedFunctionProjectionMatrix(const MATRIX projection_matrix) {
-  memcpy(fixed_function_projection_matrix_, projection_matrix, sizeof(fixed_function_projection_matrix_));
+  fixed_function_projection_matrix_.Set(projection_matrix);
 
-  GetCompositeMatrix(fixed_function_composite_matrix_, fixed_function_model_view_matrix_,
-                     fixed_function_projection_matrix_);
-  auto p = pb_begin();
-  p = pb_push_transposed_matrix(p, NV097_SET_COMPOSITE_MATRIX, fixed_function_composite_matrix_);
-  pb_end(p);
+  PushFixedFunctionCompositeMatrix();
+  fixed_function_matrix_mode_ = MATRIX_MODE_USER;
+}
 
-  matrix_transpose(fixed_function_composite_matrix_, fixed_function_composite_matrix_);
-  matrix_general_inverse(fixed_function_inverse_composite_matrix_, fixed_function_composite_matrix_);
+void TestHost::CopyFixedFunctionState(FixedFunctionState &state) const {
+  matrix_copy(state.model_view, fixed_function_model_view_matrix_.Get());
+  matrix_copy(state.composite, fixed_function_hardware_composite_matrix_.Get());
+  matrix_copy(state.inverse_model_view, fixed_function_inverse_model_view_matrix_.Get());
+
+  for (uint32_t i = 0; i < FixedFunctionState::kNumTextureStages; ++i) {
+    const TextureStage &stage = texture_stage_[i];
+    FixedFunctionState::Texgen &texgen = state.texgen[i];
+    texgen.mode[0] = static_cast<FixedFunctionState::TexGen>(stage.GetTexgenS());
+    texgen.mode[1] = static_cast<FixedFunctionState::TexGen>(stage.GetTexgenT());
+    texgen.mode[2] = static_cast<FixedFunctionState::TexGen>(stage.GetTexgenR());
+    texgen.mode[3] = static_cast<FixedFunctionState::TexGen>(stage.GetTexgenQ());
+    texgen.texture_matrix_enable = stage.GetTextureMatrixEnable();
+    matrix_copy(texgen.texture_matrix, stage.GetTextureMatrix());
+  }
+}
 
-  fixed_function_matrix_mode_ = MATRIX_MODE_USER;
+void TestHost::PushFixedFunctionCompositeMatrix() {
+  auto p = pb_begin();
+  p = pb_push_transposed_matrix(p, NV097_SET_COMPOSITE_MATRIX,
+                                const_cast<float *>(fixed_function_hardware_composite_matrix_.Get()));
+  pb_end(p);
 }
 
 void TestHost::SetTextureStageEnabled(uint32_t stage, bool enabled) {
@@ -1232,6 +1727,45 @@ std::string TestHost::GetPrimitiveName(TestHost::DrawPrimitive primitive) {
   }
 }
 
+TestHost::DrawPrimitive TestHost::GenerateExpandedIndices(std::vector<uint32_t> &indices, DrawPrimitive primitive,
+                                                          uint32_t num_vertices) {
+  switch (primitive) {
+    case PRIMITIVE_POINTS:
+    case PRIMITIVE_LINES:
+    case PRIMITIVE_TRIANGLES:
+      GenerateSequentialIndices(indices, num_vertices);
+      return primitive;
+
+    case PRIMITIVE_LINE_LOOP:
+      GenerateLineLoopIndices(indices, num_vertices);
+      return PRIMITIVE_LINES;
+
+    case PRIMITIVE_LINE_STRIP:
+      GenerateLineStripIndices(indices, num_vertices);
+      return PRIMITIVE_LINES;
+
+    case PRIMITIVE_TRIANGLE_STRIP:
+      GenerateTriangleStripIndices(indices, num_vertices);
+      return PRIMITIVE_TRIANGLES;
+
+    case PRIMITIVE_TRIANGLE_FAN:
+    case PRIMITIVE_POLYGON:
+      GenerateTriangleFanIndices(indices, num_vertices);
+      return PRIMITIVE_TRIANGLES;
+
+    case PRIMITIVE_QUADS:
+      GenerateQuadIndices(indices, num_vertices);
+      return PRIMITIVE_TRIANGLES;
+
+    case PRIMITIVE_QUAD_STRIP:
+      GenerateQuadStripIndices(indices, num_vertices);
+      return PRIMITIVE_TRIANGLES;
+  }
+
+  ASSERT(!"Unhandled primitive type");
+  return primitive;
+}
+
 void TestHost::SetColorMask(uint32_t mask) const {
   auto p = pb_begin();
   p = pb_push1(p, NV097_SET_COLOR_MASK, mask);
@@ -1546,9 +2080,8 @@ void TestHost::ClearVertexAttributeStrideOverride(TestHost::VertexAttribute attr
 }
 
 float TestHost::NV2ARound(float input) {
-  // The hardware rounding boundary is 1/16th of a pixel past 0.5
   float fraction = input - static_cast<float>(static_cast<uint32_t>(input));
-  if (fraction >= 0.5625f) {
+  if (fraction >= kNV2ARoundingThreshold) {
     return ceilf(input);
   }
 
@@ -1572,6 +2105,3 @@ static void ClearVertexAttribute(uint32_t index) {
   SetVertexAttribute(index, NV097_SET_VERTEX_DATA_ARRAY_FORMAT_TYPE_F, 0, 0, nullptr);
 }
 
-static void GetCompositeMatrix(MATRIX result, const MATRIX model_view, const MATRIX projection) {
-  matrix_multiply(result, model_view, projection);
-}
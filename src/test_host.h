@@ -7,13 +7,18 @@
 #include <cstdint>
 #include <memory>
 
+#include "lazy_matrix.h"
 #include "math3d.h"
 #include "nxdk_ext.h"
+#include "resource_pack.h"
 #include "string"
 #include "texture_format.h"
+#include "texture_memory_allocator.h"
 #include "texture_stage.h"
+#include "texture_upload_cache.h"
 #include "vertex_buffer.h"
 
+struct FixedFunctionState;
 class VertexShaderProgram;
 struct Vertex;
 class VertexBuffer;
@@ -239,10 +244,30 @@ class TestHost {
   void SetDefaultTextureParams(uint32_t stage = 0);
   int SetTexture(SDL_Surface *surface, uint32_t stage = 0);
   int SetVolumetricTexture(const SDL_Surface **surface, uint32_t depth, uint32_t stage = 0);
+  // Uploads a volume texture whose layers are produced on demand by `generate_layer`, without staging the whole volume.
+  int SetVolumetricTexture(uint32_t width, uint32_t height, uint32_t depth, uint32_t bytes_per_pixel,
+                           const TextureStage::VolumeLayerGenerator &generate_layer, uint32_t stage = 0);
   int SetRawTexture(const uint8_t *source, uint32_t width, uint32_t height, uint32_t depth, uint32_t pitch,
                     uint32_t bytes_per_pixel, bool swizzle, uint32_t stage = 0);
 
+  // Uploads `surface` along with generated mipmap levels (a complete chain if `levels` is 0) and sets the stage's
+  // number of mipmap levels.
+  int SetMipmappedTexture(SDL_Surface *surface, uint32_t levels = 0, MipmapFilter filter = MIPMAP_FILTER_BOX,
+                          bool gamma_correct = false, uint32_t stage = 0);
+
+  // Reads the pack built from the resources directory. Returns false if the file is missing or malformed.
+  bool LoadResourcePack(const char *path);
+  // Returns the pack read by LoadResourcePack.
+  const ResourcePack &GetResourcePack() const { return resource_pack_; }
+  // Copies every level of an entry of GetResourcePack() into the texture memory of the given stage as-is. The stage's
+  // format, dimensions, and number of mipmap levels are left to the caller.
+  int SetResourceTexture(const ResourcePack::Entry &entry, uint32_t stage = 0);
+
   int SetPalette(const uint32_t *palette, PaletteSize size, uint32_t stage = 0);
+  // Quantizes an A8R8G8B8 image down to `size` colors and uploads the indices and palette for the given stage, which
+  // is expected to use an I8_A8R8G8B8 format. `pitch` is in bytes.
+  int SetPalettizedTexture(const uint32_t *source, uint32_t width, uint32_t height, uint32_t pitch, PaletteSize size,
+                           bool dither = false, uint32_t stage = 0);
   void SetPaletteSize(PaletteSize size, uint32_t stage = 0);
   void SetTextureStageEnabled(uint32_t stage, bool enabled = true);
 
@@ -273,21 +298,59 @@ class TestHost {
 
   void CommitSurfaceFormat() const;
 
+  // Pushes NV097_SET_SURFACE_COLOR_OFFSET and NV097_SET_SURFACE_ZETA_OFFSET. Any offset other than 0 may direct
+  // rendering into texture memory, so the texture upload cache is cleared and bypassed until both are reset to 0.
+  uint32_t *PushSurfaceColorOffset(uint32_t *p, uint32_t offset);
+  uint32_t *PushSurfaceZetaOffset(uint32_t *p, uint32_t offset);
+  uint32_t GetSurfaceColorOffset() const { return surface_color_offset_; }
+  uint32_t GetSurfaceZetaOffset() const { return surface_zeta_offset_; }
+
   uint32_t GetMaxTextureWidth() const { return max_texture_width_; }
   uint32_t GetMaxTextureHeight() const { return max_texture_height_; }
   uint32_t GetMaxTextureDepth() const { return max_texture_depth_; }
   uint32_t GetMaxSingleTextureSize() const { return max_single_texture_size_; }
 
-  uint8_t *GetTextureMemory() const { return texture_memory_; }
+  // Direct access to texture memory. As the caller may modify the memory (either directly or by rendering into it), the
+  // texture upload cache is invalidated, but only at the time of the call. A pointer kept across a SetTexture or
+  // SetRawTexture call must be fetched again, or InvalidateTextureUploadCache called, before it is written through;
+  // otherwise later uploads of the content that was overwritten are skipped as cache hits.
+  uint8_t *GetTextureMemory() {
+    texture_upload_cache_.Invalidate();
+    return texture_memory_;
+  }
   uint32_t GetTextureMemorySize() const { return texture_memory_size_; }
 
-  uint8_t *GetTextureMemoryForStage(uint32_t stage) const {
+  uint8_t *GetTextureMemoryForStage(uint32_t stage) {
+    texture_upload_cache_.Invalidate();
     return texture_memory_ + texture_stage_[stage].GetTextureOffset();
   }
-  uint32_t *GetPaletteMemoryForStage(uint32_t stage) const {
+  uint32_t *GetPaletteMemoryForStage(uint32_t stage) {
+    texture_upload_cache_.Invalidate();
     return reinterpret_cast<uint32_t *>(texture_palette_memory_ + texture_stage_[stage].GetPaletteOffset());
   }
 
+  // Textures that should remain resident across tests may be placed in the texture arena, which follows the fixed
+  // per-stage regions. Binding a handle directs the stage, and any uploads to it, at the allocated region until it is
+  // unbound; SetupTextureStages must be called for the binding to take effect on the hardware.
+  typedef TextureMemoryAllocator::Handle TextureHandle;
+  TextureHandle AllocateTexture(uint32_t size, uint32_t alignment = TextureMemoryAllocator::kDefaultAlignment);
+  // Frees the given region, unbinding it from any stages that refer to it.
+  void FreeTexture(TextureHandle handle);
+  void BindTexture(TextureHandle handle, uint32_t stage = 0);
+  // Restores the fixed region of the given stage.
+  void UnbindTexture(uint32_t stage = 0);
+  uint8_t *GetTextureMemoryForHandle(TextureHandle handle);
+  // Moves arena allocations together to undo fragmentation. Invoked by TestSuite at suite boundaries.
+  void CompactTextureMemory();
+  TextureMemoryAllocator::Stats GetTextureArenaStats() const { return texture_arena_.GetStats(); }
+
+  // Uploads through SetTexture and SetRawTexture are skipped if the destination already holds identical content. This
+  // must be called if texture memory is modified without going through TestHost (e.g., via a pointer retrieved before
+  // the last upload, or by rendering into texture memory).
+  void InvalidateTextureUploadCache() { texture_upload_cache_.Invalidate(); }
+  const TextureUploadCache::Stats &GetTextureUploadCacheStats() const { return texture_upload_cache_.GetStats(); }
+  void ResetTextureUploadCacheStats() { texture_upload_cache_.ResetStats(); }
+
   inline uint32_t GetFramebufferWidth() const { return framebuffer_width_; }
   inline uint32_t GetFramebufferHeight() const { return framebuffer_height_; }
   inline float GetFramebufferWidthF() const { return static_cast<float>(framebuffer_width_); }
@@ -326,6 +389,11 @@ class TestHost {
   void DrawInlineElements32(const std::vector<uint32_t> &indices, uint32_t enabled_vertex_fields = kDefaultVertexFields,
                             DrawPrimitive primitive = PRIMITIVE_TRIANGLES);
 
+  // Sends the vertices of the current vertex buffer, interpreted as `primitive`, via an index array that expands it
+  // into independent points, lines, or triangles. The vertex buffer itself is not modified or duplicated.
+  void DrawInlineElementsExpanded(uint32_t enabled_vertex_fields = kDefaultVertexFields,
+                                  DrawPrimitive primitive = PRIMITIVE_TRIANGLES);
+
   void FinishDraw(bool allow_saving, const std::string &output_directory, const std::string &name,
                   const std::string &z_buffer_name = "");
 
@@ -345,7 +413,7 @@ class TestHost {
   // Gets a reasonable default projection matrix (fov = PI/4, near = 1, far = 200)
   void BuildDefaultXDKProjectionMatrix(MATRIX matrix) const;
 
-  const float *GetFixedFunctionInverseCompositeMatrix() const { return fixed_function_inverse_composite_matrix_; }
+  const float *GetFixedFunctionInverseCompositeMatrix() const { return fixed_function_inverse_composite_matrix_.Get(); }
 
   // Set up the viewport and fixed function pipeline matrices to match a default XDK project.
   void SetXDKDefaultViewportAndFixedFunctionMatrices();
@@ -359,6 +427,16 @@ class TestHost {
   void UnprojectPoint(VECTOR result, const VECTOR screen_point) const;
   void UnprojectPoint(VECTOR result, const VECTOR screen_point, float world_z) const;
 
+  // Batched versions of ProjectPoint and UnprojectPoint that produce identical results. If `round_to_pixel` is true,
+  // the projected x and y coordinates are rounded as by NV2ARound.
+  void ProjectPoints(VECTOR *results, const VECTOR *world_points, uint32_t count, bool round_to_pixel = false) const;
+  void UnprojectPoints(VECTOR *results, const VECTOR *screen_points, uint32_t count) const;
+  void UnprojectPoints(VECTOR *results, const VECTOR *screen_points, uint32_t count, float world_z) const;
+
+  // Transforms the positions of every vertex in `buffer` in place, as ProjectPoints and UnprojectPoints.
+  void ProjectVertexBuffer(VertexBuffer &buffer, bool round_to_pixel = false) const;
+  void UnprojectVertexBuffer(VertexBuffer &buffer, float world_z) const;
+
   static void SetWindowClipExclusive(bool exclusive);
   static void SetWindowClip(uint32_t right, uint32_t bottom, uint32_t left = 0, uint32_t top = 0, uint32_t region = 0);
 
@@ -367,8 +445,13 @@ class TestHost {
 
   void SetFixedFunctionModelViewMatrix(const MATRIX model_matrix);
   void SetFixedFunctionProjectionMatrix(const MATRIX projection_matrix);
-  inline const float *GetFixedFunctionModelViewMatrix() const { return fixed_function_model_view_matrix_; }
-  inline const float *GetFixedFunctionProjectionMatrix() const { return fixed_function_projection_matrix_; }
+  inline const float *GetFixedFunctionModelViewMatrix() const { return fixed_function_model_view_matrix_.Get(); }
+  inline const float *GetFixedFunctionProjectionMatrix() const { return fixed_function_projection_matrix_.Get(); }
+
+  // Copies the fixed function matrices and the texgen state of the texture stages into `state` so that it matches what
+  // the host sends to the hardware. Lighting, material and fog state is pushed by the tests themselves and must be
+  // filled in by the caller.
+  void CopyFixedFunctionState(FixedFunctionState &state) const;
 
   // Start the process of rendering an inline-defined primitive (specified via SetXXXX methods below).
   // Note that End() must be called to trigger rendering, and that SetVertex() triggers the creation of a vertex.
@@ -413,6 +496,11 @@ class TestHost {
 
   static std::string GetPrimitiveName(DrawPrimitive primitive);
 
+  // Appends indices that render `num_vertices` vertices, interpreted as `primitive`, as independent primitives.
+  // Returns the primitive that should be used when drawing the generated indices.
+  static DrawPrimitive GenerateExpandedIndices(std::vector<uint32_t> &indices, DrawPrimitive primitive,
+                                               uint32_t num_vertices);
+
   bool GetSaveResults() const { return save_results_; }
   void SetSaveResults(bool enable = true) { save_results_ = enable; }
 
@@ -529,6 +617,13 @@ class TestHost {
   // Commit any changes to texture stages (called automatically in PrepareDraw but may be useful to call more frequently
   // in scenes with multiple draws per clear)
   void SetupTextureStages() const;
+  // Returns the size of the texture memory region the given stage currently points at.
+  uint32_t GetStageTextureRegionSize(uint32_t stage) const;
+  // Returns the number of bytes written by a single level upload of the given dimensions to the given stage.
+  uint32_t GetStageTextureUploadSize(uint32_t stage, uint32_t width, uint32_t height) const;
+  // Whether uploads may be served from the texture upload cache, which is only the case while rendering to the default
+  // surfaces.
+  bool IsTextureUploadCacheActive() const { return !surface_color_offset_ && !surface_zeta_offset_; }
 
   static void SaveTexture(const std::string &output_directory, const std::string &name, const uint8_t *texture,
                           uint32_t width, uint32_t height, uint32_t pitch, uint32_t bits_per_pixel,
@@ -536,7 +631,16 @@ class TestHost {
   // Saves the given region of memory as a flat binary file.
   static void SaveRawTexture(const std::string &output_directory, const std::string &name, const uint8_t *texture,
                              uint32_t width, uint32_t height, uint32_t pitch, uint32_t bits_per_pixel);
+  // Saves texture memory in the given NV2A format as a DDS file holding the exact texel values, including formats that
+  // cannot be represented by a PNG (depth, YUV, palettized, compressed). Swizzled formats are written unswizzled.
+  // `pitch` may only be given for single level 2D textures whose rows are not tightly packed. Returns 1 if the format
+  // has no DDS equivalent (e.g., G8B8) and 2 if the file could not be written.
+  static int SaveTextureDDS(const std::string &output_directory, const std::string &name, const uint8_t *texture,
+                            uint32_t xbox_format, uint32_t width, uint32_t height, uint32_t depth = 1,
+                            uint32_t levels = 1, bool cubemap = false, uint32_t pitch = 0);
   void SaveZBuffer(const std::string &output_directory, const std::string &name) const;
+  // Saves the given string as a text file.
+  static void SaveText(const std::string &output_directory, const std::string &name, const std::string &text);
 
   // Returns the maximum possible value that can be stored in the depth surface for the given mode.
   static float MaxDepthBufferValue(uint32_t depth_buffer_format, bool float_mode);
@@ -551,6 +655,8 @@ class TestHost {
  private:
   // Update matrices when the depth buffer format changes.
   void HandleDepthBufferFormatChange();
+  // Sends the composite of the current fixed function model view and projection matrices to the hardware.
+  void PushFixedFunctionCompositeMatrix();
   uint32_t MakeInputCombiner(CombinerSource a_source, bool a_alpha, CombinerMapping a_mapping, CombinerSource b_source,
                              bool b_alpha, CombinerMapping b_mapping, CombinerSource c_source, bool c_alpha,
                              CombinerMapping c_mapping, CombinerSource d_source, bool d_alpha,
@@ -559,7 +665,9 @@ class TestHost {
                               bool cd_dot_product, CombinerSumMuxMode sum_or_mux, CombinerOutOp op) const;
   static std::string PrepareSaveFile(std::string output_directory, const std::string &filename,
                                      const std::string &ext = ".png");
-  static void SaveBackBuffer(const std::string &output_directory, const std::string &name);
+  // Saves the back buffer as a PNG, expanding 8 and 16bpp surface formats. If the active color surface is swizzled, it
+  // is read from the current color offset instead, unswizzled and saved at the surface's dimensions.
+  void SaveBackBuffer(const std::string &output_directory, const std::string &name) const;
 
  private:
   uint32_t framebuffer_width_;
@@ -580,6 +688,8 @@ class TestHost {
   uint32_t surface_clip_y_{0};
   uint32_t surface_clip_width_{640};
   uint32_t surface_clip_height_{480};
+  uint32_t surface_color_offset_{0};
+  uint32_t surface_zeta_offset_{0};
   uint32_t surface_width_{640};
   uint32_t surface_height_{480};
   AntiAliasingSetting antialiasing_setting_{AA_CENTER_1};
@@ -590,6 +700,12 @@ class TestHost {
   uint8_t *texture_memory_{nullptr};
   uint8_t *texture_palette_memory_{nullptr};
   uint32_t texture_memory_size_{0};
+  TextureUploadCache texture_upload_cache_;
+  uint32_t texture_arena_offset_{0};
+  TextureMemoryAllocator texture_arena_;
+  TextureHandle stage_texture_handle_[4]{};
+
+  ResourcePack resource_pack_;
 
   enum FixedFunctionMatrixSetting {
     MATRIX_MODE_DEFAULT_NXDK,
@@ -597,10 +713,17 @@ class TestHost {
     MATRIX_MODE_USER,
   };
   FixedFunctionMatrixSetting fixed_function_matrix_mode_{MATRIX_MODE_DEFAULT_NXDK};
-  MATRIX fixed_function_model_view_matrix_{};
-  MATRIX fixed_function_projection_matrix_{};
-  MATRIX fixed_function_composite_matrix_{};
-  MATRIX fixed_function_inverse_composite_matrix_{};
+  LazyMatrix fixed_function_model_view_matrix_;
+  LazyMatrix fixed_function_projection_matrix_;
+
+  // Derived from the model view and projection matrices. Only the matrices sent to the hardware are computed eagerly,
+  // the rest are computed when first used after a change.
+  LazyMatrix fixed_function_inverse_model_view_matrix_;
+  // The composite matrix in the layout sent to the hardware.
+  LazyMatrix fixed_function_hardware_composite_matrix_;
+  // The transposed composite matrix, suitable for vector_apply.
+  LazyMatrix fixed_function_composite_matrix_;
+  LazyMatrix fixed_function_inverse_composite_matrix_;
 
   bool save_results_{true};
 
@@ -98,7 +98,7 @@ void AntialiasingTests::Test(const char *name, TestHost::AntiAliasingSetting aa)
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kRenderBufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kRenderBufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(kTextureMemory));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(kTextureMemory));
     pb_end(p);
   }
 
@@ -119,7 +119,7 @@ void AntialiasingTests::Test(const char *name, TestHost::AntiAliasingSetting aa)
     const uint32_t kFramebufferPitch = host_.GetFramebufferWidth() * 4;
     auto p = pb_begin();
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
@@ -162,7 +162,7 @@ void AntialiasingTests::TestAARenderToFramebufferSurface(const char *name, TestH
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, pitch) | SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, pitch));
     // Point zeta at an unbounded DMA channel so it won't fail limit checks, it won't be written to anyway.
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_ZETA, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, VRAM_ADDR(host_.GetTextureMemory()));
+    p = host_.PushSurfaceZetaOffset(p, VRAM_ADDR(host_.GetTextureMemory()));
     pb_end(p);
   }
 
@@ -204,7 +204,7 @@ void AntialiasingTests::TestAARenderToFramebufferSurface(const char *name, TestH
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_ZETA, kDefaultDMAZetaChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, 0);
+    p = host_.PushSurfaceZetaOffset(p, 0);
     pb_end(p);
   }
   host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z16, host_.GetFramebufferWidth(),
@@ -285,7 +285,7 @@ void AntialiasingTests::TestModifyNonFramebufferSurface() {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kRenderBufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kRenderBufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(kTextureMemory));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(kTextureMemory));
     pb_end(p);
 
     host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z16, kTextureSize, kTextureSize, false, 0, 0,
@@ -310,7 +310,7 @@ void AntialiasingTests::TestModifyNonFramebufferSurface() {
   {
     auto p = pb_begin();
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
@@ -385,7 +385,7 @@ void AntialiasingTests::TestCPUWriteIgnoresSurfaceConfig() {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kRenderBufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kRenderBufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(kTextureMemory));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(kTextureMemory));
     pb_end(p);
 
     host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z16, kTextureSize, kTextureSize, false, 0, 0,
@@ -403,7 +403,7 @@ void AntialiasingTests::TestCPUWriteIgnoresSurfaceConfig() {
     const uint32_t kFramebufferPitch = host_.GetFramebufferWidth() * 4;
     auto p = pb_begin();
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
@@ -439,7 +439,7 @@ void AntialiasingTests::TestGPUAAWriteAfterCPUWrite() {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kRenderBufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kRenderBufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(kTextureMemory));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(kTextureMemory));
     pb_end(p);
 
     host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z16, kTextureSize, kTextureSize, false, 0, 0,
@@ -472,7 +472,7 @@ void AntialiasingTests::TestGPUAAWriteAfterCPUWrite() {
     const uint32_t kFramebufferPitch = host_.GetFramebufferWidth() * 4;
     auto p = pb_begin();
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
@@ -511,7 +511,7 @@ void AntialiasingTests::TestNonAACPURoundTrip() {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kRenderBufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kRenderBufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(kTextureMemory));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(kTextureMemory));
     pb_end(p);
 
     host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z16, kTextureSize, kTextureSize);
@@ -528,7 +528,7 @@ void AntialiasingTests::TestNonAACPURoundTrip() {
     const uint32_t kFramebufferPitch = host_.GetFramebufferWidth() * 4;
     auto p = pb_begin();
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
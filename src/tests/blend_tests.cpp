@@ -177,7 +177,7 @@ void BlendTests::RenderToTextureStart() const {
   p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kTexturePitch) |
                    SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
-  p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(kTextureMemory));
+  p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(kTextureMemory));
   pb_end(p);
 }
 
@@ -185,7 +185,7 @@ void BlendTests::RenderToTextureEnd() const {
   const uint32_t kFramebufferPitch = host_.GetFramebufferWidth() * 4;
   auto p = pb_begin();
   p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-  p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+  p = host_.PushSurfaceColorOffset(p, 0);
   p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                    SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
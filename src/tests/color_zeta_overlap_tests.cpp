@@ -199,8 +199,8 @@ void ColorZetaOverlapTests::TestXemuAdjacentSurfaceWithClipOffset(bool swizzle)
     p = pb_push1(
         p, NV097_SET_SURFACE_PITCH,
         SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kSurfacePitch) | SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kSurfacePitch));
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, texture_memory);
-    p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, texture_memory + kSurfacePitch * kSurfaceHeight);
+    p = host_.PushSurfaceColorOffset(p, texture_memory);
+    p = host_.PushSurfaceZetaOffset(p, texture_memory + kSurfacePitch * kSurfaceHeight);
     pb_end(p);
 
     host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z24S8, kSurfaceWidth, kSurfaceHeight, false);
@@ -236,8 +236,8 @@ void ColorZetaOverlapTests::TestXemuAdjacentSurfaceWithClipOffset(bool swizzle)
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
-    p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
+    p = host_.PushSurfaceZetaOffset(p, 0);
     pb_end(p);
     host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z24S8, host_.GetFramebufferWidth(),
                                     host_.GetFramebufferHeight());
@@ -269,8 +269,8 @@ void ColorZetaOverlapTests::TestXemuAdjacentSurfaceWithAA() {
     p = pb_push1(
         p, NV097_SET_SURFACE_PITCH,
         SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kSurfacePitch) | SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kSurfacePitch));
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, texture_memory);
-    p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, texture_memory + kSurfacePitch * kSurfaceHeight);
+    p = host_.PushSurfaceColorOffset(p, texture_memory);
+    p = host_.PushSurfaceZetaOffset(p, texture_memory + kSurfacePitch * kSurfaceHeight);
     pb_end(p);
     // Enable anti aliasing.
     host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z24S8, kSurfaceWidth, kSurfaceHeight, false,
@@ -296,8 +296,8 @@ void ColorZetaOverlapTests::TestXemuAdjacentSurfaceWithAA() {
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
-    p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
+    p = host_.PushSurfaceZetaOffset(p, 0);
     pb_end(p);
     host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z24S8, host_.GetFramebufferWidth(),
                                     host_.GetFramebufferHeight());
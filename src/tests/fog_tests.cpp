@@ -4,6 +4,7 @@
 
 #include <utility>
 
+#include "mesh_generator.h"
 #include "pbkit_ext.h"
 #include "shaders/perspective_vertex_shader.h"
 #include "test_host.h"
@@ -31,6 +32,17 @@ static const FogTests::FogGenMode kGenModes[] = {
 };
 // clang-format on
 
+FogTests::FogTests(TestHost& host, std::string output_dir) : FogTests(host, std::move(output_dir), "Fog") {
+  // The dense floor only exercises the fixed function fog path, so the variants are not inherited by the vertex shader
+  // suites.
+  for (const auto fog_mode : kFogModes) {
+    for (const auto gen_mode : kGenModes) {
+      const std::string test_name = MakeTestName(fog_mode, gen_mode, 0xFF, true);
+      tests_[test_name] = [this, fog_mode, gen_mode]() { Test(fog_mode, gen_mode, 0xFF, true); };
+    }
+  }
+}
+
 FogTests::FogTests(TestHost& host, std::string output_dir, std::string suite_name)
     : TestSuite(host, std::move(output_dir), std::move(suite_name)) {
   for (const auto fog_mode : kFogModes) {
@@ -63,6 +75,8 @@ void FogTests::Initialize() {
 
 void FogTests::Deinitialize() {
   vertex_buffer_.reset();
+  dense_vertex_buffer_.reset();
+  dense_index_buffer_.clear();
   TestSuite::Deinitialize();
 }
 
@@ -101,7 +115,26 @@ void FogTests::CreateGeometry() {
   }
 }
 
-void FogTests::Test(FogTests::FogMode fog_mode, FogTests::FogGenMode gen_mode, uint32_t fog_alpha) {
+void FogTests::CreateDenseGeometry() {
+  static constexpr uint32_t kColumns = 128;
+  static constexpr uint32_t kRows = 128;
+
+  MeshStyle style;
+  style.diffuse_start = Color(0.75f, 0.75f, 0.75f);
+  style.diffuse_end = Color(1.0f, 1.0f, 1.0f);
+
+  auto size = GetGridMeshSize(kColumns, kRows);
+  dense_vertex_buffer_ = std::make_shared<VertexBuffer>(size.num_vertices);
+  dense_index_buffer_.clear();
+  dense_index_buffer_.reserve(size.num_indices);
+
+  GenerateFloorMesh(dense_vertex_buffer_->Lock(), dense_index_buffer_, -60.0f, 60.0f, 0.0f, kFogEnd, -2.0f, kColumns,
+                    kRows, style);
+  dense_vertex_buffer_->Unlock();
+}
+
+void FogTests::Test(FogTests::FogMode fog_mode, FogTests::FogGenMode gen_mode, uint32_t fog_alpha,
+                    bool dense_geometry) {
   // See https://docs.microsoft.com/en-us/previous-versions/windows/desktop/bb324452(v=vs.85)
   // https://docs.microsoft.com/en-us/previous-versions/windows/desktop/bb322857(v=vs.85)
   static constexpr uint32_t kBackgroundColor = 0xFF303030;
@@ -154,16 +187,26 @@ void FogTests::Test(FogTests::FogMode fog_mode, FogTests::FogGenMode gen_mode, u
 
   pb_end(p);
 
-  host_.DrawArrays(host_.POSITION | host_.DIFFUSE);
+  if (dense_geometry) {
+    if (!dense_vertex_buffer_) {
+      CreateDenseGeometry();
+    }
+    host_.SetVertexBuffer(dense_vertex_buffer_);
+    host_.DrawInlineElements16(dense_index_buffer_, host_.POSITION | host_.DIFFUSE);
+    host_.SetVertexBuffer(vertex_buffer_);
+  } else {
+    host_.DrawArrays(host_.POSITION | host_.DIFFUSE);
+  }
 
-  std::string name = MakeTestName(fog_mode, gen_mode, fog_alpha);
+  std::string name = MakeTestName(fog_mode, gen_mode, fog_alpha, dense_geometry);
   pb_print("%s\n", name.c_str());
   pb_draw_text_screen();
 
   host_.FinishDraw(allow_saving_, output_dir_, name);
 }
 
-std::string FogTests::MakeTestName(FogTests::FogMode fog_mode, FogTests::FogGenMode gen_mode, uint32_t fog_alpha) {
+std::string FogTests::MakeTestName(FogTests::FogMode fog_mode, FogTests::FogGenMode gen_mode, uint32_t fog_alpha,
+                                   bool dense_geometry) {
   std::string ret;
 
   {
@@ -211,6 +254,10 @@ std::string FogTests::MakeTestName(FogTests::FogMode fog_mode, FogTests::FogGenM
       break;
   }
 
+  if (dense_geometry) {
+    ret += "-dense";
+  }
+
   return std::move(ret);
 }
 
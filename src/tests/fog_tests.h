@@ -32,18 +32,26 @@ class FogTests : public TestSuite {
   };
 
  public:
-  FogTests(TestHost& host, std::string output_dir, std::string suite_name = "Fog");
+  FogTests(TestHost& host, std::string output_dir);
   void Initialize() override;
   void Deinitialize() override;
 
  protected:
+  // Registers only the basic fog tests, for use by derived suites.
+  FogTests(TestHost& host, std::string output_dir, std::string suite_name);
+
   virtual void CreateGeometry();
-  void Test(FogMode fog_mode, FogGenMode gen_mode, uint32_t fog_alpha);
+  // Creates a densely tessellated floor spanning the full fog range.
+  void CreateDenseGeometry();
+  void Test(FogMode fog_mode, FogGenMode gen_mode, uint32_t fog_alpha, bool dense_geometry = false);
 
-  static std::string MakeTestName(FogMode fog_mode, FogGenMode gen_mode, uint32_t fog_alpha);
+  static std::string MakeTestName(FogMode fog_mode, FogGenMode gen_mode, uint32_t fog_alpha,
+                                  bool dense_geometry = false);
 
  protected:
   std::shared_ptr<VertexBuffer> vertex_buffer_;
+  std::shared_ptr<VertexBuffer> dense_vertex_buffer_;
+  std::vector<uint32_t> dense_index_buffer_;
 };
 
 class FogCustomShaderTests : public FogTests {
@@ -1,7 +1,7 @@
 #include "image_blit_tests.h"
 
-#include <SDL_image.h>
 #include <pbkit/pbkit.h>
+#include <windows.h>
 
 #include "debug_output.h"
 #include "nxdk_ext.h"
@@ -101,18 +101,17 @@ void ImageBlitTests::Initialize() {
   TestSuite::Initialize();
   SetDefaultTextureFormat();
 
-  SDL_Surface* temp = IMG_Load("D:\\image_blit\\TestImage.png");
-  ASSERT(temp);
-  SDL_Surface* test_image = SDL_ConvertSurfaceFormat(temp, SDL_PIXELFORMAT_BGRA32, 0);
-  SDL_free(temp);
+  // The pack stores the image in BGRA byte order, as expected by the blit source.
+  const auto& resources = host_.GetResourcePack();
+  auto test_image = resources.Find("image_blit/TestImage.png");
+  ASSERT(test_image && test_image->format == ResourcePack::FORMAT_ARGB8888 && "Missing test image");
 
   image_pitch_ = test_image->pitch;
-  image_height_ = test_image->h;
+  image_height_ = test_image->height;
   uint32_t image_bytes = image_pitch_ * image_height_;
 
   source_image_ = static_cast<uint8_t*>(MmAllocateContiguousMemory(image_bytes));
-  memcpy(source_image_, test_image->pixels, image_bytes);
-  SDL_free(test_image);
+  memcpy(source_image_, resources.GetData(*test_image), image_bytes);
 
   // TODO: Provide a mechanism to find the next unused channel.
   auto channel = kNextContextChannel;
@@ -140,6 +139,7 @@ void ImageBlitTests::Initialize() {
 void ImageBlitTests::Deinitialize() {
   MmFreeContiguousMemory(source_image_);
   source_image_ = nullptr;
+  TestSuite::Deinitialize();
 }
 
 void ImageBlitTests::ImageBlit(uint32_t operation, uint32_t beta, uint32_t source_channel, uint32_t destination_channel,
@@ -4,6 +4,8 @@
 
 #include "../test_host.h"
 #include "debug_output.h"
+#include "fixed_function_reference.h"
+#include "mesh_generator.h"
 #include "pbkit_ext.h"
 #include "shaders/precalculated_vertex_shader.h"
 #include "vertex_buffer.h"
@@ -30,6 +32,12 @@ static constexpr LightingNormalTests::DrawMode kDrawMode[] = {
     LightingNormalTests::DRAW_INLINE_ELEMENTS,
 };
 
+static constexpr LightingNormalTests::DenseMesh kDenseMeshes[] = {
+    LightingNormalTests::DENSE_SPHERE,
+    LightingNormalTests::DENSE_CYLINDER,
+    LightingNormalTests::DENSE_TORUS,
+};
+
 LightingNormalTests::LightingNormalTests(TestHost& host, std::string output_dir)
     : TestSuite(host, std::move(output_dir), "Lighting normals") {
   for (auto draw_mode : kDrawMode) {
@@ -38,30 +46,63 @@ LightingNormalTests::LightingNormalTests(TestHost& host, std::string output_dir)
       tests_[name] = [this, params, draw_mode]() { this->Test(params.set_normal, params.normal, draw_mode); };
     }
   }
+
+  for (auto mesh : kDenseMeshes) {
+    tests_[MakeDenseMeshTestName(mesh)] = [this, mesh]() { this->TestDenseMesh(mesh); };
+  }
+}
+
+// The raw NV097_SET_SPECULAR_PARAMS values, which are not modelled by FixedFunctionState.
+static constexpr uint32_t kSpecularParams[] = {0xbf34dce5, 0xc020743f, 0x40333d06, 0xbf003612, 0xbff852a5, 0x401c1bce};
+
+// Returns the lighting state used by every test. It is both sent to the hardware by PushLightAndMaterial and given to
+// the CPU reference model.
+static FixedFunctionState MakeLightAndMaterialState() {
+  FixedFunctionState state;
+  state.lighting_enable = true;
+  state.specular_enable = true;
+  state.light_control = 0x10001;
+  state.color_material = NV097_SET_COLOR_MATERIAL_ALL_FROM_MATERIAL;
+  state.material_alpha = 1.0f;
+  state.light_enable_mask = NV097_SET_LIGHT_ENABLE_MASK_LIGHT0_INFINITE;
+
+  auto& light = state.lights[0];
+  light.diffuse[0] = 0.0f;
+  light.diffuse[1] = 1.0f;
+  light.diffuse[2] = 0.7f;
+  light.infinite_direction[0] = 0.0f;
+  light.infinite_direction[1] = 0.0f;
+  light.infinite_direction[2] = 1.0f;
+  return state;
+}
+
+static uint32_t* PushVector3(uint32_t* p, DWORD command, const VECTOR value) {
+  return pb_push3f(p, command, value[0], value[1], value[2]);
 }
 
-static void SetLightAndMaterial() {
+static void PushLightAndMaterial(const FixedFunctionState& state) {
   auto p = pb_begin();
-  p = pb_push1(p, NV097_SET_SPECULAR_PARAMS, 0xbf34dce5);
-  p = pb_push1(p, 0x09e4, 0xc020743f);
-  p = pb_push1(p, 0x09e8, 0x40333d06);
-  p = pb_push1(p, 0x09ec, 0xbf003612);
-  p = pb_push1(p, 0x09f0, 0xbff852a5);
-  p = pb_push1(p, 0x09f4, 0x401c1bce);
-
-  p = pb_push1(p, NV097_SET_COLOR_MATERIAL, NV097_SET_COLOR_MATERIAL_ALL_FROM_MATERIAL);
-  p = pb_push3(p, NV097_SET_SCENE_AMBIENT_COLOR, 0x0, 0x0, 0x0);
-  p = pb_push3(p, NV097_SET_MATERIAL_EMISSION, 0x0, 0x0, 0x0);
-  p = pb_push1f(p, NV097_SET_MATERIAL_ALPHA, 1.0f);
-
-  p = pb_push3(p, NV097_SET_LIGHT_AMBIENT_COLOR, 0, 0, 0);
-  p = pb_push3f(p, NV097_SET_LIGHT_DIFFUSE_COLOR, 0.0f, 1.0f, 0.7f);
-  p = pb_push3(p, NV097_SET_LIGHT_SPECULAR_COLOR, 0, 0, 0);
-  p = pb_push1(p, NV097_SET_LIGHT_LOCAL_RANGE, 0x7149f2ca);  // 1e30
-  p = pb_push3(p, NV097_SET_LIGHT_INFINITE_HALF_VECTOR, 0, 0, 0);
-  p = pb_push3f(p, NV097_SET_LIGHT_INFINITE_DIRECTION, 0.0f, 0.0f, 1.0f);
-
-  p = pb_push1(p, NV097_SET_LIGHT_ENABLE_MASK, NV097_SET_LIGHT_ENABLE_MASK_LIGHT0_INFINITE);
+  p = pb_push1(p, NV097_SET_LIGHTING_ENABLE, state.lighting_enable);
+  p = pb_push1(p, NV097_SET_SPECULAR_ENABLE, state.specular_enable);
+
+  for (uint32_t i = 0; i < sizeof(kSpecularParams) / sizeof(kSpecularParams[0]); ++i) {
+    p = pb_push1(p, NV097_SET_SPECULAR_PARAMS + i * 4, kSpecularParams[i]);
+  }
+
+  p = pb_push1(p, NV097_SET_COLOR_MATERIAL, state.color_material);
+  p = PushVector3(p, NV097_SET_SCENE_AMBIENT_COLOR, state.scene_ambient_color);
+  p = PushVector3(p, NV097_SET_MATERIAL_EMISSION, state.material_emission);
+  p = pb_push1f(p, NV097_SET_MATERIAL_ALPHA, state.material_alpha);
+
+  const auto& light = state.lights[0];
+  p = PushVector3(p, NV097_SET_LIGHT_AMBIENT_COLOR, light.ambient);
+  p = PushVector3(p, NV097_SET_LIGHT_DIFFUSE_COLOR, light.diffuse);
+  p = PushVector3(p, NV097_SET_LIGHT_SPECULAR_COLOR, light.specular);
+  p = pb_push1f(p, NV097_SET_LIGHT_LOCAL_RANGE, light.local_range);
+  p = PushVector3(p, NV097_SET_LIGHT_INFINITE_HALF_VECTOR, light.infinite_half_vector);
+  p = PushVector3(p, NV097_SET_LIGHT_INFINITE_DIRECTION, light.infinite_direction);
+
+  p = pb_push1(p, NV097_SET_LIGHT_ENABLE_MASK, state.light_enable_mask);
 
   pb_end(p);
 }
@@ -74,15 +115,13 @@ void LightingNormalTests::Initialize() {
   host_.SetXDKDefaultViewportAndFixedFunctionMatrices();
 
   auto p = pb_begin();
-  p = pb_push1(p, NV097_SET_LIGHTING_ENABLE, true);
-  p = pb_push1(p, NV097_SET_SPECULAR_ENABLE, true);
-
   p = pb_push1(p, NV097_SET_VERTEX_DATA4UB + (4 * NV2A_VERTEX_ATTR_SPECULAR), 0);
   p = pb_push1(p, NV097_SET_VERTEX_DATA4UB + (4 * NV2A_VERTEX_ATTR_BACK_DIFFUSE), 0xFFFFFFFF);
   p = pb_push1(p, NV097_SET_VERTEX_DATA4UB + (4 * NV2A_VERTEX_ATTR_BACK_SPECULAR), 0);
   pb_end(p);
 
-  SetLightAndMaterial();
+  light_state_ = MakeLightAndMaterialState();
+  PushLightAndMaterial(light_state_);
 }
 
 void LightingNormalTests::Deinitialize() {
@@ -156,7 +195,7 @@ void LightingNormalTests::Test(bool set_normal, const float* normal, DrawMode dr
 
   // Render the test subject with no normals but lighting enabled.
   p = pb_begin();
-  p = pb_push1(p, NV097_SET_LIGHT_CONTROL, 0x10001);
+  p = pb_push1(p, NV097_SET_LIGHT_CONTROL, light_state_.light_control);
   pb_end(p);
 
   uint32_t vertex_elements = host_.POSITION | host_.DIFFUSE;
@@ -205,6 +244,110 @@ void LightingNormalTests::Test(bool set_normal, const float* normal, DrawMode dr
 
   std::string name = MakeTestName(set_normal, normal, draw_mode);
   host_.FinishDraw(allow_saving_, output_dir_, name);
+
+  if (set_normal) {
+    SaveExpectedLitColor(normal, name);
+  }
+}
+
+void LightingNormalTests::TestDenseMesh(DenseMesh mesh) {
+  // Tessellation is chosen to produce tens of thousands of vertices per mesh while still fitting 16-bit indices.
+  static constexpr uint32_t kSegments = 192;
+  static constexpr uint32_t kRings = 96;
+  static constexpr float kCenter[] = {0.0f, 0.0f, 2.0f};
+
+  MeshStyle style;
+  style.diffuse_start = Color(0.9f, 0.3f, 0.3f);
+  style.diffuse_end = Color(0.3f, 0.3f, 0.9f);
+
+  MeshSize size;
+  switch (mesh) {
+    case DENSE_SPHERE:
+      size = GetSphereMeshSize(kSegments, kRings);
+      break;
+    case DENSE_CYLINDER:
+      size = GetCylinderMeshSize(kSegments, kRings);
+      break;
+    case DENSE_TORUS:
+      size = GetTorusMeshSize(kSegments, kRings);
+      break;
+  }
+
+  auto buffer = host_.AllocateVertexBuffer(size.num_vertices);
+  std::vector<uint32_t> indices;
+  indices.reserve(size.num_indices);
+  auto vertices = buffer->Lock();
+  switch (mesh) {
+    case DENSE_SPHERE:
+      GenerateSphereMesh(vertices, indices, kCenter, 1.75f, kSegments, kRings, style);
+      break;
+    case DENSE_CYLINDER:
+      GenerateCylinderMesh(vertices, indices, kCenter, 1.25f, 3.0f, kSegments, kRings, style);
+      break;
+    case DENSE_TORUS:
+      GenerateTorusMesh(vertices, indices, kCenter, 1.5f, 0.6f, kSegments, kRings, style);
+      break;
+  }
+  buffer->Unlock();
+
+  static constexpr uint32_t kBackgroundColor = 0xFF303030;
+  host_.PrepareDraw(kBackgroundColor);
+
+  auto p = pb_begin();
+  p = pb_push1(p, NV097_SET_SHADE_MODEL, NV097_SET_SHADE_MODEL_SMOOTH);
+  p = pb_push1(p, NV097_SET_LIGHT_CONTROL, 0x10001);
+  p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, true);
+  pb_end(p);
+
+  host_.DrawInlineElements16(indices, host_.POSITION | host_.NORMAL | host_.DIFFUSE);
+
+  p = pb_begin();
+  p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, false);
+  pb_end(p);
+
+  std::string name = MakeDenseMeshTestName(mesh);
+  pb_print("%s\n", name.c_str());
+  pb_print("%u vertices\n%u triangles\n", size.num_vertices, size.num_indices / 3);
+  pb_draw_text_screen();
+
+  host_.FinishDraw(allow_saving_, output_dir_, name);
+}
+
+std::string LightingNormalTests::MakeDenseMeshTestName(DenseMesh mesh) {
+  switch (mesh) {
+    case DENSE_SPHERE:
+      return "DenseSphere";
+    case DENSE_CYLINDER:
+      return "DenseCylinder";
+    case DENSE_TORUS:
+      return "DenseTorus";
+  }
+
+  return "DenseUnknown";
+}
+
+void LightingNormalTests::SaveExpectedLitColor(const float* normal, const std::string& name) const {
+  FixedFunctionState state = light_state_;
+  host_.CopyFixedFunctionState(state);
+
+  // The light is infinite and every color comes from the material, so the whole triangle is expected to be lit the
+  // same way as a single vertex with the reused normal.
+  Vertex vertex;
+  memset(&vertex, 0, sizeof(vertex));
+  vertex.SetPosition(0.0f, 0.0f, 0.0f);
+  vertex.SetNormal(normal);
+
+  FixedFunctionVertex expected;
+  ApplyFixedFunctionPipeline(state, &vertex, 1, &expected);
+
+  char buf[128] = {0};
+  snprintf(buf, 127, "Expected lit color: %g %g %g %g\n", expected.diffuse[0], expected.diffuse[1],
+           expected.diffuse[2], expected.diffuse[3]);
+  PrintMsg("%s", buf);
+
+  if (allow_saving_ && host_.GetSaveResults()) {
+    TestHost::SaveText(output_dir_, name, buf);
+  }
 }
 
 std::string LightingNormalTests::MakeTestName(bool set_normal, const float* normal, DrawMode draw_mode) {
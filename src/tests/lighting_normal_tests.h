@@ -4,6 +4,7 @@
 #include <memory>
 #include <vector>
 
+#include "fixed_function_reference.h"
 #include "test_suite.h"
 
 class TestHost;
@@ -20,6 +21,12 @@ class LightingNormalTests : public TestSuite {
     DRAW_INLINE_ELEMENTS,
   };
 
+  enum DenseMesh {
+    DENSE_SPHERE,
+    DENSE_CYLINDER,
+    DENSE_TORUS,
+  };
+
  public:
   LightingNormalTests(TestHost& host, std::string output_dir);
 
@@ -29,14 +36,24 @@ class LightingNormalTests : public TestSuite {
  private:
   void CreateGeometry();
   void Test(bool set_normal, const float* normal, DrawMode draw_mode);
+  // Logs the color that the CPU reference model predicts for the lit triangle if it reuses `normal` and saves it as a
+  // text file next to the image of the test named `name`.
+  void SaveExpectedLitColor(const float* normal, const std::string& name) const;
+
+  // Renders a densely tessellated, lit mesh with per-vertex normals.
+  void TestDenseMesh(DenseMesh mesh);
 
   static std::string MakeTestName(bool set_normal, const float* normal, DrawMode draw_mode);
+  static std::string MakeDenseMeshTestName(DenseMesh mesh);
 
  private:
   std::shared_ptr<VertexBuffer> normal_bleed_buffer_;
   std::shared_ptr<VertexBuffer> lit_buffer_;
 
   std::vector<uint32_t> lit_index_buffer_;
+
+  // The lighting and material state sent to the hardware, also used to predict the lit colors.
+  FixedFunctionState light_state_;
 };
 
 #endif  // NXDK_PGRAPH_TESTS_LIGHTING_NORMAL_TESTS_H
@@ -63,8 +63,8 @@ void NullSurfaceTests::TestXemuBug893() {
     p = pb_push1(
         p, NV097_SET_SURFACE_PITCH,
         SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kSurfacePitch) | SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kSurfacePitch));
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, reinterpret_cast<uint32_t>(pb_back_buffer()) & 0x03FFFFFF);
-    p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, kTextureMemory & 0x03FFFFFF);
+    p = host_.PushSurfaceColorOffset(p, reinterpret_cast<uint32_t>(pb_back_buffer()) & 0x03FFFFFF);
+    p = host_.PushSurfaceZetaOffset(p, kTextureMemory & 0x03FFFFFF);
     // Note: Enabling depth testing is critical to reproducing the bug.
     p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, 1);
     p = pb_push1(p, NV097_SET_COLOR_MASK, 0x1010101);
@@ -77,8 +77,8 @@ void NullSurfaceTests::TestXemuBug893() {
   // zeta surface.
   {
     auto p = pb_begin();
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, (kTextureMemory + kSurfacePitch) & 0x03FFFFFF);
-    p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, (kTextureMemory + kSurfacePitch) & 0x03FFFFFF);
+    p = host_.PushSurfaceZetaOffset(p, 0);
     p = pb_push1(p, NV097_SET_DEPTH_MASK, 0);
     p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, 0);
     p = pb_push1(p, NV097_SET_STENCIL_TEST_ENABLE, 0);
@@ -96,8 +96,8 @@ void NullSurfaceTests::TestXemuBug893() {
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
-    p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
+    p = host_.PushSurfaceZetaOffset(p, 0);
     p = pb_push1(p, NV097_SET_DEPTH_MASK, 1);
     p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, 0);
     p = pb_push1(p, NV097_SET_COLOR_MASK,
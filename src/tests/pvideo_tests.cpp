@@ -8,6 +8,7 @@
 #include "shaders/precalculated_vertex_shader.h"
 #include "swizzle.h"
 #include "texture_generator.h"
+#include "yuv_conversion.h"
 
 static constexpr const char kStopBehavior[] = "Stop";
 static constexpr const char kAlternateStop[] = "Stop Alt";
@@ -101,31 +102,8 @@ void PvideoTests::SetTestPatternVideoFrameCR8YB8CB8YA8(uint32_t width, uint32_t
 }
 
 void PvideoTests::SetVideoFrameCR8YB8CB8YA8(const void *pixels, uint32_t width, uint32_t height) {
-  uint8_t *row = video_;
-  uint32_t dest_pitch = host_.GetFramebufferWidth() * 2;
-
-  auto source = reinterpret_cast<const uint32_t *>(pixels);
-  for (int y = 0; y < height; ++y) {
-    uint8_t *dest = row;
-    row += dest_pitch;
-    for (int x = 0; x < width; x += 2, source += 2) {
-      float R0, G0, B0, R1, G1, B1;
-
-      R0 = static_cast<float>(source[0] & 0xFF);
-      G0 = static_cast<float>((source[0] >> 8) & 0xFF);
-      B0 = static_cast<float>((source[0] >> 16) & 0xFF);
-
-      R1 = static_cast<float>(source[1] & 0xFF);
-      G1 = static_cast<float>((source[1] >> 8) & 0xFF);
-      B1 = static_cast<float>((source[1] >> 16) & 0xFF);
-
-      dest[0] = static_cast<uint8_t>((0.257f * R0) + (0.504f * G0) + (0.098f * B0) + 16);    // Y0
-      dest[1] = static_cast<uint8_t>(-(0.148f * R1) - (0.291f * G1) + (0.439f * B1) + 128);  // U
-      dest[2] = static_cast<uint8_t>((0.257f * R1) + (0.504f * G1) + (0.098f * B1) + 16);    // Y1
-      dest[3] = static_cast<uint8_t>((0.439f * R1) - (0.368f * G1) - (0.071f * B1) + 128);   // V
-      dest += 4;
-    }
-  }
+  const uint32_t dest_pitch = host_.GetFramebufferWidth() * 2;
+  ConvertRGBToYUY2(video_, dest_pitch, reinterpret_cast<const uint32_t *>(pixels), width * 4, width, height);
 }
 
 static void ClearPvideoInterrupts() { VIDEOREG(NV_PVIDEO_INTR) = 0x00000011; }
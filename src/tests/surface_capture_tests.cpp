@@ -0,0 +1,137 @@
+#include "surface_capture_tests.h"
+
+#include <pbkit/pbkit.h>
+
+#include <memory>
+#include <utility>
+
+#include "shaders/precalculated_vertex_shader.h"
+
+#define SET_MASK(mask, val) (((val) << (__builtin_ffs(mask) - 1)) & (mask))
+
+// From pbkit.c, DMA_A is set to channel 3 by default
+// NV097_SET_CONTEXT_DMA_A == NV20_TCL_PRIMITIVE_3D_SET_OBJECT1
+static constexpr uint32_t kDefaultDMAChannelA = 3;
+
+// From pbkit.c, DMA_COLOR is set to channel 9 by default
+static constexpr uint32_t kDefaultDMAColorChannel = 9;
+
+static constexpr uint32_t kSurfaceSize = 256;
+
+static const struct {
+  TestHost::SurfaceColorFormat format;
+  const char *name;
+  uint32_t bytes_per_pixel;
+} kFormats[] = {
+    {TestHost::SCF_A8R8G8B8, "A8R8G8B8", 4},
+    {TestHost::SCF_X8R8G8B8_Z8R8G8B8, "X8R8G8B8", 4},
+    {TestHost::SCF_R5G6B5, "R5G6B5", 2},
+    {TestHost::SCF_X1R5G5B5_Z1R5G5B5, "X1R5G5B5", 2},
+};
+
+SurfaceCaptureTests::SurfaceCaptureTests(TestHost &host, std::string output_dir)
+    : TestSuite(host, std::move(output_dir), "Surface capture") {
+  for (auto &format : kFormats) {
+    std::string name = std::string("SZ_") + format.name;
+    tests_[name] = [this, name, &format]() { TestSwizzled(name, format.format, format.bytes_per_pixel, false); };
+    tests_[name + "_Tex"] = [this, name, &format]() {
+      TestSwizzled(name + "_Tex", format.format, format.bytes_per_pixel, true);
+    };
+
+    name = std::string("L_") + format.name;
+    tests_[name] = [this, name, &format]() { TestLinear(name, format.format); };
+  }
+}
+
+void SurfaceCaptureTests::Initialize() {
+  TestSuite::Initialize();
+  auto shader = std::make_shared<PrecalculatedVertexShader>();
+  host_.SetVertexShaderProgram(shader);
+
+  host_.SetFinalCombiner0Just(TestHost::SRC_DIFFUSE);
+  host_.SetFinalCombiner1Just(TestHost::SRC_DIFFUSE, true);
+}
+
+void SurfaceCaptureTests::TestSwizzled(const std::string &name, TestHost::SurfaceColorFormat format,
+                                       uint32_t bytes_per_pixel, bool texture_target) {
+  host_.PrepareDraw(0xFE202020);
+
+  if (texture_target) {
+    const uint32_t kFramebufferPitch = host_.GetFramebufferWidth() * 4;
+    auto p = pb_begin();
+    p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
+    p = pb_push1(p, NV097_SET_SURFACE_PITCH,
+                 SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kSurfaceSize * bytes_per_pixel) |
+                     SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(host_.GetTextureMemory()));
+    pb_end(p);
+  }
+
+  host_.SetSurfaceFormatImmediate(format, TestHost::SZF_Z24S8, kSurfaceSize, kSurfaceSize, true);
+
+  auto p = pb_begin();
+  p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, false);
+  p = pb_push1(p, NV097_SET_STENCIL_TEST_ENABLE, false);
+  pb_end(p);
+
+  DrawPattern(static_cast<float>(kSurfaceSize));
+
+  // The swizzled surface is intentionally left bound so that the capture has to unswizzle it.
+  host_.FinishDraw(allow_saving_, output_dir_, name);
+
+  RestoreDefaultSurface();
+}
+
+void SurfaceCaptureTests::TestLinear(const std::string &name, TestHost::SurfaceColorFormat format) {
+  host_.PrepareDraw(0xFE202020);
+
+  host_.SetSurfaceFormatImmediate(format, TestHost::SZF_Z24S8, host_.GetFramebufferWidth(),
+                                  host_.GetFramebufferHeight());
+  host_.ClearColorRegion(0xFF202020);
+
+  auto p = pb_begin();
+  p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, false);
+  p = pb_push1(p, NV097_SET_STENCIL_TEST_ENABLE, false);
+  pb_end(p);
+
+  DrawPattern(host_.GetFramebufferHeightF());
+
+  host_.FinishDraw(allow_saving_, output_dir_, name);
+
+  RestoreDefaultSurface();
+}
+
+void SurfaceCaptureTests::DrawPattern(float size) const {
+  const float half = size * 0.5f;
+  auto quad = [this](float left, float top, float right, float bottom, uint32_t top_color, uint32_t bottom_color) {
+    host_.Begin(TestHost::PRIMITIVE_QUADS);
+    host_.SetDiffuse(top_color);
+    host_.SetVertex(left, top, 0.1f, 1.0f);
+    host_.SetVertex(right, top, 0.1f, 1.0f);
+    host_.SetDiffuse(bottom_color);
+    host_.SetVertex(right, bottom, 0.1f, 1.0f);
+    host_.SetVertex(left, bottom, 0.1f, 1.0f);
+    host_.End();
+  };
+
+  // Solid quadrants identify the orientation of the capture and the channel order.
+  quad(0.0f, 0.0f, half, half, 0xFFFF0000, 0xFFFF0000);
+  quad(half, 0.0f, size, half, 0xFF00FF00, 0xFF00FF00);
+  quad(0.0f, half, half, size, 0xFF0000FF, 0xFF0000FF);
+  // A vertical gradient shows the precision of the surface format.
+  quad(half, half, size, size, 0xFFFFFFFF, 0xFF000000);
+}
+
+void SurfaceCaptureTests::RestoreDefaultSurface() const {
+  const uint32_t kFramebufferPitch = host_.GetFramebufferWidth() * 4;
+  auto p = pb_begin();
+  p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
+  p = host_.PushSurfaceColorOffset(p, 0);
+  p = pb_push1(p, NV097_SET_SURFACE_PITCH,
+               SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
+                   SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
+  pb_end(p);
+
+  host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z24S8, host_.GetFramebufferWidth(),
+                                  host_.GetFramebufferHeight());
+}
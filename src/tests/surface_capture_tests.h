@@ -0,0 +1,30 @@
+#ifndef NXDK_PGRAPH_TESTS_SURFACE_CAPTURE_TESTS_H
+#define NXDK_PGRAPH_TESTS_SURFACE_CAPTURE_TESTS_H
+
+#include <string>
+
+#include "test_host.h"
+#include "test_suite.h"
+
+// Saves results while non-default color surfaces are still bound, exercising the conversions done by
+// TestHost::FinishDraw for swizzled and low bit depth surfaces.
+class SurfaceCaptureTests : public TestSuite {
+ public:
+  SurfaceCaptureTests(TestHost &host, std::string output_dir);
+  void Initialize() override;
+
+ private:
+  // Renders into a swizzled surface of the given format, either in the back buffer or in texture memory, and saves
+  // without restoring the default surface.
+  void TestSwizzled(const std::string &name, TestHost::SurfaceColorFormat format, uint32_t bytes_per_pixel,
+                    bool texture_target);
+  // Renders into the back buffer with a linear surface of the given format and saves.
+  void TestLinear(const std::string &name, TestHost::SurfaceColorFormat format);
+
+  // Draws a pattern of solid and interpolated quads covering a `size` x `size` region.
+  void DrawPattern(float size) const;
+
+  void RestoreDefaultSurface() const;
+};
+
+#endif  // NXDK_PGRAPH_TESTS_SURFACE_CAPTURE_TESTS_H
@@ -103,7 +103,7 @@ void SurfaceClipTests::TestRenderTarget(const ClipRect &rect) {
   {
     auto p = pb_begin();
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, reinterpret_cast<uint32_t>(host_.GetTextureMemory()) & 0x03FFFFFF);
+    p = host_.PushSurfaceColorOffset(p, reinterpret_cast<uint32_t>(host_.GetTextureMemory()) & 0x03FFFFFF);
 
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, host_.GetFramebufferWidth() * 2) |
@@ -141,7 +141,7 @@ void SurfaceClipTests::TestRenderTarget(const ClipRect &rect) {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     pb_end(p);
     host_.SetSurfaceFormat(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z24S8, host_.GetFramebufferWidth(),
                            host_.GetFramebufferHeight(), false);
@@ -54,12 +54,12 @@ void SurfacePitchTests::TestSwizzle() {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kTexturePitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(kTextureMemory));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(kTextureMemory));
     pb_end(p);
 
     for (auto addr : kTextureTargets) {
       auto p = pb_begin();
-      p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(addr));
+      p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(addr));
       pb_end(p);
 
       host_.Begin(TestHost::PRIMITIVE_QUADS);
@@ -86,7 +86,7 @@ void SurfacePitchTests::TestSwizzle() {
 
     auto p = pb_begin();
     p = pb_push1(p, NV097_SET_TEXTURE_OFFSET, VRAM_ADDR(kInnerTextureMemory));
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(color_surface_addr));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(color_surface_addr));
     pb_end(p);
 
     host_.Begin(TestHost::PRIMITIVE_QUADS);
@@ -174,7 +174,7 @@ void SurfacePitchTests::DrawResults(const uint32_t *result_textures, const uint3
   {
     auto p = pb_begin();
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
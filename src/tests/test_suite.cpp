@@ -80,6 +80,8 @@ void TestSuite::SetDefaultTextureFormat() const {
 }
 
 void TestSuite::Initialize() {
+  host_.CompactTextureMemory();
+
   const uint32_t kFramebufferPitch = host_.GetFramebufferWidth() * 4;
   host_.SetSurfaceFormat(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z16, host_.GetFramebufferWidth(),
                          host_.GetFramebufferHeight());
@@ -240,12 +242,27 @@ void TestSuite::Initialize() {
 
   host_.ClearAllVertexAttributeStrideOverrides();
 
+  host_.InvalidateTextureUploadCache();
+  host_.ResetTextureUploadCacheStats();
+
 #ifdef ENABLE_PGRAPH_REGION_DIFF
   pgraph_diff_.Capture();
 #endif
 }
 
 void TestSuite::Deinitialize() {
+  const auto &cache_stats = host_.GetTextureUploadCacheStats();
+  if (cache_stats.hits || cache_stats.misses) {
+    PrintMsg("%s: texture upload cache %u hits, %u misses\n", suite_name_.c_str(), cache_stats.hits,
+             cache_stats.misses);
+#ifdef ENABLE_PROGRESS_LOG
+    if (allow_saving_) {
+      Logger::Log() << suite_name_ << ": texture upload cache " << cache_stats.hits << " hits, " << cache_stats.misses
+                    << " misses" << std::endl;
+    }
+#endif
+  }
+
 #ifdef ENABLE_PGRAPH_REGION_DIFF
   pgraph_diff_.DumpDiff();
 #endif
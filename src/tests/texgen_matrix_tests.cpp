@@ -154,12 +154,9 @@ void TexgenMatrixTests::Initialize() {
   texture_stage.SetBorderColor(0xFF7F007F);
   texture_stage.SetTextureDimensions(kTextureWidth, kTextureHeight);
 
-  SDL_Surface *gradient_surface;
-  int update_texture_result = GenerateSurface(&gradient_surface, kTextureWidth, kTextureHeight);
-  ASSERT(!update_texture_result && "Failed to generate SDL surface");
-  update_texture_result = host_.SetTexture(gradient_surface, 0);
-  SDL_FreeSurface(gradient_surface);
-  ASSERT(!update_texture_result && "Failed to set texture");
+  int update_texture_result = GenerateGradientTexture(host_.GetTextureMemoryForStage(0), kTextureWidth, kTextureHeight,
+                                                      host_.GetTextureStage(0).GetFormat());
+  ASSERT(!update_texture_result && "Failed to generate texture");
 
   host_.SetCombinerControl(1, true, true);
   host_.SetFinalCombiner0Just(TestHost::SRC_TEX0);
@@ -109,13 +109,11 @@ void TextureBorderTests::Initialize() {
 
   // Generate a borderless texture as tex0
   {
-    host_.SetTextureFormat(GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8R8G8B8));
-    SDL_Surface *surface;
-    auto update_texture_result = GenerateColoredCheckerboardSurface(&surface, kTextureWidth, kTextureHeight, 2);
-    ASSERT(!update_texture_result && "Failed to generate SDL surface");
-    update_texture_result = host_.SetTexture(surface);
-    SDL_FreeSurface(surface);
-    ASSERT(!update_texture_result && "Failed to set texture");
+    const TextureFormatInfo &format = GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8R8G8B8);
+    host_.SetTextureFormat(format);
+    auto update_texture_result =
+        GenerateColoredCheckerboardTexture(host_.GetTextureMemoryForStage(0), kTextureWidth, kTextureHeight, format, 2);
+    ASSERT(!update_texture_result && "Failed to generate texture");
   }
 
   // Generate a 4 texel bordered texture as tex1
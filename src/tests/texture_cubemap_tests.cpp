@@ -1,7 +1,6 @@
 #include "texture_cubemap_tests.h"
 
 #include <SDL.h>
-#include <SDL_image.h>
 #include <pbkit/pbkit.h>
 
 #include <memory>
@@ -110,13 +109,13 @@ void TextureCubemapTests::Initialize() {
 
   // Load the normal map into stage0
   {
-    SDL_Surface *normal_map = IMG_Load("D:\\texture_cubemap\\cube_normals_object_space.png");
-    ASSERT(normal_map && "Failed to load normal map");
+    auto normal_map = host_.GetResourcePack().Find("texture_cubemap/cube_normals_object_space.png");
+    ASSERT(normal_map && normal_map->format == ResourcePack::FORMAT_ABGR8888 && normal_map->swizzled &&
+           "Failed to load normal map");
     auto &stage = host_.GetTextureStage(0);
-    stage.SetTextureDimensions(normal_map->w, normal_map->h);
+    stage.SetTextureDimensions(normal_map->width, normal_map->height);
     host_.SetTextureFormat(GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8B8G8R8), 0);
-    host_.SetTexture(normal_map);
-    SDL_free(normal_map);
+    host_.SetResourceTexture(*normal_map);
   }
 
   // Load the cube map into stage3
@@ -6,21 +6,21 @@
 #include <memory>
 #include <utility>
 
-#include "dds_image.h"
 #include "debug_output.h"
+#include "resource_pack.h"
 #include "shaders/precalculated_vertex_shader.h"
 #include "test_host.h"
 
-static constexpr const char kAlphaDXT1[] = "D:\\dxt_images\\plasma_alpha_dxt1.dds";
-static constexpr const char kAlphaDXT3[] = "D:\\dxt_images\\plasma_alpha_dxt3.dds";
-static constexpr const char kAlphaDXT5[] = "D:\\dxt_images\\plasma_alpha_dxt5.dds";
-static constexpr const char kOpaqueDXT1[] = "D:\\dxt_images\\plasma_dxt1.dds";
-static constexpr const char kOpaqueDXT3[] = "D:\\dxt_images\\plasma_dxt3.dds";
-static constexpr const char kOpaqueDXT5[] = "D:\\dxt_images\\plasma_dxt5.dds";
+static constexpr const char kAlphaDXT1[] = "dxt_images/plasma_alpha_dxt1.dds";
+static constexpr const char kAlphaDXT3[] = "dxt_images/plasma_alpha_dxt3.dds";
+static constexpr const char kAlphaDXT5[] = "dxt_images/plasma_alpha_dxt5.dds";
+static constexpr const char kOpaqueDXT1[] = "dxt_images/plasma_dxt1.dds";
+static constexpr const char kOpaqueDXT3[] = "dxt_images/plasma_dxt3.dds";
+static constexpr const char kOpaqueDXT5[] = "dxt_images/plasma_dxt5.dds";
 
-static constexpr const char kOpaqueDXT1NonSquare[] = "D:\\dxt_images\\64x256_bands_dxt1.dds";
-static constexpr const char kOpaqueDXT3NonSquare[] = "D:\\dxt_images\\64x256_bands_dxt3.dds";
-static constexpr const char kOpaqueDXT5NonSquare[] = "D:\\dxt_images\\64x256_bands_dxt5.dds";
+static constexpr const char kOpaqueDXT1NonSquare[] = "dxt_images/64x256_bands_dxt1.dds";
+static constexpr const char kOpaqueDXT3NonSquare[] = "dxt_images/64x256_bands_dxt3.dds";
+static constexpr const char kOpaqueDXT5NonSquare[] = "dxt_images/64x256_bands_dxt5.dds";
 
 struct TestCase {
   const char *filename;
@@ -43,6 +43,7 @@ static constexpr TestCase kNonSquareTestCases[] = {
 };
 
 static std::string GetFormatName(TextureFormatDXTTests::CompressedTextureFormat texture_format);
+static uint32_t GetNV2AFormat(const ResourcePack::Entry &entry);
 
 TextureFormatDXTTests::TextureFormatDXTTests(TestHost &host, std::string output_dir)
     : TestSuite(host, std::move(output_dir), "Texture DXT") {
@@ -69,39 +70,56 @@ void TextureFormatDXTTests::Initialize() {
   host_.SetShaderStageProgram(TestHost::STAGE_2D_PROJECTIVE);
   host_.SetFinalCombiner0Just(TestHost::SRC_TEX0);
   host_.SetFinalCombiner1Just(TestHost::SRC_TEX0, true);
-}
 
-void TextureFormatDXTTests::Test(const char *filename, CompressedTextureFormat texture_format) {
-  host_.PrepareDraw(0xFE101010);
-
-  DDSImage img;
-  bool loaded = img.LoadFile(filename);
-  ASSERT(loaded && "Failed to load test image from file.");
+  // Each image is drawn by several tests, so it is uploaded once and the tests only rebind it.
+  auto upload = [this](const TestCase &test) {
+    if (textures_.count(test.filename)) {
+      return;
+    }
+
+    auto image = host_.GetResourcePack().Find(test.filename);
+    ASSERT(image && "Failed to load test image from resource pack.");
+    const TestHost::TextureHandle handle = host_.AllocateTexture(image->size);
+    ASSERT(handle != TextureMemoryAllocator::kInvalidHandle && "Texture arena exhausted.");
+
+    host_.BindTexture(handle);
+    int err = host_.SetResourceTexture(*image);
+    ASSERT(!err && "Failed to set texture");
+    textures_[test.filename] = handle;
+  };
+  for (auto &test : kTestCases) {
+    upload(test);
+  }
+  for (auto &test : kNonSquareTestCases) {
+    upload(test);
+  }
+  host_.UnbindTexture();
+}
 
-  auto data = img.GetPrimaryImage();
-  uint32_t nv2a_format = 0;
-  switch (data->format) {
-    case DDSImage::SubImage::Format::DXT1:
-      nv2a_format = NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT1_A1R5G5B5;
-      break;
+void TextureFormatDXTTests::Deinitialize() {
+  for (auto &entry : textures_) {
+    host_.FreeTexture(entry.second);
+  }
+  textures_.clear();
+  TestSuite::Deinitialize();
+}
 
-    case DDSImage::SubImage::Format::DXT3:
-      nv2a_format = NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8;
-      break;
+const ResourcePack::Entry &TextureFormatDXTTests::BindImage(const char *filename) {
+  auto image = host_.GetResourcePack().Find(filename);
+  auto texture = textures_.find(filename);
+  ASSERT(image && texture != textures_.end() && "Image was not uploaded by Initialize.");
 
-    case DDSImage::SubImage::Format::DXT5:
-      nv2a_format = NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8;
-      break;
+  host_.BindTexture(texture->second);
+  auto &texture_stage = host_.GetTextureStage(0);
+  texture_stage.SetFormat(GetTextureFormatInfo(GetNV2AFormat(*image)));
+  texture_stage.SetTextureDimensions(image->width, image->height);
+  return *image;
+}
 
-    default:
-      ASSERT(!"Unimplemented subimage format.");
-  }
+void TextureFormatDXTTests::Test(const char *filename, CompressedTextureFormat texture_format) {
+  host_.PrepareDraw(0xFE101010);
 
-  auto &texture_stage = host_.GetTextureStage(0);
-  texture_stage.SetFormat(GetTextureFormatInfo(nv2a_format));
-  texture_stage.SetTextureDimensions(data->width, data->height);
-  host_.SetRawTexture(data->data.data(), data->compressed_width, data->compressed_height, data->depth, data->pitch,
-                      data->bytes_per_pixel, false);
+  BindImage(filename);
   host_.SetupTextureStages();
 
   {
@@ -136,42 +154,10 @@ void TextureFormatDXTTests::TestMipmap(const char *filename,
                                        TextureFormatDXTTests::CompressedTextureFormat texture_format) {
   host_.PrepareDraw(0xFE101010);
 
-  DDSImage img;
-  bool loaded = img.LoadFile(filename, true);
-  ASSERT(loaded && "Failed to load test image from file.");
-
-  auto primary_image = img.GetPrimaryImage();
-  uint32_t nv2a_format = 0;
-  switch (primary_image->format) {
-    case DDSImage::SubImage::Format::DXT1:
-      nv2a_format = NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT1_A1R5G5B5;
-      break;
-
-    case DDSImage::SubImage::Format::DXT3:
-      nv2a_format = NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8;
-      break;
-
-    case DDSImage::SubImage::Format::DXT5:
-      nv2a_format = NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8;
-      break;
-
-    default:
-      ASSERT(!"Unimplemented subimage format.");
-  }
-
+  const auto &image = BindImage(filename);
   auto &texture_stage = host_.GetTextureStage(0);
-  texture_stage.SetFormat(GetTextureFormatInfo(nv2a_format));
-  texture_stage.SetTextureDimensions(primary_image->width, primary_image->height);
   texture_stage.SetFilter(0, TextureStage::K_QUINCUNX, TextureStage::MIN_TENT_TENT_LOD);
-
-  texture_stage.SetMipMapLevels(img.NumLevels());
-
-  uint8_t *texture_ram = host_.GetTextureMemoryForStage(0);
-  for (auto &subimage : img.GetSubImages()) {
-    uint32_t size = subimage->pitch * subimage->compressed_height * subimage->depth;
-    memcpy(texture_ram, subimage->data.data(), size);
-    texture_ram += size;
-  }
+  texture_stage.SetMipMapLevels(image.levels);
   host_.SetupTextureStages();
 
   auto draw = [this](float left, float top, float size) {
@@ -225,12 +211,29 @@ static std::string GetFormatName(TextureFormatDXTTests::CompressedTextureFormat
   }
 }
 
+static uint32_t GetNV2AFormat(const ResourcePack::Entry &entry) {
+  switch (entry.format) {
+    case ResourcePack::FORMAT_DXT1:
+      return NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT1_A1R5G5B5;
+
+    case ResourcePack::FORMAT_DXT3:
+      return NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8;
+
+    case ResourcePack::FORMAT_DXT5:
+      return NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8;
+
+    default:
+      ASSERT(!"Unimplemented resource format.");
+      return 0;
+  }
+}
+
 std::string TextureFormatDXTTests::MakeTestName(const std::string &filename, CompressedTextureFormat texture_format,
                                                 bool mipmap) {
   std::string test_name = mipmap ? "MIP" : "";
   test_name += GetFormatName(texture_format);
 
-  const auto begin = filename.rfind('\\');
+  const auto begin = filename.rfind('/');
   const auto end = filename.rfind('.');
   ASSERT(begin != filename.npos && end != filename.npos && "Invalid filename");
   test_name += "_" + filename.substr(begin + 1, end - begin - 1);
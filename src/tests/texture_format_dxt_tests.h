@@ -1,6 +1,7 @@
 #ifndef NXDK_PGRAPH_TESTS_TEXTURE_FORMAT_DXT_TESTS_H
 #define NXDK_PGRAPH_TESTS_TEXTURE_FORMAT_DXT_TESTS_H
 
+#include <map>
 #include <string>
 
 #include "test_host.h"
@@ -19,12 +20,20 @@ class TextureFormatDXTTests : public TestSuite {
  public:
   TextureFormatDXTTests(TestHost &host, std::string output_dir);
   void Initialize() override;
+  void Deinitialize() override;
 
  private:
+  // Binds the resident copy of the given image to stage 0 and sets the stage's format and dimensions to match.
+  const ResourcePack::Entry &BindImage(const char *filename);
+
   void Test(const char *filename, CompressedTextureFormat texture_format);
   void TestMipmap(const char *filename, CompressedTextureFormat texture_format);
   static std::string MakeTestName(const std::string &filename, CompressedTextureFormat texture_format,
                                   bool mipmap = false);
+
+ private:
+  // Every image is uploaded into the texture arena once by Initialize, keyed by filename.
+  std::map<std::string, TestHost::TextureHandle> textures_;
 };
 
 #endif  // NXDK_PGRAPH_TESTS_TEXTURE_FORMAT_DXT_TESTS_H
@@ -12,9 +12,9 @@
 #include "shaders/precalculated_vertex_shader.h"
 #include "test_host.h"
 #include "texture_format.h"
+#include "texture_generator.h"
 #include "vertex_buffer.h"
 
-static int GenerateGradientSurface(SDL_Surface **gradient_surface, int width, int height);
 static int GeneratePalettizedGradientSurface(uint8_t **gradient_surface, int width, int height,
                                              TestHost::PaletteSize size);
 static uint32_t *GeneratePalette(TestHost::PaletteSize size);
@@ -29,11 +29,6 @@ static const TestHost::PaletteSize kPaletteSizes[] = {
 static bool RequiresSpecialTest(const TextureFormatInfo &format) {
   switch (format.xbox_format) {
     case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_I8_A8R8G8B8:
-    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FIXED:
-    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FLOAT:
-    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FIXED:
-    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8:
-    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8:
       return true;
 
     default:
@@ -49,16 +44,22 @@ TextureFormatTests::TextureFormatTests(TestHost &host, std::string output_dir)
       std::string name = MakeTestName(format);
       tests_[name] = [this, format]() { Test(format); };
 
-      //      if (format.xbox_swizzled) {
-      //        std::string mip_name = MakeTestName(format, true);
-      //        tests_[mip_name] = [this, format]() { TestMipMap(format); };
-      //      }
+      // The hardware only supports mipmaps for swizzled and compressed textures.
+      if (!format.xbox_linear) {
+        std::string mip_name = MakeTestName(format, true);
+        tests_[mip_name] = [this, format]() { TestMipMap(format); };
+      }
     }
   }
 
   for (auto size : kPaletteSizes) {
     std::string name = MakePalettizedTestName(size);
     tests_[name] = [this, size]() { TestPalettized(size); };
+
+    for (auto dither : {false, true}) {
+      name = MakePalettizedImageTestName(size, dither);
+      tests_[name] = [this, size, dither]() { TestPalettizedImage(size, dither); };
+    }
   }
 }
 
@@ -85,14 +86,21 @@ void TextureFormatTests::Test(const TextureFormatInfo &texture_format) {
   host_.SetTextureFormat(texture_format);
   std::string test_name = MakeTestName(texture_format);
 
-  SDL_Surface *gradient_surface;
-  int update_texture_result =
-      GenerateGradientSurface(&gradient_surface, (int)host_.GetMaxTextureWidth(), (int)host_.GetMaxTextureHeight());
-  ASSERT(!update_texture_result && "Failed to generate SDL surface");
-
-  update_texture_result = host_.SetTexture(gradient_surface);
-  SDL_FreeSurface(gradient_surface);
-  ASSERT(!update_texture_result && "Failed to set texture");
+  if (!texture_format.require_conversion) {
+    int update_texture_result = GenerateGradientTexture(
+        host_.GetTextureMemoryForStage(0), host_.GetMaxTextureWidth(), host_.GetMaxTextureHeight(), texture_format);
+    ASSERT(!update_texture_result && "Failed to generate texture");
+  } else {
+    // Formats with custom conversions are generated as an SDL surface and converted by the TextureStage.
+    auto gradient = GetGradientImage(host_.GetMaxTextureWidth(), host_.GetMaxTextureHeight());
+    SDL_Surface *gradient_surface;
+    int update_texture_result = CreateSurfaceFromImage(&gradient_surface, *gradient);
+    ASSERT(!update_texture_result && "Failed to create SDL surface");
+
+    update_texture_result = host_.SetTexture(gradient_surface);
+    SDL_FreeSurface(gradient_surface);
+    ASSERT(!update_texture_result && "Failed to set texture");
+  }
 
   host_.PrepareDraw(0xFE202020);
   host_.DrawArrays();
@@ -107,6 +115,9 @@ void TextureFormatTests::Test(const TextureFormatInfo &texture_format) {
   pb_draw_text_screen();
 
   host_.FinishDraw(allow_saving_, output_dir_, test_name);
+#ifdef SAVE_SOURCE_TEXTURES
+  SaveSourceTexture(texture_format, test_name);
+#endif
 }
 
 void TextureFormatTests::TestPalettized(TestHost::PaletteSize size) {
@@ -149,71 +160,123 @@ void TextureFormatTests::TestPalettized(TestHost::PaletteSize size) {
   host_.FinishDraw(allow_saving_, output_dir_, test_name);
 }
 
-// TODO: Implement mipmap generation and fully populate the texture.
-// void TextureFormatTests::TestMipMap(const TextureFormatInfo &texture_format) {
-//  auto shader = std::make_shared<PrecalculatedVertexShader>();
-//  host_.SetVertexShaderProgram(shader);
-//
-//  host_.SetTextureFormat(texture_format);
-//  std::string test_name = MakeTestName(texture_format, true);
-//
-//  SDL_Surface *gradient_surface;
-//  int update_texture_result =
-//      GenerateGradientSurface(&gradient_surface, (int)host_.GetMaxTextureWidth(), (int)host_.GetMaxTextureHeight());
-//  ASSERT(!update_texture_result && "Failed to generate SDL surface");
-//
-//  update_texture_result = host_.SetTexture(gradient_surface);
-//  SDL_FreeSurface(gradient_surface);
-//  ASSERT(!update_texture_result && "Failed to set texture");
-//
-//  auto &texture_stage = host_.GetTextureStage(0);
-//  texture_stage.SetFilter(0, TextureStage::K_QUINCUNX, TextureStage::MIN_TENT_TENT_LOD);
-//  host_.SetupTextureStages();
-//
-//  host_.PrepareDraw(0xFE202020);
-//
-//  auto draw = [this](float left, float top, float size) {
-//    float right = left + size;
-//    float bottom = top + size;
-//
-//    host_.Begin(TestHost::PRIMITIVE_QUADS);
-//    host_.SetTexCoord0(0.0f, 0.0f);
-//    host_.SetVertex(left, top, 0.1f, 1.0f);
-//
-//    host_.SetTexCoord0(1.0f, 0.0f);
-//    host_.SetVertex(right, top, 0.1f, 1.0f);
-//
-//    host_.SetTexCoord0(1.0f, 1.0f);
-//    host_.SetVertex(right, bottom, 0.1f, 1.0f);
-//
-//    host_.SetTexCoord0(0.0f, 1.0f);
-//    host_.SetVertex(left, bottom, 0.1f, 1.0f);
-//    host_.End();
-//  };
-//
-//  draw(5.0f, 80.0f, 256.0f);
-//  draw(270.0f, 80.0f, 128.0f);
-//  draw(410.0f, 80.0f, 64.0f);
-//  draw(480.0f, 80.0f, 32.0f);
-//  draw(520.0f, 80.0f, 16.0f);
-//  draw(270.0f, 220.0f, 8.0f);
-//  draw(280.0f, 220.0f, 4.0f);
-//  draw(290.0f, 220.0f, 2.0f);
-//  draw(300.0f, 220.0f, 1.0f);
-//
-//  texture_stage.SetMipMapLevels(1);
-//
-//  pb_print("N: %s\n", test_name.c_str());
-//  pb_print("F: 0x%x\n", texture_format.xbox_format);
-//  pb_print("SZ: %d\n", texture_format.xbox_swizzled);
-//  pb_print("C: %d\n", texture_format.require_conversion);
-//  pb_print("W: %d\n", host_.GetMaxTextureWidth());
-//  pb_print("H: %d\n", host_.GetMaxTextureHeight());
-//  pb_print("P: %d\n", texture_format.xbox_bpp * host_.GetMaxTextureWidth() / 8);
-//  pb_draw_text_screen();
-//
-//  host_.FinishDraw(allow_saving_, output_dir_, test_name);
-//}
+void TextureFormatTests::TestPalettizedImage(TestHost::PaletteSize size, bool dither) {
+  auto shader = std::make_shared<PerspectiveVertexShader>(host_.GetFramebufferWidth(), host_.GetFramebufferHeight());
+  shader->SetLightingEnabled(false);
+  host_.SetVertexShaderProgram(shader);
+
+  auto &texture_format = GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_I8_A8R8G8B8);
+  host_.SetTextureFormat(texture_format);
+  std::string test_name = MakePalettizedImageTestName(size, dither);
+
+  auto image = host_.GetResourcePack().Find("image_blit/TestImage.png");
+  ASSERT(image && image->format == ResourcePack::FORMAT_ARGB8888 && !image->swizzled && "Missing test image");
+
+  auto &texture_stage = host_.GetTextureStage(0);
+  texture_stage.SetTextureDimensions(image->width, image->height);
+  int err = host_.SetPalettizedTexture(reinterpret_cast<const uint32_t *>(host_.GetResourcePack().GetData(*image)),
+                                       image->width, image->height, image->pitch, size, dither);
+  ASSERT(!err && "Failed to set palettized texture");
+
+  host_.PrepareDraw(0xFE202020);
+  host_.DrawArrays();
+
+  pb_print("N: %s\n", texture_format.name);
+  pb_print("Ps: %d\n", size);
+  pb_print("Dither: %d\n", dither);
+  pb_print("W: %d\n", image->width);
+  pb_print("H: %d\n", image->height);
+  pb_draw_text_screen();
+
+  host_.FinishDraw(allow_saving_, output_dir_, test_name);
+
+  texture_stage.SetTextureDimensions(host_.GetMaxTextureWidth(), host_.GetMaxTextureHeight());
+}
+
+void TextureFormatTests::TestMipMap(const TextureFormatInfo &texture_format) {
+  auto shader = std::make_shared<PrecalculatedVertexShader>();
+  host_.SetVertexShaderProgram(shader);
+
+  host_.SetTextureFormat(texture_format);
+  std::string test_name = MakeTestName(texture_format, true);
+
+  auto gradient = GetGradientImage(host_.GetMaxTextureWidth(), host_.GetMaxTextureHeight());
+  SDL_Surface *gradient_surface;
+  int update_texture_result = CreateSurfaceFromImage(&gradient_surface, *gradient);
+  ASSERT(!update_texture_result && "Failed to create SDL surface");
+
+  update_texture_result = host_.SetMipmappedTexture(gradient_surface);
+  SDL_FreeSurface(gradient_surface);
+  ASSERT(!update_texture_result && "Failed to set texture");
+
+  auto &texture_stage = host_.GetTextureStage(0);
+  texture_stage.SetFilter(0, TextureStage::K_QUINCUNX, TextureStage::MIN_TENT_TENT_LOD);
+  host_.SetupTextureStages();
+
+  host_.PrepareDraw(0xFE202020);
+
+  auto draw = [this](float left, float top, float size) {
+    float right = left + size;
+    float bottom = top + size;
+
+    host_.Begin(TestHost::PRIMITIVE_QUADS);
+    host_.SetTexCoord0(0.0f, 0.0f);
+    host_.SetVertex(left, top, 0.1f, 1.0f);
+
+    host_.SetTexCoord0(1.0f, 0.0f);
+    host_.SetVertex(right, top, 0.1f, 1.0f);
+
+    host_.SetTexCoord0(1.0f, 1.0f);
+    host_.SetVertex(right, bottom, 0.1f, 1.0f);
+
+    host_.SetTexCoord0(0.0f, 1.0f);
+    host_.SetVertex(left, bottom, 0.1f, 1.0f);
+    host_.End();
+  };
+
+  draw(5.0f, 80.0f, 256.0f);
+  draw(270.0f, 80.0f, 128.0f);
+  draw(410.0f, 80.0f, 64.0f);
+  draw(480.0f, 80.0f, 32.0f);
+  draw(520.0f, 80.0f, 16.0f);
+  draw(270.0f, 220.0f, 8.0f);
+  draw(280.0f, 220.0f, 4.0f);
+  draw(290.0f, 220.0f, 2.0f);
+  draw(300.0f, 220.0f, 1.0f);
+
+  const uint32_t levels = texture_stage.GetMipMapLevels();
+  texture_stage.SetMipMapLevels(1);
+  texture_stage.SetFilter();
+
+  pb_print("N: %s\n", test_name.c_str());
+  pb_print("F: 0x%x\n", texture_format.xbox_format);
+  pb_print("SZ: %d\n", texture_format.xbox_swizzled);
+  pb_print("C: %d\n", texture_format.require_conversion);
+  pb_print("W: %d\n", host_.GetMaxTextureWidth());
+  pb_print("H: %d\n", host_.GetMaxTextureHeight());
+  pb_print("P: %d\n", texture_format.xbox_bpp * host_.GetMaxTextureWidth() / 8);
+  pb_draw_text_screen();
+
+  host_.FinishDraw(allow_saving_, output_dir_, test_name);
+#ifdef SAVE_SOURCE_TEXTURES
+  SaveSourceTexture(texture_format, test_name, levels);
+#endif
+}
+
+#ifdef SAVE_SOURCE_TEXTURES
+void TextureFormatTests::SaveSourceTexture(const TextureFormatInfo &texture_format, const std::string &test_name,
+                                           uint32_t levels) {
+  if (!allow_saving_ || !host_.GetSaveResults()) {
+    return;
+  }
+
+  // Keeps the exact texels that were sampled alongside the rendered result. Formats without a DDS equivalent are
+  // reported and skipped.
+  TestHost::SaveTextureDDS(output_dir_, test_name + "_Tex", host_.GetTextureMemoryForStage(0),
+                           texture_format.xbox_format, host_.GetMaxTextureWidth(), host_.GetMaxTextureHeight(), 1,
+                           levels);
+}
+#endif
 
 std::string TextureFormatTests::MakeTestName(const TextureFormatInfo &texture_format, bool mipmap) {
   std::string test_name = mipmap ? "Mip_" : "TexFmt_";
@@ -237,30 +300,16 @@ std::string TextureFormatTests::MakePalettizedTestName(TestHost::PaletteSize siz
   return std::move(test_name);
 }
 
-static int GenerateGradientSurface(SDL_Surface **gradient_surface, int width, int height) {
-  *gradient_surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888);
-  if (!(*gradient_surface)) {
-    return 1;
-  }
-
-  if (SDL_LockSurface(*gradient_surface)) {
-    SDL_FreeSurface(*gradient_surface);
-    *gradient_surface = nullptr;
-    return 2;
-  }
-
-  auto pixels = static_cast<uint32_t *>((*gradient_surface)->pixels);
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x, ++pixels) {
-      int x_normal = static_cast<int>(static_cast<float>(x) * 255.0f / static_cast<float>(width));
-      int y_normal = static_cast<int>(static_cast<float>(y) * 255.0f / static_cast<float>(height));
-      *pixels = SDL_MapRGBA((*gradient_surface)->format, y_normal, x_normal, 255 - y_normal, x_normal + y_normal);
-    }
-  }
+std::string TextureFormatTests::MakePalettizedImageTestName(TestHost::PaletteSize size, bool dither) {
+  std::string test_name = "TexFmt_";
+  auto &fmt = GetTextureFormatInfo(NV097_SET_TEXTURE_FORMAT_COLOR_SZ_I8_A8R8G8B8);
+  test_name += fmt.name;
 
-  SDL_UnlockSurface(*gradient_surface);
+  char buf[32] = {0};
+  snprintf(buf, 31, "_img_p%d%s", size, dither ? "_dither" : "");
+  test_name += buf;
 
-  return 0;
+  return std::move(test_name);
 }
 
 static int GeneratePalettizedGradientSurface(uint8_t **gradient_surface, int width, int height,
@@ -18,11 +18,18 @@ class TextureFormatTests : public TestSuite {
   void CreateGeometry();
 
   void Test(const TextureFormatInfo &texture_format);
-  //  void TestMipMap(const TextureFormatInfo &texture_format);
+  void TestMipMap(const TextureFormatInfo &texture_format);
   void TestPalettized(TestHost::PaletteSize size);
+  void TestPalettizedImage(TestHost::PaletteSize size, bool dither);
+
+#ifdef SAVE_SOURCE_TEXTURES
+  // Saves the texture of stage 0 as a DDS file next to the rendered result.
+  void SaveSourceTexture(const TextureFormatInfo &texture_format, const std::string &test_name, uint32_t levels = 1);
+#endif
 
   static std::string MakeTestName(const TextureFormatInfo &texture_format, bool mipmap = false);
   static std::string MakePalettizedTestName(TestHost::PaletteSize size);
+  static std::string MakePalettizedImageTestName(TestHost::PaletteSize size, bool dither);
 };
 
 #endif  // NXDK_PGRAPH_TESTS_TEXTURE_FORMAT_TESTS_H
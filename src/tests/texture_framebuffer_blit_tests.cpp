@@ -97,8 +97,8 @@ void TextureFramebufferBlitTests::Deinitialize() {
   auto p = pb_begin();
   p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
   p = pb_push1(p, NV097_SET_CONTEXT_DMA_ZETA, kDefaultDMAZetaChannel);
-  p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
-  p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, 0);
+  p = host_.PushSurfaceColorOffset(p, 0);
+  p = host_.PushSurfaceZetaOffset(p, 0);
   // Note: Leaving arbitrary offsets for these values will lead to a color buffer limit error in the two_d_line_tests.
   p = pb_push1_to(SUBCH_CLASS_62, p, NV062_SET_OFFSET_SOURCE, 0);
   p = pb_push1_to(SUBCH_CLASS_62, p, NV062_SET_OFFSET_DESTIN, 0);
@@ -234,7 +234,7 @@ void TextureFramebufferBlitTests::TestRenderTarget(const char* test_name) {
   p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, pitch) | SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, pitch));
   p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, texture_target_ctx_.ChannelID);
-  p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, reinterpret_cast<uint32_t>(target) & 0x03FFFFFF);
+  p = host_.PushSurfaceColorOffset(p, reinterpret_cast<uint32_t>(target) & 0x03FFFFFF);
   // TODO: Investigate if this is actually necessary. Morrowind does this after changing offsets.
   p = pb_push1(p, NV097_NO_OPERATION, 0);
   p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
@@ -248,7 +248,7 @@ void TextureFramebufferBlitTests::TestRenderTarget(const char* test_name) {
   p = pb_push1(p, NV097_SET_SURFACE_PITCH,
                SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, pitch) | SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, pitch));
   p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-  p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+  p = host_.PushSurfaceColorOffset(p, 0);
   // TODO: Investigate if this is actually necessary. Morrowind does this after changing offsets.
   p = pb_push1(p, NV097_NO_OPERATION, 0);
   p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
@@ -11,6 +11,7 @@
 #include "shaders/precalculated_vertex_shader.h"
 #include "test_host.h"
 #include "texture_format.h"
+#include "texture_generator.h"
 
 #define SET_MASK(mask, val) (((val) << (__builtin_ffs(mask) - 1)) & (mask))
 
@@ -22,7 +23,6 @@ static const uint32_t kTextureWidth = 256;
 static const uint32_t kTexturePitch = kTextureWidth * 4;
 static const uint32_t kTextureHeight = 256;
 
-static int GenerateGradientSurface(SDL_Surface **gradient_surface, int width, int height);
 static int GeneratePalettizedGradientSurface(uint8_t **gradient_surface, int width, int height,
                                              TestHost::PaletteSize size);
 static uint32_t *GeneratePalette(TestHost::PaletteSize size);
@@ -40,6 +40,7 @@ static bool RequiresSpecialTest(const TextureFormatInfo &format) {
     case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FIXED:
     case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FLOAT:
     case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FIXED:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FLOAT:
     case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8:
     case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8:
       return true;
@@ -132,7 +133,7 @@ void TextureRenderTargetTests::ResetAndDrawFromRenderTarget() const {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     pb_end(p);
 
     host_.PrepareDraw(0xFE212021);
@@ -163,10 +164,10 @@ void TextureRenderTargetTests::Test(const TextureFormatInfo &texture_format) {
   auto &texture_stage = host_.GetTextureStage(0);
   texture_stage.SetTextureDimensions(host_.GetMaxTextureWidth(), host_.GetMaxTextureHeight());
 
+  auto gradient = GetGradientImage(host_.GetMaxTextureWidth(), host_.GetMaxTextureHeight());
   SDL_Surface *gradient_surface;
-  int update_texture_result =
-      GenerateGradientSurface(&gradient_surface, (int)host_.GetMaxTextureWidth(), (int)host_.GetMaxTextureHeight());
-  ASSERT(!update_texture_result && "Failed to generate SDL surface");
+  int update_texture_result = CreateSurfaceFromImage(&gradient_surface, *gradient);
+  ASSERT(!update_texture_result && "Failed to create SDL surface");
 
   update_texture_result = host_.SetTexture(gradient_surface);
   SDL_FreeSurface(gradient_surface);
@@ -183,7 +184,7 @@ void TextureRenderTargetTests::Test(const TextureFormatInfo &texture_format) {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kTexturePitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, texture_target_ctx_.ChannelID);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
 
     // TODO: Investigate if this is actually necessary. Morrowind does this after changing offsets.
     p = pb_push1(p, NV097_NO_OPERATION, 0);
@@ -249,7 +250,7 @@ void TextureRenderTargetTests::TestPalettized(TestHost::PaletteSize size) {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kTexturePitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, texture_target_ctx_.ChannelID);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     // TODO: Investigate if this is actually necessary. Morrowind does this after changing offsets.
     p = pb_push1(p, NV097_NO_OPERATION, 0);
     p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
@@ -300,32 +301,6 @@ std::string TextureRenderTargetTests::MakePalettizedTestName(TestHost::PaletteSi
   return std::move(test_name);
 }
 
-static int GenerateGradientSurface(SDL_Surface **gradient_surface, int width, int height) {
-  *gradient_surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888);
-  if (!(*gradient_surface)) {
-    return 1;
-  }
-
-  if (SDL_LockSurface(*gradient_surface)) {
-    SDL_FreeSurface(*gradient_surface);
-    *gradient_surface = nullptr;
-    return 2;
-  }
-
-  auto pixels = static_cast<uint32_t *>((*gradient_surface)->pixels);
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x, ++pixels) {
-      int x_normal = static_cast<int>(static_cast<float>(x) * 255.0f / static_cast<float>(width));
-      int y_normal = static_cast<int>(static_cast<float>(y) * 255.0f / static_cast<float>(height));
-      *pixels = SDL_MapRGBA((*gradient_surface)->format, y_normal, x_normal, 255 - y_normal, x_normal + y_normal);
-    }
-  }
-
-  SDL_UnlockSurface(*gradient_surface);
-
-  return 0;
-}
-
 static int GeneratePalettizedGradientSurface(uint8_t **gradient_surface, int width, int height,
                                              TestHost::PaletteSize palette_size) {
   *gradient_surface = new uint8_t[width * height];
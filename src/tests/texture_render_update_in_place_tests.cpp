@@ -98,7 +98,7 @@ void TextureRenderUpdateInPlaceTests::Test() {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kTexturePitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, texture_target_ctx_.ChannelID);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, render_target_address);
+    p = host_.PushSurfaceColorOffset(p, render_target_address);
     // TODO: Investigate if this is actually necessary. Morrowind does this after changing offsets.
     p = pb_push1(p, NV097_NO_OPERATION, 0);
     p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
@@ -136,7 +136,7 @@ void TextureRenderUpdateInPlaceTests::Test() {
   // modulate the texture further, zeroing the red channel and increasing the alpha.
   {
     auto p = pb_begin();
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, normal_texture_address);
+    p = host_.PushSurfaceColorOffset(p, normal_texture_address);
     pb_end(p);
 
     host_.SetCombinerFactorC0(0, 0.0f, 1.0f, 1.0f, 1.0f);
@@ -159,7 +159,7 @@ void TextureRenderUpdateInPlaceTests::Test() {
                SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                    SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
   p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-  p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+  p = host_.PushSurfaceColorOffset(p, 0);
   p = pb_push1(p, NV097_SET_TEXTURE_OFFSET, normal_texture_address);
   pb_end(p);
 
@@ -5,6 +5,7 @@
 #include <utility>
 
 #include "debug_output.h"
+#include "depth_conversion.h"
 #include "pbkit_ext.h"
 #include "shaders/perspective_vertex_shader.h"
 #include "shaders/precalculated_vertex_shader.h"
@@ -120,6 +121,20 @@ static std::string MakeRawValueTestName(const TextureFormatInfo &format, TestHos
   return std::move(ret);
 }
 
+static std::string MakeRawFloatValueTestName(const TextureFormatInfo &format, TestHost::ShaderStageProgram mode,
+                                             uint32_t depth_format, uint32_t comp_func, float min_val, float max_val,
+                                             float ref) {
+  std::string ret = ShortModeName(mode) + "R";
+  ret += ShortDepthName(format, depth_format, true);
+
+  char buf[64] = {0};
+  sprintf(buf, "_%g-%g_%g_", min_val, max_val, ref);
+  ret += buf;
+
+  ret += CompareFunctionName(comp_func);
+  return std::move(ret);
+}
+
 static std::string MakeFixedFunctionTestName(const TextureFormatInfo &format, TestHost::ShaderStageProgram mode,
                                              uint32_t depth_format, bool float_depth, float min_val, float max_val,
                                              float ref, uint32_t comp_func) {
@@ -162,6 +177,18 @@ TextureShadowComparatorTests::TextureShadowComparatorTests(TestHost &host, std::
     }
   };
 
+  auto add_float_test = [this](uint32_t texture_format, uint32_t surface_format, uint32_t comp_func, float min_val,
+                               float max_val, float ref) {
+    const TextureFormatInfo &texture_format_info = GetTextureFormatInfo(texture_format);
+    for (auto texture_mode : {TestHost::STAGE_2D_PROJECTIVE, TestHost::STAGE_3D_PROJECTIVE}) {
+      std::string name = MakeRawFloatValueTestName(texture_format_info, texture_mode, surface_format, comp_func,
+                                                   min_val, max_val, ref);
+      tests_[name] = [this, surface_format, texture_format, texture_mode, comp_func, name, min_val, max_val, ref]() {
+        TestRawFloatValues(surface_format, texture_format, texture_mode, comp_func, min_val, max_val, ref, name);
+      };
+    }
+  };
+
   auto add_perspective_tests = [this](uint32_t texture_format, uint32_t surface_format, bool float_depth,
                                       uint32_t comp_func, float min_val, float max_val, float ref_val) {
     const TextureFormatInfo &texture_format_info = GetTextureFormatInfo(texture_format);
@@ -183,7 +210,6 @@ TextureShadowComparatorTests::TextureShadowComparatorTests(TestHost &host, std::
     }
   };
 
-  // TODO: Test floating point zeta buffers.
   for (auto comp_func : kCompareFuncs) {
     add_test(NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FIXED, NV097_SET_SURFACE_FORMAT_ZETA_Z16, comp_func, 0,
              0xFFFF, 0x7FFF);
@@ -199,6 +225,16 @@ TextureShadowComparatorTests::TextureShadowComparatorTests(TestHost &host, std::
     add_test(NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FIXED, NV097_SET_SURFACE_FORMAT_ZETA_Z24S8, comp_func,
              256, 512, 384);
 
+    add_float_test(NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FLOAT, NV097_SET_SURFACE_FORMAT_ZETA_Z16,
+                   comp_func, 0.0f, kZ16FloatMax, 1.0f);
+    add_float_test(NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FLOAT, NV097_SET_SURFACE_FORMAT_ZETA_Z16,
+                   comp_func, 0.5f, 2.0f, 1.25f);
+
+    add_float_test(NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FLOAT, NV097_SET_SURFACE_FORMAT_ZETA_Z24S8,
+                   comp_func, 0.0f, 65536.0f, 1.0f);
+    add_float_test(NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FLOAT, NV097_SET_SURFACE_FORMAT_ZETA_Z24S8,
+                   comp_func, 0.5f, 2.0f, 1.25f);
+
     {
       const float kZRef = kZNear + (kZFar - kZNear) * 0.06f;
       add_perspective_tests(NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FIXED, NV097_SET_SURFACE_FORMAT_ZETA_Z16,
@@ -360,6 +396,84 @@ static void PrepareRawValueTestTexture(uint8_t *memory, uint32_t width, uint32_t
   }
 }
 
+static float DecodeDepth(uint32_t value, DepthTextureFormat format) {
+  return format == DEPTH_TEXTURE_Y16_FLOAT ? DecodeZ16Float(value) : DecodeZ24Float(value);
+}
+
+static uint32_t EncodeDepth(float value, DepthTextureFormat format) {
+  return format == DEPTH_TEXTURE_Y16_FLOAT ? EncodeZ16Float(value) : EncodeZ24Float(value);
+}
+
+// Float variant of PrepareRawValueTestTexture. The explicit boxes hold the encodings adjacent to the reference and
+// maximum values rather than +/- 1.
+static void PrepareRawFloatValueTestTexture(uint8_t *memory, uint32_t width, uint32_t height, DepthTextureFormat format,
+                                            float min_val, float max_val, float default_val) {
+  static constexpr int kTotal = kHorizontal * kVertical;
+
+  const uint32_t box_width = width / kHorizontal;
+  const uint32_t box_height = height / kVertical;
+
+  const uint32_t x_indent = width - (box_width * kHorizontal);
+  const uint32_t y_indent = height - (box_height * kVertical);
+
+  auto buffer = new float[width * height];
+  for (auto i = 0; i < width * height; ++i) {
+    buffer[i] = default_val;
+  }
+
+  auto row = buffer;
+  float value = min_val;
+  const float val_inc = (max_val - min_val) / static_cast<float>(kTotal);
+  for (auto y = y_indent >> 1; y < kVertical; ++y) {
+    auto box_pixel = row + (x_indent >> 1);
+    for (auto x = 0; x < kHorizontal; ++x) {
+      for (auto i = 0; i < box_width; ++i, ++box_pixel) {
+        *box_pixel = value;
+      }
+      value += val_inc;
+    }
+
+    for (auto y_row = 1; y_row < box_height; ++y_row) {
+      memcpy(row + y_row * width, row, width * sizeof(float));
+    }
+    row += width * box_height;
+  }
+
+  // Values:
+  // {0, smallest, default - 1, default, default + 1, max - 1, max}
+  // The neighbors are clamped to [0, max] so that a reference at either end of the range does not wrap.
+  const uint32_t default_encoded = EncodeDepth(default_val, format);
+  const uint32_t max_encoded = EncodeDepth(max_val, format);
+  const uint32_t below_default = default_encoded ? default_encoded - 1 : 0;
+  const uint32_t above_default = default_encoded < max_encoded ? default_encoded + 1 : max_encoded;
+  const uint32_t below_max = max_encoded ? max_encoded - 1 : 0;
+  const float box_values[] = {
+      0.0f,
+      DecodeDepth(1, format),
+      DecodeDepth(below_default, format),
+      DecodeDepth(default_encoded, format),
+      DecodeDepth(above_default, format),
+      DecodeDepth(below_max, format),
+      DecodeDepth(max_encoded, format),
+  };
+
+  auto layout = GetExplicitBoxLayout(width, height);
+  row = buffer + layout.top * width;
+  for (uint32_t y = layout.top; y < layout.top + layout.box_height; ++y, row += width) {
+    float *pixel = row + layout.first_box_left;
+    for (auto box_value : box_values) {
+      for (auto x = 0; x < layout.box_width; ++x) {
+        pixel[x] = box_value;
+      }
+      pixel += layout.box_width + layout.spacing;
+    }
+  }
+
+  ConvertToDepth(memory, width * GetDepthTextureBytesPerPixel(format), buffer, width * sizeof(float), width, height,
+                 DEPTH_SOURCE_FLOAT, format);
+  delete[] buffer;
+}
+
 void TextureShadowComparatorTests::TestRawValues(uint32_t depth_format, uint32_t texture_format,
                                                  TestHost::ShaderStageProgram mode, uint32_t shadow_comp_function,
                                                  uint32_t min_val, uint32_t max_val, uint32_t ref,
@@ -390,6 +504,51 @@ void TextureShadowComparatorTests::TestRawValues(uint32_t depth_format, uint32_t
   }
 #endif
 
+  DrawRawValueTestQuads(texture_format, mode, shadow_comp_function, static_cast<float>(ref));
+
+  pb_print("%s\n", name.c_str());
+  pb_print("Rng 0x%X-0x%x\n", min_val, max_val);
+  pb_print("Ref, edges, center: 0x%X\n", ref);
+  pb_draw_text_screen();
+
+  host_.FinishDraw(allow_saving_, output_dir_, name);
+}
+
+void TextureShadowComparatorTests::TestRawFloatValues(uint32_t depth_format, uint32_t texture_format,
+                                                      TestHost::ShaderStageProgram mode, uint32_t shadow_comp_function,
+                                                      float min_val, float max_val, float ref,
+                                                      const std::string &name) {
+  host_.SetVertexShaderProgram(raw_value_shader_);
+
+  host_.PrepareDraw(0xFE112233);
+
+  const DepthTextureFormat format =
+      depth_format == NV097_SET_SURFACE_FORMAT_ZETA_Z16 ? DEPTH_TEXTURE_Y16_FLOAT : DEPTH_TEXTURE_X8_Y24_FLOAT;
+  PrepareRawFloatValueTestTexture(host_.GetTextureMemory(), host_.GetFramebufferWidth(), host_.GetFramebufferHeight(),
+                                  format, min_val, max_val, ref);
+
+#ifdef DEBUG_DUMP_DEPTH_TEXTURE
+  if (allow_saving_) {
+    std::string z_buffer_name = name + "_DT";
+    const uint32_t bpp = GetDepthTextureBytesPerPixel(format) * 8;
+    const uint32_t texture_pitch = host_.GetFramebufferWidth() * (bpp >> 3);
+    host_.SaveRawTexture(output_dir_, z_buffer_name, host_.GetTextureMemory(), host_.GetFramebufferWidth(),
+                         host_.GetFramebufferHeight(), texture_pitch, bpp);
+  }
+#endif
+
+  DrawRawValueTestQuads(texture_format, mode, shadow_comp_function, ref);
+
+  pb_print("%s\n", name.c_str());
+  pb_print("Rng %g-%g\n", min_val, max_val);
+  pb_print("Ref, edges, center: %g\n", ref);
+  pb_draw_text_screen();
+
+  host_.FinishDraw(allow_saving_, output_dir_, name);
+}
+
+void TextureShadowComparatorTests::DrawRawValueTestQuads(uint32_t texture_format, TestHost::ShaderStageProgram mode,
+                                                         uint32_t shadow_comp_function, float tex_depth) {
   // Render a quad using the zeta buffer as a shadow map applied to the diffuse color.
 
   // The texture map is used as a color source and will either be 0xFFFFFFFF or 0x00000000 for any given texel.
@@ -415,7 +574,6 @@ void TextureShadowComparatorTests::TestRawValues(uint32_t depth_format, uint32_t
     const float kTop = 100.0f;
     const float kBottom = host_.GetFramebufferHeightF() - kTop;
 
-    const auto tex_depth = static_cast<float>(ref);
     const float z = 1.5f;
     host_.Begin(TestHost::PRIMITIVE_QUADS);
     host_.SetDiffuse(0xFF2277FF);
@@ -468,12 +626,6 @@ void TextureShadowComparatorTests::TestRawValues(uint32_t depth_format, uint32_t
     }
   }
 
-  pb_print("%s\n", name.c_str());
-  pb_print("Rng 0x%X-0x%x\n", min_val, max_val);
-  pb_print("Ref, edges, center: 0x%X\n", ref);
-  pb_draw_text_screen();
-
-  host_.FinishDraw(allow_saving_, output_dir_, name);
 }
 
 void TextureShadowComparatorTests::TestFixedFunction(uint32_t depth_format, bool float_depth, uint32_t texture_format,
@@ -486,9 +638,11 @@ void TextureShadowComparatorTests::TestFixedFunction(uint32_t depth_format, bool
   host_.SetDepthBufferFloatMode(float_depth);
 
   auto project_point = [this](VECTOR out, const VECTOR in) { host_.ProjectPoint(out, in); };
-  auto unproject_point = [this](VECTOR out, const VECTOR in, float z) { host_.UnprojectPoint(out, in, z); };
+  auto unproject_points = [this](VECTOR *out, const VECTOR *in, uint32_t count, float z) {
+    host_.UnprojectPoints(out, in, count, z);
+  };
   TestProjected(depth_format, texture_format, mode, shadow_comp_function, min_val, max_val, ref_val, project_point,
-                unproject_point, name);
+                unproject_points, name);
 }
 
 void TextureShadowComparatorTests::TestProgrammable(uint32_t depth_format, bool float_depth, uint32_t texture_format,
@@ -513,17 +667,20 @@ void TextureShadowComparatorTests::TestProgrammable(uint32_t depth_format, bool
   host_.SetDepthBufferFloatMode(float_depth);
 
   auto project_point = [shader](VECTOR out, const VECTOR in) { shader->ProjectPoint(out, in); };
-  auto unproject_point = [shader](VECTOR out, const VECTOR in, float z) { shader->UnprojectPoint(out, in, z); };
+  auto unproject_points = [shader](VECTOR *out, const VECTOR *in, uint32_t count, float z) {
+    shader->UnprojectPoints(out, in, count, z);
+  };
 
   TestProjected(depth_format, texture_format, mode, shadow_comp_function, min_val, max_val, ref_val, project_point,
-                unproject_point, name);
+                unproject_points, name);
 }
 
 void TextureShadowComparatorTests::TestProjected(uint32_t depth_format, uint32_t texture_format,
                                                  TestHost::ShaderStageProgram mode, uint32_t shadow_comp_function,
                                                  float min_val, float max_val, float ref_val,
                                                  std::function<void(VECTOR, const VECTOR)> project_point,
-                                                 std::function<void(VECTOR, const VECTOR, float)> unproject_point,
+                                                 std::function<void(VECTOR *, const VECTOR *, uint32_t, float)>
+                                                     unproject_points,
                                                  const std::string &name) {
   auto p = pb_begin();
   // Depth test must be enabled or nothing will be written to the depth target.
@@ -533,7 +690,7 @@ void TextureShadowComparatorTests::TestProjected(uint32_t depth_format, uint32_t
 
   // Point the depth buffer at the base of texture memory.
   p = pb_push1(p, NV097_SET_CONTEXT_DMA_ZETA, texture_target_ctx_.ChannelID);
-  p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, reinterpret_cast<uint32_t>(host_.GetTextureMemory()) & 0x03FFFFFF);
+  p = host_.PushSurfaceZetaOffset(p, reinterpret_cast<uint32_t>(host_.GetTextureMemory()) & 0x03FFFFFF);
   pb_end(p);
 
   host_.PrepareDraw(0xFE332211);
@@ -559,26 +716,21 @@ void TextureShadowComparatorTests::TestProjected(uint32_t depth_format, uint32_t
     float z_top = min_val;
     float z_bottom = max_val;
 
-    VECTOR ul;
-    VECTOR screen_point = {sLeft, sTop, 0.0f, 1.0f};
-    unproject_point(ul, screen_point, z_top);
-
-    VECTOR ur;
-    screen_point[_X] = sRight;
-    unproject_point(ur, screen_point, z_top);
-
-    VECTOR lr;
-    screen_point[_Y] = sBottom;
-    unproject_point(lr, screen_point, z_bottom);
-
-    VECTOR ll;
-    screen_point[_X] = sLeft;
-    unproject_point(ll, screen_point, z_bottom);
-
-    host_.SetVertex(ul[_X], ul[_Y], z_top, 1.0f);
-    host_.SetVertex(ur[_X], ur[_Y], z_top, 1.0f);
-    host_.SetVertex(lr[_X], lr[_Y], z_bottom, 1.0f);
-    host_.SetVertex(ll[_X], ll[_Y], z_bottom, 1.0f);
+    // Corners in draw order, the top edge at z_top and the bottom at z_bottom.
+    const VECTOR screen_points[4] = {
+        {sLeft, sTop, 0.0f, 1.0f},
+        {sRight, sTop, 0.0f, 1.0f},
+        {sRight, sBottom, 0.0f, 1.0f},
+        {sLeft, sBottom, 0.0f, 1.0f},
+    };
+    VECTOR world_points[4];
+    unproject_points(world_points, screen_points, 2, z_top);
+    unproject_points(world_points + 2, screen_points + 2, 2, z_bottom);
+
+    host_.SetVertex(world_points[0][_X], world_points[0][_Y], z_top, 1.0f);
+    host_.SetVertex(world_points[1][_X], world_points[1][_Y], z_top, 1.0f);
+    host_.SetVertex(world_points[2][_X], world_points[2][_Y], z_bottom, 1.0f);
+    host_.SetVertex(world_points[3][_X], world_points[3][_Y], z_bottom, 1.0f);
     host_.End();
   }
 
@@ -586,28 +738,20 @@ void TextureShadowComparatorTests::TestProjected(uint32_t depth_format, uint32_t
 
   // Render quads at various depths along the center of the screen.
   {
-    auto box = [this, &unproject_point](float left, float top, float right, float bottom, float z) {
+    auto box = [this, &unproject_points](float left, float top, float right, float bottom, float z) {
       host_.SetDiffuse(0xFFAA11AA);
-      VECTOR ul;
-      VECTOR screen_point = {left, top, 0.0f, 1.0f};
-      unproject_point(ul, screen_point, z);
-
-      VECTOR ur;
-      screen_point[_X] = right;
-      unproject_point(ur, screen_point, z);
-
-      VECTOR lr;
-      screen_point[_Y] = bottom;
-      unproject_point(lr, screen_point, z);
-
-      VECTOR ll;
-      screen_point[_X] = left;
-      unproject_point(ll, screen_point, z);
-
-      host_.SetVertex(ul[_X], ul[_Y], z, 1.0f);
-      host_.SetVertex(ur[_X], ur[_Y], z, 1.0f);
-      host_.SetVertex(lr[_X], lr[_Y], z, 1.0f);
-      host_.SetVertex(ll[_X], ll[_Y], z, 1.0f);
+      const VECTOR screen_points[4] = {
+          {left, top, 0.0f, 1.0f},
+          {right, top, 0.0f, 1.0f},
+          {right, bottom, 0.0f, 1.0f},
+          {left, bottom, 0.0f, 1.0f},
+      };
+      VECTOR world_points[4];
+      unproject_points(world_points, screen_points, 4, z);
+
+      for (auto &point : world_points) {
+        host_.SetVertex(point[_X], point[_Y], z, 1.0f);
+      }
     };
     auto left = static_cast<float>(layout.first_box_left);
     const auto top = static_cast<float>(layout.top);
@@ -642,7 +786,7 @@ void TextureShadowComparatorTests::TestProjected(uint32_t depth_format, uint32_t
 
   p = pb_begin();
   // Restore the depth buffer.
-  p = pb_push1(p, NV097_SET_SURFACE_ZETA_OFFSET, 0);
+  p = host_.PushSurfaceZetaOffset(p, 0);
   p = pb_push1(p, NV097_SET_CONTEXT_DMA_ZETA, kDefaultDMAZetaChannel);
   p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, false);
   pb_end(p);
@@ -693,14 +837,11 @@ void TextureShadowComparatorTests::TestProjected(uint32_t depth_format, uint32_t
     sBottom = host_.GetFramebufferHeightF() - sTop;
 
     const float z = 1.5f;
-    VECTOR ul;
-    VECTOR screen_point = {sLeft, sTop, 0.0f, 1.0f};
-    unproject_point(ul, screen_point, z);
-
-    VECTOR lr;
-    screen_point[_X] = sRight;
-    screen_point[_Y] = sBottom;
-    unproject_point(lr, screen_point, z);
+    const VECTOR screen_points[2] = {{sLeft, sTop, 0.0f, 1.0f}, {sRight, sBottom, 0.0f, 1.0f}};
+    VECTOR world_points[2];
+    unproject_points(world_points, screen_points, 2, z);
+    const float *ul = world_points[0];
+    const float *lr = world_points[1];
 
     host_.Begin(TestHost::PRIMITIVE_QUADS);
     host_.SetDiffuse(0xFF2277FF);
@@ -739,27 +880,32 @@ void TextureShadowComparatorTests::TestProjected(uint32_t depth_format, uint32_t
     const float top = static_cast<float>(layout.top) + top_offset;
     const float bottom = static_cast<float>(layout.top) + bottom_offset;
 
-    for (auto color : kMarkerColors) {
-      host_.Begin(TestHost::PRIMITIVE_TRIANGLES);
-      host_.SetDiffuse(color);
-
-      VECTOR pt;
-
-      VECTOR screen_point = {left + left_offset, bottom, 0.0f, 1.0f};
-      unproject_point(pt, screen_point, 0.0f);
-      host_.SetVertex(pt);
-
-      screen_point[_X] = left + mid_offset;
-      screen_point[_Y] = top;
-      unproject_point(pt, screen_point, 0.0f);
-      host_.SetVertex(pt);
-
-      screen_point[_X] = left + right_offset;
-      screen_point[_Y] = bottom;
-      unproject_point(pt, screen_point, 0.0f);
-      host_.SetVertex(pt);
-
+    // Every marker lies on z = 0, so the whole row is unprojected at once.
+    static constexpr uint32_t kNumMarkers = sizeof(kMarkerColors) / sizeof(kMarkerColors[0]);
+    VECTOR screen_points[kNumMarkers * 3];
+    for (uint32_t i = 0; i < kNumMarkers; ++i) {
+      VECTOR *marker = screen_points + i * 3;
+      marker[0][_X] = left + left_offset;
+      marker[0][_Y] = bottom;
+      marker[1][_X] = left + mid_offset;
+      marker[1][_Y] = top;
+      marker[2][_X] = left + right_offset;
+      marker[2][_Y] = bottom;
+      for (uint32_t vertex = 0; vertex < 3; ++vertex) {
+        marker[vertex][_Z] = 0.0f;
+        marker[vertex][_W] = 1.0f;
+      }
       left += static_cast<float>(layout.spacing + layout.box_width);
+    }
+    VECTOR world_points[kNumMarkers * 3];
+    unproject_points(world_points, screen_points, kNumMarkers * 3, 0.0f);
+
+    for (uint32_t i = 0; i < kNumMarkers; ++i) {
+      host_.Begin(TestHost::PRIMITIVE_TRIANGLES);
+      host_.SetDiffuse(kMarkerColors[i]);
+      for (uint32_t vertex = 0; vertex < 3; ++vertex) {
+        host_.SetVertex(world_points[i * 3 + vertex]);
+      }
       host_.End();
     }
   }
@@ -24,6 +24,9 @@ class TextureShadowComparatorTests : public TestSuite {
   void TestRawValues(uint32_t depth_format, uint32_t texture_format, TestHost::ShaderStageProgram mode,
                      uint32_t shadow_comp_function, uint32_t min_val, uint32_t max_val, uint32_t ref,
                      const std::string &name);
+  void TestRawFloatValues(uint32_t depth_format, uint32_t texture_format, TestHost::ShaderStageProgram mode,
+                          uint32_t shadow_comp_function, float min_val, float max_val, float ref,
+                          const std::string &name);
   void TestFixedFunction(uint32_t depth_format, bool float_depth, uint32_t texture_format,
                          TestHost::ShaderStageProgram mode, uint32_t shadow_comp_function, float min_val, float max_val,
                          float ref_val, const std::string &name);
@@ -31,10 +34,15 @@ class TextureShadowComparatorTests : public TestSuite {
                         TestHost::ShaderStageProgram mode, uint32_t shadow_comp_function, float min_val, float max_val,
                         float ref_val, const std::string &name);
 
+  // Draws a quad using texture stage 0 as a shadow map and marks the explicit value boxes.
+  void DrawRawValueTestQuads(uint32_t texture_format, TestHost::ShaderStageProgram mode, uint32_t shadow_comp_function,
+                             float tex_depth);
+
   void TestProjected(uint32_t depth_format, uint32_t texture_format, TestHost::ShaderStageProgram mode,
                      uint32_t shadow_comp_function, float min_val, float max_val, float ref_val,
                      std::function<void(VECTOR, const VECTOR)> project_point,
-                     std::function<void(VECTOR, const VECTOR, float)> unproject_point, const std::string &name);
+                     std::function<void(VECTOR *, const VECTOR *, uint32_t, float)> unproject_points,
+                     const std::string &name);
 
  private:
   struct s_CtxDma texture_target_ctx_ {};
@@ -3,6 +3,7 @@
 #include <SDL.h>
 #include <pbkit/pbkit.h>
 
+#include <cstring>
 #include <memory>
 #include <utility>
 
@@ -230,9 +231,12 @@ std::string TextureSignedComponentTests::MakeTestName(const TextureFormatInfo &t
 }
 
 static int GenerateBlockTestSurface(SDL_Surface **surface, int width, int height) {
-  int ret = GenerateCheckerboardSurface(surface, width, height, 0xFFFEFDFC, 0x7F202122);
-  if (ret) {
-    return ret;
+  // The checkerboard background is shared through the generated image cache and the blocks are drawn over a copy.
+  auto background = GetCheckerboardImage(width, height, 0xFFFEFDFC, 0x7F202122);
+
+  *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ABGR8888);
+  if (!(*surface)) {
+    return 1;
   }
 
   if (SDL_LockSurface(*surface)) {
@@ -242,6 +246,10 @@ static int GenerateBlockTestSurface(SDL_Surface **surface, int width, int height
   }
 
   auto pixels = static_cast<uint32_t *>((*surface)->pixels);
+  auto row = static_cast<uint8_t *>((*surface)->pixels);
+  for (int y = 0; y < height; ++y, row += (*surface)->pitch) {
+    memcpy(row, background->pixels.data() + y * width, background->GetPitch());
+  }
 
   static constexpr int kLeft = 5;
   static constexpr int kTop = 10;
@@ -2,6 +2,7 @@
 
 #include <pbkit/pbkit.h>
 
+#include "index_generator.h"
 #include "pbkit_ext.h"
 #include "shaders/precalculated_vertex_shader.h"
 #include "test_host.h"
@@ -20,6 +21,7 @@ static constexpr ThreeDPrimitiveTests::DrawMode kDrawModes[] = {
     ThreeDPrimitiveTests::DRAW_INLINE_BUFFERS,
     ThreeDPrimitiveTests::DRAW_INLINE_ARRAYS,
     ThreeDPrimitiveTests::DRAW_INLINE_ELEMENTS,
+    ThreeDPrimitiveTests::DRAW_INLINE_ELEMENTS_EXPANDED,
 };
 
 static constexpr TestHost::DrawPrimitive kPrimitives[] = {
@@ -72,61 +74,47 @@ void ThreeDPrimitiveTests::CreateLines() {
   auto buffer = host_.AllocateVertexBuffer(kNumLines * 2);
 
   auto vertex = buffer->Lock();
-  index_buffer_.clear();
-  auto index = 0;
 
   vertex->SetPosition(kLeft, kTop, kZFront);
   vertex->SetDiffuseGrey(0.75f);
-  index_buffer_.push_back(index++);
   ++vertex;
   vertex->SetPosition(kRight, kTop, kZFront);
   vertex->SetDiffuseGrey(1.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
 
   vertex->SetPosition(-2, 1, kZFront);
   vertex->SetDiffuse(1.0f, 0.0f, 0.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
   vertex->SetPosition(2, 0, kZBack);
   vertex->SetDiffuse(1.0f, 0.0f, 0.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
 
   vertex->SetPosition(1.5, 0.5, kZBack);
   vertex->SetDiffuse(0.0f, 1.0f, 0.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
   vertex->SetPosition(-1.5, 0.75, kZBack);
   vertex->SetDiffuse(0.0f, 1.0f, 0.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
 
   vertex->SetPosition(kRight, 0.25, kZFront);
   vertex->SetDiffuseGrey(1.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
   vertex->SetPosition(1.75f, 1.25, kZFront);
   vertex->SetDiffuseGrey(0.15f);
-  index_buffer_.push_back(index++);
   ++vertex;
 
   vertex->SetPosition(kLeft, 1.0f, kZFront);
   vertex->SetDiffuse(0.25f, 0.25f, 1.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
   vertex->SetPosition(kLeft, -1.0f, kZFront);
   vertex->SetDiffuse(0.65f, 0.65f, 1.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
 
   vertex->SetPosition(kLeft, kBottom, kZBack);
   vertex->SetDiffuse(0.0f, 1.0f, 1.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
   vertex->SetPosition(kRight, kBottom, kZBack);
   vertex->SetDiffuse(0.5f, 0.5f, 1.0f);
-  index_buffer_.push_back(index++);
   ++vertex;
 
   buffer->Unlock();
@@ -170,11 +158,6 @@ void ThreeDPrimitiveTests::CreateTriangles() {
     float three[] = {0.0f, 0.0f, kZBack};
     buffer->DefineTriangle(index++, one, two, three, color_one, color_two, color_three);
   }
-
-  index_buffer_.clear();
-  for (auto i = 0; i < buffer->GetNumVertices(); ++i) {
-    index_buffer_.push_back(i);
-  }
 }
 
 void ThreeDPrimitiveTests::CreateTriangleStrip() {
@@ -182,13 +165,10 @@ void ThreeDPrimitiveTests::CreateTriangleStrip() {
   auto buffer = host_.AllocateVertexBuffer(3 + (kNumTriangles - 1));
 
   auto vertex = buffer->Lock();
-  index_buffer_.clear();
-  auto index = 0;
 
-  auto add_vertex = [&vertex, &index, this](float x, float y, float z, float r, float g, float b) {
+  auto add_vertex = [&vertex](float x, float y, float z, float r, float g, float b) {
     vertex->SetPosition(x, y, z);
     vertex->SetDiffuse(r, g, b);
-    this->index_buffer_.push_back(index++);
     ++vertex;
   };
 
@@ -214,13 +194,10 @@ void ThreeDPrimitiveTests::CreateTriangleFan() {
   auto buffer = host_.AllocateVertexBuffer(3 + (kNumTriangles - 1));
 
   auto vertex = buffer->Lock();
-  index_buffer_.clear();
-  auto index = 0;
 
-  auto add_vertex = [&vertex, &index, this](float x, float y, float z, float r, float g, float b) {
+  auto add_vertex = [&vertex](float x, float y, float z, float r, float g, float b) {
     vertex->SetPosition(x, y, z);
     vertex->SetDiffuse(r, g, b);
-    this->index_buffer_.push_back(index++);
     ++vertex;
   };
 
@@ -246,13 +223,10 @@ void ThreeDPrimitiveTests::CreateQuads() {
   auto buffer = host_.AllocateVertexBuffer(kNumQuads * 4);
 
   auto vertex = buffer->Lock();
-  index_buffer_.clear();
-  auto index = 0;
 
-  auto add_vertex = [&vertex, &index, this](float x, float y, float z, float r, float g, float b) {
+  auto add_vertex = [&vertex](float x, float y, float z, float r, float g, float b) {
     vertex->SetPosition(x, y, z);
     vertex->SetDiffuse(r, g, b);
-    this->index_buffer_.push_back(index++);
     ++vertex;
   };
 
@@ -279,13 +253,10 @@ void ThreeDPrimitiveTests::CreateQuadStrip() {
   auto buffer = host_.AllocateVertexBuffer(4 + (kNumQuads - 1) * 2);
 
   auto vertex = buffer->Lock();
-  index_buffer_.clear();
-  auto index = 0;
 
-  auto add_vertex = [&vertex, &index, this](float x, float y, float z, float r, float g, float b) {
+  auto add_vertex = [&vertex](float x, float y, float z, float r, float g, float b) {
     vertex->SetPosition(x, y, z);
     vertex->SetDiffuse(r, g, b);
-    this->index_buffer_.push_back(index++);
     ++vertex;
   };
 
@@ -305,13 +276,10 @@ void ThreeDPrimitiveTests::CreatePolygon() {
   auto buffer = host_.AllocateVertexBuffer(kNumVertices);
 
   auto vertex = buffer->Lock();
-  index_buffer_.clear();
-  auto index = 0;
 
-  auto add_vertex = [&vertex, &index, this](float x, float y, float z, float r, float g, float b) {
+  auto add_vertex = [&vertex](float x, float y, float z, float r, float g, float b) {
     vertex->SetPosition(x, y, z);
     vertex->SetDiffuse(r, g, b);
-    this->index_buffer_.push_back(index++);
     ++vertex;
   };
 
@@ -337,7 +305,7 @@ void ThreeDPrimitiveTests::Test(TestHost::DrawPrimitive primitive, DrawMode draw
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kAAFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(kTextureMemory));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(kTextureMemory));
     pb_end(p);
     host_.SetSurfaceFormat(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z16, host_.GetFramebufferWidth(),
                            host_.GetFramebufferHeight(), false, 0, 0, 0, 0, TestHost::AA_CENTER_CORNER_2);
@@ -399,9 +367,15 @@ void ThreeDPrimitiveTests::Test(TestHost::DrawPrimitive primitive, DrawMode draw
       break;
 
     case DRAW_INLINE_ELEMENTS:
+      index_buffer_.clear();
+      GenerateSequentialIndices(index_buffer_, host_.GetVertexBuffer()->GetNumVertices());
       host_.DrawInlineElements16(index_buffer_, vertex_elements, primitive);
       break;
 
+    case DRAW_INLINE_ELEMENTS_EXPANDED:
+      host_.DrawInlineElementsExpanded(vertex_elements, primitive);
+      break;
+
     case DRAW_INLINE_ARRAYS:
       host_.DrawInlineArray(vertex_elements, primitive);
       break;
@@ -424,7 +398,7 @@ void ThreeDPrimitiveTests::Test(TestHost::DrawPrimitive primitive, DrawMode draw
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     pb_end(p);
     host_.SetSurfaceFormatImmediate(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z16, host_.GetFramebufferWidth(),
                                     host_.GetFramebufferHeight());
@@ -490,6 +464,10 @@ std::string ThreeDPrimitiveTests::MakeTestName(TestHost::DrawPrimitive primitive
     case DRAW_INLINE_ELEMENTS:
       ret += "-inlineelements";
       break;
+
+    case DRAW_INLINE_ELEMENTS_EXPANDED:
+      ret += "-inlineelementsexpanded";
+      break;
   }
 
   if (line_smooth) {
@@ -18,6 +18,8 @@ class ThreeDPrimitiveTests : public TestSuite {
     DRAW_INLINE_BUFFERS,
     DRAW_INLINE_ARRAYS,
     DRAW_INLINE_ELEMENTS,
+    // Draws composite primitives as independent points/lines/triangles via an index array into the original vertices.
+    DRAW_INLINE_ELEMENTS_EXPANDED,
   };
 
  public:
@@ -0,0 +1,166 @@
+#include "vertex_cache_tests.h"
+
+#include <pbkit/pbkit.h>
+
+#include <chrono>
+#include <utility>
+
+#include "debug_output.h"
+#include "logger.h"
+#include "mesh_generator.h"
+#include "test_host.h"
+#include "vertex_buffer.h"
+#include "vertex_cache_optimizer.h"
+
+// Number of times the mesh is drawn for a single timing sample.
+static constexpr int kTimedIterations = 8;
+
+static constexpr uint32_t kSegments = 192;
+static constexpr uint32_t kRings = 96;
+
+// clang-format off
+static constexpr VertexCacheTests::Mesh kMeshes[] = {
+    VertexCacheTests::MESH_SPHERE,
+    VertexCacheTests::MESH_TORUS,
+};
+
+static constexpr VertexCacheTests::Ordering kOrderings[] = {
+    VertexCacheTests::ORDER_GENERATED,
+    VertexCacheTests::ORDER_SHUFFLED,
+    VertexCacheTests::ORDER_OPTIMIZED,
+};
+// clang-format on
+
+// Shuffles the triangles in the given list using a fixed seed so that results are reproducible.
+static void ShuffleTriangles(std::vector<uint32_t>& indices) {
+  uint32_t state = 0x12345678;
+  const uint32_t num_triangles = indices.size() / 3;
+  for (uint32_t i = num_triangles; i > 1; --i) {
+    state = state * 1664525 + 1013904223;
+    const uint32_t j = state % i;
+    for (uint32_t k = 0; k < 3; ++k) {
+      std::swap(indices[(i - 1) * 3 + k], indices[j * 3 + k]);
+    }
+  }
+}
+
+VertexCacheTests::VertexCacheTests(TestHost& host, std::string output_dir)
+    : TestSuite(host, std::move(output_dir), "Vertex cache") {
+  for (auto mesh : kMeshes) {
+    for (auto ordering : kOrderings) {
+      tests_[MakeTestName(mesh, ordering)] = [this, mesh, ordering]() { Test(mesh, ordering); };
+    }
+  }
+}
+
+void VertexCacheTests::Initialize() {
+  TestSuite::Initialize();
+
+  host_.SetVertexShaderProgram(nullptr);
+  host_.SetXDKDefaultViewportAndFixedFunctionMatrices();
+}
+
+void VertexCacheTests::Deinitialize() {
+  vertex_buffer_.reset();
+  for (auto& indices : index_buffers_) {
+    indices.clear();
+  }
+  TestSuite::Deinitialize();
+}
+
+void VertexCacheTests::CreateGeometry(Mesh mesh) {
+  if (vertex_buffer_ && current_mesh_ == mesh) {
+    return;
+  }
+  current_mesh_ = mesh;
+
+  static constexpr float kCenter[] = {0.0f, 0.0f, 2.0f};
+  MeshStyle style;
+  style.diffuse_start = Color(0.2f, 0.8f, 0.3f);
+  style.diffuse_end = Color(0.8f, 0.2f, 0.7f);
+
+  auto& generated = index_buffers_[ORDER_GENERATED];
+  generated.clear();
+
+  MeshSize size = mesh == MESH_SPHERE ? GetSphereMeshSize(kSegments, kRings) : GetTorusMeshSize(kSegments, kRings);
+  vertex_buffer_ = host_.AllocateVertexBuffer(size.num_vertices);
+  auto vertices = vertex_buffer_->Lock();
+  if (mesh == MESH_SPHERE) {
+    GenerateSphereMesh(vertices, generated, kCenter, 1.75f, kSegments, kRings, style);
+  } else {
+    GenerateTorusMesh(vertices, generated, kCenter, 1.6f, 0.7f, kSegments, kRings, style);
+  }
+  vertex_buffer_->Unlock();
+
+  index_buffers_[ORDER_SHUFFLED] = generated;
+  ShuffleTriangles(index_buffers_[ORDER_SHUFFLED]);
+
+  // Optimize the shuffled order to demonstrate that the result does not depend on the input having good locality.
+  index_buffers_[ORDER_OPTIMIZED] = OptimizeVertexCacheOrder(index_buffers_[ORDER_SHUFFLED], size.num_vertices);
+}
+
+void VertexCacheTests::Test(Mesh mesh, Ordering ordering) {
+  CreateGeometry(mesh);
+  const auto& indices = index_buffers_[ordering];
+  auto stats = SimulateVertexCache(indices);
+
+  static constexpr uint32_t kBackgroundColor = 0xFF303030;
+  host_.SetVertexBuffer(vertex_buffer_);
+  host_.PrepareDraw(kBackgroundColor);
+
+  auto p = pb_begin();
+  p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, true);
+  pb_end(p);
+
+  auto start_time = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < kTimedIterations; ++i) {
+    host_.DrawInlineElements16(indices, host_.POSITION | host_.DIFFUSE);
+  }
+  while (pb_busy()) {
+    /* Wait for completion... */
+  }
+  auto now = std::chrono::high_resolution_clock::now();
+  auto elapsed =
+      static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - start_time).count());
+
+  p = pb_begin();
+  p = pb_push1(p, NV097_SET_DEPTH_TEST_ENABLE, false);
+  pb_end(p);
+
+  std::string name = MakeTestName(mesh, ordering);
+
+  // Timings are intentionally excluded from the rendered output so that results remain comparable across runs. They
+  // include pushing the indices, so they are dominated by CPU pushbuffer construction rather than vertex processing.
+  PrintMsg("%s: %u triangles, ACMR %.3f, %d draws pushed and executed in %uus\n", name.c_str(), stats.num_triangles,
+           stats.ACMR(), kTimedIterations, elapsed);
+#ifdef ENABLE_PROGRESS_LOG
+  if (allow_saving_) {
+    Logger::Log() << "  " << name << ": ACMR " << stats.ACMR() << ", " << kTimedIterations
+                  << " draws pushed and executed in " << elapsed << "us" << std::endl;
+  }
+#endif
+
+  pb_print("%s\n", name.c_str());
+  pb_print("Triangles: %u\n", stats.num_triangles);
+  pb_print("ACMR (FIFO %u): %.3f\n", kDefaultVertexCacheSize, stats.ACMR());
+  pb_draw_text_screen();
+
+  host_.FinishDraw(allow_saving_, output_dir_, name);
+}
+
+std::string VertexCacheTests::MakeTestName(Mesh mesh, Ordering ordering) {
+  std::string ret = mesh == MESH_SPHERE ? "Sphere" : "Torus";
+  switch (ordering) {
+    case ORDER_GENERATED:
+      ret += "-generated";
+      break;
+    case ORDER_SHUFFLED:
+      ret += "-shuffled";
+      break;
+    case ORDER_OPTIMIZED:
+      ret += "-optimized";
+      break;
+  }
+
+  return std::move(ret);
+}
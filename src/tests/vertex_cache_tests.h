@@ -0,0 +1,48 @@
+#ifndef NXDK_PGRAPH_TESTS_VERTEX_CACHE_TESTS_H
+#define NXDK_PGRAPH_TESTS_VERTEX_CACHE_TESTS_H
+
+#include <memory>
+#include <vector>
+
+#include "test_suite.h"
+
+class TestHost;
+class VertexBuffer;
+
+// Draws dense meshes with their triangles in generated, randomized, and cache optimized orders. The miss ratio of a
+// simulated post-transform vertex cache is rendered for each order.
+//
+// The logged timings cover building the ARRAY_ELEMENT16 pushbuffer on the CPU as well as the GPU work, and the former
+// dominates for inline elements. They are therefore not a measurement of the hardware post-transform cache.
+class VertexCacheTests : public TestSuite {
+ public:
+  enum Mesh {
+    MESH_SPHERE,
+    MESH_TORUS,
+  };
+
+  enum Ordering {
+    ORDER_GENERATED,
+    ORDER_SHUFFLED,
+    ORDER_OPTIMIZED,
+  };
+
+ public:
+  VertexCacheTests(TestHost& host, std::string output_dir);
+
+  void Initialize() override;
+  void Deinitialize() override;
+
+ private:
+  void CreateGeometry(Mesh mesh);
+  void Test(Mesh mesh, Ordering ordering);
+
+  static std::string MakeTestName(Mesh mesh, Ordering ordering);
+
+ private:
+  std::shared_ptr<VertexBuffer> vertex_buffer_;
+  Mesh current_mesh_{MESH_SPHERE};
+  std::vector<uint32_t> index_buffers_[3];
+};
+
+#endif  // NXDK_PGRAPH_TESTS_VERTEX_CACHE_TESTS_H
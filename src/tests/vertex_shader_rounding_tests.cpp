@@ -161,7 +161,7 @@ void VertexShaderRoundingTests::TestGeometrySubscreen(float bias) {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kTexturePitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(host_.GetTextureMemory()));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(host_.GetTextureMemory()));
     p = pb_push1(p, NV097_NO_OPERATION, 0);
     p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
     pb_end(p);
@@ -197,7 +197,7 @@ void VertexShaderRoundingTests::TestGeometrySubscreen(float bias) {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     p = pb_push1(p, NV097_NO_OPERATION, 0);
     p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
     pb_end(p);
@@ -292,7 +292,7 @@ void VertexShaderRoundingTests::TestGeometrySuperscreen(float bias) {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kTexturePitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(host_.GetTextureMemory()));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(host_.GetTextureMemory()));
     p = pb_push1(p, NV097_NO_OPERATION, 0);
     p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
     pb_end(p);
@@ -328,7 +328,7 @@ void VertexShaderRoundingTests::TestGeometrySuperscreen(float bias) {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     p = pb_push1(p, NV097_NO_OPERATION, 0);
     p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
     pb_end(p);
@@ -423,7 +423,7 @@ void VertexShaderRoundingTests::TestRenderTarget() {
         p, NV097_SET_SURFACE_PITCH,
         SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kTexturePitch) | SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kTexturePitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, VRAM_ADDR(render_target_));
+    p = host_.PushSurfaceColorOffset(p, VRAM_ADDR(render_target_));
     // TODO: Investigate if this is actually necessary. Morrowind does this after changing offsets.
     p = pb_push1(p, NV097_NO_OPERATION, 0);
     p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
@@ -509,7 +509,7 @@ void VertexShaderRoundingTests::TestRenderTarget() {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+    p = host_.PushSurfaceColorOffset(p, 0);
     pb_end(p);
     host_.SetSurfaceFormat(TestHost::SCF_A8R8G8B8, TestHost::SZF_Z24S8, host_.GetFramebufferWidth(),
                            host_.GetFramebufferHeight());
@@ -567,7 +567,7 @@ void VertexShaderRoundingTests::TestCompositingRenderTarget(int z) {
                  SET_MASK(NV097_SET_SURFACE_PITCH_COLOR, kFramebufferPitch) |
                      SET_MASK(NV097_SET_SURFACE_PITCH_ZETA, kFramebufferPitch));
     p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAChannelA);
-    p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, reinterpret_cast<uint32_t>(host_.GetTextureMemory()) & 0x03FFFFFF);
+    p = host_.PushSurfaceColorOffset(p, reinterpret_cast<uint32_t>(host_.GetTextureMemory()) & 0x03FFFFFF);
 
     // TODO: Investigate if this is actually necessary. Morrowind does this after changing offsets.
     p = pb_push1(p, NV097_NO_OPERATION, 0);
@@ -613,7 +613,7 @@ void VertexShaderRoundingTests::TestCompositingRenderTarget(int z) {
 
   auto p = pb_begin();
   p = pb_push1(p, NV097_SET_CONTEXT_DMA_COLOR, kDefaultDMAColorChannel);
-  p = pb_push1(p, NV097_SET_SURFACE_COLOR_OFFSET, 0);
+  p = host_.PushSurfaceColorOffset(p, 0);
   // TODO: Investigate if this is actually necessary. Morrowind does this after changing offsets.
   p = pb_push1(p, NV097_NO_OPERATION, 0);
   p = pb_push1(p, NV097_WAIT_FOR_IDLE, 0);
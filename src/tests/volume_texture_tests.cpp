@@ -30,6 +30,7 @@ static bool RequiresSpecialTest(const TextureFormatInfo &format) {
     case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FIXED:
     case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FLOAT:
     case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FIXED:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FLOAT:
     case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8:
     case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8:
       return true;
@@ -153,20 +154,22 @@ void VolumeTextureTests::Test(const TextureFormatInfo &texture_format) {
   const uint32_t height = kTextureHeight;
 
   host_.SetTextureFormat(texture_format);
-  auto **layers = new SDL_Surface *[kTextureDepth];
 
-  for (auto d = 0; d < kTextureDepth; ++d) {
-    int update_texture_result = GenerateSurface(&layers[d], (int)width, (int)height, d);
-    ASSERT(!update_texture_result && "Failed to generate SDL surface");
-  }
+  // Each layer is generated and converted just before it is swizzled into texture memory.
+  auto generate_layer = [&texture_format, width, height](uint8_t *dest, uint32_t pitch, uint32_t layer) {
+    SDL_Surface *surface;
+    int err = GenerateSurface(&surface, (int)width, (int)height, (int)layer);
+    ASSERT(!err && "Failed to generate SDL surface");
 
-  int update_texture_result = host_.SetVolumetricTexture((const SDL_Surface **)layers, kTextureDepth);
-  ASSERT(!update_texture_result && "Failed to set texture");
+    err = SDL_ConvertPixels(surface->w, surface->h, surface->format->format, surface->pixels, surface->pitch,
+                            texture_format.sdl_format, dest, (int)pitch);
+    SDL_FreeSurface(surface);
+    return err;
+  };
 
-  for (auto d = 0; d < kTextureDepth; ++d) {
-    SDL_FreeSurface(layers[d]);
-  }
-  delete[] layers;
+  int update_texture_result = host_.SetVolumetricTexture(width, height, kTextureDepth,
+                                                         SDL_BYTESPERPIXEL(texture_format.sdl_format), generate_layer);
+  ASSERT(!update_texture_result && "Failed to set texture");
 
   auto &stage = host_.GetTextureStage(0);
   stage.SetTextureDimensions(width, height, kTextureDepth);
@@ -0,0 +1,598 @@
+#include "texture_codec.h"
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include <cstring>
+#include <vector>
+
+#include "depth_conversion.h"
+#include "dxt_compressor.h"
+#include "dxt_decoder.h"
+#include "palette_quantizer.h"
+#include "pixel_packer.h"
+#include "yuv_conversion.h"
+
+static constexpr uint32_t kOpaque = 0xFF000000;
+
+// Matches the conversion performed by TextureStage::SetTexture for luminance formats.
+static inline uint8_t Luminance(uint32_t color) {
+  const uint32_t red = color & 0xFF;
+  const uint32_t green = (color >> 8) & 0xFF;
+  const uint32_t blue = (color >> 16) & 0xFF;
+  return static_cast<uint8_t>(0.299f * red + 0.587f * green + 0.114f * blue);
+}
+
+static inline uint32_t Gray(uint32_t luminance, uint32_t alpha = 0xFF) {
+  return luminance | (luminance << 8) | (luminance << 16) | (alpha << 24);
+}
+
+// Swaps the red and blue components, converting between ABGR8888 and ARGB8888.
+static inline uint32_t SwapRedBlue(uint32_t color) {
+  return (color & 0xFF00FF00) | ((color & 0xFF) << 16) | ((color >> 16) & 0xFF);
+}
+
+// Calls `process_row(source_row, dest_row)` for each row, with the rows cast to the given types.
+template <typename SourceType, typename DestType, typename RowFunction>
+static void ForEachRow(uint8_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t source_pitch,
+                       uint32_t height, RowFunction process_row) {
+  for (uint32_t y = 0; y < height; ++y, dest += dest_pitch, source += source_pitch) {
+    process_row(reinterpret_cast<const SourceType *>(source), reinterpret_cast<DestType *>(dest));
+  }
+}
+
+#ifdef __SSE__
+// SSE1 has no 128-bit integer operations, so the packed RGB conversions use the 64-bit MMX registers that come with it,
+// two 32-bit or four 16-bit pixels per register. Callers must execute _mm_empty before any x87 floating point code.
+
+static inline __m64 Load64(const void *source) {
+  __m64 ret;
+  memcpy(&ret, source, sizeof(ret));
+  return ret;
+}
+
+static inline void Store64(void *dest, __m64 value) { memcpy(dest, &value, sizeof(value)); }
+
+// Converts between ABGR8888 and ARGB8888.
+static inline __m64 SwapRedBlueSSE(__m64 colors) {
+  const __m64 low_byte = _mm_set1_pi32(0xFF);
+  const __m64 green_alpha = _mm_and_si64(colors, _mm_set1_pi32(static_cast<int>(0xFF00FF00)));
+  const __m64 red = _mm_slli_pi32(_mm_and_si64(colors, low_byte), 16);
+  const __m64 blue = _mm_and_si64(_mm_srli_pi32(colors, 16), low_byte);
+  return _mm_or_si64(green_alpha, _mm_or_si64(red, blue));
+}
+
+// Converts between ABGR8888 and RGBA8888.
+static inline __m64 ReverseBytesSSE(__m64 colors) {
+  const __m64 swapped = _mm_or_si64(_mm_slli_pi16(colors, 8), _mm_srli_pi16(colors, 8));
+  return _mm_shuffle_pi16(swapped, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// Converts ABGR8888 to BGRA8888.
+static inline __m64 RotateLeft8SSE(__m64 colors) {
+  return _mm_or_si64(_mm_slli_pi32(colors, 8), _mm_srli_pi32(colors, 24));
+}
+
+// Converts BGRA8888 to ABGR8888.
+static inline __m64 RotateRight8SSE(__m64 colors) {
+  return _mm_or_si64(_mm_srli_pi32(colors, 8), _mm_slli_pi32(colors, 24));
+}
+
+// Applies `transform` to groups of four 32-bit pixels, combining the results with `alpha_or`. Returns the number of
+// pixels converted.
+template <typename Transform>
+static inline uint32_t Convert32SSE(const uint32_t *in, uint32_t *out, uint32_t width, uint32_t alpha_or,
+                                    Transform transform) {
+  const __m64 alpha = _mm_set1_pi32(static_cast<int>(alpha_or));
+  uint32_t x = 0;
+  for (; x + 4 <= width; x += 4) {
+    Store64(out + x, _mm_or_si64(transform(Load64(in + x)), alpha));
+    Store64(out + x + 2, _mm_or_si64(transform(Load64(in + x + 2)), alpha));
+  }
+  return x;
+}
+
+// Returns R5G6B5 pixels in the low 16 bits of each 32-bit lane.
+static inline __m64 PackRGB565SSE(__m64 colors) {
+  const __m64 red = _mm_slli_pi32(_mm_and_si64(colors, _mm_set1_pi32(0xF8)), 8);
+  const __m64 green = _mm_and_si64(_mm_srli_pi32(colors, 5), _mm_set1_pi32(0x07E0));
+  const __m64 blue = _mm_and_si64(_mm_srli_pi32(colors, 19), _mm_set1_pi32(0x001F));
+  return _mm_or_si64(red, _mm_or_si64(green, blue));
+}
+
+// Expands R5G6B5 pixels held in the low 16 bits of each 32-bit lane, replicating the high bits like PixelPacker.
+static inline __m64 UnpackRGB565SSE(__m64 pixels) {
+  const __m64 red = _mm_or_si64(_mm_and_si64(_mm_srli_pi32(pixels, 8), _mm_set1_pi32(0xF8)),
+                                _mm_and_si64(_mm_srli_pi32(pixels, 13), _mm_set1_pi32(0x07)));
+  const __m64 green = _mm_or_si64(_mm_and_si64(_mm_slli_pi32(pixels, 5), _mm_set1_pi32(0xFC00)),
+                                  _mm_and_si64(_mm_srli_pi32(pixels, 1), _mm_set1_pi32(0x0300)));
+  const __m64 blue = _mm_or_si64(_mm_and_si64(_mm_slli_pi32(pixels, 19), _mm_set1_pi32(0xF80000)),
+                                 _mm_and_si64(_mm_slli_pi32(pixels, 14), _mm_set1_pi32(0x070000)));
+  return _mm_or_si64(_mm_or_si64(red, green), _mm_or_si64(blue, _mm_set1_pi32(static_cast<int>(kOpaque))));
+}
+
+// Encodes and decodes as many leading pixels of a row as possible, returning the number converted. Layouts without a
+// vector implementation convert nothing.
+template <typename Packer>
+static inline uint32_t EncodeRowSSE(const uint32_t *, typename Packer::Pixel *, uint32_t) {
+  return 0;
+}
+
+template <typename Packer>
+static inline uint32_t DecodeRowSSE(const typename Packer::Pixel *, uint32_t *, uint32_t, uint32_t) {
+  return 0;
+}
+
+template <>
+inline uint32_t EncodeRowSSE<PackARGB8888>(const uint32_t *in, uint32_t *out, uint32_t width) {
+  return Convert32SSE(in, out, width, 0, SwapRedBlueSSE);
+}
+
+template <>
+inline uint32_t DecodeRowSSE<PackARGB8888>(const uint32_t *in, uint32_t *out, uint32_t width, uint32_t alpha_or) {
+  return Convert32SSE(in, out, width, alpha_or, SwapRedBlueSSE);
+}
+
+template <>
+inline uint32_t EncodeRowSSE<PackRGBA8888>(const uint32_t *in, uint32_t *out, uint32_t width) {
+  return Convert32SSE(in, out, width, 0, ReverseBytesSSE);
+}
+
+template <>
+inline uint32_t DecodeRowSSE<PackRGBA8888>(const uint32_t *in, uint32_t *out, uint32_t width, uint32_t alpha_or) {
+  return Convert32SSE(in, out, width, alpha_or, ReverseBytesSSE);
+}
+
+template <>
+inline uint32_t EncodeRowSSE<PackBGRA8888>(const uint32_t *in, uint32_t *out, uint32_t width) {
+  return Convert32SSE(in, out, width, 0, RotateLeft8SSE);
+}
+
+template <>
+inline uint32_t DecodeRowSSE<PackBGRA8888>(const uint32_t *in, uint32_t *out, uint32_t width, uint32_t alpha_or) {
+  return Convert32SSE(in, out, width, alpha_or, RotateRight8SSE);
+}
+
+template <>
+inline uint32_t EncodeRowSSE<PackRGB565>(const uint32_t *in, uint16_t *out, uint32_t width) {
+  // _mm_packs_pi32 saturates to signed 16 bits, so values are biased into that range and restored afterwards.
+  const __m64 bias = _mm_set1_pi32(0x8000);
+  const __m64 unbias = _mm_set1_pi16(static_cast<int16_t>(0x8000));
+  uint32_t x = 0;
+  for (; x + 4 <= width; x += 4) {
+    const __m64 low = _mm_sub_pi32(PackRGB565SSE(Load64(in + x)), bias);
+    const __m64 high = _mm_sub_pi32(PackRGB565SSE(Load64(in + x + 2)), bias);
+    Store64(out + x, _mm_xor_si64(_mm_packs_pi32(low, high), unbias));
+  }
+  return x;
+}
+
+template <>
+inline uint32_t DecodeRowSSE<PackRGB565>(const uint16_t *in, uint32_t *out, uint32_t width, uint32_t) {
+  const __m64 zero = _mm_setzero_si64();
+  uint32_t x = 0;
+  for (; x + 4 <= width; x += 4) {
+    const __m64 pixels = Load64(in + x);
+    Store64(out + x, UnpackRGB565SSE(_mm_unpacklo_pi16(pixels, zero)));
+    Store64(out + x + 2, UnpackRGB565SSE(_mm_unpackhi_pi16(pixels, zero)));
+  }
+  return x;
+}
+#endif  // __SSE__
+
+template <typename Packer>
+static void EncodePacked(uint8_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch,
+                         uint32_t width, uint32_t height) {
+  typedef typename Packer::Pixel Pixel;
+  ForEachRow<uint32_t, Pixel>(dest, dest_pitch, reinterpret_cast<const uint8_t *>(source), source_pitch, height,
+                              [width](const uint32_t *in, Pixel *out) {
+                                uint32_t x = 0;
+#ifdef __SSE__
+                                x = EncodeRowSSE<Packer>(in, out, width);
+#endif
+                                for (; x < width; ++x) {
+                                  out[x] = Packer::Pack(in[x]);
+                                }
+                              });
+#ifdef __SSE__
+  _mm_empty();
+#endif
+}
+
+// `kAlphaOr` is combined with each decoded pixel, allowing formats with an unused alpha component to decode as opaque.
+template <typename Packer, uint32_t kAlphaOr>
+static void DecodePacked(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t source_pitch,
+                         uint32_t width, uint32_t height) {
+  typedef typename Packer::Pixel Pixel;
+  ForEachRow<Pixel, uint32_t>(reinterpret_cast<uint8_t *>(dest), dest_pitch, source, source_pitch, height,
+                              [width](const Pixel *in, uint32_t *out) {
+                                uint32_t x = 0;
+#ifdef __SSE__
+                                x = DecodeRowSSE<Packer>(in, out, width, kAlphaOr);
+#endif
+                                for (; x < width; ++x) {
+                                  out[x] = Packer::Unpack(in[x]) | kAlphaOr;
+                                }
+                              });
+#ifdef __SSE__
+  _mm_empty();
+#endif
+}
+
+// Two byte formats holding a pair of 8-bit color components, the first at byte 0 and the second at byte 1. The shifts
+// give the position of each component within an ABGR8888 color.
+template <uint32_t kLowShift, uint32_t kHighShift>
+static void EncodeTwoComponent(uint8_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch,
+                               uint32_t width, uint32_t height) {
+  ForEachRow<uint32_t, uint8_t>(dest, dest_pitch, reinterpret_cast<const uint8_t *>(source), source_pitch, height,
+                                [width](const uint32_t *in, uint8_t *out) {
+                                  for (uint32_t x = 0; x < width; ++x) {
+                                    *out++ = static_cast<uint8_t>(in[x] >> kLowShift);
+                                    *out++ = static_cast<uint8_t>(in[x] >> kHighShift);
+                                  }
+                                });
+}
+
+template <uint32_t kLowShift, uint32_t kHighShift>
+static void DecodeTwoComponent(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t source_pitch,
+                               uint32_t width, uint32_t height) {
+  ForEachRow<uint8_t, uint32_t>(reinterpret_cast<uint8_t *>(dest), dest_pitch, source, source_pitch, height,
+                                [width](const uint8_t *in, uint32_t *out) {
+                                  for (uint32_t x = 0; x < width; ++x, in += 2) {
+                                    out[x] = (static_cast<uint32_t>(in[0]) << kLowShift) |
+                                             (static_cast<uint32_t>(in[1]) << kHighShift) | kOpaque;
+                                  }
+                                });
+}
+
+static void EncodeLuminance(uint8_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch,
+                            uint32_t width, uint32_t height) {
+  ForEachRow<uint32_t, uint8_t>(dest, dest_pitch, reinterpret_cast<const uint8_t *>(source), source_pitch, height,
+                                [width](const uint32_t *in, uint8_t *out) {
+                                  for (uint32_t x = 0; x < width; ++x) {
+                                    out[x] = Luminance(in[x]);
+                                  }
+                                });
+}
+
+static DepthTextureFormat GetDepthFormat(TextureCodecFormat format) {
+  switch (format) {
+    case TEXTURE_CODEC_DEPTH_Y16_FLOAT:
+      return DEPTH_TEXTURE_Y16_FLOAT;
+    case TEXTURE_CODEC_DEPTH_X8_Y24_FIXED:
+      return DEPTH_TEXTURE_X8_Y24_FIXED;
+    case TEXTURE_CODEC_DEPTH_X8_Y24_FLOAT:
+      return DEPTH_TEXTURE_X8_Y24_FLOAT;
+    default:
+      return DEPTH_TEXTURE_Y16_FIXED;
+  }
+}
+
+static void EncodeDepth(uint8_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch,
+                        uint32_t width, uint32_t height, DepthTextureFormat depth_format) {
+  // Converting a row at a time keeps the luminance staging buffer small.
+  std::vector<uint8_t> luminance(width);
+  auto source_row = reinterpret_cast<const uint8_t *>(source);
+  for (uint32_t y = 0; y < height; ++y, dest += dest_pitch, source_row += source_pitch) {
+    EncodeLuminance(luminance.data(), width, reinterpret_cast<const uint32_t *>(source_row), source_pitch, width, 1);
+    ConvertToDepth(dest, dest_pitch, luminance.data(), width, width, 1, DEPTH_SOURCE_UNORM8, depth_format);
+  }
+}
+
+// Returns the 8-bit luminance of a depth texel, normalized to the range of the format.
+template <DepthTextureFormat kFormat>
+static inline uint32_t DepthToLuminance(uint32_t value) {
+  switch (kFormat) {
+    case DEPTH_TEXTURE_Y16_FIXED:
+      return value >> 8;
+    case DEPTH_TEXTURE_X8_Y24_FIXED:
+      return value >> 24;
+    case DEPTH_TEXTURE_Y16_FLOAT:
+      return static_cast<uint32_t>(DecodeZ16Float(static_cast<uint16_t>(value)) / kZ16FloatMax * 255.0f + 0.5f);
+    case DEPTH_TEXTURE_X8_Y24_FLOAT:
+      return static_cast<uint32_t>(DecodeZ24Float(value >> 8) / DecodeZ24Float(0xFEFFFF) * 255.0f + 0.5f);
+  }
+  return 0;
+}
+
+template <typename TexelType, DepthTextureFormat kFormat>
+static void DecodeDepth(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t source_pitch,
+                        uint32_t width, uint32_t height) {
+  ForEachRow<TexelType, uint32_t>(reinterpret_cast<uint8_t *>(dest), dest_pitch, source, source_pitch, height,
+                                  [width](const TexelType *in, uint32_t *out) {
+                                    for (uint32_t x = 0; x < width; ++x) {
+                                      out[x] = Gray(DepthToLuminance<kFormat>(in[x]));
+                                    }
+                                  });
+}
+
+static int EncodePalettized(uint8_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch,
+                            uint32_t width, uint32_t height, uint32_t *palette) {
+  if (!palette) {
+    return 1;
+  }
+
+  // The quantizer operates on (and produces) A8R8G8B8 colors.
+  std::vector<uint32_t> argb(width * height);
+  auto source_row = reinterpret_cast<const uint8_t *>(source);
+  for (uint32_t y = 0; y < height; ++y, source_row += source_pitch) {
+    auto in = reinterpret_cast<const uint32_t *>(source_row);
+    for (uint32_t x = 0; x < width; ++x) {
+      argb[y * width + x] = SwapRedBlue(in[x]);
+    }
+  }
+
+  return QuantizeImage(palette, 256, dest, dest_pitch, argb.data(), width * 4, width, height);
+}
+
+static int DecodePalettized(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t source_pitch,
+                            uint32_t width, uint32_t height, const uint32_t *palette) {
+  if (!palette) {
+    return 1;
+  }
+
+  uint32_t colors[256];
+  for (uint32_t i = 0; i < 256; ++i) {
+    colors[i] = SwapRedBlue(palette[i]);
+  }
+
+  ForEachRow<uint8_t, uint32_t>(reinterpret_cast<uint8_t *>(dest), dest_pitch, source, source_pitch, height,
+                                [width, &colors](const uint8_t *in, uint32_t *out) {
+                                  for (uint32_t x = 0; x < width; ++x) {
+                                    out[x] = colors[in[x]];
+                                  }
+                                });
+  return 0;
+}
+
+uint32_t GetTextureCodecBitsPerPixel(TextureCodecFormat format) {
+  switch (format) {
+    case TEXTURE_CODEC_A8B8G8R8:
+    case TEXTURE_CODEC_R8G8B8A8:
+    case TEXTURE_CODEC_A8R8G8B8:
+    case TEXTURE_CODEC_X8R8G8B8:
+    case TEXTURE_CODEC_B8G8R8A8:
+    case TEXTURE_CODEC_DEPTH_X8_Y24_FIXED:
+    case TEXTURE_CODEC_DEPTH_X8_Y24_FLOAT:
+      return 32;
+
+    case TEXTURE_CODEC_R5G6B5:
+    case TEXTURE_CODEC_A1R5G5B5:
+    case TEXTURE_CODEC_X1R5G5B5:
+    case TEXTURE_CODEC_A4R4G4B4:
+    case TEXTURE_CODEC_A8Y8:
+    case TEXTURE_CODEC_Y16:
+    case TEXTURE_CODEC_G8B8:
+    case TEXTURE_CODEC_R8B8:
+    case TEXTURE_CODEC_YUY2:
+    case TEXTURE_CODEC_UYVY:
+    case TEXTURE_CODEC_DEPTH_Y16_FIXED:
+    case TEXTURE_CODEC_DEPTH_Y16_FLOAT:
+      return 16;
+
+    case TEXTURE_CODEC_Y8:
+    case TEXTURE_CODEC_AY8:
+    case TEXTURE_CODEC_I8_A8R8G8B8:
+    case TEXTURE_CODEC_DXT3:
+    case TEXTURE_CODEC_DXT5:
+      return 8;
+
+    case TEXTURE_CODEC_DXT1:
+      return 4;
+
+    case TEXTURE_CODEC_NONE:
+      break;
+  }
+  return 0;
+}
+
+uint32_t GetTextureCodecPitch(TextureCodecFormat format, uint32_t width) {
+  switch (format) {
+    case TEXTURE_CODEC_DXT1:
+    case TEXTURE_CODEC_DXT3:
+    case TEXTURE_CODEC_DXT5:
+      // A row of blocks holds 4 rows of pixels.
+      return (width + 3) / 4 * GetTextureCodecBitsPerPixel(format) * 2;
+
+    default:
+      return width * GetTextureCodecBitsPerPixel(format) / 8;
+  }
+}
+
+uint32_t GetTextureCodecSize(TextureCodecFormat format, uint32_t width, uint32_t height) {
+  switch (format) {
+    case TEXTURE_CODEC_DXT1:
+    case TEXTURE_CODEC_DXT3:
+    case TEXTURE_CODEC_DXT5:
+      return GetTextureCodecPitch(format, width) * ((height + 3) / 4);
+
+    default:
+      return GetTextureCodecPitch(format, width) * height;
+  }
+}
+
+int EncodeTexture(uint8_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch, uint32_t width,
+                  uint32_t height, TextureCodecFormat format, uint32_t *palette) {
+  if (WithPixelPacker(format, [&](auto packer) {
+        EncodePacked<decltype(packer)>(dest, dest_pitch, source, source_pitch, width, height);
+      })) {
+    return 0;
+  }
+
+  switch (format) {
+    case TEXTURE_CODEC_Y8:
+    case TEXTURE_CODEC_AY8:
+      EncodeLuminance(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_A8Y8:
+      ForEachRow<uint32_t, uint8_t>(dest, dest_pitch, reinterpret_cast<const uint8_t *>(source), source_pitch, height,
+                                    [width](const uint32_t *in, uint8_t *out) {
+                                      for (uint32_t x = 0; x < width; ++x) {
+                                        *out++ = Luminance(in[x]);
+                                        *out++ = static_cast<uint8_t>(in[x] >> 24);
+                                      }
+                                    });
+      break;
+
+    case TEXTURE_CODEC_Y16:
+    case TEXTURE_CODEC_DEPTH_Y16_FIXED:
+    case TEXTURE_CODEC_DEPTH_Y16_FLOAT:
+    case TEXTURE_CODEC_DEPTH_X8_Y24_FIXED:
+    case TEXTURE_CODEC_DEPTH_X8_Y24_FLOAT:
+      EncodeDepth(dest, dest_pitch, source, source_pitch, width, height, GetDepthFormat(format));
+      break;
+
+    case TEXTURE_CODEC_G8B8:
+      EncodeTwoComponent<16, 8>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_R8B8:
+      EncodeTwoComponent<16, 0>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_YUY2:
+      ConvertRGBToYUY2(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_UYVY:
+      ConvertRGBToUYVY(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_DXT1:
+      CompressDXT1(dest, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_DXT3:
+      CompressDXT3(dest, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_DXT5:
+      CompressDXT5(dest, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_I8_A8R8G8B8:
+      return EncodePalettized(dest, dest_pitch, source, source_pitch, width, height, palette);
+
+    default:
+      // Packed RGB formats are handled above.
+      return 1;
+  }
+
+  return 0;
+}
+
+int DecodeTexture(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t source_pitch, uint32_t width,
+                  uint32_t height, TextureCodecFormat format, const uint32_t *palette) {
+  switch (format) {
+    case TEXTURE_CODEC_A8B8G8R8:
+      DecodePacked<PackABGR8888, 0>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_R8G8B8A8:
+      DecodePacked<PackRGBA8888, 0>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_A8R8G8B8:
+      DecodePacked<PackARGB8888, 0>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_X8R8G8B8:
+      DecodePacked<PackARGB8888, kOpaque>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_B8G8R8A8:
+      DecodePacked<PackBGRA8888, 0>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_R5G6B5:
+      DecodePacked<PackRGB565, 0>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_A1R5G5B5:
+      DecodePacked<PackARGB1555, 0>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_X1R5G5B5:
+      DecodePacked<PackARGB1555, kOpaque>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_A4R4G4B4:
+      DecodePacked<PackARGB4444, 0>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_Y8:
+    case TEXTURE_CODEC_AY8: {
+      const bool luminance_alpha = format == TEXTURE_CODEC_AY8;
+      ForEachRow<uint8_t, uint32_t>(reinterpret_cast<uint8_t *>(dest), dest_pitch, source, source_pitch, height,
+                                    [width, luminance_alpha](const uint8_t *in, uint32_t *out) {
+                                      for (uint32_t x = 0; x < width; ++x) {
+                                        out[x] = Gray(in[x], luminance_alpha ? in[x] : 0xFF);
+                                      }
+                                    });
+    } break;
+
+    case TEXTURE_CODEC_A8Y8:
+      ForEachRow<uint8_t, uint32_t>(reinterpret_cast<uint8_t *>(dest), dest_pitch, source, source_pitch, height,
+                                    [width](const uint8_t *in, uint32_t *out) {
+                                      for (uint32_t x = 0; x < width; ++x, in += 2) {
+                                        out[x] = Gray(in[0], in[1]);
+                                      }
+                                    });
+      break;
+
+    case TEXTURE_CODEC_Y16:
+    case TEXTURE_CODEC_DEPTH_Y16_FIXED:
+      DecodeDepth<uint16_t, DEPTH_TEXTURE_Y16_FIXED>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_DEPTH_Y16_FLOAT:
+      DecodeDepth<uint16_t, DEPTH_TEXTURE_Y16_FLOAT>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_DEPTH_X8_Y24_FIXED:
+      DecodeDepth<uint32_t, DEPTH_TEXTURE_X8_Y24_FIXED>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_DEPTH_X8_Y24_FLOAT:
+      DecodeDepth<uint32_t, DEPTH_TEXTURE_X8_Y24_FLOAT>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_G8B8:
+      DecodeTwoComponent<16, 8>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_R8B8:
+      DecodeTwoComponent<16, 0>(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_YUY2:
+      ConvertYUY2ToRGB(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_UYVY:
+      ConvertUYVYToRGB(dest, dest_pitch, source, source_pitch, width, height);
+      break;
+
+    case TEXTURE_CODEC_DXT1:
+      DecompressDXT1(dest, dest_pitch, source, width, height);
+      break;
+
+    case TEXTURE_CODEC_DXT3:
+      DecompressDXT3(dest, dest_pitch, source, width, height);
+      break;
+
+    case TEXTURE_CODEC_DXT5:
+      DecompressDXT5(dest, dest_pitch, source, width, height);
+      break;
+
+    case TEXTURE_CODEC_I8_A8R8G8B8:
+      return DecodePalettized(dest, dest_pitch, source, source_pitch, width, height, palette);
+
+    case TEXTURE_CODEC_NONE:
+      return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+#ifndef NXDK_PGRAPH_TESTS_TEXTURE_CODEC_H
+#define NXDK_PGRAPH_TESTS_TEXTURE_CODEC_H
+
+#include <cstdint>
+
+// Conversion between 32bpp ABGR8888 images (R, G, B, A in memory order, as used by PixelPacker and the DXT and YUV
+// converters) and the texel encodings of the NV2A texture formats. Swizzled and linear variants of a format share an
+// encoding, the codec always operates on linear data (see third_party/swizzle.h). Pitches are in bytes.
+//
+// Encoding produces the same bytes as TextureStage::SetTexture. Decoding expands packed components by bit replication
+// so that the full range maps onto [0, 255], and components that a format does not store decode as 0 (alpha as 0xFF).
+// Luminance and depth formats decode to gray; depth values are normalized to the range of the format before being
+// reduced to 8 bits.
+
+enum TextureCodecFormat {
+  TEXTURE_CODEC_NONE,
+
+  TEXTURE_CODEC_A8B8G8R8,
+  TEXTURE_CODEC_R8G8B8A8,
+  TEXTURE_CODEC_A8R8G8B8,
+  TEXTURE_CODEC_X8R8G8B8,
+  TEXTURE_CODEC_B8G8R8A8,
+  TEXTURE_CODEC_R5G6B5,
+  TEXTURE_CODEC_A1R5G5B5,
+  TEXTURE_CODEC_X1R5G5B5,
+  TEXTURE_CODEC_A4R4G4B4,
+
+  TEXTURE_CODEC_Y8,
+  // Luminance that is also used as alpha.
+  TEXTURE_CODEC_AY8,
+  TEXTURE_CODEC_A8Y8,
+  TEXTURE_CODEC_Y16,
+  TEXTURE_CODEC_G8B8,
+  TEXTURE_CODEC_R8B8,
+
+  // 4:2:2 YUV, widths must be even.
+  TEXTURE_CODEC_YUY2,
+  TEXTURE_CODEC_UYVY,
+
+  // Encoded from the luminance of the source, treated as a normalized depth value.
+  TEXTURE_CODEC_DEPTH_Y16_FIXED,
+  TEXTURE_CODEC_DEPTH_Y16_FLOAT,
+  TEXTURE_CODEC_DEPTH_X8_Y24_FIXED,
+  TEXTURE_CODEC_DEPTH_X8_Y24_FLOAT,
+
+  // Compressed blocks are written contiguously and the pitch arguments for the compressed side are ignored.
+  TEXTURE_CODEC_DXT1,
+  TEXTURE_CODEC_DXT3,
+  TEXTURE_CODEC_DXT5,
+
+  // 8-bit indices into a 256 entry A8R8G8B8 palette (the layout expected by TestHost::SetPalette).
+  TEXTURE_CODEC_I8_A8R8G8B8,
+};
+
+// Returns the number of bits per texel (per pixel, averaged over a block for compressed formats).
+uint32_t GetTextureCodecBitsPerPixel(TextureCodecFormat format);
+
+// Returns the number of bytes in a tightly packed row (a row of 4x4 blocks for compressed formats).
+uint32_t GetTextureCodecPitch(TextureCodecFormat format, uint32_t width);
+
+// Returns the number of bytes needed to hold a tightly packed `width` x `height` image.
+uint32_t GetTextureCodecSize(TextureCodecFormat format, uint32_t width, uint32_t height);
+
+// Encodes a `width` x `height` ABGR8888 image. Palettized formats quantize the image and write the palette to
+// `palette`, which must hold 256 entries. Returns 0 on success.
+int EncodeTexture(uint8_t *dest, uint32_t dest_pitch, const uint32_t *source, uint32_t source_pitch, uint32_t width,
+                  uint32_t height, TextureCodecFormat format, uint32_t *palette = nullptr);
+
+// Decodes a `width` x `height` image into ABGR8888. Palettized formats look indices up in `palette`. Returns 0 on
+// success.
+int DecodeTexture(uint32_t *dest, uint32_t dest_pitch, const uint8_t *source, uint32_t source_pitch, uint32_t width,
+                  uint32_t height, TextureCodecFormat format, const uint32_t *palette = nullptr);
+
+#endif  // NXDK_PGRAPH_TESTS_TEXTURE_CODEC_H
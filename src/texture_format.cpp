@@ -33,8 +33,10 @@ constexpr TextureFormatInfo kTextureFormats[] = {
     {SDL_PIXELFORMAT_RGBA8888, NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_G8B8, 16, false, true, true, "G8B8"},
     //    {SDL_PIXELFORMAT_RGBA8888, NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_R8B8, 16, false, true, true, "R8B8"},
 
-    {SDL_PIXELFORMAT_RGBA8888, NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FIXED, 32, false, true, false,
+    {SDL_PIXELFORMAT_RGBA8888, NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FIXED, 32, false, true, true,
      "D_X8Y24_FIXED"},
+    {SDL_PIXELFORMAT_RGBA8888, NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FLOAT, 32, false, true, true,
+     "D_X8Y24_FLOAT"},
     {SDL_PIXELFORMAT_RGBA8888, NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FIXED, 16, false, true, true,
      "D_Y16_FIXED"},
     {SDL_PIXELFORMAT_RGBA8888, NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FLOAT, 16, false, true, true,
@@ -88,3 +90,98 @@ const TextureFormatInfo &GetTextureFormatInfo(uint32_t nv_texture_format) {
   ASSERT(!"Unknown texture format.");
   return kInvalidTextureFormatInfo;
 }
+
+TextureCodecFormat GetTextureCodecFormat(uint32_t nv_texture_format) {
+  switch (nv_texture_format) {
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8B8G8R8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_A8B8G8R8:
+      return TEXTURE_CODEC_A8B8G8R8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_R8G8B8A8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_R8G8B8A8:
+      return TEXTURE_CODEC_R8G8B8A8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8R8G8B8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_A8R8G8B8:
+      return TEXTURE_CODEC_A8R8G8B8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_X8R8G8B8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_X8R8G8B8:
+      return TEXTURE_CODEC_X8R8G8B8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_B8G8R8A8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_B8G8R8A8:
+      return TEXTURE_CODEC_B8G8R8A8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_R5G6B5:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_R5G6B5:
+      return TEXTURE_CODEC_R5G6B5;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A1R5G5B5:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_A1R5G5B5:
+      return TEXTURE_CODEC_A1R5G5B5;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_X1R5G5B5:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_X1R5G5B5:
+      return TEXTURE_CODEC_X1R5G5B5;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A4R4G4B4:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_A4R4G4B4:
+      return TEXTURE_CODEC_A4R4G4B4;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_Y8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_Y8:
+      return TEXTURE_CODEC_Y8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_AY8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_AY8:
+      return TEXTURE_CODEC_AY8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8Y8:
+      return TEXTURE_CODEC_A8Y8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_Y16:
+      return TEXTURE_CODEC_Y16;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_G8B8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_G8B8:
+      return TEXTURE_CODEC_G8B8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_R8B8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_R8B8:
+      return TEXTURE_CODEC_R8B8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LC_IMAGE_CR8YB8CB8YA8:
+      return TEXTURE_CODEC_YUY2;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LC_IMAGE_YB8CR8YA8CB8:
+      return TEXTURE_CODEC_UYVY;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FIXED:
+      return TEXTURE_CODEC_DEPTH_Y16_FIXED;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FLOAT:
+      return TEXTURE_CODEC_DEPTH_Y16_FLOAT;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FIXED:
+      return TEXTURE_CODEC_DEPTH_X8_Y24_FIXED;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_X8_Y24_FLOAT:
+      return TEXTURE_CODEC_DEPTH_X8_Y24_FLOAT;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT1_A1R5G5B5:
+      return TEXTURE_CODEC_DXT1;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8:
+      return TEXTURE_CODEC_DXT3;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8:
+      return TEXTURE_CODEC_DXT5;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_I8_A8R8G8B8:
+      return TEXTURE_CODEC_I8_A8R8G8B8;
+
+    default:
+      return TEXTURE_CODEC_NONE;
+  }
+}
@@ -3,6 +3,8 @@
 
 #include <SDL.h>
 
+#include "texture_codec.h"
+
 typedef struct TextureFormatInfo {
   SDL_PixelFormatEnum sdl_format{SDL_PIXELFORMAT_ARGB8888};
   uint32_t xbox_format{0};
@@ -18,4 +20,7 @@ extern const int kNumFormats;
 
 const TextureFormatInfo &GetTextureFormatInfo(uint32_t nv_texture_format);
 
+// Returns the codec for the texel encoding of the given format, or TEXTURE_CODEC_NONE if it is not supported.
+TextureCodecFormat GetTextureCodecFormat(uint32_t nv_texture_format);
+
 #endif  // NXDK_PGRAPH_TESTS_TEXTURE_FORMAT_H
@@ -1,55 +1,6 @@
 #include "texture_generator.h"
 
-#include "swizzle.h"
-
-void GenerateRGBACheckerboard(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
-                              uint32_t pitch, uint32_t first_color, uint32_t second_color, uint32_t checker_size) {
-  auto buffer = reinterpret_cast<uint8_t *>(target);
-  auto odd = first_color;
-  auto even = second_color;
-  buffer += y_offset * pitch;
-
-  for (uint32_t y = 0; y < height; ++y) {
-    auto pixel = reinterpret_cast<uint32_t *>(buffer);
-    pixel += x_offset;
-    buffer += pitch;
-
-    if (!(y % checker_size)) {
-      auto temp = odd;
-      odd = even;
-      even = temp;
-    }
-
-    for (uint32_t x = 0; x < width; ++x) {
-      *pixel++ = ((x / checker_size) & 0x01) ? odd : even;
-    }
-  }
-}
-
-void GenerateSwizzledRGBACheckerboard(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width,
-                                      uint32_t height, uint32_t pitch, uint32_t first_color, uint32_t second_color,
-                                      uint32_t checker_size) {
-  const uint32_t size = height * pitch;
-  auto temp_buffer = new uint8_t[size];
-  memcpy(temp_buffer, target, size);
-
-  GenerateRGBACheckerboard(temp_buffer, x_offset, y_offset, width, height, pitch, first_color, second_color,
-                           checker_size);
-  swizzle_rect(temp_buffer, width, height, reinterpret_cast<uint8_t *>(target), pitch, 4);
-  delete[] temp_buffer;
-}
-
-void GenerateRGBATestPattern(void *target, uint32_t width, uint32_t height) {
-  auto pixels = static_cast<uint32_t *>(target);
-  for (uint32_t y = 0; y < height; ++y) {
-    auto y_normal = static_cast<uint32_t>(static_cast<float>(y) * 255.0f / static_cast<float>(height));
-
-    for (uint32_t x = 0; x < width; ++x, ++pixels) {
-      auto x_normal = static_cast<uint32_t>(static_cast<float>(x) * 255.0f / static_cast<float>(width));
-      *pixels = y_normal + (x_normal << 8) + ((255 - y_normal) << 16) + ((x_normal + y_normal) << 24);
-    }
-  }
-}
+#include "pixel_packer.h"
 
 int GenerateSurface(SDL_Surface **surface, int width, int height) {
   *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888);
@@ -63,38 +14,13 @@ int GenerateSurface(SDL_Surface **surface, int width, int height) {
     return 2;
   }
 
+  // The gradient rows are ABGR8888, which is the byte reversal of the surface's RGBA8888.
+  const GradientRowGenerator generate_row(width, height);
   auto pixels = static_cast<uint32_t *>((*surface)->pixels);
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x, ++pixels) {
-      int x_normal = static_cast<int>(static_cast<float>(x) * 255.0f / static_cast<float>(width));
-      int y_normal = static_cast<int>(static_cast<float>(y) * 255.0f / static_cast<float>(height));
-      *pixels = SDL_MapRGBA((*surface)->format, y_normal, x_normal, 255 - y_normal, x_normal + y_normal);
-    }
-  }
-
-  SDL_UnlockSurface(*surface);
-
-  return 0;
-}
-
-int GenerateCheckboardSurface(SDL_Surface **surface, int width, int height) {
-  *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888);
-  if (!(*surface)) {
-    return 1;
-  }
-
-  if (SDL_LockSurface(*surface)) {
-    SDL_FreeSurface(*surface);
-    *surface = nullptr;
-    return 2;
-  }
-
-  auto pixels = static_cast<uint32_t *>((*surface)->pixels);
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x, ++pixels) {
-      int x_normal = static_cast<int>(static_cast<float>(x) * 255.0f / static_cast<float>(width));
-      int y_normal = static_cast<int>(static_cast<float>(y) * 255.0f / static_cast<float>(height));
-      *pixels = SDL_MapRGBA((*surface)->format, y_normal, x_normal, 255 - y_normal, x_normal + y_normal);
+  for (int y = 0; y < height; ++y, pixels += width) {
+    generate_row(y, pixels);
+    for (int x = 0; x < width; ++x) {
+      pixels[x] = __builtin_bswap32(pixels[x]);
     }
   }
 
@@ -124,34 +50,6 @@ int GenerateCheckerboardSurface(SDL_Surface **surface, int width, int height, ui
   return 0;
 }
 
-void GenerateColoredCheckerboard(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
-                                 uint32_t pitch, const uint32_t *colors, uint32_t num_colors, uint32_t checker_size) {
-  auto buffer = reinterpret_cast<uint8_t *>(target);
-  buffer += y_offset * pitch;
-
-  uint32_t row_color_index = 0;
-
-  for (uint32_t y = 0; y < height; ++y) {
-    auto pixel = reinterpret_cast<uint32_t *>(buffer);
-    pixel += x_offset;
-    buffer += pitch;
-
-    if (y && !(y % checker_size)) {
-      row_color_index = ++row_color_index % num_colors;
-    }
-
-    auto color_index = row_color_index;
-    auto color = colors[color_index];
-    for (uint32_t x = 0; x < width; ++x) {
-      if (x && !(x % checker_size)) {
-        color_index = ++color_index % num_colors;
-        color = colors[color_index];
-      }
-      *pixel++ = color;
-    }
-  }
-}
-
 int GenerateColoredCheckerboardSurface(SDL_Surface **gradient_surface, int width, int height, uint32_t checker_size) {
   *gradient_surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888);
   if (!(*gradient_surface)) {
@@ -183,3 +81,73 @@ int GenerateColoredCheckerboardSurface(SDL_Surface **gradient_surface, int width
 
   return 0;
 }
+
+// Colors used by GenerateColoredCheckerboardSurface, in ABGR8888.
+static constexpr uint32_t kColoredCheckerboardColors[] = {
+    0xFF0000FF, 0x660000FF, 0xFF00FF00, 0x6600FF00, 0xFFFF4444, 0x66FF4444, 0xFFFFFFFF, 0x66FFFFFF,
+};
+
+template <typename RowGenerator>
+static int GenerateTexture(uint8_t *dest, uint32_t width, uint32_t height, const TextureFormatInfo &format,
+                           RowGenerator generate_row) {
+  if (format.require_conversion) {
+    return 1;
+  }
+
+  const bool swizzle = format.xbox_swizzled;
+  const bool packed = WithPixelPacker(GetTextureCodecFormat(format.xbox_format), [&](auto packer) {
+    WritePackedImage<decltype(packer)>(dest, width, height, swizzle, generate_row);
+  });
+  return packed ? 0 : 2;
+}
+
+int GenerateGradientTexture(uint8_t *dest, uint32_t width, uint32_t height, const TextureFormatInfo &format) {
+  const GradientRowGenerator generate_row(width, height);
+  return GenerateTexture(dest, width, height, format, generate_row);
+}
+
+int GenerateCheckerboardTexture(uint8_t *dest, uint32_t width, uint32_t height, const TextureFormatInfo &format,
+                                uint32_t first_color, uint32_t second_color, uint32_t checker_size) {
+  const uint32_t colors[] = {first_color, second_color};
+  const CheckerboardRowGenerator generate_row(width, colors, 2, checker_size);
+  return GenerateTexture(dest, width, height, format, generate_row);
+}
+
+int GenerateColoredCheckerboardTexture(uint8_t *dest, uint32_t width, uint32_t height, const TextureFormatInfo &format,
+                                       uint32_t checker_size) {
+  static constexpr uint32_t kNumColors = sizeof(kColoredCheckerboardColors) / sizeof(kColoredCheckerboardColors[0]);
+  const CheckerboardRowGenerator generate_row(width, kColoredCheckerboardColors, kNumColors, checker_size);
+  return GenerateTexture(dest, width, height, format, generate_row);
+}
+
+// Generator IDs used to key GeneratedImageCache entries.
+enum CachedGenerator {
+  CACHED_GRADIENT = 1,
+  CACHED_CHECKERBOARD,
+};
+
+std::shared_ptr<const GeneratedImageCache::Image> GetGradientImage(uint32_t width, uint32_t height) {
+  const GeneratedImageCache::Key key{CACHED_GRADIENT, width, height, {}};
+  return GeneratedImageCache::Shared().Get(key, [](uint32_t *pixels, uint32_t width, uint32_t height) {
+    const GradientRowGenerator generate_row(width, height);
+    for (uint32_t y = 0; y < height; ++y, pixels += width) {
+      generate_row(y, pixels);
+    }
+  });
+}
+
+std::shared_ptr<const GeneratedImageCache::Image> GetCheckerboardImage(uint32_t width, uint32_t height,
+                                                                       uint32_t first_color, uint32_t second_color,
+                                                                       uint32_t checker_size) {
+  const GeneratedImageCache::Key key{CACHED_CHECKERBOARD, width, height, {first_color, second_color, checker_size}};
+  return GeneratedImageCache::Shared().Get(key, [=](uint32_t *pixels, uint32_t width, uint32_t height) {
+    GenerateRGBACheckerboard(pixels, 0, 0, width, height, width * 4, first_color, second_color, checker_size);
+  });
+}
+
+int CreateSurfaceFromImage(SDL_Surface **surface, const GeneratedImageCache::Image &image) {
+  *surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint32_t *>(image.pixels.data()),
+                                                static_cast<int>(image.width), static_cast<int>(image.height), 32,
+                                                static_cast<int>(image.GetPitch()), SDL_PIXELFORMAT_ABGR8888);
+  return *surface ? 0 : 1;
+}
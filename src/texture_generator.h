@@ -4,24 +4,37 @@
 #include <SDL.h>
 
 #include <cstdint>
+#include <memory>
 
-// Inserts a rectangular checkerboard pattern into the given 32bpp texture buffer.
-void GenerateRGBACheckerboard(void *buffer, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
-                              uint32_t pitch, uint32_t first_color = 0xFF00FFFF, uint32_t second_color = 0xFF000000,
-                              uint32_t checker_size = 8);
-
-void GenerateColoredCheckerboard(void *buffer, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
-                                 uint32_t pitch, const uint32_t *colors, uint32_t num_colors,
-                                 uint32_t checker_size = 8);
-
-void GenerateSwizzledRGBACheckerboard(void *buffer, uint32_t x_offset, uint32_t y_offset, uint32_t width,
-                                      uint32_t height, uint32_t pitch, uint32_t first_color = 0xFF00FFFF,
-                                      uint32_t second_color = 0xFF000000, uint32_t checker_size = 8);
-
-void GenerateRGBATestPattern(void *target, uint32_t width, uint32_t height);
+#include "generated_image_cache.h"
+#include "pattern_generator.h"
+#include "texture_format.h"
 
 int GenerateSurface(SDL_Surface **surface, int width, int height);
 int GenerateCheckerboardSurface(SDL_Surface **surface, int width, int height, uint32_t first_color = 0xFF00FFFF,
                                 uint32_t second_color = 0xFF000000, uint32_t checker_size = 8);
 int GenerateColoredCheckerboardSurface(SDL_Surface **surface, int width, int height, uint32_t checker_size = 4);
+
+// The following generate the same images as their *Surface counterparts directly into `dest` in the layout of `format`
+// (swizzled or linear), producing the same bytes as uploading the surface via TextureStage::SetTexture without the
+// intermediate surface conversion. Formats that require a custom conversion are not supported and return non-zero.
+int GenerateGradientTexture(uint8_t *dest, uint32_t width, uint32_t height, const TextureFormatInfo &format);
+int GenerateCheckerboardTexture(uint8_t *dest, uint32_t width, uint32_t height, const TextureFormatInfo &format,
+                                uint32_t first_color = 0xFF00FFFF, uint32_t second_color = 0xFF000000,
+                                uint32_t checker_size = 8);
+int GenerateColoredCheckerboardTexture(uint8_t *dest, uint32_t width, uint32_t height, const TextureFormatInfo &format,
+                                       uint32_t checker_size = 4);
+
+// The following return the images of their *Surface counterparts from GeneratedImageCache::Shared(), generating them
+// only if they are not already cached.
+std::shared_ptr<const GeneratedImageCache::Image> GetGradientImage(uint32_t width, uint32_t height);
+std::shared_ptr<const GeneratedImageCache::Image> GetCheckerboardImage(uint32_t width, uint32_t height,
+                                                                       uint32_t first_color = 0xFF00FFFF,
+                                                                       uint32_t second_color = 0xFF000000,
+                                                                       uint32_t checker_size = 8);
+
+// Creates an ABGR8888 surface that references the pixels of `image` without copying them. The surface must be treated
+// as read only and freed before `image` is released.
+int CreateSurfaceFromImage(SDL_Surface **surface, const GeneratedImageCache::Image &image);
+
 #endif  // NXDK_PGRAPH_TESTS_TEXTURE_GENERATOR_H
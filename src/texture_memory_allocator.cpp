@@ -0,0 +1,159 @@
+#include "texture_memory_allocator.h"
+
+#include <algorithm>
+
+static inline uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void TextureMemoryAllocator::Reset(uint32_t size) {
+  size_ = size;
+  allocations_.clear();
+  free_blocks_.clear();
+  if (size) {
+    free_blocks_.push_back({0, size});
+  }
+}
+
+TextureMemoryAllocator::Handle TextureMemoryAllocator::Allocate(uint32_t size, uint32_t alignment) {
+  if (!size || !alignment || (alignment & (alignment - 1))) {
+    return kInvalidHandle;
+  }
+  alignment = std::max(alignment, kDefaultAlignment);
+
+  for (auto it = free_blocks_.begin(); it != free_blocks_.end(); ++it) {
+    const uint64_t block_end = static_cast<uint64_t>(it->offset) + it->size;
+    const uint64_t offset = (static_cast<uint64_t>(it->offset) + alignment - 1) & ~static_cast<uint64_t>(alignment - 1);
+    if (offset + size > block_end) {
+      continue;
+    }
+
+    // Any padding needed for alignment remains in the free list in place of the original block.
+    const uint32_t leading = static_cast<uint32_t>(offset) - it->offset;
+    const uint32_t trailing = static_cast<uint32_t>(block_end - offset - size);
+    if (leading && trailing) {
+      it->size = leading;
+      free_blocks_.insert(it + 1, {static_cast<uint32_t>(offset) + size, trailing});
+    } else if (leading) {
+      it->size = leading;
+    } else if (trailing) {
+      it->offset += size;
+      it->size = trailing;
+    } else {
+      free_blocks_.erase(it);
+    }
+
+    Handle handle = next_handle_++;
+    if (next_handle_ == kInvalidHandle) {
+      next_handle_ = 1;
+    }
+
+    Allocation allocation{handle, static_cast<uint32_t>(offset), size, alignment};
+    auto insert_at = std::lower_bound(allocations_.begin(), allocations_.end(), allocation,
+                                      [](const Allocation &a, const Allocation &b) { return a.offset < b.offset; });
+    allocations_.insert(insert_at, allocation);
+    return handle;
+  }
+
+  return kInvalidHandle;
+}
+
+void TextureMemoryAllocator::Free(Handle handle) {
+  auto it = std::find_if(allocations_.begin(), allocations_.end(),
+                         [handle](const Allocation &allocation) { return allocation.handle == handle; });
+  if (it == allocations_.end()) {
+    return;
+  }
+
+  AddFreeBlock(it->offset, it->size);
+  allocations_.erase(it);
+}
+
+uint32_t TextureMemoryAllocator::GetOffset(Handle handle) const {
+  auto allocation = Find(handle);
+  return allocation ? allocation->offset : 0;
+}
+
+uint32_t TextureMemoryAllocator::GetSize(Handle handle) const {
+  auto allocation = Find(handle);
+  return allocation ? allocation->size : 0;
+}
+
+uint32_t TextureMemoryAllocator::Compact(const std::function<void(uint32_t, uint32_t, uint32_t)> &move) {
+  uint32_t num_moved = 0;
+  uint32_t cursor = 0;
+
+  free_blocks_.clear();
+  for (auto &allocation : allocations_) {
+    const uint32_t offset = AlignUp(cursor, allocation.alignment);
+    if (offset != cursor) {
+      free_blocks_.push_back({cursor, offset - cursor});
+    }
+
+    if (offset != allocation.offset) {
+      move(offset, allocation.offset, allocation.size);
+      allocation.offset = offset;
+      ++num_moved;
+    }
+    cursor = offset + allocation.size;
+  }
+
+  if (cursor < size_) {
+    free_blocks_.push_back({cursor, size_ - cursor});
+  }
+
+  return num_moved;
+}
+
+TextureMemoryAllocator::Stats TextureMemoryAllocator::GetStats() const {
+  Stats stats;
+  stats.num_allocations = allocations_.size();
+  for (auto &allocation : allocations_) {
+    stats.allocated_bytes += allocation.size;
+  }
+
+  stats.num_free_blocks = free_blocks_.size();
+  for (auto &block : free_blocks_) {
+    stats.free_bytes += block.size;
+    stats.largest_free_block = std::max(stats.largest_free_block, block.size);
+  }
+  return stats;
+}
+
+const TextureMemoryAllocator::Allocation *TextureMemoryAllocator::Find(Handle handle) const {
+  if (handle == kInvalidHandle) {
+    return nullptr;
+  }
+
+  for (auto &allocation : allocations_) {
+    if (allocation.handle == handle) {
+      return &allocation;
+    }
+  }
+  return nullptr;
+}
+
+void TextureMemoryAllocator::AddFreeBlock(uint32_t offset, uint32_t size) {
+  auto next = std::lower_bound(free_blocks_.begin(), free_blocks_.end(), offset,
+                               [](const FreeBlock &block, uint32_t value) { return block.offset < value; });
+
+  if (next != free_blocks_.begin()) {
+    auto prev = next - 1;
+    if (prev->offset + prev->size == offset) {
+      prev->size += size;
+      if (next != free_blocks_.end() && offset + size == next->offset) {
+        prev->size += next->size;
+        free_blocks_.erase(next);
+      }
+      return;
+    }
+  }
+
+  if (next != free_blocks_.end() && offset + size == next->offset) {
+    next->offset = offset;
+    next->size += size;
+    return;
+  }
+
+  free_blocks_.insert(next, {offset, size});
+}
@@ -0,0 +1,86 @@
+#ifndef NXDK_PGRAPH_TESTS_TEXTURE_MEMORY_ALLOCATOR_H
+#define NXDK_PGRAPH_TESTS_TEXTURE_MEMORY_ALLOCATOR_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Sub-allocates a fixed size region of texture memory, allowing multiple textures to remain resident at the same time.
+//
+// Allocations are identified by handles rather than offsets so that they may be relocated by Compact. Offsets are
+// relative to the start of the managed region. Free space is tracked as a list of blocks sorted by offset, adjacent
+// blocks are coalesced on Free, and new allocations are placed in the first block that fits.
+class TextureMemoryAllocator {
+ public:
+  typedef uint32_t Handle;
+
+  struct Stats {
+    uint32_t num_allocations{0};
+    uint32_t allocated_bytes{0};
+    uint32_t num_free_blocks{0};
+    uint32_t free_bytes{0};
+    uint32_t largest_free_block{0};
+  };
+
+  static constexpr Handle kInvalidHandle = 0;
+
+  // Minimum alignment of every allocation. The NV2A requires texture offsets to be aligned to 128 bytes.
+  static constexpr uint32_t kDefaultAlignment = 128;
+
+ public:
+  explicit TextureMemoryAllocator(uint32_t size = 0) { Reset(size); }
+
+  // Discards all allocations and manages a region of the given size.
+  void Reset(uint32_t size);
+
+  // Returns a handle to `size` bytes aligned to the larger of `alignment` and kDefaultAlignment, or kInvalidHandle if
+  // there is no free block large enough or the alignment is not a power of two.
+  Handle Allocate(uint32_t size, uint32_t alignment = kDefaultAlignment);
+
+  // Releases the given allocation. Invalid handles are ignored.
+  void Free(Handle handle);
+
+  bool IsValid(Handle handle) const { return Find(handle) != nullptr; }
+
+  // Returns the offset/size of the given allocation, which must be valid.
+  uint32_t GetOffset(Handle handle) const;
+  uint32_t GetSize(Handle handle) const;
+
+  // Moves allocations toward the start of the region, in increasing offset order, so that all free space forms a single
+  // block at the end. `move` is invoked with (dest_offset, source_offset, size) for every allocation that is relocated
+  // and must copy with memmove semantics, as the ranges may overlap. Handles remain valid. Returns the number of
+  // allocations that were moved.
+  uint32_t Compact(const std::function<void(uint32_t, uint32_t, uint32_t)> &move);
+
+  Stats GetStats() const;
+
+  uint32_t GetRegionSize() const { return size_; }
+
+ private:
+  struct Allocation {
+    Handle handle;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t alignment;
+  };
+
+  struct FreeBlock {
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  const Allocation *Find(Handle handle) const;
+
+  // Adds the given range to the free list, merging it with any adjacent blocks.
+  void AddFreeBlock(uint32_t offset, uint32_t size);
+
+ private:
+  uint32_t size_{0};
+  Handle next_handle_{1};
+
+  // Both lists are sorted by offset.
+  std::vector<Allocation> allocations_;
+  std::vector<FreeBlock> free_blocks_;
+};
+
+#endif  // NXDK_PGRAPH_TESTS_TEXTURE_MEMORY_ALLOCATOR_H
@@ -1,14 +1,32 @@
 #include "texture_stage.h"
 
+#include <vector>
+
 #include "debug_output.h"
 #include "math3d.h"
 #include "nxdk_ext.h"
 #include "pbkit_ext.h"
 #include "swizzle.h"
+#include "texture_codec.h"
 
 // bitscan forward
 static int bsf(int val){__asm bsf eax, val}
 
+// Returns the size of a 4x4 block for compressed formats, or 0 for uncompressed formats.
+static uint32_t GetCompressedBlockSize(uint32_t xbox_format) {
+  switch (xbox_format) {
+    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT1_A1R5G5B5:
+      return 8;
+
+    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT23_A8R8G8B8:
+    case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT45_A8R8G8B8:
+      return 16;
+
+    default:
+      return 0;
+  }
+}
+
 TextureStage::TextureStage() {
   matrix_unit(texture_matrix_);
 }
@@ -134,221 +152,44 @@ void TextureStage::SetFilter(uint32_t lod_bias, TextureStage::ConvolutionKernel
 }
 
 int TextureStage::SetTexture(const SDL_Surface *surface, uint8_t *memory_base) const {
-  auto pixels = static_cast<uint32_t *>(surface->pixels);
-
-  // if conversion required, do so, otherwise use SDL to convert
+  // Formats that SDL cannot produce are encoded by the texture codec from an ABGR8888 copy of the surface.
   if (format_.require_conversion) {
-    uint8_t *dest = memory_base + texture_memory_offset_;
+    const TextureCodecFormat codec_format = GetTextureCodecFormat(format_.xbox_format);
+    if (codec_format == TEXTURE_CODEC_NONE) {
+      return 3;
+    }
 
-    // Buffer for formats that need to be swizzled after conversion.
-    uint32_t swizzle_w = surface->w;
-    uint32_t swizzle_h = surface->h;
-    uint32_t swizzle_depth = 1;
-    uint32_t swizzle_pitch = surface->pitch;
-    uint32_t swizzle_bpp = surface->format->BytesPerPixel;
-    uint8_t *converted = nullptr;
-
-    // TODO: potential reference material -
-    // https://github.com/scalablecory/colors/blob/master/color.c
-    switch (format_.xbox_format) {
-      case NV097_SET_TEXTURE_FORMAT_COLOR_LC_IMAGE_CR8YB8CB8YA8:  // YUY2 aka
-                                                                  // YUYV
-      {
-        uint32_t *source = pixels;
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; x += 2, source += 2) {
-            uint8_t R0, G0, B0, R1, G1, B1;
-            SDL_GetRGB(source[0], surface->format, &R0, &G0, &B0);
-            SDL_GetRGB(source[1], surface->format, &R1, &G1, &B1);
-            dest[0] = (0.257f * R0) + (0.504f * G0) + (0.098f * B0) + 16;    // Y0
-            dest[1] = -(0.148f * R1) - (0.291f * G1) + (0.439f * B1) + 128;  // U
-            dest[2] = (0.257f * R1) + (0.504f * G1) + (0.098f * B1) + 16;    // Y1
-            dest[3] = (0.439f * R1) - (0.368f * G1) - (0.071f * B1) + 128;   // V
-            dest += 4;
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_LC_IMAGE_YB8CR8YA8CB8:  // UYVY
-      {
-        uint32_t *source = pixels;
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; x += 2, source += 2) {
-            uint8_t R0, G0, B0, R1, G1, B1;
-            SDL_GetRGB(source[0], surface->format, &R0, &G0, &B0);
-            SDL_GetRGB(source[1], surface->format, &R1, &G1, &B1);
-            dest[0] = -(0.148f * R1) - (0.291f * G1) + (0.439f * B1) + 128;  // U
-            dest[1] = (0.257f * R0) + (0.504f * G0) + (0.098f * B0) + 16;    // Y0
-            dest[2] = (0.439f * R1) - (0.368f * G1) - (0.071f * B1) + 128;   // V
-            dest[3] = (0.257f * R1) + (0.504f * G1) + (0.098f * B1) + 16;    // Y1
-            dest += 4;
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_AY8:
-      case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_Y8: {
-        uint32_t *source = pixels;
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; ++x, ++source) {
-            uint8_t red, green, blue;
-            SDL_GetRGB(source[0], surface->format, &red, &green, &blue);
-            *dest++ = static_cast<uint8_t>(0.299f * red + 0.587f * green + 0.114f * blue);
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_AY8:
-      case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_Y8: {
-        uint32_t *source = pixels;
-        swizzle_bpp = 1;
-        swizzle_pitch = swizzle_w * swizzle_bpp;
-        converted = new uint8_t[swizzle_pitch * swizzle_h * swizzle_depth];
-        dest = converted;
-
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; ++x, ++source) {
-            uint8_t red, green, blue;
-            SDL_GetRGB(source[0], surface->format, &red, &green, &blue);
-            *dest++ = static_cast<uint8_t>(0.299f * red + 0.587f * green + 0.114f * blue);
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_A8Y8: {
-        uint32_t *source = pixels;
-        swizzle_bpp = 2;
-        swizzle_pitch = swizzle_w * swizzle_bpp;
-        converted = new uint8_t[swizzle_pitch * swizzle_h * swizzle_depth];
-        dest = converted;
-
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; ++x, ++source) {
-            uint8_t red, green, blue, alpha;
-            SDL_GetRGBA(*source, surface->format, &red, &green, &blue, &alpha);
-            *dest++ = static_cast<uint8_t>(0.299f * red + 0.587f * green + 0.114f * blue);
-            *dest++ = alpha;
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_Y16:
-      case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FIXED: {
-        // Treat the source as a 32-bit depth value and remap to 16 bit.
-        uint32_t *source = pixels;
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; ++x, ++source) {
-            uint8_t red, green, blue;
-            SDL_GetRGB(source[0], surface->format, &red, &green, &blue);
-            uint32_t y_value = static_cast<uint8_t>(0.299f * red + 0.587f * green + 0.114f * blue);
-            y_value = static_cast<uint32_t>(static_cast<float>(y_value) / 255.0f * 65535.0f);
-            *dest++ = y_value & 0xFF;
-            *dest++ = (y_value >> 8) & 0xFF;
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_DEPTH_Y16_FLOAT: {
-        // TODO: Implement conversion to float.
-        ASSERT(!"Y16 float format not supported.");
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_G8B8: {
-        uint32_t *source = pixels;
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; ++x, ++source) {
-            uint8_t red, green, blue, alpha;
-            SDL_GetRGBA(*source, surface->format, &red, &green, &blue, &alpha);
-            *dest++ = blue;
-            *dest++ = green;
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_LU_IMAGE_R8B8: {
-        uint32_t *source = pixels;
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; ++x, ++source) {
-            uint8_t red, green, blue, alpha;
-            SDL_GetRGBA(*source, surface->format, &red, &green, &blue, &alpha);
-            *dest++ = blue;
-            *dest++ = red;
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_G8B8: {
-        uint32_t *source = pixels;
-        swizzle_bpp = 2;
-        swizzle_pitch = swizzle_w * swizzle_bpp;
-        converted = new uint8_t[swizzle_pitch * swizzle_h * swizzle_depth];
-        dest = converted;
-
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; ++x, ++source) {
-            uint8_t red, green, blue, alpha;
-            SDL_GetRGBA(*source, surface->format, &red, &green, &blue, &alpha);
-            *dest++ = blue;
-            *dest++ = green;
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_SZ_R8B8: {
-        uint32_t *source = pixels;
-        swizzle_bpp = 2;
-        swizzle_pitch = swizzle_w * swizzle_bpp;
-        converted = new uint8_t[swizzle_pitch * swizzle_h * swizzle_depth];
-        dest = converted;
-
-        for (int y = 0; y < surface->h; ++y) {
-          for (int x = 0; x < surface->w; ++x, ++source) {
-            uint8_t red, green, blue, alpha;
-            SDL_GetRGBA(*source, surface->format, &red, &green, &blue, &alpha);
-            *dest++ = blue;
-            *dest++ = red;
-          }
-        }
-      } break;
-
-      case NV097_SET_TEXTURE_FORMAT_COLOR_L_DXT1_A1R5G5B5: {
-        uint32_t *source = pixels;
-        for (int y = 0; y < surface->h; y += 4) {
-          for (int x = 0; x < surface->w; x += 4, source += 4) {
-            // TODO: use proper encoding of the colors by quering all the colors and calculating color distances
-            // Reference: https://www.khronos.org/opengl/wiki/S3_Texture_Compression
-            uint8_t red, green, blue, alpha;
-            SDL_GetRGBA(*source, surface->format, &red, &green, &blue, &alpha);
-
-            // color0
-            dest[0] = 0x0;
-            dest[1] = 0x0;
-            // color1
-            dest[2] = ((green & 0x1C) << 3) + (blue >> 3);
-            dest[3] = (red & 0xF8) + (green >> 5);
-            uint8_t code = alpha >= 125 ? 0x55 : 0xFF;
-            dest[4] = code;  // code 0
-            dest[5] = code;  // code 1
-            dest[6] = code;  // code 2
-            dest[7] = code;  // code 3
-            dest += 8;
-          }
-          source += 3 * surface->w;
-        }
-      } break;
-
-      default:
-        return 3;
+    SDL_Surface *abgr = nullptr;
+    const SDL_Surface *source = surface;
+    if (surface->format->format != SDL_PIXELFORMAT_ABGR8888) {
+      abgr = SDL_ConvertSurfaceFormat(const_cast<SDL_Surface *>(surface), SDL_PIXELFORMAT_ABGR8888, 0);
+      if (!abgr) {
+        ASSERT(!"Failed to convert surface format.");
+        return 4;
+      }
+      source = abgr;
     }
 
+    // Swizzled formats are encoded into a linear buffer and then swizzled into place.
+    const uint32_t pitch = GetTextureCodecPitch(codec_format, source->w);
+    std::vector<uint8_t> linear;
+    uint8_t *dest = memory_base + texture_memory_offset_;
     if (format_.xbox_swizzled) {
-      ASSERT(converted && "Swizzle source buffer not populated");
-      SetRawTexture((const uint8_t *)converted, swizzle_w, swizzle_h, swizzle_depth, swizzle_pitch, swizzle_bpp,
-                    format_.xbox_swizzled, memory_base);
-      delete[] converted;
+      linear.resize(GetTextureCodecSize(codec_format, source->w, source->h));
+      dest = linear.data();
     }
 
-    return 0;
+    int ret = EncodeTexture(dest, pitch, static_cast<const uint32_t *>(source->pixels), source->pitch, source->w,
+                            source->h, codec_format);
+    if (!ret && format_.xbox_swizzled) {
+      SetRawTexture(linear.data(), source->w, source->h, 1, pitch, GetTextureCodecBitsPerPixel(codec_format) / 8,
+                    true, memory_base);
+    }
+
+    if (abgr) {
+      SDL_FreeSurface(abgr);
+    }
+    return ret ? 3 : 0;
   }
 
   // standard SDL conversion to destination format
@@ -365,50 +206,55 @@ int TextureStage::SetTexture(const SDL_Surface *surface, uint8_t *memory_base) c
 }
 
 int TextureStage::SetVolumetricTexture(const SDL_Surface **layers, uint32_t depth, uint8_t *memory_base) const {
-  ASSERT((!format_.xbox_linear) && "Volumetric textures using linear formats are not supported by XBOX.")
-
-  auto **new_surfaces = new SDL_Surface *[depth];
+  const uint32_t width = layers[0]->w;
+  const uint32_t height = layers[0]->h;
+  const uint32_t bytes_per_pixel = SDL_BYTESPERPIXEL(format_.sdl_format);
 
-  for (auto i = 0; i < depth; ++i) {
-    auto *surface = const_cast<SDL_Surface *>(layers[i]);
-    new_surfaces[i] = SDL_ConvertSurfaceFormat(surface, format_.sdl_format, 0);
+  auto convert_layer = [this, layers, width, height](uint8_t *dest, uint32_t pitch, uint32_t layer) {
+    const SDL_Surface *surface = layers[layer];
+    ASSERT(static_cast<uint32_t>(surface->w) == width && "Volumetric surface layers must have identical dimensions");
+    ASSERT(static_cast<uint32_t>(surface->h) == height && "Volumetric surface layers must have identical dimensions");
 
-    if (!new_surfaces[i]) {
+    if (SDL_ConvertPixels(surface->w, surface->h, surface->format->format, surface->pixels, surface->pitch,
+                          format_.sdl_format, dest, static_cast<int>(pitch))) {
       ASSERT(!"Failed to convert surface format.");
-      // This will leak memory, but the ASSERT will halt execution anyway.
       return 4;
     }
-  }
+    return 0;
+  };
 
-  const int32_t width = new_surfaces[0]->w;
-  int32_t height = new_surfaces[0]->h;
-  int32_t pitch = new_surfaces[0]->pitch;
-  int32_t bytes_per_pixel = new_surfaces[0]->format->BytesPerPixel;
-
-  uint32_t converted_surface_size = pitch * height;
-  auto *flattened = new uint8_t[converted_surface_size * depth];
-  uint8_t *dest = flattened;
-  for (auto i = 0; i < depth; ++i) {
-    SDL_Surface *s = new_surfaces[i];
-    ASSERT(s->w == width && "Volumetric surface layers must have identical dimensions");
-    ASSERT(s->h == height && "Volumetric surface layers must have identical dimensions");
-    ASSERT(s->pitch == pitch && "Volumetric surface layers must have identical dimensions");
-    ASSERT(s->format->BytesPerPixel == bytes_per_pixel && "Volumetric surface layers must have identical dimensions");
-
-    memcpy(dest, s->pixels, converted_surface_size);
-    dest += converted_surface_size;
-  }
+  return SetVolumetricTexture(width, height, depth, bytes_per_pixel, convert_layer, memory_base);
+}
 
-  for (auto i = 0; i < depth; ++i) {
-    SDL_FreeSurface(new_surfaces[i]);
-  }
-  delete[] new_surfaces;
+int TextureStage::SetVolumetricTexture(uint32_t width, uint32_t height, uint32_t depth, uint32_t bytes_per_pixel,
+                                       const VolumeLayerGenerator &generate_layer, uint8_t *memory_base) const {
+  ASSERT((!format_.xbox_linear) && "Volumetric textures using linear formats are not supported by XBOX.")
 
-  int ret = SetRawTexture(flattened, width, height, depth, pitch, bytes_per_pixel, format_.xbox_swizzled, memory_base);
+  const uint32_t pitch = width * bytes_per_pixel;
+  uint8_t *dest = memory_base + texture_memory_offset_;
 
-  delete[] flattened;
+  // Unswizzled layers are stored one after another, so they are generated in place.
+  if (!format_.xbox_swizzled) {
+    const uint32_t layer_size = pitch * height;
+    for (uint32_t layer = 0; layer < depth; ++layer, dest += layer_size) {
+      int ret = generate_layer(dest, pitch, layer);
+      if (ret) {
+        return ret;
+      }
+    }
+    return 0;
+  }
 
-  return ret;
+  std::vector<uint8_t> layer_buffer(pitch * height);
+  for (uint32_t layer = 0; layer < depth; ++layer) {
+    int ret = generate_layer(layer_buffer.data(), pitch, layer);
+    if (ret) {
+      return ret;
+    }
+    swizzle_box_slice(layer_buffer.data(), width, height, depth, layer, dest, pitch, bytes_per_pixel);
+  }
+
+  return 0;
 }
 
 int TextureStage::SetRawTexture(const uint8_t *source, uint32_t width, uint32_t height, uint32_t depth, uint32_t pitch,
@@ -428,6 +274,61 @@ int TextureStage::SetRawTexture(const uint8_t *source, uint32_t width, uint32_t
   return 0;
 }
 
+int TextureStage::SetMipmappedTexture(const SDL_Surface *surface, uint32_t levels, MipmapFilter filter,
+                                      bool gamma_correct, uint8_t *memory_base) {
+  if (format_.xbox_linear) {
+    ASSERT(!"Linear textures may not have mipmaps.");
+    return 5;
+  }
+
+  const uint32_t max_levels = GetMipmapLevelCount(surface->w, surface->h);
+  if (!levels || levels > max_levels) {
+    levels = max_levels;
+  }
+
+  // Each level is generated from the previous one, so work in a fixed 32bpp format.
+  SDL_Surface *level_surface =
+      SDL_ConvertSurfaceFormat(const_cast<SDL_Surface *>(surface), SDL_PIXELFORMAT_ABGR8888, 0);
+  if (!level_surface) {
+    return 4;
+  }
+
+  int ret = 0;
+  for (uint32_t level = 0; level < levels; ++level) {
+    if (level) {
+      const int width = level_surface->w > 1 ? level_surface->w / 2 : 1;
+      const int height = level_surface->h > 1 ? level_surface->h / 2 : 1;
+      SDL_Surface *next = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ABGR8888);
+      if (!next) {
+        ret = 4;
+        break;
+      }
+
+      DownsampleMipmapLevel(static_cast<uint32_t *>(next->pixels), next->pitch,
+                            static_cast<const uint32_t *>(level_surface->pixels), level_surface->pitch,
+                            level_surface->w, level_surface->h, filter, gamma_correct, level_surface->format->Ashift);
+      SDL_FreeSurface(level_surface);
+      level_surface = next;
+    }
+
+    // SetTexture writes relative to memory_base, so offset it to target the level.
+    ret = SetTexture(level_surface, memory_base + GetMipmapLevelOffset(surface->w, surface->h, level));
+    if (ret) {
+      break;
+    }
+  }
+
+  SDL_FreeSurface(level_surface);
+  if (!ret) {
+    mipmap_levels_ = levels;
+  }
+  return ret;
+}
+
+uint32_t TextureStage::GetMipmapLevelOffset(uint32_t width, uint32_t height, uint32_t level) const {
+  return ::GetMipmapLevelOffset(width, height, level, format_.xbox_bpp, GetCompressedBlockSize(format_.xbox_format));
+}
+
 int TextureStage::SetPalette(const uint32_t *palette, uint32_t length, uint8_t *memory_base) {
   auto ret = SetPaletteSize(length);
   if (ret) {
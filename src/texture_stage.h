@@ -4,6 +4,9 @@
 #include <pbkit/pbkit.h>
 #include <printf/printf.h>
 
+#include <functional>
+
+#include "mipmap_generator.h"
 #include "texture_format.h"
 
 // Sets up an nv2a texture stage.
@@ -41,6 +44,10 @@ class TextureStage {
     TG_REFLECTION_MAP = NV097_SET_TEXGEN_S_REFLECTION_MAP,
   };
 
+  // Writes a single linear layer of a volume texture, already in the stage's format, to `dest` with rows `pitch` bytes
+  // apart. Returns 0 on success.
+  typedef std::function<int(uint8_t *dest, uint32_t pitch, uint32_t layer)> VolumeLayerGenerator;
+
  public:
   TextureStage();
 
@@ -96,6 +103,7 @@ class TextureStage {
 
   void SetEnabled(bool enabled = true) { enabled_ = enabled; }
   void SetFormat(const TextureFormatInfo &format) { format_ = format; }
+  const TextureFormatInfo &GetFormat() const { return format_; }
   void SetBorderColor(uint32_t color) { border_color_ = color; }
 
   void SetCubemapEnable(bool val = true) { cubemap_enable_ = val; }
@@ -174,9 +182,21 @@ class TextureStage {
 
   int SetTexture(const SDL_Surface *surface, uint8_t *memory_base) const;
   int SetVolumetricTexture(const SDL_Surface **layers, uint32_t depth, uint8_t *memory_base) const;
+  // Generates and swizzles one layer at a time directly into texture memory, so only a single layer is ever staged.
+  // Layers of unswizzled formats are generated in place.
+  int SetVolumetricTexture(uint32_t width, uint32_t height, uint32_t depth, uint32_t bytes_per_pixel,
+                           const VolumeLayerGenerator &generate_layer, uint8_t *memory_base) const;
   int SetRawTexture(const uint8_t *source, uint32_t width, uint32_t height, uint32_t depth, uint32_t pitch,
                     uint32_t bytes_per_pixel, bool swizzle, uint8_t *memory_base) const;
 
+  // Uploads `surface` followed by `levels` - 1 generated mipmap levels (a complete chain if `levels` is 0) and sets the
+  // number of mipmap levels accordingly.
+  int SetMipmappedTexture(const SDL_Surface *surface, uint32_t levels, MipmapFilter filter, bool gamma_correct,
+                          uint8_t *memory_base);
+
+  // Returns the offset of the given mipmap level from the start of this stage's texture.
+  uint32_t GetMipmapLevelOffset(uint32_t width, uint32_t height, uint32_t level) const;
+
   int SetPalette(const uint32_t *palette, uint32_t length, uint8_t *memory_base);
   int SetPaletteSize(uint32_t length);
 
@@ -0,0 +1,100 @@
+#include "texture_upload_cache.h"
+
+#include <cstring>
+
+bool TextureUploadCache::Lookup(uint32_t offset, uint64_t key) {
+  for (auto &entry : entries_) {
+    if (entry.offset == offset && entry.key == key) {
+      entry.last_used = ++clock_;
+      ++stats_.hits;
+      return true;
+    }
+  }
+
+  ++stats_.misses;
+  return false;
+}
+
+void TextureUploadCache::Insert(uint32_t offset, uint32_t size, uint64_t key) {
+  Invalidate(offset, size);
+  if (!capacity_) {
+    return;
+  }
+
+  if (entries_.size() >= capacity_) {
+    auto oldest = entries_.begin();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->last_used < oldest->last_used) {
+        oldest = it;
+      }
+    }
+    entries_.erase(oldest);
+  }
+
+  entries_.push_back({offset, size, key, ++clock_});
+}
+
+void TextureUploadCache::Invalidate(uint32_t offset, uint32_t size) {
+  if (!size) {
+    return;
+  }
+
+  const uint64_t end = static_cast<uint64_t>(offset) + size;
+  auto it = entries_.begin();
+  while (it != entries_.end()) {
+    const uint64_t entry_end = static_cast<uint64_t>(it->offset) + it->size;
+    if (it->offset < end && offset < entry_end) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// Two independently seeded lanes of MurmurHash3 (x86, 32-bit), which only needs 32-bit multiplies and is therefore
+// reasonably fast on the XBOX CPU.
+static inline uint32_t Rotate(uint32_t value, uint32_t bits) { return (value << bits) | (value >> (32 - bits)); }
+
+static inline uint32_t MixBlock(uint32_t hash, uint32_t block) {
+  block *= 0xCC9E2D51;
+  block = Rotate(block, 15);
+  block *= 0x1B873593;
+  hash ^= block;
+  hash = Rotate(hash, 13);
+  return hash * 5 + 0xE6546B64;
+}
+
+static inline uint32_t Finalize(uint32_t hash, uint32_t size) {
+  hash ^= size;
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6B;
+  hash ^= hash >> 13;
+  hash *= 0xC2B2AE35;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+uint64_t TextureUploadCache::Hash(const void *data, uint32_t size, uint64_t seed) {
+  auto bytes = static_cast<const uint8_t *>(data);
+  uint32_t low = static_cast<uint32_t>(seed) ^ 0x9E3779B9;
+  uint32_t high = static_cast<uint32_t>(seed >> 32) ^ 0x7F4A7C15;
+
+  const uint32_t num_blocks = size / 4;
+  for (uint32_t i = 0; i < num_blocks; ++i, bytes += 4) {
+    uint32_t block;
+    memcpy(&block, bytes, sizeof(block));
+    low = MixBlock(low, block);
+    high = MixBlock(high, block ^ 0x5BD1E995);
+  }
+
+  uint32_t tail = 0;
+  for (uint32_t i = 0; i < (size & 3); ++i) {
+    tail |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+  }
+  low = MixBlock(low, tail);
+  high = MixBlock(high, tail ^ 0x5BD1E995);
+
+  return (static_cast<uint64_t>(Finalize(high, size)) << 32) | Finalize(low, size);
+}
+
+uint64_t TextureUploadCache::Hash(uint32_t value, uint64_t seed) { return Hash(&value, sizeof(value), seed); }
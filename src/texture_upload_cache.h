@@ -0,0 +1,63 @@
+#ifndef NXDK_PGRAPH_TESTS_TEXTURE_UPLOAD_CACHE_H
+#define NXDK_PGRAPH_TESTS_TEXTURE_UPLOAD_CACHE_H
+
+#include <cstdint>
+#include <vector>
+
+// Tracks what was most recently uploaded to regions of texture memory so that uploads of identical content to the same
+// location can be skipped.
+//
+// Uploads are identified by a caller-provided key, typically a hash of the source bytes combined with every parameter
+// that affects the bytes written (format, dimensions, swizzling). Regions are byte ranges relative to the start of
+// texture memory. Any write to texture memory that does not go through the cache must be reported via Invalidate.
+class TextureUploadCache {
+ public:
+  struct Stats {
+    uint32_t hits{0};
+    uint32_t misses{0};
+  };
+
+  static constexpr uint32_t kDefaultCapacity = 8;
+
+ public:
+  explicit TextureUploadCache(uint32_t capacity = kDefaultCapacity) : capacity_(capacity) {}
+
+  // Returns true if the region starting at `offset` is known to hold the upload identified by `key`.
+  bool Lookup(uint32_t offset, uint64_t key);
+
+  // Records that the `size` bytes at `offset` hold the upload identified by `key`. Any other entries overlapping the
+  // region are discarded. The least recently used entry is evicted if the cache is full.
+  void Insert(uint32_t offset, uint32_t size, uint64_t key);
+
+  // Discards all entries.
+  void Invalidate() { entries_.clear(); }
+
+  // Discards any entries overlapping the given region.
+  void Invalidate(uint32_t offset, uint32_t size);
+
+  uint32_t NumEntries() const { return entries_.size(); }
+
+  const Stats &GetStats() const { return stats_; }
+  void ResetStats() { stats_ = {}; }
+
+  // Returns a 64-bit hash of the given bytes, continuing from `seed`.
+  static uint64_t Hash(const void *data, uint32_t size, uint64_t seed = 0);
+
+  // Combines a single value into the given hash.
+  static uint64_t Hash(uint32_t value, uint64_t seed);
+
+ private:
+  struct Entry {
+    uint32_t offset;
+    uint32_t size;
+    uint64_t key;
+    uint32_t last_used;
+  };
+
+  uint32_t capacity_;
+  uint32_t clock_{0};
+  std::vector<Entry> entries_;
+  Stats stats_;
+};
+
+#endif  // NXDK_PGRAPH_TESTS_TEXTURE_UPLOAD_CACHE_H
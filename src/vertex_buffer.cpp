@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "debug_output.h"
+#include "index_generator.h"
 #include "pbkit_ext.h"
 
 void Vertex::Translate(float x, float y, float z, float w) {
@@ -324,32 +325,13 @@ void VertexBuffer::SetSpecular(uint32_t vertex_index, const Color &color) {
 }
 
 std::shared_ptr<VertexBuffer> VertexBuffer::ConvertFromTriangleStripToTriangles() const {
-  auto num_triangles = num_vertices_ - 2;
-  auto ret = std::make_shared<VertexBuffer>(num_triangles * 3);
+  std::vector<uint32_t> indices;
+  GenerateTriangleStripIndices(indices, num_vertices_);
 
-  auto src = normalized_vertex_buffer_;
+  auto ret = std::make_shared<VertexBuffer>(indices.size());
   auto dst = ret->normalized_vertex_buffer_;
-
-  memcpy(dst, src, sizeof(*dst) * 3);
-  dst += 3;
-  src += 2;
-
-  auto copy_triangle = [&src, &dst](bool is_odd) {
-    if (is_odd) {
-      memcpy(dst++, src, sizeof(*dst));
-      memcpy(dst++, src - 1, sizeof(*dst));
-      ++src;
-      memcpy(dst++, src, sizeof(*dst));
-    } else {
-      memcpy(dst++, src - 1, sizeof(*dst));
-      memcpy(dst++, src, sizeof(*dst));
-      ++src;
-      memcpy(dst++, src, sizeof(*dst));
-    }
-  };
-
-  for (auto i = 1; i < num_triangles; ++i) {
-    copy_triangle(i & 0x01);
+  for (auto index : indices) {
+    memcpy(dst++, normalized_vertex_buffer_ + index, sizeof(*dst));
   }
 
   return ret;
@@ -2,6 +2,8 @@
 #define NXDK_PGRAPH_TESTS__VERTEX_BUFFER_H_
 
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <vector>
 
 #include "math3d.h"
@@ -204,7 +206,9 @@ class VertexBuffer {
   ~VertexBuffer();
 
   // Returns a new VertexBuffer containing vertices suitable for rendering as triangles by treating the contents of this
-  // buffer as a triangle strip.
+  // buffer as a triangle strip. Shared vertices are copied once per triangle, so this is only needed when the triangles
+  // must be modified independently of the strip; TestHost::DrawInlineElementsExpanded draws the strip as triangles
+  // without copying any vertex data.
   std::shared_ptr<VertexBuffer> ConvertFromTriangleStripToTriangles() const;
 
   Vertex* Lock();
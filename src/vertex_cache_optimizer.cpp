@@ -0,0 +1,149 @@
+#include "vertex_cache_optimizer.h"
+
+VertexCacheStats SimulateVertexCache(const std::vector<uint32_t>& indices, uint32_t cache_size) {
+  VertexCacheStats ret;
+  ret.num_triangles = indices.size() / 3;
+
+  // Without a cache every vertex is transformed.
+  if (!cache_size) {
+    ret.cache_misses = indices.size();
+    return ret;
+  }
+
+  // Ring buffer of cached vertex indices, scanned linearly (the cache is small enough that this beats a hash lookup).
+  std::vector<uint32_t> cache(cache_size, 0xFFFFFFFF);
+  uint32_t next_slot = 0;
+
+  for (auto index : indices) {
+    bool hit = false;
+    for (auto entry : cache) {
+      if (entry == index) {
+        hit = true;
+        break;
+      }
+    }
+
+    if (!hit) {
+      ++ret.cache_misses;
+      cache[next_slot] = index;
+      next_slot = (next_slot + 1) % cache_size;
+    }
+  }
+
+  return ret;
+}
+
+std::vector<uint32_t> OptimizeVertexCacheOrder(const std::vector<uint32_t>& indices, uint32_t num_vertices,
+                                               uint32_t cache_size) {
+  const uint32_t num_triangles = indices.size() / 3;
+  std::vector<uint32_t> ret;
+  ret.reserve(num_triangles * 3);
+
+  // Vertex-triangle adjacency in compressed row form.
+  std::vector<uint32_t> live_triangles(num_vertices, 0);
+  for (uint32_t i = 0; i < num_triangles * 3; ++i) {
+    ++live_triangles[indices[i]];
+  }
+
+  std::vector<uint32_t> adjacency_offset(num_vertices + 1, 0);
+  for (uint32_t v = 0; v < num_vertices; ++v) {
+    adjacency_offset[v + 1] = adjacency_offset[v] + live_triangles[v];
+  }
+
+  std::vector<uint32_t> adjacency(num_triangles * 3);
+  {
+    std::vector<uint32_t> fill(adjacency_offset.begin(), adjacency_offset.end() - 1);
+    for (uint32_t t = 0; t < num_triangles; ++t) {
+      for (uint32_t k = 0; k < 3; ++k) {
+        const uint32_t v = indices[t * 3 + k];
+        adjacency[fill[v]++] = t;
+      }
+    }
+  }
+
+  // Time stamp at which each vertex last entered the cache. Starting the clock at cache_size + 1 ensures that no
+  // vertex is considered cached initially.
+  std::vector<uint32_t> cache_time(num_vertices, 0);
+  uint32_t time_stamp = cache_size + 1;
+
+  std::vector<bool> emitted(num_triangles, false);
+  std::vector<uint32_t> dead_end_stack;
+  std::vector<uint32_t> candidates;
+  uint32_t cursor = 0;
+
+  auto skip_dead_end = [&]() -> int32_t {
+    while (!dead_end_stack.empty()) {
+      const uint32_t v = dead_end_stack.back();
+      dead_end_stack.pop_back();
+      if (live_triangles[v] > 0) {
+        return static_cast<int32_t>(v);
+      }
+    }
+
+    while (cursor < num_vertices) {
+      if (live_triangles[cursor] > 0) {
+        return static_cast<int32_t>(cursor);
+      }
+      ++cursor;
+    }
+
+    return -1;
+  };
+
+  auto get_next_vertex = [&]() -> int32_t {
+    int32_t best_vertex = -1;
+    int32_t best_priority = -1;
+    for (auto v : candidates) {
+      if (!live_triangles[v]) {
+        continue;
+      }
+
+      // Prefer the oldest vertex that will still be in the cache once all of its remaining triangles are emitted.
+      int32_t priority = 0;
+      const uint32_t age = time_stamp - cache_time[v];
+      if (age + 2 * live_triangles[v] <= cache_size) {
+        priority = static_cast<int32_t>(age);
+      }
+
+      if (priority > best_priority) {
+        best_priority = priority;
+        best_vertex = static_cast<int32_t>(v);
+      }
+    }
+
+    if (best_vertex < 0) {
+      best_vertex = skip_dead_end();
+    }
+    return best_vertex;
+  };
+
+  int32_t fanning_vertex = num_vertices ? skip_dead_end() : -1;
+  while (fanning_vertex >= 0) {
+    candidates.clear();
+
+    const auto fan = static_cast<uint32_t>(fanning_vertex);
+    for (uint32_t i = adjacency_offset[fan]; i < adjacency_offset[fan + 1]; ++i) {
+      const uint32_t t = adjacency[i];
+      if (emitted[t]) {
+        continue;
+      }
+      emitted[t] = true;
+
+      for (uint32_t k = 0; k < 3; ++k) {
+        const uint32_t v = indices[t * 3 + k];
+        ret.push_back(v);
+        dead_end_stack.push_back(v);
+        candidates.push_back(v);
+        --live_triangles[v];
+
+        if (time_stamp - cache_time[v] > cache_size) {
+          cache_time[v] = time_stamp++;
+        }
+      }
+    }
+
+    fanning_vertex = get_next_vertex();
+  }
+
+  return ret;
+}
@@ -0,0 +1,34 @@
+#ifndef NXDK_PGRAPH_TESTS_VERTEX_CACHE_OPTIMIZER_H
+#define NXDK_PGRAPH_TESTS_VERTEX_CACHE_OPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+
+// Approximate number of entries in the NV2A post-transform vertex cache.
+constexpr uint32_t kDefaultVertexCacheSize = 16;
+
+struct VertexCacheStats {
+  uint32_t num_triangles{0};
+  uint32_t cache_misses{0};
+
+  // Average cache miss ratio (transformed vertices per triangle). Ranges from ~0.5 for an ideal ordering of a large
+  // regular mesh to 3.0 when no vertices are reused.
+  float ACMR() const {
+    return num_triangles ? static_cast<float>(cache_misses) / static_cast<float>(num_triangles) : 0.0f;
+  }
+};
+
+// Simulates a FIFO post-transform cache of `cache_size` entries processing the given triangle list. A `cache_size` of 0
+// counts every index as a miss.
+VertexCacheStats SimulateVertexCache(const std::vector<uint32_t>& indices,
+                                     uint32_t cache_size = kDefaultVertexCacheSize);
+
+// Reorders the triangles in the given triangle list to improve post-transform cache reuse for a FIFO cache of
+// `cache_size` entries. `num_vertices` must be greater than the largest index.
+//
+// Implements "Tipsify" from Sander, Nehab, and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced
+// Overdraw" (SIGGRAPH 2007), which runs in linear time. Triangle winding is preserved.
+std::vector<uint32_t> OptimizeVertexCacheOrder(const std::vector<uint32_t>& indices, uint32_t num_vertices,
+                                               uint32_t cache_size = kDefaultVertexCacheSize);
+
+#endif  // NXDK_PGRAPH_TESTS_VERTEX_CACHE_OPTIMIZER_H
@@ -0,0 +1,199 @@
+#include "yuv_conversion.h"
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+uint8_t RGBToY(uint32_t red, uint32_t green, uint32_t blue) {
+  const auto r = static_cast<float>(red);
+  const auto g = static_cast<float>(green);
+  const auto b = static_cast<float>(blue);
+  return static_cast<uint8_t>((0.257f * r) + (0.504f * g) + (0.098f * b) + 16);
+}
+
+uint8_t RGBToU(uint32_t red, uint32_t green, uint32_t blue) {
+  const auto r = static_cast<float>(red);
+  const auto g = static_cast<float>(green);
+  const auto b = static_cast<float>(blue);
+  return static_cast<uint8_t>(-(0.148f * r) - (0.291f * g) + (0.439f * b) + 128);
+}
+
+uint8_t RGBToV(uint32_t red, uint32_t green, uint32_t blue) {
+  const auto r = static_cast<float>(red);
+  const auto g = static_cast<float>(green);
+  const auto b = static_cast<float>(blue);
+  return static_cast<uint8_t>((0.439f * r) - (0.368f * g) - (0.071f * b) + 128);
+}
+
+// Byte offsets of each component within a 4 byte macropixel.
+struct Packing {
+  uint32_t y0;
+  uint32_t u;
+  uint32_t y1;
+  uint32_t v;
+};
+
+static constexpr Packing kYUY2 = {0, 1, 2, 3};
+static constexpr Packing kUYVY = {1, 0, 3, 2};
+
+#ifdef __SSE__
+// Number of macropixels converted per iteration of the SSE encoder.
+static constexpr uint32_t kSSEBatch = 4;
+
+// Truncates non-negative values below 2^22 and returns them in the low mantissa bits of the result. Adding 2^23 rounds
+// to the nearest integer, which is then corrected down if it exceeds the input.
+static inline __m128 TruncateToMantissa(__m128 value) {
+  const __m128 magic = _mm_set1_ps(8388608.0f);
+  __m128 rounded = _mm_sub_ps(_mm_add_ps(value, magic), magic);
+  rounded = _mm_sub_ps(rounded, _mm_and_ps(_mm_cmpgt_ps(rounded, value), _mm_set1_ps(1.0f)));
+  return _mm_add_ps(rounded, magic);
+}
+
+// Converts kSSEBatch macropixels. Each component is evaluated with the same single precision operations, in the same
+// order, as RGBToY/U/V, so the output is bit-identical to the scalar path.
+static inline void EncodeBatchSSE(const Packing& packing, uint8_t* out, const uint32_t* pixel, uint32_t red_shift,
+                                  uint32_t green_shift, uint32_t blue_shift) {
+  alignas(16) float channels[6][kSSEBatch];
+  for (uint32_t i = 0; i < kSSEBatch; ++i) {
+    const uint32_t p0 = pixel[i * 2];
+    const uint32_t p1 = pixel[i * 2 + 1];
+    channels[0][i] = static_cast<float>((p0 >> red_shift) & 0xFF);
+    channels[1][i] = static_cast<float>((p0 >> green_shift) & 0xFF);
+    channels[2][i] = static_cast<float>((p0 >> blue_shift) & 0xFF);
+    channels[3][i] = static_cast<float>((p1 >> red_shift) & 0xFF);
+    channels[4][i] = static_cast<float>((p1 >> green_shift) & 0xFF);
+    channels[5][i] = static_cast<float>((p1 >> blue_shift) & 0xFF);
+  }
+
+  const __m128 r0 = _mm_load_ps(channels[0]);
+  const __m128 g0 = _mm_load_ps(channels[1]);
+  const __m128 b0 = _mm_load_ps(channels[2]);
+  const __m128 r1 = _mm_load_ps(channels[3]);
+  const __m128 g1 = _mm_load_ps(channels[4]);
+  const __m128 b1 = _mm_load_ps(channels[5]);
+
+  auto luma = [](__m128 r, __m128 g, __m128 b) {
+    __m128 ret = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.257f), r), _mm_mul_ps(_mm_set1_ps(0.504f), g));
+    ret = _mm_add_ps(ret, _mm_mul_ps(_mm_set1_ps(0.098f), b));
+    return _mm_add_ps(ret, _mm_set1_ps(16.0f));
+  };
+
+  __m128 u = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(_mm_set1_ps(0.148f), r1));
+  u = _mm_sub_ps(u, _mm_mul_ps(_mm_set1_ps(0.291f), g1));
+  u = _mm_add_ps(u, _mm_mul_ps(_mm_set1_ps(0.439f), b1));
+  u = _mm_add_ps(u, _mm_set1_ps(128.0f));
+
+  __m128 v = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(0.439f), r1), _mm_mul_ps(_mm_set1_ps(0.368f), g1));
+  v = _mm_sub_ps(v, _mm_mul_ps(_mm_set1_ps(0.071f), b1));
+  v = _mm_add_ps(v, _mm_set1_ps(128.0f));
+
+  alignas(16) uint32_t results[4][kSSEBatch];
+  _mm_store_ps(reinterpret_cast<float*>(results[0]), TruncateToMantissa(luma(r0, g0, b0)));
+  _mm_store_ps(reinterpret_cast<float*>(results[1]), TruncateToMantissa(u));
+  _mm_store_ps(reinterpret_cast<float*>(results[2]), TruncateToMantissa(luma(r1, g1, b1)));
+  _mm_store_ps(reinterpret_cast<float*>(results[3]), TruncateToMantissa(v));
+
+  for (uint32_t i = 0; i < kSSEBatch; ++i, out += 4) {
+    out[packing.y0] = static_cast<uint8_t>(results[0][i]);
+    out[packing.u] = static_cast<uint8_t>(results[1][i]);
+    out[packing.y1] = static_cast<uint8_t>(results[2][i]);
+    out[packing.v] = static_cast<uint8_t>(results[3][i]);
+  }
+}
+#endif  // __SSE__
+
+static void EncodeYUV422(const Packing& packing, uint8_t* dest, uint32_t dest_pitch, const uint32_t* source,
+                         uint32_t source_pitch, uint32_t width, uint32_t height, uint32_t red_shift,
+                         uint32_t green_shift, uint32_t blue_shift) {
+  auto source_row = reinterpret_cast<const uint8_t*>(source);
+  for (uint32_t y = 0; y < height; ++y, dest += dest_pitch, source_row += source_pitch) {
+    auto pixel = reinterpret_cast<const uint32_t*>(source_row);
+    uint8_t* out = dest;
+    uint32_t x = 0;
+
+#ifdef __SSE__
+    for (; x + kSSEBatch * 2 <= width; x += kSSEBatch * 2, pixel += kSSEBatch * 2, out += kSSEBatch * 4) {
+      EncodeBatchSSE(packing, out, pixel, red_shift, green_shift, blue_shift);
+    }
+#endif
+
+    for (; x < width; x += 2, pixel += 2, out += 4) {
+      const uint32_t p0 = pixel[0];
+      const uint32_t p1 = pixel[1];
+      const uint32_t r0 = (p0 >> red_shift) & 0xFF;
+      const uint32_t g0 = (p0 >> green_shift) & 0xFF;
+      const uint32_t b0 = (p0 >> blue_shift) & 0xFF;
+      const uint32_t r1 = (p1 >> red_shift) & 0xFF;
+      const uint32_t g1 = (p1 >> green_shift) & 0xFF;
+      const uint32_t b1 = (p1 >> blue_shift) & 0xFF;
+
+      out[packing.y0] = RGBToY(r0, g0, b0);
+      out[packing.u] = RGBToU(r1, g1, b1);
+      out[packing.y1] = RGBToY(r1, g1, b1);
+      out[packing.v] = RGBToV(r1, g1, b1);
+    }
+  }
+}
+
+static inline uint32_t Clamp8(int32_t value) {
+  if (value < 0) {
+    return 0;
+  }
+  if (value > 255) {
+    return 255;
+  }
+  return static_cast<uint32_t>(value);
+}
+
+static void DecodeYUV422(const Packing& packing, uint32_t* dest, uint32_t dest_pitch, const uint8_t* source,
+                         uint32_t source_pitch, uint32_t width, uint32_t height, uint32_t red_shift,
+                         uint32_t green_shift, uint32_t blue_shift, uint32_t alpha_shift) {
+  const uint32_t alpha = 0xFFu << alpha_shift;
+  auto dest_row = reinterpret_cast<uint8_t*>(dest);
+
+  // Standard 8.8 fixed-point BT.601 inverse.
+  auto to_rgb = [=](int32_t c, int32_t d, int32_t e) {
+    const int32_t luma = 298 * c + 128;
+    const uint32_t r = Clamp8((luma + 409 * e) >> 8);
+    const uint32_t g = Clamp8((luma - 100 * d - 208 * e) >> 8);
+    const uint32_t b = Clamp8((luma + 516 * d) >> 8);
+    return (r << red_shift) | (g << green_shift) | (b << blue_shift) | alpha;
+  };
+
+  for (uint32_t y = 0; y < height; ++y, source += source_pitch, dest_row += dest_pitch) {
+    const uint8_t* in = source;
+    auto out = reinterpret_cast<uint32_t*>(dest_row);
+    for (uint32_t x = 0; x < width; x += 2, in += 4, out += 2) {
+      const int32_t d = static_cast<int32_t>(in[packing.u]) - 128;
+      const int32_t e = static_cast<int32_t>(in[packing.v]) - 128;
+      out[0] = to_rgb(static_cast<int32_t>(in[packing.y0]) - 16, d, e);
+      out[1] = to_rgb(static_cast<int32_t>(in[packing.y1]) - 16, d, e);
+    }
+  }
+}
+
+void ConvertRGBToYUY2(uint8_t* dest, uint32_t dest_pitch, const uint32_t* source, uint32_t source_pitch,
+                      uint32_t width, uint32_t height, uint32_t red_shift, uint32_t green_shift,
+                      uint32_t blue_shift) {
+  EncodeYUV422(kYUY2, dest, dest_pitch, source, source_pitch, width, height, red_shift, green_shift, blue_shift);
+}
+
+void ConvertRGBToUYVY(uint8_t* dest, uint32_t dest_pitch, const uint32_t* source, uint32_t source_pitch,
+                      uint32_t width, uint32_t height, uint32_t red_shift, uint32_t green_shift,
+                      uint32_t blue_shift) {
+  EncodeYUV422(kUYVY, dest, dest_pitch, source, source_pitch, width, height, red_shift, green_shift, blue_shift);
+}
+
+void ConvertYUY2ToRGB(uint32_t* dest, uint32_t dest_pitch, const uint8_t* source, uint32_t source_pitch,
+                      uint32_t width, uint32_t height, uint32_t red_shift, uint32_t green_shift, uint32_t blue_shift,
+                      uint32_t alpha_shift) {
+  DecodeYUV422(kYUY2, dest, dest_pitch, source, source_pitch, width, height, red_shift, green_shift, blue_shift,
+               alpha_shift);
+}
+
+void ConvertUYVYToRGB(uint32_t* dest, uint32_t dest_pitch, const uint8_t* source, uint32_t source_pitch,
+                      uint32_t width, uint32_t height, uint32_t red_shift, uint32_t green_shift, uint32_t blue_shift,
+                      uint32_t alpha_shift) {
+  DecodeYUV422(kUYVY, dest, dest_pitch, source, source_pitch, width, height, red_shift, green_shift, blue_shift,
+               alpha_shift);
+}
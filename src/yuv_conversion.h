@@ -0,0 +1,40 @@
+#ifndef NXDK_PGRAPH_TESTS_YUV_CONVERSION_H
+#define NXDK_PGRAPH_TESTS_YUV_CONVERSION_H
+
+#include <cstdint>
+
+// Conversion between 32bpp RGB and 4:2:2 packed YUV (BT.601, studio swing).
+//
+// Source and destination RGB pixels are 32-bit values with 8-bit components at the given bit shifts (the defaults
+// describe SDL_PIXELFORMAT_ABGR8888, i.e., R, G, B, A in memory order). Pitches are in bytes and widths must be even.
+//
+// When encoding, luma is computed for each pixel while chroma is taken from the second pixel of each pair. This is a
+// point sample rather than an average, but matches the output that existing test results were generated with.
+
+// Computes individual components by truncating a single precision float evaluation of the BT.601 equations, e.g.,
+// `(uint8_t)(0.257f * R + 0.504f * G + 0.098f * B + 16)`. The whole-image encoders produce bit-identical results.
+uint8_t RGBToY(uint32_t red, uint32_t green, uint32_t blue);
+uint8_t RGBToU(uint32_t red, uint32_t green, uint32_t blue);
+uint8_t RGBToV(uint32_t red, uint32_t green, uint32_t blue);
+
+// Writes YUY2 (aka YUYV, NV097_SET_TEXTURE_FORMAT_COLOR_LC_IMAGE_CR8YB8CB8YA8) data: Y0 U Y1 V.
+void ConvertRGBToYUY2(uint8_t* dest, uint32_t dest_pitch, const uint32_t* source, uint32_t source_pitch,
+                      uint32_t width, uint32_t height, uint32_t red_shift = 0, uint32_t green_shift = 8,
+                      uint32_t blue_shift = 16);
+
+// Writes UYVY (NV097_SET_TEXTURE_FORMAT_COLOR_LC_IMAGE_YB8CR8YA8CB8) data: U Y0 V Y1.
+void ConvertRGBToUYVY(uint8_t* dest, uint32_t dest_pitch, const uint32_t* source, uint32_t source_pitch,
+                      uint32_t width, uint32_t height, uint32_t red_shift = 0, uint32_t green_shift = 8,
+                      uint32_t blue_shift = 16);
+
+// Decodes YUY2 data into opaque 32bpp RGB pixels. Chroma is shared by each pair of pixels.
+void ConvertYUY2ToRGB(uint32_t* dest, uint32_t dest_pitch, const uint8_t* source, uint32_t source_pitch,
+                      uint32_t width, uint32_t height, uint32_t red_shift = 0, uint32_t green_shift = 8,
+                      uint32_t blue_shift = 16, uint32_t alpha_shift = 24);
+
+// Decodes UYVY data into opaque 32bpp RGB pixels. Chroma is shared by each pair of pixels.
+void ConvertUYVYToRGB(uint32_t* dest, uint32_t dest_pitch, const uint8_t* source, uint32_t source_pitch,
+                      uint32_t width, uint32_t height, uint32_t red_shift = 0, uint32_t green_shift = 8,
+                      uint32_t blue_shift = 16, uint32_t alpha_shift = 24);
+
+#endif  // NXDK_PGRAPH_TESTS_YUV_CONVERSION_H
@@ -0,0 +1,46 @@
+#ifndef NXDK_PGRAPH_TESTS_HOST_BENCHMARK_H
+#define NXDK_PGRAPH_TESTS_HOST_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Minimal registry for the benchmarks in host_benchmarks. Each benchmark prints its own results table.
+struct Benchmark {
+  const char *name;
+  void (*run)();
+};
+
+std::vector<Benchmark> &GetBenchmarks();
+
+struct BenchmarkRegistrar {
+  BenchmarkRegistrar(const char *name, void (*run)()) { GetBenchmarks().push_back({name, run}); }
+};
+
+#define HOST_BENCHMARK(name)                                     \
+  static void name();                                            \
+  static const BenchmarkRegistrar name##_registrar(#name, name); \
+  static void name()
+
+// Returns the fastest of `repeats` timings of `body`, in seconds.
+inline double TimeBest(const std::function<void()> &body, uint32_t repeats = 5) {
+  double best = 1e30;
+  for (uint32_t i = 0; i < repeats; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+// Prevents the compiler from discarding a computed value.
+template <typename T>
+inline void KeepAlive(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif  // NXDK_PGRAPH_TESTS_HOST_BENCHMARK_H
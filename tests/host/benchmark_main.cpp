@@ -0,0 +1,28 @@
+#include <cstdio>
+#include <cstring>
+
+#include "benchmark.h"
+
+std::vector<Benchmark> &GetBenchmarks() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+// Runs every benchmark, or only those whose names contain one of the arguments.
+int main(int argc, char **argv) {
+  for (const auto &benchmark : GetBenchmarks()) {
+    bool selected = argc < 2;
+    for (int i = 1; i < argc && !selected; ++i) {
+      selected = strstr(benchmark.name, argv[i]) != nullptr;
+    }
+    if (!selected) {
+      continue;
+    }
+
+    printf("== %s ==\n", benchmark.name);
+    benchmark.run();
+    printf("\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "dds_image.h"
+
+static constexpr uint32_t kSize = 1024;
+static constexpr uint32_t kLevels = 11;
+
+// Compares reading a complete 1024x1024 mipmap chain into a texture buffer with LoadFile (every level as a separate
+// sub-image, then copied) and with Open plus a single ReadLevels.
+HOST_BENCHMARK(DDSLoad1024x1024) {
+  struct Source {
+    const char *name;
+    DDSImage::Format format;
+  };
+  const Source sources[] = {
+      {"DXT1", DDSImage::Format::DXT1},
+      {"DXT5", DDSImage::Format::DXT5},
+      {"A8R8G8B8", DDSImage::Format::A8R8G8B8},
+  };
+
+  printf("%-9s %10s %10s %12s\n", "format", "bytes", "eager us", "streaming us");
+  for (auto &source : sources) {
+    const std::string filename = std::string("dds_image_benchmark_") + source.name + ".dds";
+    const std::string path = (std::filesystem::temp_directory_path() / filename).string();
+
+    DDSImage::TextureDescription description;
+    description.format = source.format;
+    description.width = kSize;
+    description.height = kSize;
+    description.levels = kLevels;
+
+    // Any content will do, the loaders do not inspect it.
+    std::vector<uint8_t> texture(kSize * kSize * 8);
+    for (uint32_t i = 0; i < texture.size(); ++i) {
+      texture[i] = static_cast<uint8_t>(i * 31);
+    }
+    if (!DDSImage::SaveFile(path.c_str(), texture.data(), description)) {
+      printf("%-9s failed to write %s\n", source.name, path.c_str());
+      continue;
+    }
+
+    DDSImage probe;
+    if (!probe.Open(path.c_str())) {
+      printf("%-9s failed to open %s\n", source.name, path.c_str());
+      continue;
+    }
+    const uint32_t chain_size = probe.GetFaceSize(probe.NumFileLevels());
+    probe.Close();
+    std::vector<uint8_t> dest(chain_size);
+
+    const double eager = TimeBest(
+        [&]() {
+          DDSImage image;
+          image.LoadFile(path.c_str(), true);
+          uint8_t *out = dest.data();
+          for (auto &sub_image : image.GetSubImages()) {
+            memcpy(out, sub_image->data.data(), sub_image->data.size());
+            out += sub_image->data.size();
+          }
+          KeepAlive(dest);
+        },
+        50);
+    const double streaming = TimeBest(
+        [&]() {
+          DDSImage image;
+          image.Open(path.c_str());
+          image.ReadLevels(dest.data(), 0, image.NumFileLevels());
+          KeepAlive(dest);
+        },
+        50);
+
+    printf("%-9s %10u %10.1f %12.1f\n", source.name, chain_size, eager * 1e6, streaming * 1e6);
+    std::remove(path.c_str());
+  }
+}
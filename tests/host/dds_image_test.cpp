@@ -0,0 +1,246 @@
+#include "dds_image.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "swizzle_reference.h"
+
+static constexpr uint32_t kCubemapFaceAlignment = 128;
+
+static const DDSImage::Format kFormats[] = {
+    DDSImage::Format::DXT1,
+    DDSImage::Format::DXT3,
+    DDSImage::Format::DXT5,
+    DDSImage::Format::A8R8G8B8,
+    DDSImage::Format::X8R8G8B8,
+    DDSImage::Format::A8B8G8R8,
+    DDSImage::Format::X8B8G8R8,
+    DDSImage::Format::R8G8B8A8,
+    DDSImage::Format::B8G8R8A8,
+    DDSImage::Format::R5G6B5,
+    DDSImage::Format::A1R5G5B5,
+    DDSImage::Format::X1R5G5B5,
+    DDSImage::Format::A4R4G4B4,
+    DDSImage::Format::L8,
+    DDSImage::Format::A8L8,
+    DDSImage::Format::L16,
+    DDSImage::Format::A8,
+    DDSImage::Format::P8,
+    DDSImage::Format::YUY2,
+    DDSImage::Format::UYVY,
+    DDSImage::Format::D16,
+    DDSImage::Format::D16F,
+    DDSImage::Format::D24S8,
+    DDSImage::Format::D24FS8,
+};
+
+static const char *const kFormatNames[] = {
+    "DXT1",
+    "DXT3",
+    "DXT5",
+    "A8R8G8B8",
+    "X8R8G8B8",
+    "A8B8G8R8",
+    "X8B8G8R8",
+    "R8G8B8A8",
+    "B8G8R8A8",
+    "R5G6B5",
+    "A1R5G5B5",
+    "X1R5G5B5",
+    "A4R4G4B4",
+    "L8",
+    "A8L8",
+    "L16",
+    "A8",
+    "P8",
+    "YUY2",
+    "UYVY",
+    "D16",
+    "D16F",
+    "D24S8",
+    "D24FS8",
+};
+
+static std::vector<uint8_t> MakeTexture(uint32_t size) {
+  std::vector<uint8_t> ret(size);
+  uint32_t state = 1;
+  for (auto &value : ret) {
+    state = state * 1664525 + 1013904223;
+    value = static_cast<uint8_t>(state >> 24);
+  }
+  return ret;
+}
+
+class DDSImageTest : public ::testing::TestWithParam<DDSImage::Format> {
+ protected:
+  void SetUp() override {
+    path_ = ::testing::TempDir() + "dds_image_test_" + std::to_string(static_cast<int>(GetParam())) + ".dds";
+  }
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  // Writes `description` from `texture` and checks that every level of every face reads back as the source bytes,
+  // after re-swizzling if the source was swizzled.
+  void ExpectRoundTrip(const DDSImage::TextureDescription &description, const std::vector<uint8_t> &texture) {
+    ASSERT_TRUE(DDSImage::SaveFile(path_.c_str(), texture.data(), description));
+
+    DDSImage image;
+    ASSERT_TRUE(image.Open(path_.c_str()));
+    EXPECT_EQ(image.GetFormat(), description.format);
+    EXPECT_EQ(image.NumFileLevels(), description.levels);
+    EXPECT_EQ(image.NumFaces(), description.cubemap ? 6u : 1u);
+    EXPECT_EQ(image.IsVolume(), description.depth > 1);
+    EXPECT_EQ(image.GetLevelInfo(0).width, description.width);
+    EXPECT_EQ(image.GetLevelInfo(0).height, description.height);
+    EXPECT_EQ(image.GetLevelInfo(0).depth, description.depth);
+
+    const uint32_t face_size = image.GetFaceSize(image.NumFileLevels());
+    const uint32_t face_stride = (face_size + kCubemapFaceAlignment - 1) & ~(kCubemapFaceAlignment - 1);
+    ASSERT_LE(face_stride * image.NumFaces(), texture.size());
+
+    std::vector<uint8_t> face(face_size);
+    for (uint32_t face_index = 0; face_index < image.NumFaces(); ++face_index) {
+      SCOPED_TRACE(face_index);
+      ASSERT_TRUE(image.ReadLevels(face.data(), 0, image.NumFileLevels(), face_index));
+      const uint8_t *expected = texture.data() + face_index * face_stride;
+
+      if (!description.swizzled || image.GetBlockSize()) {
+        EXPECT_EQ(memcmp(face.data(), expected, face_size), 0);
+        continue;
+      }
+
+      const uint8_t *level_data = face.data();
+      for (uint32_t level = 0; level < image.NumFileLevels(); ++level) {
+        SCOPED_TRACE(level);
+        const auto &info = image.GetLevelInfo(level, face_index);
+        std::vector<uint8_t> swizzled(info.size);
+        ReferenceSwizzleBox(level_data, info.width, info.height, info.depth, swizzled.data(), info.pitch,
+                            info.pitch * info.height, image.GetBytesPerPixel());
+        EXPECT_EQ(memcmp(swizzled.data(), expected, info.size), 0);
+        level_data += info.size;
+        expected += info.size;
+      }
+    }
+  }
+
+  std::string path_;
+};
+
+TEST_P(DDSImageTest, MipmappedRoundTrip) {
+  DDSImage::TextureDescription description;
+  description.format = GetParam();
+  description.width = 64;
+  description.height = 32;
+  description.levels = 7;
+  ExpectRoundTrip(description, MakeTexture(64 * 32 * 8));
+}
+
+TEST_P(DDSImageTest, SwizzledRoundTrip) {
+  DDSImage::TextureDescription description;
+  description.format = GetParam();
+  description.width = 32;
+  description.height = 16;
+  description.levels = 3;
+  description.swizzled = true;
+  ExpectRoundTrip(description, MakeTexture(32 * 16 * 8));
+}
+
+TEST_P(DDSImageTest, CubemapRoundTrip) {
+  DDSImage::TextureDescription description;
+  description.format = GetParam();
+  description.width = 16;
+  description.height = 16;
+  description.levels = 5;
+  description.cubemap = true;
+  ExpectRoundTrip(description, MakeTexture(16 * 16 * 8 * 6));
+}
+
+TEST_P(DDSImageTest, VolumeRoundTrip) {
+  DDSImage::TextureDescription description;
+  description.format = GetParam();
+  description.width = 16;
+  description.height = 8;
+  description.depth = 4;
+  description.levels = 2;
+  description.swizzled = true;
+  ExpectRoundTrip(description, MakeTexture(16 * 8 * 4 * 8));
+}
+
+// LoadFile is built on the same level table, so its sub-images must match ReadLevel.
+TEST_P(DDSImageTest, LoadFileMatchesReadLevel) {
+  DDSImage::TextureDescription description;
+  description.format = GetParam();
+  description.width = 32;
+  description.height = 32;
+  description.levels = 6;
+  auto texture = MakeTexture(32 * 32 * 8);
+  ASSERT_TRUE(DDSImage::SaveFile(path_.c_str(), texture.data(), description));
+
+  DDSImage streamed;
+  ASSERT_TRUE(streamed.Open(path_.c_str()));
+  DDSImage loaded;
+  ASSERT_TRUE(loaded.LoadFile(path_.c_str(), true));
+  ASSERT_EQ(loaded.NumLevels(), description.levels);
+
+  for (uint32_t level = 0; level < description.levels; ++level) {
+    auto sub_image = loaded.GetSubImage(level);
+    const auto &info = streamed.GetLevelInfo(level);
+    EXPECT_EQ(sub_image->width, info.width);
+    EXPECT_EQ(sub_image->height, info.height);
+    ASSERT_EQ(sub_image->data.size(), info.size);
+
+    std::vector<uint8_t> data(info.size);
+    ASSERT_TRUE(streamed.ReadLevel(data.data(), level));
+    EXPECT_EQ(data, sub_image->data) << level;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllFormats, DDSImageTest, ::testing::ValuesIn(kFormats),
+                         [](const ::testing::TestParamInfo<DDSImage::Format> &info) {
+                           return std::string(kFormatNames[info.index]);
+                         });
+
+// Rows beyond the populated width are dropped.
+TEST(DDSImageSaveTest, PitchedRoundTrip) {
+  static constexpr uint32_t kWidth = 5;
+  static constexpr uint32_t kHeight = 3;
+  static constexpr uint32_t kPitch = 32;
+  const std::string path = ::testing::TempDir() + "dds_image_test_pitched.dds";
+  auto texture = MakeTexture(kPitch * kHeight);
+
+  DDSImage::TextureDescription description;
+  description.format = DDSImage::Format::A8R8G8B8;
+  description.width = kWidth;
+  description.height = kHeight;
+  description.pitch = kPitch;
+  ASSERT_TRUE(DDSImage::SaveFile(path.c_str(), texture.data(), description));
+
+  DDSImage image;
+  ASSERT_TRUE(image.Open(path.c_str()));
+  ASSERT_EQ(image.GetLevelInfo(0).pitch, kWidth * 4);
+  std::vector<uint8_t> data(image.GetLevelInfo(0).size);
+  ASSERT_TRUE(image.ReadLevel(data.data(), 0));
+  std::remove(path.c_str());
+
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    EXPECT_EQ(memcmp(data.data() + y * kWidth * 4, texture.data() + y * kPitch, kWidth * 4), 0) << y;
+  }
+}
+
+TEST(DDSImageSaveTest, RejectsUnsupportedFormat) {
+  const std::string path = ::testing::TempDir() + "dds_image_test_unsupported.dds";
+  uint8_t texture[64]{};
+  DDSImage::TextureDescription description;
+  description.width = 4;
+  description.height = 4;
+  EXPECT_FALSE(DDSImage::SaveFile(path.c_str(), texture, description));
+  std::remove(path.c_str());
+}
+
+TEST(DDSImageSaveTest, OpenFailsForMissingFile) {
+  DDSImage image;
+  EXPECT_FALSE(image.Open((::testing::TempDir() + "dds_image_test_missing.dds").c_str()));
+  EXPECT_FALSE(image.IsOpen());
+}
@@ -0,0 +1,141 @@
+#include "depth_conversion.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+static float BitsToFloat(uint32_t value) {
+  float ret;
+  memcpy(&ret, &value, sizeof(ret));
+  return ret;
+}
+
+TEST(DepthConversionTest, Z16FloatRoundTripsEveryEncoding) {
+  float previous = -1.0f;
+  for (uint32_t value = 0; value <= 0xFFFF; ++value) {
+    const float decoded = DecodeZ16Float(static_cast<uint16_t>(value));
+    ASSERT_GT(decoded, previous) << "Encoding " << value << " is not monotonic";
+    ASSERT_EQ(EncodeZ16Float(decoded), value);
+    previous = decoded;
+  }
+}
+
+TEST(DepthConversionTest, Z16FloatTruncatesExcessMantissa) {
+  for (uint32_t value = 1; value < 0xFFFF; ++value) {
+    const float decoded = DecodeZ16Float(static_cast<uint16_t>(value));
+    const float next = DecodeZ16Float(static_cast<uint16_t>(value + 1));
+    const float between = std::nextafter(next, 0.0f);
+    ASSERT_EQ(EncodeZ16Float(between), value) << decoded;
+  }
+}
+
+TEST(DepthConversionTest, Z16FloatLimits) {
+  EXPECT_EQ(DecodeZ16Float(0), 0.0f);
+  EXPECT_EQ(DecodeZ16Float(1), std::ldexp(1.0f + 1.0f / 4096.0f, -7));
+  EXPECT_EQ(DecodeZ16Float(0xFFFF), kZ16FloatMax);
+
+  // Values at or below 2^-7 flush to 0.
+  EXPECT_EQ(EncodeZ16Float(std::ldexp(1.0f, -7)), 0);
+  EXPECT_EQ(EncodeZ16Float(1e-10f), 0);
+  EXPECT_EQ(EncodeZ16Float(0.0f), 0);
+  EXPECT_EQ(EncodeZ16Float(-0.0f), 0);
+  EXPECT_EQ(EncodeZ16Float(-1.0f), 0);
+  EXPECT_EQ(EncodeZ16Float(std::numeric_limits<float>::quiet_NaN()), 0);
+
+  EXPECT_EQ(EncodeZ16Float(kZ16FloatMax), 0xFFFF);
+  EXPECT_EQ(EncodeZ16Float(1000.0f), 0xFFFF);
+  EXPECT_EQ(EncodeZ16Float(std::numeric_limits<float>::infinity()), 0xFFFF);
+}
+
+TEST(DepthConversionTest, Z24FloatRoundTripsEveryEncoding) {
+  float previous = -1.0f;
+  // Encodings above 0xFEFFFF decode to IEEE infinities and NaNs, which the format does not represent.
+  for (uint32_t value = 0; value <= 0xFEFFFF; ++value) {
+    const float decoded = DecodeZ24Float(value);
+    ASSERT_GT(decoded, previous) << "Encoding " << value << " is not monotonic";
+    ASSERT_EQ(EncodeZ24Float(decoded), value);
+    previous = decoded;
+  }
+}
+
+TEST(DepthConversionTest, Z24FloatTruncatesExcessMantissa) {
+  for (uint32_t value = 0; value < 0xFEFFFF; value += 0x101) {
+    const float next = DecodeZ24Float(value + 1);
+    ASSERT_EQ(EncodeZ24Float(std::nextafter(next, 0.0f)), value);
+  }
+}
+
+TEST(DepthConversionTest, Z24FloatLimits) {
+  const float max_value = BitsToFloat(0x7F7FFF80);
+  EXPECT_EQ(DecodeZ24Float(0xFEFFFF), max_value);
+  // Only the low 24 bits are significant.
+  EXPECT_EQ(DecodeZ24Float(0xAB000001), DecodeZ24Float(0x000001));
+
+  EXPECT_EQ(EncodeZ24Float(-1.0f), 0u);
+  EXPECT_EQ(EncodeZ24Float(std::numeric_limits<float>::quiet_NaN()), 0u);
+  EXPECT_EQ(EncodeZ24Float(std::numeric_limits<float>::max()), 0xFEFFFFu);
+  EXPECT_EQ(EncodeZ24Float(std::numeric_limits<float>::infinity()), 0xFEFFFFu);
+}
+
+TEST(DepthConversionTest, ConvertUnorm8FillsRange) {
+  std::vector<uint8_t> source(256);
+  for (uint32_t i = 0; i < source.size(); ++i) {
+    source[i] = static_cast<uint8_t>(i);
+  }
+
+  std::vector<uint16_t> y16(256);
+  ConvertToDepth(y16.data(), 256 * 2, source.data(), 256, 256, 1, DEPTH_SOURCE_UNORM8, DEPTH_TEXTURE_Y16_FIXED);
+  EXPECT_EQ(y16[0], 0);
+  EXPECT_EQ(y16[0x80], 0x8080);
+  EXPECT_EQ(y16[0xFF], 0xFFFF);
+
+  std::vector<uint32_t> y24(256);
+  ConvertToDepth(y24.data(), 256 * 4, source.data(), 256, 256, 1, DEPTH_SOURCE_UNORM8, DEPTH_TEXTURE_X8_Y24_FIXED);
+  EXPECT_EQ(y24[0], 0u);
+  EXPECT_EQ(y24[0x80], 0x80808000u);
+  EXPECT_EQ(y24[0xFF], 0xFFFFFF00u);
+
+  std::vector<uint16_t> y16f(256);
+  ConvertToDepth(y16f.data(), 256 * 2, source.data(), 256, 256, 1, DEPTH_SOURCE_UNORM8, DEPTH_TEXTURE_Y16_FLOAT);
+  EXPECT_EQ(y16f[0], 0);
+  EXPECT_EQ(y16f[0xFF], 0xFFFF);
+  for (uint32_t i = 1; i < 256; ++i) {
+    EXPECT_GT(y16f[i], y16f[i - 1]);
+  }
+}
+
+TEST(DepthConversionTest, ConvertFloatHonorsPitch) {
+  static constexpr uint32_t kWidth = 3;
+  static constexpr uint32_t kHeight = 2;
+  static constexpr uint32_t kSourcePitch = 4 * sizeof(float);
+  static constexpr uint32_t kDestPitch = 4 * sizeof(uint32_t);
+  const float source[] = {0.0f, 1.0f, 2.0f, 99.0f, 3.0f, 4.0f, 5.0f, 99.0f};
+  uint32_t dest[8];
+  memset(dest, 0xCD, sizeof(dest));
+
+  ConvertToDepth(dest, kDestPitch, source, kSourcePitch, kWidth, kHeight, DEPTH_SOURCE_FLOAT,
+                 DEPTH_TEXTURE_X8_Y24_FLOAT);
+
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    for (uint32_t x = 0; x < kWidth; ++x) {
+      const uint32_t texel = dest[y * 4 + x];
+      EXPECT_EQ(texel & 0xFF, 0u);
+      EXPECT_EQ(DecodeZ24Float(texel >> 8), source[y * 4 + x]);
+    }
+    // Padding is left untouched.
+    EXPECT_EQ(dest[y * 4 + 3], 0xCDCDCDCDu);
+  }
+}
+
+TEST(DepthConversionTest, ConvertFloatClampsFixedPoint) {
+  const float source[] = {-5.0f, 0.5f, 1234.9f, 70000.0f};
+  uint16_t dest[4];
+  ConvertToDepth(dest, sizeof(dest), source, sizeof(source), 4, 1, DEPTH_SOURCE_FLOAT, DEPTH_TEXTURE_Y16_FIXED);
+  EXPECT_EQ(dest[0], 0);
+  EXPECT_EQ(dest[1], 0);
+  EXPECT_EQ(dest[2], 1234);
+  EXPECT_EQ(dest[3], 0xFFFF);
+}
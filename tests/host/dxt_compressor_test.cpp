@@ -0,0 +1,159 @@
+#include "dxt_compressor.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "dxt_decoder.h"
+#include "image_util.h"
+
+enum Format { DXT1, DXT3, DXT5 };
+
+static std::vector<uint8_t> Compress(Format format, const HostImage &image, DXTCompressionMode mode) {
+  std::vector<uint8_t> ret;
+  switch (format) {
+    case DXT1:
+      ret.resize(GetDXT1CompressedSize(image.width, image.height));
+      CompressDXT1(ret.data(), image.pixels.data(), image.width * 4, image.width, image.height, mode);
+      break;
+    case DXT3:
+      ret.resize(GetDXT3CompressedSize(image.width, image.height));
+      CompressDXT3(ret.data(), image.pixels.data(), image.width * 4, image.width, image.height, mode);
+      break;
+    case DXT5:
+      ret.resize(GetDXT5CompressedSize(image.width, image.height));
+      CompressDXT5(ret.data(), image.pixels.data(), image.width * 4, image.width, image.height, mode);
+      break;
+  }
+  return ret;
+}
+
+static std::vector<uint32_t> Decompress(Format format, const std::vector<uint8_t> &data, uint32_t width,
+                                        uint32_t height) {
+  std::vector<uint32_t> ret(width * height);
+  switch (format) {
+    case DXT1:
+      DecompressDXT1(ret.data(), width * 4, data.data(), width, height, DXT_INTERPOLATE_REFERENCE);
+      break;
+    case DXT3:
+      DecompressDXT3(ret.data(), width * 4, data.data(), width, height, DXT_INTERPOLATE_REFERENCE);
+      break;
+    case DXT5:
+      DecompressDXT5(ret.data(), width * 4, data.data(), width, height, DXT_INTERPOLATE_REFERENCE);
+      break;
+  }
+  return ret;
+}
+
+static ImageError RoundTrip(Format format, const HostImage &image, DXTCompressionMode mode,
+                            uint32_t component_mask = 0x07) {
+  auto decoded = Decompress(format, Compress(format, image, mode), image.width, image.height);
+  return CompareImages(decoded.data(), image.pixels.data(), decoded.size(), component_mask);
+}
+
+static HostImage LoadPlasma() {
+  HostImage ret;
+  EXPECT_TRUE(LoadPNG(GetResourcePath("dxt_images/plasma_original.png"), ret));
+  return ret;
+}
+
+TEST(DXTCompressor, CompressedSizes) {
+  EXPECT_EQ(GetDXT1CompressedSize(4, 4), 8u);
+  EXPECT_EQ(GetDXT3CompressedSize(4, 4), 16u);
+  EXPECT_EQ(GetDXT5CompressedSize(4, 4), 16u);
+  EXPECT_EQ(GetDXT1CompressedSize(5, 9), 8u * 2 * 3);
+  EXPECT_EQ(GetDXT5CompressedSize(1, 1), 16u);
+}
+
+TEST(DXTCompressor, RepresentableSolidColorsAreExact) {
+  // Each channel is exactly representable in 5:6:5.
+  for (uint32_t color : {0xFFFF00FF, 0xFF00FF00, 0xFF848284, 0xFF000000, 0xFFFFFFFF}) {
+    HostImage image{8, 8, std::vector<uint32_t>(64, color)};
+    for (auto format : {DXT1, DXT3, DXT5}) {
+      for (auto mode : {DXT_COMPRESS_FAST, DXT_COMPRESS_QUALITY}) {
+        auto decoded = Decompress(format, Compress(format, image, mode), 8, 8);
+        EXPECT_EQ(decoded, image.pixels) << "format " << format << " mode " << mode << " color " << std::hex << color;
+      }
+    }
+  }
+}
+
+TEST(DXTCompressor, DXT1EncodesLowAlphaAsTransparent) {
+  auto image = MakeGradientImage(16, 16);
+  auto decoded = Decompress(DXT1, Compress(DXT1, image, DXT_COMPRESS_QUALITY), 16, 16);
+  for (uint32_t i = 0; i < decoded.size(); ++i) {
+    const bool transparent = (image.pixels[i] >> 24) < 128;
+    if (transparent) {
+      EXPECT_EQ(decoded[i], 0u) << "pixel " << i;
+    } else {
+      EXPECT_EQ(decoded[i] >> 24, 0xFFu) << "pixel " << i;
+    }
+  }
+}
+
+TEST(DXTCompressor, PadsPartialBlocksWithEdgePixels) {
+  auto image = MakeGradientImage(6, 7);
+  HostImage padded{8, 8, std::vector<uint32_t>(64)};
+  for (uint32_t y = 0; y < 8; ++y) {
+    for (uint32_t x = 0; x < 8; ++x) {
+      padded.pixels[y * 8 + x] = image.pixels[std::min(y, 6u) * 6 + std::min(x, 5u)];
+    }
+  }
+
+  for (auto format : {DXT1, DXT3, DXT5}) {
+    EXPECT_EQ(Compress(format, image, DXT_COMPRESS_QUALITY), Compress(format, padded, DXT_COMPRESS_QUALITY))
+        << "format " << format;
+  }
+}
+
+TEST(DXTCompressor, HonorsComponentShifts) {
+  auto image = MakeGradientImage(16, 16);
+  std::vector<uint32_t> argb(image.pixels.size());
+  for (uint32_t i = 0; i < argb.size(); ++i) {
+    const uint32_t p = image.pixels[i];
+    argb[i] = (p & 0xFF00FF00) | ((p & 0xFF) << 16) | ((p >> 16) & 0xFF);
+  }
+
+  std::vector<uint8_t> expected(GetDXT5CompressedSize(16, 16));
+  CompressDXT5(expected.data(), image.pixels.data(), 16 * 4, 16, 16);
+  std::vector<uint8_t> actual(expected.size());
+  CompressDXT5(actual.data(), argb.data(), 16 * 4, 16, 16, DXT_COMPRESS_QUALITY, 16, 8, 0, 24);
+  EXPECT_EQ(actual, expected);
+}
+
+TEST(DXTCompressor, GradientQuality) {
+  auto image = MakeGradientImage(64, 64);
+  // DXT1 punches through pixels with low alpha, so its color error is measured on an opaque copy.
+  auto opaque = image;
+  for (auto &pixel : opaque.pixels) {
+    pixel |= 0xFF000000;
+  }
+
+  for (auto mode : {DXT_COMPRESS_FAST, DXT_COMPRESS_QUALITY}) {
+    EXPECT_GT(RoundTrip(DXT1, opaque, mode).psnr, 38.0) << "mode " << mode;
+    EXPECT_GT(RoundTrip(DXT3, image, mode).psnr, 38.0) << "mode " << mode;
+    EXPECT_GT(RoundTrip(DXT5, image, mode).psnr, 38.0) << "mode " << mode;
+  }
+}
+
+TEST(DXTCompressor, QualityModeImprovesPlasma) {
+  auto image = LoadPlasma();
+  for (auto format : {DXT1, DXT3, DXT5}) {
+    const double fast = RoundTrip(format, image, DXT_COMPRESS_FAST).psnr;
+    const double quality = RoundTrip(format, image, DXT_COMPRESS_QUALITY).psnr;
+    EXPECT_GT(fast, 24.0) << "format " << format;
+    EXPECT_GT(quality, fast) << "format " << format;
+  }
+}
+
+TEST(DXTCompressor, AlphaQuality) {
+  auto image = MakeGradientImage(64, 64);
+
+  // DXT3 stores alpha with 4 bits, so the error is bounded by half a step.
+  auto dxt3 = RoundTrip(DXT3, image, DXT_COMPRESS_QUALITY, 0x08);
+  EXPECT_LE(dxt3.max_error, 9u);
+
+  auto dxt5 = RoundTrip(DXT5, image, DXT_COMPRESS_QUALITY, 0x08);
+  EXPECT_GT(dxt5.psnr, 45.0);
+  EXPECT_GT(dxt5.psnr, dxt3.psnr);
+}
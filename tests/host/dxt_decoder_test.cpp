@@ -0,0 +1,210 @@
+#include "dxt_decoder.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "dds_image.h"
+#include "image_util.h"
+
+// Red and blue endpoints with indices 0, 1, 2, 3 in each row.
+static const uint8_t kRedBlueBlock[] = {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0xE4, 0xE4, 0xE4};
+
+static uint32_t RGBA(uint32_t r, uint32_t g, uint32_t b, uint32_t a = 0xFF) {
+  return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+static void ExpectNear(uint32_t actual, uint32_t expected, int tolerance) {
+  for (uint32_t shift = 0; shift < 32; shift += 8) {
+    const int a = (actual >> shift) & 0xFF;
+    const int e = (expected >> shift) & 0xFF;
+    EXPECT_NEAR(a, e, tolerance) << std::hex << actual << " vs " << expected;
+  }
+}
+
+TEST(DXTDecoder, DXT1FourColorBlock) {
+  uint32_t pixels[16];
+  DecompressDXT1(pixels, 16, kRedBlueBlock, 4, 4, DXT_INTERPOLATE_REFERENCE);
+
+  const uint32_t expected[] = {RGBA(255, 0, 0), RGBA(0, 0, 255), RGBA(170, 0, 85), RGBA(85, 0, 170)};
+  for (uint32_t y = 0; y < 4; ++y) {
+    for (uint32_t x = 0; x < 4; ++x) {
+      EXPECT_EQ(pixels[y * 4 + x], expected[x]) << x << ", " << y;
+    }
+  }
+
+  // The hardware interpolation differs from the reference by a few units at most.
+  uint32_t nv2a[16];
+  DecompressDXT1(nv2a, 16, kRedBlueBlock, 4, 4, DXT_INTERPOLATE_NV2A);
+  for (uint32_t i = 0; i < 16; ++i) {
+    ExpectNear(nv2a[i], pixels[i], 3);
+  }
+}
+
+TEST(DXTDecoder, DXT1ThreeColorBlock) {
+  // color0 <= color1 selects the 3-color mode.
+  const uint8_t block[] = {0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xE4, 0xE4, 0xE4};
+  uint32_t pixels[16];
+  DecompressDXT1(pixels, 16, block, 4, 4, DXT_INTERPOLATE_REFERENCE);
+
+  EXPECT_EQ(pixels[0], RGBA(0, 0, 255));
+  EXPECT_EQ(pixels[1], RGBA(255, 0, 0));
+  EXPECT_EQ(pixels[2], RGBA(127, 0, 127));
+  EXPECT_EQ(pixels[3], 0u);
+}
+
+TEST(DXTDecoder, DXT3ExplicitAlphaAndFourColorMode) {
+  uint8_t block[16];
+  // Alpha nibbles 0..15 in pixel order.
+  for (uint32_t i = 0; i < 8; ++i) {
+    block[i] = static_cast<uint8_t>((i * 2) | ((i * 2 + 1) << 4));
+  }
+  // The 3-color ordering of the endpoints still decodes in 4-color mode.
+  const uint8_t color[] = {0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xE4, 0xE4, 0xE4};
+  memcpy(block + 8, color, sizeof(color));
+
+  uint32_t pixels[16];
+  DecompressDXT3(pixels, 16, block, 4, 4, DXT_INTERPOLATE_REFERENCE);
+  for (uint32_t i = 0; i < 16; ++i) {
+    EXPECT_EQ(pixels[i] >> 24, i * 17) << i;
+  }
+  EXPECT_EQ(pixels[3] & 0xFFFFFF, RGBA(170, 0, 85) & 0xFFFFFF);
+}
+
+TEST(DXTDecoder, DXT5AlphaModes) {
+  uint8_t block[16];
+  memcpy(block + 8, kRedBlueBlock, sizeof(kRedBlueBlock));
+
+  // Eight value mode: indices 0..7 on the first row and a half (index 1 = alpha1).
+  block[0] = 255;
+  block[1] = 0;
+  uint64_t indices = 0;
+  for (uint32_t i = 0; i < 16; ++i) {
+    indices |= static_cast<uint64_t>(i & 0x07) << (i * 3);
+  }
+  for (uint32_t i = 0; i < 6; ++i) {
+    block[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+  }
+
+  uint32_t pixels[16];
+  DecompressDXT5(pixels, 16, block, 4, 4, DXT_INTERPOLATE_REFERENCE);
+  const uint32_t eight[] = {255, 0, 218, 182, 145, 109, 72, 36};
+  for (uint32_t i = 0; i < 16; ++i) {
+    EXPECT_NEAR(static_cast<int>(pixels[i] >> 24), static_cast<int>(eight[i & 0x07]), 1) << i;
+  }
+
+  // Six value mode, with index 6 = 0 and index 7 = 255.
+  block[0] = 40;
+  block[1] = 240;
+  DecompressDXT5(pixels, 16, block, 4, 4, DXT_INTERPOLATE_REFERENCE);
+  const uint32_t six[] = {40, 240, 80, 120, 160, 200, 0, 255};
+  for (uint32_t i = 0; i < 16; ++i) {
+    EXPECT_NEAR(static_cast<int>(pixels[i] >> 24), static_cast<int>(six[i & 0x07]), 1) << i;
+  }
+}
+
+TEST(DXTDecoder, ClipsPartialBlocks) {
+  // A 3x3 image inside a 5 pixel pitch must leave the padding untouched.
+  std::vector<uint32_t> pixels(5 * 3, 0xDEADBEEF);
+  DecompressDXT1(pixels.data(), 5 * 4, kRedBlueBlock, 3, 3, DXT_INTERPOLATE_REFERENCE);
+  for (uint32_t y = 0; y < 3; ++y) {
+    EXPECT_EQ(pixels[y * 5 + 0], RGBA(255, 0, 0));
+    EXPECT_EQ(pixels[y * 5 + 2], RGBA(170, 0, 85));
+    EXPECT_EQ(pixels[y * 5 + 3], 0xDEADBEEF);
+    EXPECT_EQ(pixels[y * 5 + 4], 0xDEADBEEF);
+  }
+}
+
+struct ResourceCase {
+  const char *dds;
+  const char *png;
+  // Minimum RGB PSNR and, if nonzero, alpha PSNR of the decoded primary image against the source PNG.
+  double min_rgb_psnr;
+  double min_alpha_psnr;
+};
+
+static void PrintTo(const ResourceCase &param, std::ostream *os) { *os << param.dds; }
+
+class DXTDecoderResourceTest : public ::testing::TestWithParam<ResourceCase> {};
+
+// Decodes the checked in DDS files and compares them with the images they were compressed from.
+TEST_P(DXTDecoderResourceTest, MatchesSourceImage) {
+  const auto &param = GetParam();
+
+  HostImage source;
+  ASSERT_TRUE(LoadPNG(GetResourcePath(param.png), source));
+
+  DDSImage dds;
+  ASSERT_TRUE(dds.LoadFile(GetResourcePath(param.dds).c_str(), true));
+  auto image = dds.GetPrimaryImage();
+  ASSERT_EQ(image->width, source.width);
+  ASSERT_EQ(image->height, source.height);
+
+  for (auto interpolation : {DXT_INTERPOLATE_REFERENCE, DXT_INTERPOLATE_NV2A}) {
+    std::vector<uint32_t> decoded(image->width * image->height);
+    const uint32_t pitch = image->width * 4;
+    switch (image->format) {
+      case DDSImage::Format::DXT1:
+        DecompressDXT1(decoded.data(), pitch, image->data.data(), image->width, image->height, interpolation);
+        break;
+      case DDSImage::Format::DXT3:
+        DecompressDXT3(decoded.data(), pitch, image->data.data(), image->width, image->height, interpolation);
+        break;
+      case DDSImage::Format::DXT5:
+        DecompressDXT5(decoded.data(), pitch, image->data.data(), image->width, image->height, interpolation);
+        break;
+      default:
+        FAIL() << "Unexpected format";
+    }
+
+    // Transparent DXT1 texels are black, so only opaque source pixels are compared.
+    std::vector<uint32_t> expected = source.pixels;
+    if (image->format == DDSImage::Format::DXT1) {
+      for (uint32_t i = 0; i < decoded.size(); ++i) {
+        if (!(decoded[i] >> 24)) {
+          decoded[i] = expected[i];
+        }
+      }
+    }
+
+    const auto rgb = CompareImages(decoded.data(), expected.data(), decoded.size());
+    EXPECT_GT(rgb.psnr, param.min_rgb_psnr) << "interpolation " << interpolation;
+    if (param.min_alpha_psnr > 0.0) {
+      EXPECT_GT(CompareImages(decoded.data(), expected.data(), decoded.size(), 0x08).psnr, param.min_alpha_psnr)
+          << "interpolation " << interpolation;
+    }
+  }
+
+  // Every mip level must be present and decodable.
+  uint32_t width = image->width;
+  uint32_t height = image->height;
+  for (auto &level : dds.GetSubImages()) {
+    EXPECT_EQ(level->width, width);
+    EXPECT_EQ(level->height, height);
+    const uint32_t block_bytes = image->format == DDSImage::Format::DXT1 ? 8 : 16;
+    EXPECT_GE(level->data.size(), ((width + 3) / 4) * ((height + 3) / 4) * block_bytes);
+    width = std::max(1u, width / 2);
+    height = std::max(1u, height / 2);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Resources, DXTDecoderResourceTest,
+                         ::testing::Values(ResourceCase{"dxt_images/plasma_dxt1.dds", "dxt_images/plasma_original.png",
+                                                        27.0, 0.0},
+                                           ResourceCase{"dxt_images/plasma_dxt3.dds", "dxt_images/plasma_original.png",
+                                                        27.0, 0.0},
+                                           ResourceCase{"dxt_images/plasma_dxt5.dds", "dxt_images/plasma_original.png",
+                                                        27.0, 0.0},
+                                           ResourceCase{"dxt_images/plasma_alpha_dxt1.dds",
+                                                        "dxt_images/plasma_alpha.png", 27.0, 0.0},
+                                           ResourceCase{"dxt_images/plasma_alpha_dxt3.dds",
+                                                        "dxt_images/plasma_alpha.png", 27.0, 30.0},
+                                           ResourceCase{"dxt_images/plasma_alpha_dxt5.dds",
+                                                        "dxt_images/plasma_alpha.png", 27.0, 40.0},
+                                           ResourceCase{"dxt_images/64x256_bands_dxt1.dds",
+                                                        "dxt_images/64x256_bands.png", 24.0, 0.0},
+                                           ResourceCase{"dxt_images/64x256_bands_dxt3.dds",
+                                                        "dxt_images/64x256_bands.png", 24.0, 0.0},
+                                           ResourceCase{"dxt_images/64x256_bands_dxt5.dds",
+                                                        "dxt_images/64x256_bands.png", 24.0, 0.0}));
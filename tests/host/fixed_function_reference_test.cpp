@@ -0,0 +1,364 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// These include math3d.h, whose macros (such as _11) collide with identifiers in the GoogleTest headers.
+#include "fixed_function_reference.h"
+#include "vertex_buffer.h"
+
+static constexpr float kTolerance = 1e-5f;
+
+static Vertex MakeVertex(float x, float y, float z) {
+  Vertex vertex;
+  memset(&vertex, 0, sizeof(vertex));
+  vertex.SetPosition(x, y, z);
+  vertex.SetNormal(0.0f, 0.0f, 1.0f);
+  vertex.SetDiffuse(1.0f, 1.0f, 1.0f);
+  vertex.SetSpecular(0.0f, 0.0f, 0.0f);
+  return vertex;
+}
+
+static FixedFunctionVertex Apply(const FixedFunctionState &state, const Vertex &vertex) {
+  FixedFunctionVertex result;
+  ApplyFixedFunctionPipeline(state, &vertex, 1, &result);
+  return result;
+}
+
+static void ExpectColor(const float *actual, float r, float g, float b, float a) {
+  EXPECT_NEAR(actual[0], r, kTolerance);
+  EXPECT_NEAR(actual[1], g, kTolerance);
+  EXPECT_NEAR(actual[2], b, kTolerance);
+  EXPECT_NEAR(actual[3], a, kTolerance);
+}
+
+static void SetVector(VECTOR out, float x, float y, float z, float w) {
+  out[_X] = x;
+  out[_Y] = y;
+  out[_Z] = z;
+  out[_W] = w;
+}
+
+static void MakeTranslation(MATRIX result, float x, float y, float z) {
+  matrix_unit(result);
+  result[_41] = x;
+  result[_42] = y;
+  result[_43] = z;
+}
+
+// The light set up by LightingNormalTests: a single infinite light whose colors all come from the material.
+static FixedFunctionState MakeLightingNormalState() {
+  FixedFunctionState state;
+  state.lighting_enable = true;
+  state.light_enable_mask = FixedFunctionState::LIGHT_INFINITE;
+  SetVector(state.lights[0].diffuse, 0.0f, 1.0f, 0.7f, 0.0f);
+  SetVector(state.lights[0].infinite_direction, 0.0f, 0.0f, 1.0f, 0.0f);
+  return state;
+}
+
+TEST(FixedFunctionReferenceTest, PositionIsTransformedByCompositeRows) {
+  FixedFunctionState state;
+  MakeTranslation(state.composite, 10.0f, 20.0f, 30.0f);
+  state.composite[_11] = 2.0f;
+  state.composite[_44] = 3.0f;
+
+  const auto result = Apply(state, MakeVertex(1.0f, 2.0f, 3.0f));
+  EXPECT_NEAR(result.position[0], 12.0f, kTolerance);
+  EXPECT_NEAR(result.position[1], 22.0f, kTolerance);
+  EXPECT_NEAR(result.position[2], 33.0f, kTolerance);
+  EXPECT_NEAR(result.position[3], 3.0f, kTolerance);
+}
+
+TEST(FixedFunctionReferenceTest, UnlitColorsPassThroughClamped) {
+  FixedFunctionState state;
+  auto vertex = MakeVertex(0.0f, 0.0f, 0.0f);
+  vertex.SetDiffuse(0.25f, 2.0f, -1.0f, 0.5f);
+  vertex.SetSpecular(0.75f, 0.5f, 0.25f, 0.125f);
+
+  const auto result = Apply(state, vertex);
+  ExpectColor(result.diffuse, 0.25f, 1.0f, 0.0f, 0.5f);
+  ExpectColor(result.specular, 0.75f, 0.5f, 0.25f, 0.125f);
+}
+
+// The diffuse term is the light color scaled by N.L, so unnormalized normals over or under light the vertex unless
+// normalization is enabled.
+TEST(FixedFunctionReferenceTest, LightingNormal) {
+  auto state = MakeLightingNormalState();
+  auto vertex = MakeVertex(0.0f, 0.0f, 0.0f);
+
+  vertex.SetNormal(0.0f, 0.6f, 0.8f);
+  ExpectColor(Apply(state, vertex).diffuse, 0.0f, 0.8f, 0.56f, 1.0f);
+
+  vertex.SetNormal(0.0f, 0.0f, -1.0f);
+  ExpectColor(Apply(state, vertex).diffuse, 0.0f, 0.0f, 0.0f, 1.0f);
+
+  vertex.SetNormal(0.0f, 0.0f, 0.5f);
+  ExpectColor(Apply(state, vertex).diffuse, 0.0f, 0.5f, 0.35f, 1.0f);
+  state.normalization_enable = true;
+  ExpectColor(Apply(state, vertex).diffuse, 0.0f, 1.0f, 0.7f, 1.0f);
+
+  // Normals are transformed by the transpose of the inverse model view matrix, here that of a uniform scale by 2.
+  state.normalization_enable = false;
+  vertex.SetNormal(0.0f, 0.0f, 1.0f);
+  matrix_unit(state.inverse_model_view);
+  state.inverse_model_view[_11] = 0.5f;
+  state.inverse_model_view[_22] = 0.5f;
+  state.inverse_model_view[_33] = 0.5f;
+  ExpectColor(Apply(state, vertex).diffuse, 0.0f, 0.5f, 0.35f, 1.0f);
+  state.normalization_enable = true;
+  ExpectColor(Apply(state, vertex).diffuse, 0.0f, 1.0f, 0.7f, 1.0f);
+
+  // A rotation of 90 degrees about y, which turns the normal (-0.6, 0, 0.8) into (0.8, 0, 0.6).
+  matrix_unit(state.inverse_model_view);
+  state.inverse_model_view[_11] = 0.0f;
+  state.inverse_model_view[_13] = 1.0f;
+  state.inverse_model_view[_31] = -1.0f;
+  state.inverse_model_view[_33] = 0.0f;
+  vertex.SetNormal(-0.6f, 0.0f, 0.8f);
+  ExpectColor(Apply(state, vertex).diffuse, 0.0f, 0.6f, 0.42f, 1.0f);
+}
+
+TEST(FixedFunctionReferenceTest, MaterialColorFromMaterial) {
+  auto state = MakeLightingNormalState();
+  SetVector(state.lights[0].ambient, 0.1f, 0.2f, 0.0f, 0.0f);
+  state.material_alpha = 0.25f;
+  auto vertex = MakeVertex(0.0f, 0.0f, 0.0f);
+  vertex.SetDiffuse(0.5f, 0.5f, 0.5f, 0.75f);
+
+  ExpectColor(Apply(state, vertex).diffuse, 0.1f, 1.0f, 0.7f, 0.25f);
+}
+
+// Vertex colors selected by NV097_SET_COLOR_MATERIAL scale the light colors, which already include the material.
+TEST(FixedFunctionReferenceTest, MaterialColorFromVertex) {
+  auto state = MakeLightingNormalState();
+  SetVector(state.lights[0].diffuse, 0.5f, 1.0f, 0.5f, 0.0f);
+  auto vertex = MakeVertex(0.0f, 0.0f, 0.0f);
+  vertex.SetNormal(0.0f, 0.6f, 0.8f);
+  vertex.SetDiffuse(0.5f, 0.25f, 1.0f, 0.75f);
+  vertex.SetSpecular(1.0f, 0.5f, 0.0f, 0.125f);
+
+  // Diffuse from the vertex diffuse color, taking its alpha too.
+  state.color_material = FixedFunctionState::SOURCE_VERTEX_DIFFUSE << 4;
+  ExpectColor(Apply(state, vertex).diffuse, 0.2f, 0.2f, 0.4f, 0.75f);
+
+  // Diffuse from the vertex specular color.
+  state.color_material = FixedFunctionState::SOURCE_VERTEX_SPECULAR << 4;
+  ExpectColor(Apply(state, vertex).diffuse, 0.4f, 0.4f, 0.0f, 0.125f);
+
+  // Emission from the vertex specular color, added unscaled.
+  state.color_material = FixedFunctionState::SOURCE_VERTEX_SPECULAR;
+  ExpectColor(Apply(state, vertex).diffuse, 1.0f, 1.0f, 0.4f, 1.0f);
+}
+
+// The ambient color is scaled by the material emission, and the scene ambient color is used for both the ambient and
+// emissive colors when they come from the material. This follows xemu and has not been confirmed on hardware.
+TEST(FixedFunctionReferenceTest, MaterialColorSceneAmbientAndEmission) {
+  FixedFunctionState state;
+  state.lighting_enable = true;
+  SetVector(state.scene_ambient_color, 0.2f, 0.4f, 0.1f, 0.0f);
+  SetVector(state.material_emission, 0.5f, 0.5f, 2.0f, 0.0f);
+  auto vertex = MakeVertex(0.0f, 0.0f, 0.0f);
+  vertex.SetDiffuse(0.5f, 0.25f, 0.0f);
+
+  ExpectColor(Apply(state, vertex).diffuse, 0.3f, 0.6f, 0.3f, 1.0f);
+
+  state.color_material = FixedFunctionState::SOURCE_VERTEX_DIFFUSE << 2;
+  ExpectColor(Apply(state, vertex).diffuse, 0.45f, 0.525f, 0.1f, 1.0f);
+}
+
+TEST(FixedFunctionReferenceTest, InfiniteLightSpecular) {
+  auto state = MakeLightingNormalState();
+  state.specular_power = 2.0f;
+  SetVector(state.lights[0].specular, 1.0f, 0.5f, 0.25f, 0.0f);
+  SetVector(state.lights[0].infinite_half_vector, 0.0f, 0.0f, 1.0f, 0.0f);
+  auto vertex = MakeVertex(0.0f, 0.0f, 0.0f);
+  vertex.SetNormal(0.0f, 0.6f, 0.8f);
+  vertex.SetSpecular(0.0f, 0.0f, 0.0f, 0.5f);
+
+  ExpectColor(Apply(state, vertex).specular, 0.0f, 0.0f, 0.0f, 0.5f);
+
+  state.specular_enable = true;
+  ExpectColor(Apply(state, vertex).specular, 0.64f, 0.32f, 0.16f, 0.5f);
+
+  // No highlight on faces that point away from the light, even if they face the half vector.
+  SetVector(state.lights[0].infinite_direction, 0.0f, 0.0f, -1.0f, 0.0f);
+  ExpectColor(Apply(state, vertex).specular, 0.0f, 0.0f, 0.0f, 0.5f);
+}
+
+TEST(FixedFunctionReferenceTest, LocalLightAttenuation) {
+  auto state = MakeLightingNormalState();
+  state.light_enable_mask = FixedFunctionState::LIGHT_LOCAL;
+  auto &light = state.lights[0];
+  SetVector(light.diffuse, 1.0f, 1.0f, 1.0f, 0.0f);
+  SetVector(light.local_position, 0.0f, 0.0f, 4.0f, 1.0f);
+  SetVector(light.local_attenuation, 1.0f, 0.5f, 0.25f, 0.0f);
+
+  // 3 units from the light: 1 / (1 + 0.5 * 3 + 0.25 * 9).
+  const float attenuation = 1.0f / 4.75f;
+  ExpectColor(Apply(state, MakeVertex(0.0f, 0.0f, 1.0f)).diffuse, attenuation, attenuation, attenuation, 1.0f);
+
+  // The light position is in eye space, so the vertex is moved by the model view matrix.
+  MakeTranslation(state.model_view, 0.0f, 0.0f, 1.0f);
+  ExpectColor(Apply(state, MakeVertex(0.0f, 0.0f, 0.0f)).diffuse, attenuation, attenuation, attenuation, 1.0f);
+
+  light.local_range = 2.5f;
+  ExpectColor(Apply(state, MakeVertex(0.0f, 0.0f, 0.0f)).diffuse, 0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+TEST(FixedFunctionReferenceTest, FogGenModes) {
+  FixedFunctionState state;
+  MakeTranslation(state.model_view, 0.0f, 0.0f, 2.0f);
+  auto vertex = MakeVertex(3.0f, 4.0f, -2.0f);
+  vertex.fog_coord = 7.0f;
+  vertex.SetSpecular(0.0f, 0.0f, 0.0f, 1.5f);
+
+  state.fog_gen_mode = FixedFunctionState::FOG_GEN_SPEC_ALPHA;
+  EXPECT_NEAR(Apply(state, vertex).fog_coord, 1.0f, kTolerance);
+
+  state.fog_gen_mode = FixedFunctionState::FOG_GEN_RADIAL;
+  EXPECT_NEAR(Apply(state, vertex).fog_coord, 5.0f, kTolerance);
+
+  state.fog_gen_mode = FixedFunctionState::FOG_GEN_PLANAR;
+  SetVector(state.fog_plane, 0.0f, 1.0f, 0.0f, -6.0f);
+  EXPECT_NEAR(Apply(state, vertex).fog_coord, -2.0f, kTolerance);
+
+  state.fog_gen_mode = FixedFunctionState::FOG_GEN_ABS_PLANAR;
+  EXPECT_NEAR(Apply(state, vertex).fog_coord, 2.0f, kTolerance);
+
+  state.fog_gen_mode = FixedFunctionState::FOG_GEN_FOG_X;
+  EXPECT_NEAR(Apply(state, vertex).fog_coord, 7.0f, kTolerance);
+}
+
+// The fog parameters are set up the way D3D style fog start, end and density are converted to NV097_SET_FOG_PARAMS,
+// so the factors match the D3D fog equations.
+TEST(FixedFunctionReferenceTest, FogModes) {
+  FixedFunctionState state;
+  state.fog_gen_mode = FixedFunctionState::FOG_GEN_FOG_X;
+  auto vertex = MakeVertex(0.0f, 0.0f, 0.0f);
+  auto factor_at = [&](float coordinate) {
+    vertex.fog_coord = coordinate;
+    return Apply(state, vertex).fog_factor;
+  };
+
+  // Linear from 2 to 10.
+  static constexpr float kStart = 2.0f;
+  static constexpr float kEnd = 10.0f;
+  state.fog_mode = FixedFunctionState::FOG_LINEAR;
+  state.fog_params[0] = 1.0f + kEnd / (kEnd - kStart);
+  state.fog_params[1] = -1.0f / (kEnd - kStart);
+  EXPECT_NEAR(factor_at(4.0f), 0.75f, kTolerance);
+  EXPECT_NEAR(factor_at(0.0f), 1.0f, kTolerance);
+  EXPECT_NEAR(factor_at(12.0f), 0.0f, kTolerance);
+  EXPECT_NEAR(factor_at(-4.0f), 1.0f, kTolerance);
+  state.fog_mode = FixedFunctionState::FOG_LINEAR_ABS;
+  EXPECT_NEAR(factor_at(-4.0f), 0.75f, kTolerance);
+
+  static constexpr float kDensity = 0.25f;
+  const float ln2 = std::log(2.0f);
+  state.fog_mode = FixedFunctionState::FOG_EXP;
+  state.fog_params[0] = 1.5f;
+  state.fog_params[1] = -kDensity / (16.0f * ln2);
+  EXPECT_NEAR(factor_at(3.0f), std::exp(-kDensity * 3.0f), kTolerance);
+  state.fog_mode = FixedFunctionState::FOG_EXP_ABS;
+  EXPECT_NEAR(factor_at(-3.0f), std::exp(-kDensity * 3.0f), kTolerance);
+
+  state.fog_mode = FixedFunctionState::FOG_EXP2;
+  state.fog_params[1] = kDensity / std::sqrt(32.0f * ln2);
+  EXPECT_NEAR(factor_at(3.0f), std::exp(-(kDensity * 3.0f) * (kDensity * 3.0f)), kTolerance);
+  state.fog_mode = FixedFunctionState::FOG_EXP2_ABS;
+  EXPECT_NEAR(factor_at(-3.0f), std::exp(-(kDensity * 3.0f) * (kDensity * 3.0f)), kTolerance);
+}
+
+TEST(FixedFunctionReferenceTest, TexgenLinear) {
+  FixedFunctionState state;
+  MakeTranslation(state.model_view, 10.0f, 0.0f, 0.0f);
+  auto &texgen = state.texgen[1];
+  texgen.mode[0] = FixedFunctionState::TEXGEN_EYE_LINEAR;
+  texgen.mode[1] = FixedFunctionState::TEXGEN_OBJECT_LINEAR;
+  SetVector(texgen.plane[0], 1.0f, 0.0f, 0.0f, 0.5f);
+  SetVector(texgen.plane[1], 1.0f, 2.0f, 0.0f, 0.0f);
+
+  auto vertex = MakeVertex(1.0f, 2.0f, 3.0f);
+  vertex.SetTexCoord0(0.1f, 0.2f, 0.3f, 0.4f);
+  vertex.SetTexCoord1(0.5f, 0.6f, 0.7f, 0.8f);
+  const auto result = Apply(state, vertex);
+
+  EXPECT_NEAR(result.texcoord[1][0], 11.5f, kTolerance);
+  EXPECT_NEAR(result.texcoord[1][1], 5.0f, kTolerance);
+  // Coordinates that are not generated pass through, as do the other stages.
+  EXPECT_NEAR(result.texcoord[1][2], 0.7f, kTolerance);
+  EXPECT_NEAR(result.texcoord[1][3], 0.8f, kTolerance);
+  ExpectColor(result.texcoord[0], 0.1f, 0.2f, 0.3f, 0.4f);
+}
+
+TEST(FixedFunctionReferenceTest, TexgenNormalAndReflectionMaps) {
+  FixedFunctionState state;
+  auto &texgen = state.texgen[0];
+  auto vertex = MakeVertex(0.0f, 0.0f, 5.0f);
+  const float half_sqrt2 = std::sqrt(0.5f);
+  vertex.SetNormal(0.0f, half_sqrt2, -half_sqrt2);
+  vertex.SetTexCoord0(0.1f, 0.2f, 0.3f, 0.4f);
+
+  for (auto &mode : texgen.mode) {
+    mode = FixedFunctionState::TEXGEN_NORMAL_MAP;
+  }
+  ExpectColor(Apply(state, vertex).texcoord[0], 0.0f, half_sqrt2, -half_sqrt2, 0.4f);
+
+  // The view direction (0, 0, 1) reflects off the normal to (0, 1, 0).
+  for (auto &mode : texgen.mode) {
+    mode = FixedFunctionState::TEXGEN_REFLECTION_MAP;
+  }
+  ExpectColor(Apply(state, vertex).texcoord[0], 0.0f, 1.0f, 0.0f, 0.4f);
+
+  // Sphere map: r / (2 * |r + (0, 0, 1)|) + 0.5.
+  for (auto &mode : texgen.mode) {
+    mode = FixedFunctionState::TEXGEN_SPHERE_MAP;
+  }
+  const float t = 1.0f / (2.0f * std::sqrt(2.0f)) + 0.5f;
+  ExpectColor(Apply(state, vertex).texcoord[0], 0.5f, t, 0.3f, 0.4f);
+}
+
+TEST(FixedFunctionReferenceTest, TextureMatrixIsAppliedAfterTexgen) {
+  FixedFunctionState state;
+  auto &texgen = state.texgen[2];
+  texgen.mode[0] = FixedFunctionState::TEXGEN_OBJECT_LINEAR;
+  texgen.texture_matrix_enable = true;
+  // Scales s by 2 and moves q into t, in the layout applied by vector_apply.
+  matrix_unit(texgen.texture_matrix);
+  texgen.texture_matrix[_11] = 2.0f;
+  texgen.texture_matrix[_22] = 0.0f;
+  texgen.texture_matrix[_24] = 1.0f;
+
+  auto vertex = MakeVertex(3.0f, 0.0f, 0.0f);
+  vertex.SetTexCoord2(0.0f, 0.5f, 0.25f, 0.75f);
+  ExpectColor(Apply(state, vertex).texcoord[2], 6.0f, 0.75f, 0.25f, 0.75f);
+}
+
+// Partial batches repeat the last vertex, which must not leak into the results of the others.
+TEST(FixedFunctionReferenceTest, BatchesMatchSingleVertices) {
+  auto state = MakeLightingNormalState();
+  state.specular_enable = true;
+  state.specular_power = 3.0f;
+  state.normalization_enable = true;
+  SetVector(state.lights[0].specular, 1.0f, 1.0f, 1.0f, 0.0f);
+  SetVector(state.lights[0].infinite_half_vector, 0.0f, 0.6f, 0.8f, 0.0f);
+  state.fog_gen_mode = FixedFunctionState::FOG_GEN_RADIAL;
+  state.texgen[0].mode[0] = FixedFunctionState::TEXGEN_SPHERE_MAP;
+  state.texgen[0].mode[1] = FixedFunctionState::TEXGEN_SPHERE_MAP;
+  MakeTranslation(state.model_view, 0.0f, 0.0f, 5.0f);
+
+  std::vector<Vertex> vertices;
+  for (int i = 0; i < 7; ++i) {
+    auto vertex = MakeVertex(static_cast<float>(i), static_cast<float>(i % 3), 1.0f);
+    vertex.SetNormal(0.1f * static_cast<float>(i), 1.0f, 2.0f);
+    vertices.push_back(vertex);
+  }
+
+  std::vector<FixedFunctionVertex> batched(vertices.size());
+  ApplyFixedFunctionPipeline(state, vertices.data(), vertices.size(), batched.data());
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    const auto single = Apply(state, vertices[i]);
+    EXPECT_EQ(memcmp(&single, &batched[i], sizeof(single)), 0) << "vertex " << i;
+  }
+}
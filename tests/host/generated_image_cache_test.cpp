@@ -0,0 +1,163 @@
+#include "generated_image_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+// Every image in these tests is 16x16, 1 KiB.
+static constexpr uint32_t kImageSize = 16 * 16 * 4;
+
+static GeneratedImageCache::Key MakeKey(uint32_t generator, uint32_t param = 0) {
+  return {generator, 16, 16, {param, 0, 0, 0}};
+}
+
+// Returns a generator that fills the image with `value` and counts its invocations.
+static GeneratedImageCache::Generator CountingGenerator(uint32_t value, uint32_t &calls) {
+  return [value, &calls](uint32_t *pixels, uint32_t width, uint32_t height) {
+    ++calls;
+    for (uint32_t i = 0; i < width * height; ++i) {
+      pixels[i] = value;
+    }
+  };
+}
+
+TEST(GeneratedImageCacheTest, HitReturnsCachedImage) {
+  GeneratedImageCache cache;
+  uint32_t calls = 0;
+
+  auto first = cache.Get(MakeKey(1), CountingGenerator(0xFF00FF00, calls));
+  auto second = cache.Get(MakeKey(1), CountingGenerator(0xFF0000FF, calls));
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(calls, 1u);
+  EXPECT_EQ(first->width, 16u);
+  EXPECT_EQ(first->height, 16u);
+  EXPECT_EQ(first->pixels.size(), 256u);
+  EXPECT_EQ(first->pixels[255], 0xFF00FF00);
+  EXPECT_EQ(cache.GetStats().hits, 1u);
+  EXPECT_EQ(cache.GetStats().misses, 1u);
+  EXPECT_EQ(cache.GetMemoryUsage(), kImageSize);
+}
+
+// Keys differing in any field identify different images.
+TEST(GeneratedImageCacheTest, KeysCompareEveryField) {
+  GeneratedImageCache cache;
+  uint32_t calls = 0;
+  const GeneratedImageCache::Key keys[] = {
+      {1, 16, 16, {0, 0, 0, 0}}, {2, 16, 16, {0, 0, 0, 0}}, {1, 8, 16, {0, 0, 0, 0}},
+      {1, 16, 8, {0, 0, 0, 0}},  {1, 16, 16, {0, 0, 0, 1}},
+  };
+  for (const auto &key : keys) {
+    cache.Get(key, CountingGenerator(0, calls));
+  }
+  EXPECT_EQ(calls, 5u);
+  EXPECT_EQ(cache.NumEntries(), 5u);
+
+  for (const auto &key : keys) {
+    cache.Get(key, CountingGenerator(0, calls));
+  }
+  EXPECT_EQ(calls, 5u);
+  EXPECT_EQ(cache.GetStats().hits, 5u);
+}
+
+TEST(GeneratedImageCacheTest, EvictsLeastRecentlyUsedAtLimit) {
+  GeneratedImageCache cache(3 * kImageSize);
+  uint32_t calls = 0;
+
+  cache.Get(MakeKey(1), CountingGenerator(1, calls));
+  cache.Get(MakeKey(2), CountingGenerator(2, calls));
+  cache.Get(MakeKey(3), CountingGenerator(3, calls));
+  // Touching 1 makes 2 the least recently used image.
+  cache.Get(MakeKey(1), CountingGenerator(1, calls));
+  cache.Get(MakeKey(4), CountingGenerator(4, calls));
+
+  EXPECT_EQ(cache.NumEntries(), 3u);
+  EXPECT_EQ(cache.GetMemoryUsage(), 3 * kImageSize);
+  EXPECT_EQ(cache.GetStats().evictions, 1u);
+  EXPECT_EQ(calls, 4u);
+
+  cache.Get(MakeKey(1), CountingGenerator(1, calls));
+  cache.Get(MakeKey(3), CountingGenerator(3, calls));
+  cache.Get(MakeKey(4), CountingGenerator(4, calls));
+  EXPECT_EQ(calls, 4u);
+
+  cache.Get(MakeKey(2), CountingGenerator(2, calls));
+  EXPECT_EQ(calls, 5u);
+  EXPECT_LE(cache.GetMemoryUsage(), cache.GetMemoryLimit());
+}
+
+// Evicting an image that a caller still holds would not free its memory, so it is skipped.
+TEST(GeneratedImageCacheTest, ReferencedImagesAreNotEvicted) {
+  GeneratedImageCache cache(2 * kImageSize);
+  uint32_t calls = 0;
+
+  auto held = cache.Get(MakeKey(1), CountingGenerator(1, calls));
+  cache.Get(MakeKey(2), CountingGenerator(2, calls));
+  cache.Get(MakeKey(3), CountingGenerator(3, calls));
+
+  cache.Get(MakeKey(1), CountingGenerator(1, calls));
+  EXPECT_EQ(calls, 3u);
+  cache.Get(MakeKey(2), CountingGenerator(2, calls));
+  EXPECT_EQ(calls, 4u);
+}
+
+// When every cached image is referenced, new images are returned without being cached.
+TEST(GeneratedImageCacheTest, ImagesThatDoNotFitAreNotCached) {
+  GeneratedImageCache cache(kImageSize);
+  uint32_t calls = 0;
+
+  auto held = cache.Get(MakeKey(1), CountingGenerator(1, calls));
+  auto uncached = cache.Get(MakeKey(2), CountingGenerator(2, calls));
+  ASSERT_TRUE(uncached);
+  EXPECT_EQ(uncached->pixels[0], 2u);
+  EXPECT_EQ(cache.NumEntries(), 1u);
+
+  cache.Get(MakeKey(2), CountingGenerator(2, calls));
+  EXPECT_EQ(calls, 3u);
+
+  // An image larger than the limit is never cached.
+  GeneratedImageCache small(kImageSize - 1);
+  auto image = small.Get(MakeKey(1), CountingGenerator(1, calls));
+  ASSERT_TRUE(image);
+  EXPECT_EQ(small.NumEntries(), 0u);
+  EXPECT_EQ(small.GetMemoryUsage(), 0u);
+}
+
+TEST(GeneratedImageCacheTest, LoweringTheLimitEvicts) {
+  GeneratedImageCache cache(4 * kImageSize);
+  uint32_t calls = 0;
+  auto held = cache.Get(MakeKey(1), CountingGenerator(1, calls));
+  for (uint32_t i = 2; i <= 4; ++i) {
+    cache.Get(MakeKey(i), CountingGenerator(i, calls));
+  }
+  ASSERT_EQ(cache.GetMemoryUsage(), 4 * kImageSize);
+
+  cache.SetMemoryLimit(2 * kImageSize);
+  EXPECT_EQ(cache.NumEntries(), 2u);
+  EXPECT_EQ(cache.GetStats().evictions, 2u);
+
+  // The held image and the most recently used one survive.
+  cache.Get(MakeKey(1), CountingGenerator(1, calls));
+  cache.Get(MakeKey(4), CountingGenerator(4, calls));
+  EXPECT_EQ(calls, 4u);
+
+  // Referenced images are kept even if that leaves the cache above the limit.
+  auto held_4 = cache.Get(MakeKey(4), CountingGenerator(4, calls));
+  cache.SetMemoryLimit(kImageSize);
+  EXPECT_EQ(cache.NumEntries(), 2u);
+  EXPECT_GT(cache.GetMemoryUsage(), cache.GetMemoryLimit());
+}
+
+TEST(GeneratedImageCacheTest, ClearKeepsHeldImagesValid) {
+  GeneratedImageCache cache;
+  uint32_t calls = 0;
+  auto held = cache.Get(MakeKey(1), CountingGenerator(0x12345678, calls));
+
+  cache.Clear();
+  EXPECT_EQ(cache.NumEntries(), 0u);
+  EXPECT_EQ(cache.GetMemoryUsage(), 0u);
+  EXPECT_EQ(held->pixels[17], 0x12345678u);
+
+  cache.Get(MakeKey(1), CountingGenerator(0, calls));
+  EXPECT_EQ(calls, 2u);
+}
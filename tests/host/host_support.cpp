@@ -0,0 +1,11 @@
+// Definitions normally provided by the XBE that are needed by the sources under test.
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "debug_output.h"
+
+void PrintAssertAndWaitForever(const char *assert_code, const char *filename, uint32_t line) {
+  fprintf(stderr, "ASSERT FAILED: '%s' at %s:%d\n", assert_code, filename, line);
+  abort();
+}
@@ -0,0 +1,78 @@
+#include "image_util.h"
+
+#include <png.h>
+
+#include <cmath>
+#include <cstdlib>
+
+std::string GetResourcePath(const char *name) { return std::string(HOST_TEST_RESOURCE_DIR) + "/" + name; }
+
+bool LoadPNG(const std::string &path, HostImage &image) {
+  png_image png{};
+  png.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_file(&png, path.c_str())) {
+    return false;
+  }
+
+  png.format = PNG_FORMAT_RGBA;
+  image.width = png.width;
+  image.height = png.height;
+  image.pixels.resize(png.width * png.height);
+  return png_image_finish_read(&png, nullptr, image.pixels.data(), static_cast<png_int_32>(png.width * 4), nullptr);
+}
+
+HostImage MakeGradientImage(uint32_t width, uint32_t height) {
+  HostImage ret{width, height};
+  ret.pixels.resize(width * height);
+  auto pixel = ret.pixels.data();
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      const uint32_t r = x * 255 / (width - 1);
+      const uint32_t g = y * 255 / (height - 1);
+      const uint32_t b = (x + y) * 255 / (width + height - 2);
+      const uint32_t a = 255 - (x * 255 / (width - 1));
+      *pixel++ = r | (g << 8) | (b << 16) | (a << 24);
+    }
+  }
+  return ret;
+}
+
+HostImage MakeNoiseImage(uint32_t width, uint32_t height, uint32_t seed) {
+  HostImage ret{width, height};
+  ret.pixels.resize(width * height);
+  uint32_t state = seed;
+  for (auto &pixel : ret.pixels) {
+    state = state * 1664525 + 1013904223;
+    pixel = state ^ (state >> 13);
+  }
+  return ret;
+}
+
+ImageError CompareImages(const uint32_t *actual, const uint32_t *expected, uint32_t num_pixels,
+                         uint32_t component_mask) {
+  ImageError ret;
+  double squared_error = 0.0;
+  uint32_t num_samples = 0;
+  for (uint32_t i = 0; i < num_pixels; ++i) {
+    for (uint32_t component = 0; component < 4; ++component) {
+      if (!(component_mask & (1 << component))) {
+        continue;
+      }
+      const int a = (actual[i] >> (component * 8)) & 0xFF;
+      const int e = (expected[i] >> (component * 8)) & 0xFF;
+      const uint32_t error = abs(a - e);
+      squared_error += error * error;
+      ++num_samples;
+      if (error > ret.max_error) {
+        ret.max_error = error;
+      }
+    }
+  }
+
+  if (squared_error == 0.0) {
+    ret.psnr = INFINITY;
+  } else {
+    ret.psnr = 10.0 * log10(255.0 * 255.0 / (squared_error / num_samples));
+  }
+  return ret;
+}
@@ -0,0 +1,37 @@
+#ifndef NXDK_PGRAPH_TESTS_HOST_IMAGE_UTIL_H
+#define NXDK_PGRAPH_TESTS_HOST_IMAGE_UTIL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Helpers for comparing 32bpp images in the layout used by the texture helpers in src/ (R, G, B, A in memory order).
+
+struct HostImage {
+  uint32_t width{0};
+  uint32_t height{0};
+  std::vector<uint32_t> pixels;
+};
+
+// Returns the path of a file in the resources directory.
+std::string GetResourcePath(const char *name);
+
+// Loads a PNG file. Returns false on failure.
+bool LoadPNG(const std::string &path, HostImage &image);
+
+// Returns a deterministic width x height image with smooth color gradients.
+HostImage MakeGradientImage(uint32_t width, uint32_t height);
+
+// Returns a deterministic width x height image of per-pixel noise, which is a worst case for block compression.
+HostImage MakeNoiseImage(uint32_t width, uint32_t height, uint32_t seed = 1);
+
+// Error statistics between two images of identical dimensions, over the components selected by `component_mask` (a
+// bitmask of 0x01 = R, 0x02 = G, 0x04 = B, 0x08 = A).
+struct ImageError {
+  double psnr{0.0};
+  uint32_t max_error{0};
+};
+ImageError CompareImages(const uint32_t *actual, const uint32_t *expected, uint32_t num_pixels,
+                         uint32_t component_mask = 0x07);
+
+#endif  // NXDK_PGRAPH_TESTS_HOST_IMAGE_UTIL_H
@@ -0,0 +1,253 @@
+#include "index_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// vertex_buffer.h includes math3d.h, whose macros (such as _11) collide with identifiers in the GoogleTest headers.
+#include "vertex_buffer.h"
+
+using GenerateFunction = std::function<void(std::vector<uint32_t> &, uint32_t, uint32_t)>;
+using ExpandFunction = std::function<std::vector<Vertex>(const std::vector<Vertex> &)>;
+
+static std::vector<Vertex> MakeVertices(uint32_t count) {
+  std::vector<Vertex> vertices(count);
+  memset(vertices.data(), 0, vertices.size() * sizeof(Vertex));
+  for (uint32_t i = 0; i < count; ++i) {
+    vertices[i].SetPosition(static_cast<float>(i), static_cast<float>(i * 2), 1.0f);
+    vertices[i].SetDiffuse(static_cast<float>(i) / 16.0f, 0.5f, 1.0f);
+  }
+  return vertices;
+}
+
+static std::vector<Vertex> Gather(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices) {
+  std::vector<Vertex> ret;
+  for (auto index : indices) {
+    ret.push_back(vertices[index]);
+  }
+  return ret;
+}
+
+// The vertex copying expansion that VertexBuffer::ConvertFromTriangleStripToTriangles used before it was built on the
+// index generator.
+static std::vector<Vertex> ExpandTriangleStrip(const std::vector<Vertex> &vertices) {
+  if (vertices.size() < 3) {
+    return {};
+  }
+  const auto num_triangles = vertices.size() - 2;
+  std::vector<Vertex> ret(num_triangles * 3);
+
+  auto src = vertices.data();
+  auto dst = ret.data();
+
+  memcpy(dst, src, sizeof(*dst) * 3);
+  dst += 3;
+  src += 2;
+
+  auto copy_triangle = [&src, &dst](bool is_odd) {
+    if (is_odd) {
+      memcpy(dst++, src, sizeof(*dst));
+      memcpy(dst++, src - 1, sizeof(*dst));
+      ++src;
+      memcpy(dst++, src, sizeof(*dst));
+    } else {
+      memcpy(dst++, src - 1, sizeof(*dst));
+      memcpy(dst++, src, sizeof(*dst));
+      ++src;
+      memcpy(dst++, src, sizeof(*dst));
+    }
+  };
+
+  for (size_t i = 1; i < num_triangles; ++i) {
+    copy_triangle(i & 0x01);
+  }
+
+  return ret;
+}
+
+static std::vector<Vertex> ExpandLineStrip(const std::vector<Vertex> &vertices) {
+  std::vector<Vertex> ret;
+  for (size_t i = 1; i < vertices.size(); ++i) {
+    ret.push_back(vertices[i - 1]);
+    ret.push_back(vertices[i]);
+  }
+  return ret;
+}
+
+static std::vector<Vertex> ExpandLineLoop(const std::vector<Vertex> &vertices) {
+  auto ret = ExpandLineStrip(vertices);
+  if (vertices.size() >= 2) {
+    ret.push_back(vertices.back());
+    ret.push_back(vertices.front());
+  }
+  return ret;
+}
+
+static std::vector<Vertex> ExpandTriangleFan(const std::vector<Vertex> &vertices) {
+  std::vector<Vertex> ret;
+  for (size_t i = 2; i < vertices.size(); ++i) {
+    ret.push_back(vertices[0]);
+    ret.push_back(vertices[i - 1]);
+    ret.push_back(vertices[i]);
+  }
+  return ret;
+}
+
+// Splits the quad a, b, c, d (in winding order) into two triangles.
+static void AppendQuad(std::vector<Vertex> &out, const Vertex &a, const Vertex &b, const Vertex &c, const Vertex &d) {
+  out.insert(out.end(), {a, b, c, a, c, d});
+}
+
+static std::vector<Vertex> ExpandQuads(const std::vector<Vertex> &vertices) {
+  std::vector<Vertex> ret;
+  for (size_t i = 0; i + 4 <= vertices.size(); i += 4) {
+    AppendQuad(ret, vertices[i], vertices[i + 1], vertices[i + 2], vertices[i + 3]);
+  }
+  return ret;
+}
+
+static std::vector<Vertex> ExpandQuadStrip(const std::vector<Vertex> &vertices) {
+  std::vector<Vertex> ret;
+  for (size_t i = 0; i + 4 <= vertices.size(); i += 2) {
+    AppendQuad(ret, vertices[i], vertices[i + 1], vertices[i + 3], vertices[i + 2]);
+  }
+  return ret;
+}
+
+static void ExpectSameVertices(const std::vector<Vertex> &actual, const std::vector<Vertex> &expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_EQ(memcmp(&actual[i], &expected[i], sizeof(Vertex)), 0) << "vertex " << i;
+  }
+}
+
+struct PrimitiveMode {
+  const char *name;
+  GenerateFunction generate;
+  ExpandFunction expand;
+};
+
+static const PrimitiveMode kModes[] = {
+    {"LineStrip", GenerateLineStripIndices, ExpandLineStrip},
+    {"LineLoop", GenerateLineLoopIndices, ExpandLineLoop},
+    {"TriangleStrip", GenerateTriangleStripIndices, ExpandTriangleStrip},
+    // Polygons are drawn as fans.
+    {"TriangleFan", GenerateTriangleFanIndices, ExpandTriangleFan},
+    {"Quads", GenerateQuadIndices, ExpandQuads},
+    {"QuadStrip", GenerateQuadStripIndices, ExpandQuadStrip},
+};
+
+class IndexGeneratorModeTest : public ::testing::TestWithParam<PrimitiveMode> {};
+
+// Drawing the original vertices through the generated indices produces the same vertex stream as copying them, for
+// every vertex count including those with incomplete trailing primitives.
+TEST_P(IndexGeneratorModeTest, MatchesVertexExpansion) {
+  const auto &mode = GetParam();
+  for (uint32_t count = 0; count <= 13; ++count) {
+    SCOPED_TRACE(count);
+    const auto vertices = MakeVertices(count);
+    std::vector<uint32_t> indices;
+    mode.generate(indices, count, 0);
+    ExpectSameVertices(Gather(vertices, indices), mode.expand(vertices));
+  }
+}
+
+// Generated indices are appended after existing ones and offset by the first vertex.
+TEST_P(IndexGeneratorModeTest, AppendsFromFirstVertex) {
+  const auto &mode = GetParam();
+  static constexpr uint32_t kFirstVertex = 5;
+  static constexpr uint32_t kCount = 8;
+
+  std::vector<uint32_t> expected;
+  mode.generate(expected, kCount, 0);
+  for (auto &index : expected) {
+    index += kFirstVertex;
+  }
+  expected.insert(expected.begin(), {100, 101});
+
+  std::vector<uint32_t> indices{100, 101};
+  mode.generate(indices, kCount, kFirstVertex);
+  EXPECT_EQ(indices, expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(Modes, IndexGeneratorModeTest, ::testing::ValuesIn(kModes),
+                         [](const ::testing::TestParamInfo<PrimitiveMode> &info) { return info.param.name; });
+
+TEST(IndexGeneratorTest, SequentialIndices) {
+  std::vector<uint32_t> indices{7};
+  GenerateSequentialIndices(indices, 4, 2);
+  EXPECT_EQ(indices, (std::vector<uint32_t>{7, 2, 3, 4, 5}));
+}
+
+// Returns the signed area of each triangle in the xy plane.
+static std::vector<float> TriangleAreas(const std::vector<float> &positions, const std::vector<uint32_t> &indices) {
+  std::vector<float> areas;
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    const float *a = &positions[indices[i] * 2];
+    const float *b = &positions[indices[i + 1] * 2];
+    const float *c = &positions[indices[i + 2] * 2];
+    areas.push_back((b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]));
+  }
+  return areas;
+}
+
+static void ExpectConsistentWinding(const std::vector<float> &positions, const std::vector<uint32_t> &indices,
+                                    float expected_sign) {
+  const auto areas = TriangleAreas(positions, indices);
+  ASSERT_FALSE(areas.empty());
+  for (size_t i = 0; i < areas.size(); ++i) {
+    EXPECT_GT(areas[i] * expected_sign, 0.0f) << "triangle " << i;
+  }
+}
+
+// A zigzag of vertices alternating between y = 0 and y = 1, as used by strips.
+static std::vector<float> MakeZigzag(uint32_t count) {
+  std::vector<float> positions;
+  for (uint32_t i = 0; i < count; ++i) {
+    positions.push_back(static_cast<float>(i / 2));
+    positions.push_back(static_cast<float>(i & 0x01));
+  }
+  return positions;
+}
+
+// Every triangle keeps the (clockwise) winding of the first triangle of the strip.
+TEST(IndexGeneratorTest, TriangleStripKeepsWinding) {
+  std::vector<uint32_t> indices;
+  GenerateTriangleStripIndices(indices, 12);
+  ExpectConsistentWinding(MakeZigzag(12), indices, -1.0f);
+}
+
+TEST(IndexGeneratorTest, QuadStripKeepsWinding) {
+  std::vector<uint32_t> indices;
+  GenerateQuadStripIndices(indices, 12);
+  ExpectConsistentWinding(MakeZigzag(12), indices, -1.0f);
+}
+
+TEST(IndexGeneratorTest, TriangleFanKeepsWinding) {
+  // A counterclockwise convex polygon.
+  std::vector<float> positions;
+  static constexpr uint32_t kCount = 9;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    const float angle = static_cast<float>(i) * 2.0f * static_cast<float>(M_PI) / kCount;
+    positions.push_back(std::cos(angle));
+    positions.push_back(std::sin(angle));
+  }
+  std::vector<uint32_t> indices;
+  GenerateTriangleFanIndices(indices, kCount);
+  ExpectConsistentWinding(positions, indices, 1.0f);
+}
+
+TEST(IndexGeneratorTest, QuadsKeepWinding) {
+  // Three counterclockwise unit squares side by side.
+  std::vector<float> positions;
+  for (uint32_t i = 0; i < 3; ++i) {
+    const auto x = static_cast<float>(i * 2);
+    positions.insert(positions.end(), {x, 0.0f, x + 1.0f, 0.0f, x + 1.0f, 1.0f, x, 1.0f});
+  }
+  std::vector<uint32_t> indices;
+  GenerateQuadIndices(indices, 12);
+  ExpectConsistentWinding(positions, indices, 1.0f);
+}
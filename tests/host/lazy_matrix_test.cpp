@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+// lazy_matrix.h includes math3d.h, whose macros (such as _11) collide with identifiers in the GoogleTest headers.
+#include "lazy_matrix.h"
+
+static void MakeTranslation(MATRIX result, float x) {
+  matrix_unit(result);
+  result[_41] = x;
+}
+
+// A chain shaped like the TestHost matrices: two inputs, their product, its transpose and the transpose's inverse.
+class LazyMatrixTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    matrix_unit(model_view_.Modify());
+    matrix_unit(projection_.Modify());
+    composite_.Derive({&model_view_, &projection_}, [this](MATRIX result) {
+      matrix_multiply_aligned(result, model_view_.Get(), projection_.Get());
+    });
+    transposed_.Derive({&composite_}, [this](MATRIX result) { matrix_transpose_aligned(result, composite_.Get()); });
+    inverse_.Derive({&transposed_},
+                    [this](MATRIX result) { matrix_general_inverse_aligned(result, transposed_.Get()); });
+  }
+
+  void ExpectComputeCounts(uint32_t composite, uint32_t transposed, uint32_t inverse) {
+    EXPECT_EQ(composite_.GetComputeCount(), composite);
+    EXPECT_EQ(transposed_.GetComputeCount(), transposed);
+    EXPECT_EQ(inverse_.GetComputeCount(), inverse);
+  }
+
+  LazyMatrix model_view_;
+  LazyMatrix projection_;
+  LazyMatrix composite_;
+  LazyMatrix transposed_;
+  LazyMatrix inverse_;
+};
+
+TEST_F(LazyMatrixTest, NothingIsComputedUntilRead) {
+  ExpectComputeCounts(0, 0, 0);
+  EXPECT_TRUE(composite_.IsDirty());
+  EXPECT_TRUE(inverse_.IsDirty());
+  EXPECT_FALSE(model_view_.IsDirty());
+  EXPECT_EQ(model_view_.GetComputeCount(), 0u);
+}
+
+// Reading a derived matrix computes it and everything it depends on exactly once.
+TEST_F(LazyMatrixTest, ReadComputesDependenciesOnce) {
+  inverse_.Get();
+  ExpectComputeCounts(1, 1, 1);
+
+  inverse_.Get();
+  transposed_.Get();
+  composite_.Get();
+  ExpectComputeCounts(1, 1, 1);
+  EXPECT_FALSE(inverse_.IsDirty());
+}
+
+// Only the matrices that are read after a change are recomputed.
+TEST_F(LazyMatrixTest, ChangeRecomputesOnlyWhatIsRead) {
+  inverse_.Get();
+
+  MATRIX translation;
+  MakeTranslation(translation, 2.0f);
+  model_view_.Set(translation);
+  EXPECT_TRUE(composite_.IsDirty());
+  EXPECT_TRUE(inverse_.IsDirty());
+  ExpectComputeCounts(1, 1, 1);
+
+  composite_.Get();
+  ExpectComputeCounts(2, 1, 1);
+
+  // Several changes between reads cost a single recompute.
+  for (int i = 0; i < 10; ++i) {
+    MakeTranslation(translation, static_cast<float>(i));
+    projection_.Set(translation);
+  }
+  inverse_.Get();
+  ExpectComputeCounts(3, 2, 2);
+}
+
+// Setting an input to its current value leaves the dependents valid.
+TEST_F(LazyMatrixTest, RedundantSetDoesNotInvalidate) {
+  inverse_.Get();
+
+  MATRIX identity;
+  matrix_unit(identity);
+  model_view_.Set(identity);
+  projection_.Set(identity);
+  EXPECT_FALSE(inverse_.IsDirty());
+  inverse_.Get();
+  ExpectComputeCounts(1, 1, 1);
+}
+
+// Modify always invalidates, even if the caller ends up writing the same value.
+TEST_F(LazyMatrixTest, ModifyInvalidates) {
+  inverse_.Get();
+  matrix_unit(projection_.Modify());
+  inverse_.Get();
+  ExpectComputeCounts(2, 2, 2);
+}
+
+// Invalidate recomputes a derived matrix whose parameters, rather than its inputs, changed.
+TEST_F(LazyMatrixTest, InvalidateRecomputesDerivedMatrix) {
+  inverse_.Get();
+  transposed_.Invalidate();
+  EXPECT_FALSE(composite_.IsDirty());
+  EXPECT_TRUE(inverse_.IsDirty());
+  inverse_.Get();
+  ExpectComputeCounts(1, 2, 2);
+}
+
+TEST_F(LazyMatrixTest, DerivedValuesMatchDirectComputation) {
+  MATRIX translation;
+  MakeTranslation(translation, 3.0f);
+  model_view_.Set(translation);
+  MATRIX scale;
+  matrix_unit(scale);
+  scale[_11] = 2.0f;
+  scale[_22] = 4.0f;
+  projection_.Set(scale);
+
+  MATRIX expected;
+  matrix_multiply(expected, translation, scale);
+  matrix_transpose(expected, expected);
+  MATRIX expected_inverse;
+  ASSERT_EQ(matrix_general_inverse(expected_inverse, expected), 1);
+
+  EXPECT_EQ(memcmp(transposed_.Get(), expected, sizeof(expected)), 0);
+  EXPECT_EQ(memcmp(inverse_.Get(), expected_inverse, sizeof(expected_inverse)), 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(inverse_.Get()) % 16, 0u);
+}
@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <vector>
+
+#include "benchmark.h"
+#include "math3d_scalar.h"
+
+static constexpr uint32_t kCount = 4096;
+static constexpr uint32_t kMatrixIterations = 100000;
+
+// Compares the scalar and SSE builds of the matrix derivations done for every LazyMatrix recompute and of the array
+// functions used to project screen grids.
+HOST_BENCHMARK(Math3D) {
+  ALIGNED_MATRIX a;
+  ALIGNED_MATRIX b;
+  for (uint32_t i = 0; i < 16; ++i) {
+    a[i] = static_cast<float>(i % 5) - 1.5f;
+    b[i] = static_cast<float>((i * 7) % 11) * 0.25f;
+  }
+  a[0] += 10.0f;
+  a[5] += 10.0f;
+  a[10] += 10.0f;
+  a[15] += 10.0f;
+  ALIGNED_MATRIX result;
+
+  std::vector<float> points(kCount * 4);
+  for (uint32_t i = 0; i < points.size(); ++i) {
+    points[i] = static_cast<float>(i % 640) * 0.5f;
+  }
+  std::vector<float> output(points.size());
+
+  struct Case {
+    const char *name;
+    uint32_t items;
+    std::function<void()> scalar;
+    std::function<void()> sse;
+  };
+  // Each matrix case repeats the call so that a timing is long enough to be meaningful.
+  auto repeat = [&](void (*fn)(MATRIX, const MATRIX, const MATRIX)) {
+    return [&, fn]() {
+      for (uint32_t i = 0; i < kMatrixIterations; ++i) {
+        fn(result, a, b);
+        KeepAlive(result);
+      }
+    };
+  };
+  auto repeat_unary = [&](auto fn) {
+    return [&, fn]() {
+      for (uint32_t i = 0; i < kMatrixIterations; ++i) {
+        fn(result, a);
+        KeepAlive(result);
+      }
+    };
+  };
+  const Case cases[] = {
+      {"matrix_multiply", kMatrixIterations, repeat(scalar_matrix_multiply), repeat(matrix_multiply)},
+      {"matrix_multiply_aligned", kMatrixIterations, repeat(scalar_matrix_multiply_aligned),
+       repeat(matrix_multiply_aligned)},
+      {"matrix_transpose_aligned", kMatrixIterations, repeat_unary(scalar_matrix_transpose_aligned),
+       repeat_unary(matrix_transpose_aligned)},
+      {"matrix_general_inverse_aligned", kMatrixIterations, repeat_unary(scalar_matrix_general_inverse_aligned),
+       repeat_unary(matrix_general_inverse_aligned)},
+      {"vector_project_array", kCount,
+       [&]() {
+         scalar_vector_project_array(output.data(), 16, points.data(), 16, kCount, a);
+         KeepAlive(output);
+       },
+       [&]() {
+         vector_project_array(output.data(), 16, points.data(), 16, kCount, a);
+         KeepAlive(output);
+       }},
+      {"vector_unproject_array", kCount,
+       [&]() {
+         scalar_vector_unproject_array(output.data(), 16, points.data(), 16, kCount, a, 0.0f, 64000.0f, 0.0f);
+         KeepAlive(output);
+       },
+       [&]() {
+         vector_unproject_array(output.data(), 16, points.data(), 16, kCount, a, 0.0f, 64000.0f, 0.0f);
+         KeepAlive(output);
+       }},
+  };
+
+#ifdef __SSE__
+  printf("%-31s %12s %12s   (SSE)\n", "function", "scalar ns", "SSE ns");
+#else
+  printf("%-31s %12s %12s\n", "function", "scalar ns", "default ns");
+#endif
+  for (const auto &entry : cases) {
+    const double scalar = TimeBest(entry.scalar);
+    const double sse = TimeBest(entry.sse);
+    printf("%-31s %12.2f %12.2f\n", entry.name, scalar * 1e9 / entry.items, sse * 1e9 / entry.items);
+  }
+}
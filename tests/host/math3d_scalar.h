@@ -0,0 +1,29 @@
+#ifndef NXDK_PGRAPH_TESTS_HOST_MATH3D_SCALAR_H
+#define NXDK_PGRAPH_TESTS_HOST_MATH3D_SCALAR_H
+
+#include "math3d.h"
+
+// The scalar build of math3d.c (see MATH3D_SCALAR_OBJ in the Makefile), used as the reference for the SSE paths. Only
+// the functions that have an SSE implementation are declared.
+
+extern "C" {
+void scalar_vector_apply(VECTOR output, const VECTOR input0, const MATRIX input1);
+void scalar_vector_apply_aligned(VECTOR output, const VECTOR input0, const MATRIX input1);
+void scalar_vector_apply_array(float *output, unsigned int output_stride, const float *input,
+                               unsigned int input_stride, unsigned int count, const MATRIX matrix);
+void scalar_vector_project_array(float *output, unsigned int output_stride, const float *input,
+                                 unsigned int input_stride, unsigned int count, const MATRIX matrix);
+void scalar_vector_unproject_array(float *output, unsigned int output_stride, const float *input,
+                                   unsigned int input_stride, unsigned int count, const MATRIX inverse, float near_z,
+                                   float far_z, float world_z);
+void scalar_vector_round_xy_array(float *points, unsigned int stride, unsigned int count, float threshold);
+int scalar_matrix_general_inverse(MATRIX output, const MATRIX input);
+int scalar_matrix_general_inverse_aligned(MATRIX output, const MATRIX input);
+void scalar_matrix_multiply(MATRIX output, const MATRIX input0, const MATRIX input1);
+void scalar_matrix_multiply_aligned(MATRIX output, const MATRIX input0, const MATRIX input1);
+void scalar_matrix_transpose(MATRIX output, const MATRIX input0);
+void scalar_matrix_transpose_aligned(MATRIX output, const MATRIX input0);
+void scalar_matrix_adjoint(MATRIX output, const MATRIX m);
+}
+
+#endif  // NXDK_PGRAPH_TESTS_HOST_MATH3D_SCALAR_H
@@ -0,0 +1,316 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// math3d.h defines macros (such as _11) that collide with identifiers in the GoogleTest headers, so it comes last.
+#include "math3d.h"
+#include "math3d_scalar.h"
+
+// The SSE paths are documented as bit identical to the scalar expressions they replace, so every comparison is exact.
+// When the tests are built without SSE both sides run the scalar code.
+
+static constexpr uint32_t kIterations = 1000;
+
+class Random {
+ public:
+  // Returns a value in [-range, range).
+  float Next(float range = 4.0f) {
+    state_ = state_ * 1664525 + 1013904223;
+    return (static_cast<float>(state_ >> 8) / static_cast<float>(1 << 24) * 2.0f - 1.0f) * range;
+  }
+
+  void Fill(float *values, uint32_t count, float range = 4.0f) {
+    for (uint32_t i = 0; i < count; ++i) {
+      values[i] = Next(range);
+    }
+  }
+
+ private:
+  uint32_t state_{1};
+};
+
+// A model view projection viewport matrix like the ones built by TestHost, transposed for use with vector_apply.
+static void MakeComposite(MATRIX result, Random &random, bool depth_24 = true) {
+  const VECTOR eye{random.Next(), random.Next(), -7.0f + random.Next(1.0f), 1.0f};
+  const VECTOR at{random.Next(1.0f), random.Next(1.0f), 0.0f, 1.0f};
+  const VECTOR up{0.0f, 1.0f, 0.0f, 1.0f};
+  MATRIX view;
+  create_d3d_look_at_lh(view, eye, at, up);
+  MATRIX projection;
+  create_d3d_perspective_fov_lh(projection, M_PI * 0.25f, 640.0f / 480.0f, 1.0f, 200.0f);
+  MATRIX viewport;
+  if (depth_24) {
+    create_d3d_standard_viewport_24(viewport, 640.0f, 480.0f);
+  } else {
+    create_d3d_standard_viewport_16(viewport, 640.0f, 480.0f);
+  }
+
+  matrix_multiply(result, view, projection);
+  matrix_multiply(result, result, viewport);
+  matrix_transpose(result, result);
+}
+
+#define EXPECT_BITS_EQ(actual, expected, count) \
+  EXPECT_EQ(memcmp((actual), (expected), sizeof(float) * (count)), 0)
+
+TEST(Math3D, VectorApplyMatchesScalar) {
+  Random random;
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    ALIGNED_MATRIX matrix;
+    ALIGNED_VECTOR input;
+    random.Fill(matrix, 16);
+    random.Fill(input, 4);
+
+    VECTOR expected;
+    scalar_vector_apply(expected, input, matrix);
+    VECTOR actual;
+    vector_apply(actual, input, matrix);
+    EXPECT_BITS_EQ(actual, expected, 4) << i;
+
+    ALIGNED_VECTOR aligned;
+    vector_apply_aligned(aligned, input, matrix);
+    EXPECT_BITS_EQ(aligned, expected, 4) << i;
+  }
+}
+
+TEST(Math3D, MatrixMultiplyMatchesScalar) {
+  Random random;
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    ALIGNED_MATRIX a;
+    ALIGNED_MATRIX b;
+    random.Fill(a, 16);
+    random.Fill(b, 16);
+
+    MATRIX expected;
+    scalar_matrix_multiply(expected, a, b);
+    MATRIX actual;
+    matrix_multiply(actual, a, b);
+    EXPECT_BITS_EQ(actual, expected, 16) << i;
+
+    ALIGNED_MATRIX aligned;
+    matrix_multiply_aligned(aligned, a, b);
+    EXPECT_BITS_EQ(aligned, expected, 16) << i;
+
+    // The output may alias either input.
+    matrix_multiply_aligned(a, a, b);
+    EXPECT_BITS_EQ(a, expected, 16) << i;
+  }
+}
+
+TEST(Math3D, MatrixTransposeMatchesScalar) {
+  Random random;
+  for (uint32_t i = 0; i < 16; ++i) {
+    ALIGNED_MATRIX input;
+    random.Fill(input, 16);
+
+    MATRIX expected;
+    scalar_matrix_transpose(expected, input);
+    for (uint32_t row = 0; row < 4; ++row) {
+      for (uint32_t column = 0; column < 4; ++column) {
+        ASSERT_EQ(expected[row * 4 + column], input[column * 4 + row]);
+      }
+    }
+
+    MATRIX actual;
+    matrix_transpose(actual, input);
+    EXPECT_BITS_EQ(actual, expected, 16) << i;
+
+    matrix_transpose_aligned(input, input);
+    EXPECT_BITS_EQ(input, expected, 16) << i;
+  }
+}
+
+TEST(Math3D, MatrixAdjointMatchesScalar) {
+  Random random;
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    MATRIX input;
+    random.Fill(input, 16);
+
+    MATRIX expected;
+    scalar_matrix_adjoint(expected, input);
+    MATRIX actual;
+    matrix_adjoint(actual, input);
+    EXPECT_BITS_EQ(actual, expected, 16) << i;
+  }
+}
+
+TEST(Math3D, MatrixGeneralInverseMatchesScalar) {
+  Random random;
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    ALIGNED_MATRIX input;
+    if (i & 1) {
+      MakeComposite(input, random);
+    } else {
+      random.Fill(input, 16);
+    }
+
+    MATRIX expected;
+    ASSERT_EQ(scalar_matrix_general_inverse(expected, input), 1) << i;
+    MATRIX actual;
+    ASSERT_EQ(matrix_general_inverse(actual, input), 1) << i;
+    EXPECT_BITS_EQ(actual, expected, 16) << i;
+
+    ALIGNED_MATRIX aligned;
+    ASSERT_EQ(matrix_general_inverse_aligned(aligned, input), 1) << i;
+    EXPECT_BITS_EQ(aligned, expected, 16) << i;
+  }
+
+  // Singular matrices are rejected by both paths.
+  ALIGNED_MATRIX singular{};
+  ALIGNED_MATRIX output;
+  EXPECT_EQ(scalar_matrix_general_inverse_aligned(output, singular), 0);
+  EXPECT_EQ(matrix_general_inverse_aligned(output, singular), 0);
+}
+
+// Strided arrays, as used on interleaved vertices, with a stride that is not a multiple of 16 bytes.
+TEST(Math3D, ArrayFunctionsMatchScalar) {
+  static constexpr uint32_t kCount = 257;
+  static constexpr uint32_t kStride = 7;
+  Random random;
+  std::vector<float> input(kCount * kStride);
+  random.Fill(input.data(), input.size(), 400.0f);
+
+  for (uint32_t i = 0; i < 16; ++i) {
+    SCOPED_TRACE(i);
+    MATRIX composite;
+    MakeComposite(composite, random);
+    MATRIX inverse;
+    ASSERT_EQ(matrix_general_inverse(inverse, composite), 1);
+
+    std::vector<float> expected(input.size());
+    std::vector<float> actual(input.size());
+
+    scalar_vector_apply_array(expected.data(), kStride * 4, input.data(), kStride * 4, kCount, composite);
+    vector_apply_array(actual.data(), kStride * 4, input.data(), kStride * 4, kCount, composite);
+    EXPECT_BITS_EQ(actual.data(), expected.data(), actual.size());
+
+    scalar_vector_project_array(expected.data(), kStride * 4, input.data(), kStride * 4, kCount, composite);
+    vector_project_array(actual.data(), kStride * 4, input.data(), kStride * 4, kCount, composite);
+    EXPECT_BITS_EQ(actual.data(), expected.data(), actual.size());
+
+    const float world_z = random.Next();
+    scalar_vector_unproject_array(expected.data(), kStride * 4, input.data(), kStride * 4, kCount, inverse, 0.0f,
+                                  64000.0f, world_z);
+    vector_unproject_array(actual.data(), kStride * 4, input.data(), kStride * 4, kCount, inverse, 0.0f, 64000.0f,
+                           world_z);
+    EXPECT_BITS_EQ(actual.data(), expected.data(), actual.size());
+
+    const float threshold = 0.5f + random.Next(0.5f);
+    memcpy(expected.data(), input.data(), input.size() * sizeof(float));
+    memcpy(actual.data(), input.data(), input.size() * sizeof(float));
+    scalar_vector_round_xy_array(expected.data(), kStride * 4, kCount, threshold);
+    vector_round_xy_array(actual.data(), kStride * 4, kCount, threshold);
+    EXPECT_BITS_EQ(actual.data(), expected.data(), actual.size());
+  }
+}
+
+// The rounding path uses a 2^23 trick, so values around that magnitude, integers, negative zero and exact threshold
+// hits are checked explicitly.
+TEST(Math3D, RoundXYEdgeCasesMatchScalar) {
+  const float values[] = {0.0f,       -0.0f,       0.5f,       -0.5f,      0.49999997f, 1.0f,       -1.0f,
+                          2.5f,       -2.5f,       8388607.5f, 8388608.0f, -8388608.0f, 16777216.0f, 1e30f,
+                          -1e30f,     0.75f,       -0.25f,     319.5f,     239.49998f,  -319.5f};
+  static constexpr uint32_t kNumValues = sizeof(values) / sizeof(values[0]);
+  for (float threshold : {0.0f, 0.5f, 0.75f, 1.0f}) {
+    SCOPED_TRACE(threshold);
+    std::vector<float> expected;
+    for (uint32_t i = 0; i < kNumValues; ++i) {
+      expected.insert(expected.end(), {values[i], values[kNumValues - 1 - i], 3.0f, 1.0f});
+    }
+    std::vector<float> actual = expected;
+    scalar_vector_round_xy_array(expected.data(), 16, kNumValues, threshold);
+    vector_round_xy_array(actual.data(), 16, kNumValues, threshold);
+    EXPECT_BITS_EQ(actual.data(), expected.data(), actual.size());
+  }
+}
+
+// Unprojects a screen point onto a world z plane in double precision. With the composite applied as by vector_apply,
+// screen x = (row_x . world) / (row_w . world) and likewise for y, which is linear in world x and y once world z is
+// fixed.
+static void ReferenceUnproject(double *world_x, double *world_y, const MATRIX composite, double screen_x,
+                               double screen_y, double world_z) {
+  double a[2][3];
+  for (int i = 0; i < 2; ++i) {
+    const double screen = i ? screen_y : screen_x;
+    double row[4];
+    for (int column = 0; column < 4; ++column) {
+      row[column] = composite[i * 4 + column] - screen * composite[_41 + column];
+    }
+    a[i][0] = row[0];
+    a[i][1] = row[1];
+    a[i][2] = -(row[2] * world_z + row[3]);
+  }
+  const double det = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+  *world_x = (a[0][2] * a[1][1] - a[0][1] * a[1][2]) / det;
+  *world_y = (a[0][0] * a[1][2] - a[0][2] * a[1][0]) / det;
+}
+
+// Unprojects a 640x480 grid with the shared kUnprojectNearZ and kUnprojectFarZ screen depths and returns the largest
+// world space error against ReferenceUnproject and the largest screen space error after projecting the result back.
+static std::pair<double, double> MeasureUnprojectError(bool depth_24) {
+  static constexpr uint32_t kWidth = 640;
+  static constexpr uint32_t kHeight = 480;
+  static constexpr uint32_t kGridStep = 16;
+
+  std::vector<float> screen;
+  for (uint32_t y = 0; y <= kHeight; y += kGridStep) {
+    for (uint32_t x = 0; x <= kWidth; x += kGridStep) {
+      screen.insert(screen.end(), {static_cast<float>(x), static_cast<float>(y), 0.0f, 1.0f});
+    }
+  }
+  const uint32_t count = screen.size() / 4;
+
+  Random random;
+  double max_world_error = 0.0;
+  double max_screen_error = 0.0;
+  for (uint32_t i = 0; i < 16; ++i) {
+    MATRIX composite;
+    MakeComposite(composite, random, depth_24);
+    MATRIX inverse;
+    EXPECT_EQ(matrix_general_inverse(inverse, composite), 1);
+
+    for (float world_z : {-2.0f, 0.0f, 1.5f, 10.0f}) {
+      std::vector<float> world(screen.size());
+      vector_unproject_array(world.data(), 16, screen.data(), 16, count, inverse, kUnprojectNearZ, kUnprojectFarZ,
+                             world_z);
+      std::vector<float> projected(screen.size());
+      vector_project_array(projected.data(), 16, world.data(), 16, count, composite);
+
+      for (uint32_t point = 0; point < count; ++point) {
+        const float *unprojected = world.data() + point * 4;
+        EXPECT_EQ(unprojected[_Z], world_z);
+        EXPECT_EQ(unprojected[_W], 1.0f);
+
+        double x;
+        double y;
+        ReferenceUnproject(&x, &y, composite, screen[point * 4], screen[point * 4 + 1], world_z);
+        max_world_error = std::max({max_world_error, std::fabs(x - unprojected[_X]), std::fabs(y - unprojected[_Y])});
+
+        const float *reprojected = projected.data() + point * 4;
+        max_screen_error = std::max({max_screen_error, std::fabs(reprojected[_X] - screen[point * 4]) * 1.0,
+                                     std::fabs(reprojected[_Y] - screen[point * 4 + 1]) * 1.0});
+      }
+    }
+  }
+  return {max_world_error, max_screen_error};
+}
+
+// With a 16-bit depth range the near and far screen depths span most of the view frustum and unprojected points land
+// well within the 1/16th of a pixel that the hardware resolves.
+TEST(Math3D, UnprojectAccuracy16BitDepth) {
+  auto error = MeasureUnprojectError(false);
+  EXPECT_LT(error.first, 1e-3);
+  EXPECT_LT(error.second, 1.0 / 64.0);
+}
+
+// With a 24-bit depth range kUnprojectFarZ lies just past the near plane, so the ray is extrapolated far beyond the
+// two points that define it. This bounds the resulting error (see the TODO on kUnprojectFarZ).
+TEST(Math3D, UnprojectAccuracy24BitDepth) {
+  auto error = MeasureUnprojectError(true);
+  EXPECT_LT(error.first, 0.05);
+  EXPECT_LT(error.second, 0.25);
+}
@@ -0,0 +1,54 @@
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "benchmark.h"
+#include "mesh_generator.h"
+
+// Reports the generation throughput of each mesh type at the tessellation used by the dense geometry tests and above.
+HOST_BENCHMARK(MeshGenerator) {
+  static constexpr float kCenter[] = {0.0f, 0.0f, 0.0f};
+
+  struct Entry {
+    const char *name;
+    std::function<MeshSize(uint32_t)> size;
+    std::function<void(Vertex *, std::vector<uint32_t> &, uint32_t)> generate;
+  };
+  const Entry kEntries[] = {
+      {"grid", [](uint32_t n) { return GetGridMeshSize(n, n); },
+       [](Vertex *vertices, std::vector<uint32_t> &indices, uint32_t n) {
+         GenerateGridMesh(vertices, indices, -1.0f, 1.0f, 1.0f, -1.0f, 0.0f, n, n);
+       }},
+      {"sphere", [](uint32_t n) { return GetSphereMeshSize(n, n); },
+       [](Vertex *vertices, std::vector<uint32_t> &indices, uint32_t n) {
+         GenerateSphereMesh(vertices, indices, kCenter, 1.0f, n, n);
+       }},
+      {"cylinder", [](uint32_t n) { return GetCylinderMeshSize(n, n); },
+       [](Vertex *vertices, std::vector<uint32_t> &indices, uint32_t n) {
+         GenerateCylinderMesh(vertices, indices, kCenter, 1.0f, 2.0f, n, n);
+       }},
+      {"torus", [](uint32_t n) { return GetTorusMeshSize(n, n); },
+       [](Vertex *vertices, std::vector<uint32_t> &indices, uint32_t n) {
+         GenerateTorusMesh(vertices, indices, kCenter, 1.0f, 0.25f, n, n);
+       }},
+  };
+
+  printf("%-10s %10s %10s %10s %14s\n", "mesh", "divisions", "vertices", "ms", "Mvertices/s");
+  for (const auto &entry : kEntries) {
+    for (uint32_t divisions : {64u, 256u}) {
+      const auto size = entry.size(divisions);
+      std::vector<Vertex> vertices(size.num_vertices);
+      std::vector<uint32_t> indices;
+      indices.reserve(size.num_indices);
+
+      const double seconds = TimeBest([&]() {
+        indices.clear();
+        entry.generate(vertices.data(), indices, divisions);
+        KeepAlive(vertices);
+        KeepAlive(indices);
+      });
+      printf("%-10s %10u %10u %10.3f %14.1f\n", entry.name, divisions, size.num_vertices, seconds * 1000.0,
+             size.num_vertices / seconds / 1e6);
+    }
+  }
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+// mesh_generator.h includes math3d.h, whose macros (such as _11) collide with identifiers in the GoogleTest headers.
+#include "mesh_generator.h"
+
+static constexpr float kCenter[] = {1.0f, -2.0f, 3.0f};
+static constexpr uint32_t kFirstVertex = 7;
+
+struct Mesh {
+  MeshSize size;
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+};
+
+using GenerateFunction = std::function<void(Vertex *, std::vector<uint32_t> &, const MeshStyle &, uint32_t)>;
+
+struct MeshCase {
+  const char *name;
+  MeshSize size;
+  GenerateFunction generate;
+};
+
+static const MeshCase kMeshes[] = {
+    {"Grid", GetGridMeshSize(5, 3),
+     [](Vertex *vertices, std::vector<uint32_t> &indices, const MeshStyle &style, uint32_t first_vertex) {
+       GenerateGridMesh(vertices, indices, -2.0f, 1.0f, 2.0f, -1.0f, 4.0f, 5, 3, style, first_vertex);
+     }},
+    {"Floor", GetGridMeshSize(4, 6),
+     [](Vertex *vertices, std::vector<uint32_t> &indices, const MeshStyle &style, uint32_t first_vertex) {
+       GenerateFloorMesh(vertices, indices, -2.0f, 2.0f, 1.0f, 20.0f, -1.0f, 4, 6, style, first_vertex);
+     }},
+    {"Sphere", GetSphereMeshSize(12, 7),
+     [](Vertex *vertices, std::vector<uint32_t> &indices, const MeshStyle &style, uint32_t first_vertex) {
+       GenerateSphereMesh(vertices, indices, kCenter, 1.5f, 12, 7, style, first_vertex);
+     }},
+    {"Cylinder", GetCylinderMeshSize(10, 3),
+     [](Vertex *vertices, std::vector<uint32_t> &indices, const MeshStyle &style, uint32_t first_vertex) {
+       GenerateCylinderMesh(vertices, indices, kCenter, 0.75f, 2.0f, 10, 3, style, first_vertex);
+     }},
+    {"Torus", GetTorusMeshSize(16, 8),
+     [](Vertex *vertices, std::vector<uint32_t> &indices, const MeshStyle &style, uint32_t first_vertex) {
+       GenerateTorusMesh(vertices, indices, kCenter, 1.5f, 0.5f, 16, 8, style, first_vertex);
+     }},
+};
+
+class MeshGeneratorTest : public ::testing::TestWithParam<MeshCase> {
+ protected:
+  // Generates the mesh after a single existing index, as if it followed another mesh in a shared buffer.
+  static Mesh Generate(const MeshCase &mesh_case, const MeshStyle &style = {}) {
+    Mesh mesh;
+    mesh.size = mesh_case.size;
+    mesh.vertices.resize(mesh.size.num_vertices);
+    mesh.indices.push_back(0);
+    mesh_case.generate(mesh.vertices.data(), mesh.indices, style, kFirstVertex);
+    mesh.indices.erase(mesh.indices.begin());
+    return mesh;
+  }
+
+  static const Vertex &Get(const Mesh &mesh, uint32_t index) { return mesh.vertices[index - kFirstVertex]; }
+};
+
+static float Length(const float *v) { return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]); }
+
+TEST_P(MeshGeneratorTest, IndexCountMatchesSize) {
+  const auto mesh = Generate(GetParam());
+  EXPECT_EQ(mesh.indices.size(), mesh.size.num_indices);
+  EXPECT_EQ(mesh.indices.size() % 3, 0u);
+}
+
+TEST_P(MeshGeneratorTest, IndicesAreOffsetIntoTheMesh) {
+  const auto mesh = Generate(GetParam());
+  std::vector<bool> used(mesh.size.num_vertices);
+  for (auto index : mesh.indices) {
+    ASSERT_GE(index, kFirstVertex);
+    ASSERT_LT(index, kFirstVertex + mesh.size.num_vertices);
+    used[index - kFirstVertex] = true;
+  }
+
+  // The pole vertices of a sphere that only touch degenerate triangles may be unused, but every row is referenced.
+  uint32_t num_used = 0;
+  for (bool value : used) {
+    num_used += value;
+  }
+  EXPECT_GT(num_used, mesh.size.num_vertices / 2);
+}
+
+TEST_P(MeshGeneratorTest, NormalsAreUnitLength) {
+  const auto mesh = Generate(GetParam());
+  for (uint32_t i = 0; i < mesh.size.num_vertices; ++i) {
+    EXPECT_NEAR(Length(mesh.vertices[i].normal), 1.0f, 1e-5f) << "vertex " << i;
+  }
+}
+
+// cross(b - a, c - a) of every triangle points along the outward normals of its vertices.
+TEST_P(MeshGeneratorTest, TrianglesFaceAlongTheirNormals) {
+  const auto mesh = Generate(GetParam());
+  for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+    const auto &a = Get(mesh, mesh.indices[i]);
+    const auto &b = Get(mesh, mesh.indices[i + 1]);
+    const auto &c = Get(mesh, mesh.indices[i + 2]);
+
+    float ab[3];
+    float ac[3];
+    float normal_sum[3];
+    for (int axis = 0; axis < 3; ++axis) {
+      ab[axis] = b.pos[axis] - a.pos[axis];
+      ac[axis] = c.pos[axis] - a.pos[axis];
+      normal_sum[axis] = a.normal[axis] + b.normal[axis] + c.normal[axis];
+    }
+    const float face[3] = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2],
+                           ab[0] * ac[1] - ab[1] * ac[0]};
+
+    ASSERT_GT(Length(face), 1e-6f) << "degenerate triangle " << i / 3;
+    const float dot = face[0] * normal_sum[0] + face[1] * normal_sum[1] + face[2] * normal_sum[2];
+    EXPECT_GT(dot / (Length(face) * Length(normal_sum)), 0.5f) << "triangle " << i / 3;
+  }
+}
+
+TEST_P(MeshGeneratorTest, DiffuseFollowsTexcoordV) {
+  MeshStyle style;
+  style.diffuse_start = {1.0f, 0.0f, 0.5f, 1.0f};
+  style.diffuse_end = {0.0f, 1.0f, 0.5f, 0.0f};
+  const auto mesh = Generate(GetParam(), style);
+
+  // Cylinder caps take the start or end color and are checked by CylinderCapsUseEndColors.
+  const uint32_t lattice_vertices =
+      std::string(GetParam().name) == "Cylinder" ? GetGridMeshSize(10, 3).num_vertices : mesh.size.num_vertices;
+  for (uint32_t i = 0; i < lattice_vertices; ++i) {
+    const auto &vertex = mesh.vertices[i];
+    const float v = vertex.texcoord0[1];
+    EXPECT_NEAR(vertex.diffuse[0], 1.0f - v, 1e-5f);
+    EXPECT_NEAR(vertex.diffuse[1], v, 1e-5f);
+    EXPECT_NEAR(vertex.diffuse[2], 0.5f, 1e-5f);
+    EXPECT_NEAR(vertex.diffuse[3], 1.0f - v, 1e-5f);
+    EXPECT_EQ(vertex.pos[3], 1.0f);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Meshes, MeshGeneratorTest, ::testing::ValuesIn(kMeshes),
+                         [](const ::testing::TestParamInfo<MeshCase> &info) { return info.param.name; });
+
+TEST(MeshGeneratorShapeTest, SphereVerticesLieOnTheSurface) {
+  static constexpr float kRadius = 1.5f;
+  const auto size = GetSphereMeshSize(12, 7);
+  std::vector<Vertex> vertices(size.num_vertices);
+  std::vector<uint32_t> indices;
+  GenerateSphereMesh(vertices.data(), indices, kCenter, kRadius, 12, 7);
+
+  for (const auto &vertex : vertices) {
+    for (int axis = 0; axis < 3; ++axis) {
+      EXPECT_NEAR(vertex.pos[axis], kCenter[axis] + vertex.normal[axis] * kRadius, 1e-5f);
+    }
+  }
+}
+
+TEST(MeshGeneratorShapeTest, TorusVerticesLieOnTheTube) {
+  static constexpr float kMajorRadius = 1.5f;
+  static constexpr float kMinorRadius = 0.5f;
+  const auto size = GetTorusMeshSize(16, 8);
+  std::vector<Vertex> vertices(size.num_vertices);
+  std::vector<uint32_t> indices;
+  GenerateTorusMesh(vertices.data(), indices, kCenter, kMajorRadius, kMinorRadius, 16, 8);
+
+  for (const auto &vertex : vertices) {
+    // The tube center is the point of the main ring closest to the vertex.
+    const float x = vertex.pos[0] - kCenter[0];
+    const float z = vertex.pos[2] - kCenter[2];
+    const float ring_distance = std::sqrt(x * x + z * z);
+    const float tube_center[3] = {kCenter[0] + x / ring_distance * kMajorRadius, kCenter[1],
+                                  kCenter[2] + z / ring_distance * kMajorRadius};
+    for (int axis = 0; axis < 3; ++axis) {
+      EXPECT_NEAR(vertex.pos[axis], tube_center[axis] + vertex.normal[axis] * kMinorRadius, 1e-5f);
+    }
+  }
+}
+
+TEST(MeshGeneratorShapeTest, CylinderCapsUseEndColors) {
+  MeshStyle style;
+  style.diffuse_start = {1.0f, 0.0f, 0.0f, 1.0f};
+  style.diffuse_end = {0.0f, 0.0f, 1.0f, 1.0f};
+  const auto size = GetCylinderMeshSize(10, 3);
+  std::vector<Vertex> vertices(size.num_vertices);
+  std::vector<uint32_t> indices;
+  GenerateCylinderMesh(vertices.data(), indices, kCenter, 0.75f, 2.0f, 10, 3, style);
+
+  // Each cap is a center vertex and a closed ring of 11 vertices.
+  const uint32_t top_cap = GetGridMeshSize(10, 3).num_vertices;
+  const uint32_t bottom_cap = top_cap + 12;
+  ASSERT_EQ(bottom_cap + 12, size.num_vertices);
+  for (uint32_t i = 0; i < 12; ++i) {
+    EXPECT_EQ(vertices[top_cap + i].normal[1], 1.0f);
+    EXPECT_EQ(vertices[top_cap + i].pos[1], kCenter[1] + 1.0f);
+    EXPECT_EQ(vertices[top_cap + i].diffuse[0], 1.0f);
+    EXPECT_EQ(vertices[bottom_cap + i].normal[1], -1.0f);
+    EXPECT_EQ(vertices[bottom_cap + i].pos[1], kCenter[1] - 1.0f);
+    EXPECT_EQ(vertices[bottom_cap + i].diffuse[2], 1.0f);
+  }
+}
+
+TEST(MeshGeneratorShapeTest, GridSpansTheRequestedRectangle) {
+  const auto size = GetGridMeshSize(4, 2);
+  EXPECT_EQ(size.num_vertices, 15u);
+  EXPECT_EQ(size.num_indices, 48u);
+  std::vector<Vertex> vertices(size.num_vertices);
+  std::vector<uint32_t> indices;
+  GenerateGridMesh(vertices.data(), indices, -2.0f, 1.0f, 2.0f, -1.0f, 4.0f, 4, 2);
+
+  EXPECT_EQ(vertices.front().pos[0], -2.0f);
+  EXPECT_EQ(vertices.front().pos[1], 1.0f);
+  EXPECT_EQ(vertices.back().pos[0], 2.0f);
+  EXPECT_EQ(vertices.back().pos[1], -1.0f);
+  EXPECT_EQ(vertices.back().texcoord0[0], 1.0f);
+  EXPECT_EQ(vertices.back().texcoord0[1], 1.0f);
+  for (const auto &vertex : vertices) {
+    EXPECT_EQ(vertex.pos[2], 4.0f);
+  }
+}
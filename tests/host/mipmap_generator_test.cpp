@@ -0,0 +1,283 @@
+#include "mipmap_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// A 32bpp image whose rows may be padded beyond its width.
+struct Image {
+  uint32_t width;
+  uint32_t height;
+  uint32_t pitch_pixels;
+  std::vector<uint32_t> pixels;
+
+  Image(uint32_t width, uint32_t height, uint32_t padding = 0)
+      : width(width), height(height), pitch_pixels(width + padding), pixels(pitch_pixels * height, 0xDEADBEEF) {}
+
+  uint32_t Pitch() const { return pitch_pixels * 4; }
+  uint32_t &At(uint32_t x, uint32_t y) { return pixels[y * pitch_pixels + x]; }
+  uint32_t At(uint32_t x, uint32_t y) const { return pixels[y * pitch_pixels + x]; }
+};
+
+static Image MakeRandomImage(uint32_t width, uint32_t height, uint32_t padding, uint32_t seed) {
+  Image image(width, height, padding);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      seed = seed * 1664525 + 1013904223;
+      image.At(x, y) = seed;
+    }
+  }
+  return image;
+}
+
+static Image Downsample(const Image &source, MipmapFilter filter, bool gamma_correct, uint32_t alpha_shift = 24) {
+  Image dest(source.width > 1 ? source.width / 2 : 1, source.height > 1 ? source.height / 2 : 1, 3);
+  DownsampleMipmapLevel(dest.pixels.data(), dest.Pitch(), source.pixels.data(), source.Pitch(), source.width,
+                        source.height, filter, gamma_correct, alpha_shift);
+  return dest;
+}
+
+static float SRGBToLinear(uint32_t value) {
+  const float v = static_cast<float>(value) / 255.0f;
+  return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+static uint32_t LinearToSRGB(float value) {
+  const float v = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+  return static_cast<uint32_t>(std::lround(v * 255.0f));
+}
+
+// Returns the 2x2 box filtered value of one component of the destination texel at (x, y). Source coordinates past the
+// edge of a 1 texel wide or tall image repeat the last texel.
+static uint32_t ReferenceBox(const Image &source, uint32_t x, uint32_t y, uint32_t shift, bool gamma_correct) {
+  const uint32_t x0 = x * 2;
+  const uint32_t x1 = source.width > 1 ? x0 + 1 : x0;
+  const uint32_t y0 = y * 2;
+  const uint32_t y1 = source.height > 1 ? y0 + 1 : y0;
+  const uint32_t values[] = {(source.At(x0, y0) >> shift) & 0xFF, (source.At(x1, y0) >> shift) & 0xFF,
+                             (source.At(x0, y1) >> shift) & 0xFF, (source.At(x1, y1) >> shift) & 0xFF};
+
+  if (!gamma_correct) {
+    return (values[0] + values[1] + values[2] + values[3] + 2) >> 2;
+  }
+
+  float sum = 0.0f;
+  for (auto value : values) {
+    sum += SRGBToLinear(value);
+  }
+  return LinearToSRGB(sum * 0.25f);
+}
+
+// Compares every component of `dest` to the reference filter, allowing a difference of `tolerance`, and checks that
+// the padding at the end of each destination row was not written.
+static void ExpectMatchesReferenceBox(const Image &source, const Image &dest, bool gamma_correct, uint32_t alpha_shift,
+                                      uint32_t tolerance) {
+  for (uint32_t y = 0; y < dest.height; ++y) {
+    for (uint32_t x = 0; x < dest.width; ++x) {
+      for (uint32_t shift = 0; shift < 32; shift += 8) {
+        const uint32_t actual = (dest.At(x, y) >> shift) & 0xFF;
+        const uint32_t expected = ReferenceBox(source, x, y, shift, gamma_correct && shift != alpha_shift);
+        EXPECT_LE(std::abs(static_cast<int>(actual) - static_cast<int>(expected)), static_cast<int>(tolerance))
+            << "texel " << x << ", " << y << " shift " << shift << " expected " << expected << " actual " << actual;
+      }
+    }
+    for (uint32_t x = dest.width; x < dest.pitch_pixels; ++x) {
+      EXPECT_EQ(dest.At(x, y), 0xDEADBEEF);
+    }
+  }
+}
+
+TEST(MipmapLayoutTest, LevelCount) {
+  EXPECT_EQ(GetMipmapLevelCount(1, 1), 1u);
+  EXPECT_EQ(GetMipmapLevelCount(2, 2), 2u);
+  EXPECT_EQ(GetMipmapLevelCount(256, 256), 9u);
+  EXPECT_EQ(GetMipmapLevelCount(256, 64), 9u);
+  EXPECT_EQ(GetMipmapLevelCount(1, 16), 5u);
+  EXPECT_EQ(GetMipmapLevelCount(3, 5), 3u);
+}
+
+TEST(MipmapLayoutTest, UncompressedLevelSizes) {
+  // 64x16, 32x8, 16x4, 8x2, 4x1, 2x1, 1x1.
+  static constexpr uint32_t kExpected[] = {4096, 1024, 256, 64, 16, 8, 4};
+  for (uint32_t level = 0; level < 7; ++level) {
+    EXPECT_EQ(GetMipmapLevelSize(64, 16, level, 32), kExpected[level]) << "level " << level;
+  }
+  // Levels past the end of the chain stay 1x1.
+  EXPECT_EQ(GetMipmapLevelSize(64, 16, 7, 32), 4u);
+
+  EXPECT_EQ(GetMipmapLevelSize(8, 2, 1, 16), 8u);
+  EXPECT_EQ(GetMipmapLevelSize(2, 16, 3, 16), 4u);
+  EXPECT_EQ(GetMipmapLevelSize(1, 1, 0, 8), 1u);
+  // Partial bytes are rounded up.
+  EXPECT_EQ(GetMipmapLevelSize(1, 1, 0, 4), 1u);
+}
+
+TEST(MipmapLayoutTest, CompressedLevelSizes) {
+  // DXT1: 64x16, 32x8, 16x4, 8x2, 4x1, 2x1, 1x1. Levels smaller than a block still occupy a whole block.
+  static constexpr uint32_t kExpectedDXT1[] = {512, 128, 32, 16, 8, 8, 8};
+  for (uint32_t level = 0; level < 7; ++level) {
+    EXPECT_EQ(GetMipmapLevelSize(64, 16, level, 4, 8), kExpectedDXT1[level]) << "level " << level;
+  }
+
+  // DXT5: 16x16, 8x8, 4x4, 2x2, 1x1.
+  static constexpr uint32_t kExpectedDXT5[] = {256, 64, 16, 16, 16};
+  for (uint32_t level = 0; level < 5; ++level) {
+    EXPECT_EQ(GetMipmapLevelSize(16, 16, level, 8, 16), kExpectedDXT5[level]) << "level " << level;
+  }
+
+  // 12x4 is 3x1 blocks, 6x2 is 2x1 blocks.
+  EXPECT_EQ(GetMipmapLevelSize(12, 4, 0, 4, 8), 24u);
+  EXPECT_EQ(GetMipmapLevelSize(12, 4, 1, 4, 8), 16u);
+}
+
+TEST(MipmapLayoutTest, LevelsAreContiguous) {
+  EXPECT_EQ(GetMipmapLevelOffset(16, 16, 0, 32), 0u);
+  EXPECT_EQ(GetMipmapLevelOffset(16, 16, 3, 32), 1024u + 256u + 64u);
+  EXPECT_EQ(GetMipmapLevelOffset(64, 16, 4, 4, 8), 512u + 128u + 32u + 16u);
+
+  struct Layout {
+    uint32_t width;
+    uint32_t height;
+    uint32_t bits_per_pixel;
+    uint32_t block_size;
+  };
+  static constexpr Layout kLayouts[] = {{256, 256, 32, 0}, {128, 8, 16, 0}, {1, 64, 32, 0},
+                                        {64, 64, 4, 8},    {32, 4, 8, 16},  {8, 256, 8, 0}};
+  for (const auto &layout : kLayouts) {
+    SCOPED_TRACE(::testing::Message() << layout.width << "x" << layout.height << " " << layout.bits_per_pixel);
+    const uint32_t levels = GetMipmapLevelCount(layout.width, layout.height);
+    for (uint32_t level = 1; level <= levels; ++level) {
+      EXPECT_EQ(GetMipmapLevelOffset(layout.width, layout.height, level, layout.bits_per_pixel, layout.block_size),
+                GetMipmapLevelOffset(layout.width, layout.height, level - 1, layout.bits_per_pixel, layout.block_size) +
+                    GetMipmapLevelSize(layout.width, layout.height, level - 1, layout.bits_per_pixel,
+                                       layout.block_size));
+    }
+  }
+}
+
+TEST(MipmapDownsampleTest, BoxAveragesEach2x2Block) {
+  const auto source = MakeRandomImage(16, 8, 5, 1);
+  const auto dest = Downsample(source, MIPMAP_FILTER_BOX, false);
+  ASSERT_EQ(dest.width, 8u);
+  ASSERT_EQ(dest.height, 4u);
+  ExpectMatchesReferenceBox(source, dest, false, 24, 0);
+}
+
+TEST(MipmapDownsampleTest, BoxRoundsHalfUp) {
+  Image source(2, 2);
+  source.At(0, 0) = 0x00000000;
+  source.At(1, 0) = 0x01010101;
+  source.At(0, 1) = 0x01000100;
+  source.At(1, 1) = 0x03020100;
+  const auto dest = Downsample(source, MIPMAP_FILTER_BOX, false);
+  // Component sums of 5, 3, 3 and 1, from the highest byte.
+  EXPECT_EQ(dest.At(0, 0), 0x01010100u);
+}
+
+TEST(MipmapDownsampleTest, BoxGammaCorrectMatchesSRGBReference) {
+  const auto source = MakeRandomImage(16, 8, 2, 2);
+  ExpectMatchesReferenceBox(source, Downsample(source, MIPMAP_FILTER_BOX, true), true, 24, 1);
+  ExpectMatchesReferenceBox(source, Downsample(source, MIPMAP_FILTER_BOX, true, 0), true, 0, 1);
+}
+
+// Averaging black and white gives the sRGB encoding of 50% intensity for color components, but the alpha component is
+// averaged linearly.
+TEST(MipmapDownsampleTest, GammaCorrectBlendsColorInLinearSpace) {
+  Image source(2, 2);
+  source.At(0, 0) = 0x00000000;
+  source.At(1, 0) = 0xFFFFFFFF;
+  source.At(0, 1) = 0x00000000;
+  source.At(1, 1) = 0xFFFFFFFF;
+
+  EXPECT_EQ(Downsample(source, MIPMAP_FILTER_BOX, false).At(0, 0), 0x80808080u);
+  EXPECT_EQ(Downsample(source, MIPMAP_FILTER_BOX, true).At(0, 0), 0x80BCBCBCu);
+  EXPECT_EQ(Downsample(source, MIPMAP_FILTER_BOX, true, 0).At(0, 0), 0xBCBCBC80u);
+}
+
+// Once one dimension reaches 1 texel, only the other one is reduced.
+TEST(MipmapDownsampleTest, NonSquareTails) {
+  struct Size {
+    uint32_t width;
+    uint32_t height;
+  };
+  static constexpr Size kSizes[] = {{16, 2}, {2, 16}, {8, 1}, {1, 8}, {2, 1}, {1, 2}, {1, 1}};
+  uint32_t seed = 3;
+  for (const auto &size : kSizes) {
+    for (bool gamma_correct : {false, true}) {
+      SCOPED_TRACE(::testing::Message() << size.width << "x" << size.height << " gamma " << gamma_correct);
+      const auto source = MakeRandomImage(size.width, size.height, 1, seed++);
+      const auto dest = Downsample(source, MIPMAP_FILTER_BOX, gamma_correct);
+      EXPECT_EQ(dest.width, size.width > 1 ? size.width / 2 : 1);
+      EXPECT_EQ(dest.height, size.height > 1 ? size.height / 2 : 1);
+      ExpectMatchesReferenceBox(source, dest, gamma_correct, 24, gamma_correct ? 1 : 0);
+    }
+  }
+}
+
+TEST(MipmapDownsampleTest, OneByNAveragesPairs) {
+  Image source(1, 4);
+  source.At(0, 0) = 0x00000010;
+  source.At(0, 1) = 0x00000021;
+  source.At(0, 2) = 0xFF000000;
+  source.At(0, 3) = 0x01000000;
+  const auto dest = Downsample(source, MIPMAP_FILTER_BOX, false);
+  ASSERT_EQ(dest.width, 1u);
+  ASSERT_EQ(dest.height, 2u);
+  EXPECT_EQ(dest.At(0, 0), 0x00000019u);
+  EXPECT_EQ(dest.At(0, 1), 0x80000000u);
+}
+
+// Generates a complete chain into a single buffer laid out by GetMipmapLevelOffset, as TextureStage does.
+TEST(MipmapDownsampleTest, ChainReachesOneByOne) {
+  static constexpr uint32_t kWidth = 32;
+  static constexpr uint32_t kHeight = 8;
+  static constexpr uint32_t kColor = 0x80402010;
+  const uint32_t levels = GetMipmapLevelCount(kWidth, kHeight);
+  ASSERT_EQ(levels, 6u);
+
+  std::vector<uint32_t> chain(GetMipmapLevelOffset(kWidth, kHeight, levels, 32) / 4, 0);
+  std::fill(chain.begin(), chain.begin() + kWidth * kHeight, kColor);
+
+  uint32_t width = kWidth;
+  uint32_t height = kHeight;
+  for (uint32_t level = 1; level < levels; ++level) {
+    const uint32_t *source = chain.data() + GetMipmapLevelOffset(kWidth, kHeight, level - 1, 32) / 4;
+    uint32_t *dest = chain.data() + GetMipmapLevelOffset(kWidth, kHeight, level, 32) / 4;
+    const uint32_t dest_width = width > 1 ? width / 2 : 1;
+    DownsampleMipmapLevel(dest, dest_width * 4, source, width * 4, width, height, MIPMAP_FILTER_BOX, true);
+    width = dest_width;
+    height = height > 1 ? height / 2 : 1;
+  }
+
+  EXPECT_EQ(width, 1u);
+  EXPECT_EQ(height, 1u);
+  for (size_t i = 0; i < chain.size(); ++i) {
+    ASSERT_EQ(chain[i], kColor) << "texel " << i;
+  }
+}
+
+// The Kaiser weights sum to exactly 1, so a flat image is unchanged, including at the clamped edges.
+TEST(MipmapDownsampleTest, KaiserPreservesFlatColor) {
+  struct Size {
+    uint32_t width;
+    uint32_t height;
+  };
+  static constexpr Size kSizes[] = {{16, 16}, {32, 4}, {16, 1}, {1, 16}, {2, 2}};
+  for (const auto &size : kSizes) {
+    SCOPED_TRACE(::testing::Message() << size.width << "x" << size.height);
+    Image source(size.width, size.height, 2);
+    for (uint32_t y = 0; y < size.height; ++y) {
+      for (uint32_t x = 0; x < size.width; ++x) {
+        source.At(x, y) = 0xC0804020;
+      }
+    }
+    const auto dest = Downsample(source, MIPMAP_FILTER_KAISER, false);
+    for (uint32_t y = 0; y < dest.height; ++y) {
+      for (uint32_t x = 0; x < dest.width; ++x) {
+        EXPECT_EQ(dest.At(x, y), 0xC0804020u) << "texel " << x << ", " << y;
+      }
+    }
+  }
+}
@@ -0,0 +1,183 @@
+#include "palette_quantizer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include "image_util.h"
+
+// Maps the indices produced by QuantizeImage back to colors.
+static std::vector<uint32_t> Reconstruct(const uint32_t *palette, const std::vector<uint8_t> &indices) {
+  std::vector<uint32_t> ret(indices.size());
+  for (uint32_t i = 0; i < indices.size(); ++i) {
+    ret[i] = palette[indices[i]];
+  }
+  return ret;
+}
+
+static uint32_t Distance(uint32_t a, uint32_t b) {
+  uint32_t ret = 0;
+  for (uint32_t shift = 0; shift < 32; shift += 8) {
+    const int delta = static_cast<int>((a >> shift) & 0xFF) - static_cast<int>((b >> shift) & 0xFF);
+    ret += delta * delta;
+  }
+  return ret;
+}
+
+TEST(PaletteQuantizer, RejectsInvalidArguments) {
+  uint32_t palette[256];
+  uint8_t indices[4];
+  const uint32_t source[4] = {};
+  EXPECT_NE(QuantizeImage(palette, 0, indices, 2, source, 8, 2, 2), 0);
+  EXPECT_NE(QuantizeImage(palette, 257, indices, 2, source, 8, 2, 2), 0);
+  EXPECT_NE(QuantizeImage(palette, 16, indices, 2, source, 8, 0, 2), 0);
+  EXPECT_NE(QuantizeImage(palette, 16, indices, 2, source, 8, 2, 0), 0);
+}
+
+// Images with no more colors than palette entries are reproduced exactly.
+TEST(PaletteQuantizer, FewColorsAreExact) {
+  static constexpr uint32_t kColors[] = {0xFF0000FF, 0xFF00FF00, 0x80FF0000, 0x00000000, 0xFFFFFFFF, 0x7F102030};
+  static constexpr uint32_t kSize = 16;
+  std::vector<uint32_t> source(kSize * kSize);
+  for (uint32_t i = 0; i < source.size(); ++i) {
+    source[i] = kColors[(i * 7 + i / kSize) % 6];
+  }
+
+  for (bool dither : {false, true}) {
+    SCOPED_TRACE(dither);
+    uint32_t palette[16];
+    memset(palette, 0xCD, sizeof(palette));
+    std::vector<uint8_t> indices(source.size());
+    ASSERT_EQ(QuantizeImage(palette, 16, indices.data(), kSize, source.data(), kSize * 4, kSize, kSize, dither), 0);
+
+    EXPECT_EQ(Reconstruct(palette, indices), source);
+  }
+}
+
+// Entries beyond the number of colors found by median cut are zeroed.
+TEST(PaletteQuantizer, UnusedEntriesAreZeroed) {
+  const uint32_t source[4] = {0xFF0000FF, 0xFF0000FF, 0xFF00FF00, 0xFF00FF00};
+  uint32_t palette[8];
+  memset(palette, 0xCD, sizeof(palette));
+  uint8_t indices[4];
+  ASSERT_EQ(QuantizeImage(palette, 8, indices, 4, source, 16, 4, 1), 0);
+
+  EXPECT_EQ(std::set<uint32_t>(palette, palette + 2), std::set<uint32_t>(source, source + 4));
+  for (uint32_t i = 2; i < 8; ++i) {
+    EXPECT_EQ(palette[i], 0u) << i;
+  }
+}
+
+// Without dithering every pixel maps to its nearest palette entry.
+TEST(PaletteQuantizer, IndicesAreNearestEntries) {
+  static constexpr uint32_t kSize = 64;
+  auto image = MakeNoiseImage(kSize, kSize);
+  uint32_t palette[16];
+  std::vector<uint8_t> indices(kSize * kSize);
+  ASSERT_EQ(QuantizeImage(palette, 16, indices.data(), kSize, image.pixels.data(), kSize * 4, kSize, kSize), 0);
+
+  for (uint32_t i = 0; i < indices.size(); ++i) {
+    ASSERT_LT(indices[i], 16);
+    const uint32_t distance = Distance(image.pixels[i], palette[indices[i]]);
+    for (uint32_t entry = 0; entry < 16; ++entry) {
+      ASSERT_LE(distance, Distance(image.pixels[i], palette[entry])) << "pixel " << i << " entry " << entry;
+    }
+  }
+}
+
+TEST(PaletteQuantizer, HonorsPitches) {
+  static constexpr uint32_t kWidth = 5;
+  static constexpr uint32_t kHeight = 3;
+  static constexpr uint32_t kSourcePitch = 8 * 4;
+  static constexpr uint32_t kIndicesPitch = 8;
+  std::vector<uint32_t> source(8 * kHeight, 0xDEADBEEF);
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    for (uint32_t x = 0; x < kWidth; ++x) {
+      source[y * 8 + x] = (x + y) & 1 ? 0xFF000000 : 0xFFFFFFFF;
+    }
+  }
+  std::vector<uint8_t> indices(kIndicesPitch * kHeight, 0xEE);
+
+  uint32_t palette[4];
+  ASSERT_EQ(QuantizeImage(palette, 4, indices.data(), kIndicesPitch, source.data(), kSourcePitch, kWidth, kHeight), 0);
+
+  // The padding of the source is not part of the image, so it never appears in the palette.
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    for (uint32_t x = 0; x < kWidth; ++x) {
+      EXPECT_EQ(palette[indices[y * kIndicesPitch + x]], source[y * 8 + x]);
+    }
+    for (uint32_t x = kWidth; x < kIndicesPitch; ++x) {
+      EXPECT_EQ(indices[y * kIndicesPitch + x], 0xEE);
+    }
+  }
+}
+
+TEST(PaletteQuantizer, TestImageQuality) {
+  HostImage image;
+  ASSERT_TRUE(LoadPNG(GetResourcePath("image_blit/TestImage.png"), image));
+  const uint32_t num_pixels = image.width * image.height;
+
+  struct Case {
+    uint32_t palette_size;
+    double min_psnr;
+  };
+  for (auto test : {Case{256, 30.0}, Case{16, 20.0}}) {
+    SCOPED_TRACE(test.palette_size);
+    uint32_t palette[256];
+    std::vector<uint8_t> indices(num_pixels);
+    ASSERT_EQ(QuantizeImage(palette, test.palette_size, indices.data(), image.width, image.pixels.data(),
+                            image.width * 4, image.width, image.height),
+              0);
+
+    auto quantized = Reconstruct(palette, indices);
+    EXPECT_GE(CompareImages(quantized.data(), image.pixels.data(), num_pixels, 0x0F).psnr, test.min_psnr);
+
+    // Refinement never makes the palette worse than the median cut seed.
+    std::vector<uint8_t> seed_indices(num_pixels);
+    uint32_t seed_palette[256];
+    ASSERT_EQ(QuantizeImage(seed_palette, test.palette_size, seed_indices.data(), image.width, image.pixels.data(),
+                            image.width * 4, image.width, image.height, false, 0),
+              0);
+    auto seed = Reconstruct(seed_palette, seed_indices);
+    EXPECT_GE(CompareImages(quantized.data(), image.pixels.data(), num_pixels, 0x0F).psnr,
+              CompareImages(seed.data(), image.pixels.data(), num_pixels, 0x0F).psnr);
+  }
+}
+
+// Error diffusion preserves the average brightness of a ramp that the palette cannot represent directly.
+TEST(PaletteQuantizer, DitheringPreservesLocalAverages) {
+  static constexpr uint32_t kSize = 64;
+  static constexpr uint32_t kBlock = 8;
+  std::vector<uint32_t> source(kSize * kSize);
+  for (uint32_t i = 0; i < source.size(); ++i) {
+    const uint32_t value = (i % kSize) * 4;
+    source[i] = 0xFF000000 | value | (value << 8) | (value << 16);
+  }
+
+  // Returns the summed absolute error of the average of each kBlock x kBlock block.
+  auto block_error = [&](bool dither) {
+    uint32_t palette[4];
+    std::vector<uint8_t> indices(source.size());
+    EXPECT_EQ(QuantizeImage(palette, 4, indices.data(), kSize, source.data(), kSize * 4, kSize, kSize, dither), 0);
+    auto quantized = Reconstruct(palette, indices);
+
+    double total = 0.0;
+    for (uint32_t by = 0; by < kSize; by += kBlock) {
+      for (uint32_t bx = 0; bx < kSize; bx += kBlock) {
+        int delta = 0;
+        for (uint32_t y = by; y < by + kBlock; ++y) {
+          for (uint32_t x = bx; x < bx + kBlock; ++x) {
+            delta += static_cast<int>(quantized[y * kSize + x] & 0xFF) - static_cast<int>(source[y * kSize + x] & 0xFF);
+          }
+        }
+        total += std::abs(delta) / static_cast<double>(kBlock * kBlock);
+      }
+    }
+    return total;
+  };
+
+  EXPECT_LT(block_error(true), block_error(false) * 0.5);
+}
@@ -0,0 +1,53 @@
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "benchmark.h"
+#include "pattern_generator.h"
+#include "pattern_reference.h"
+
+static constexpr uint32_t kWidth = 640;
+static constexpr uint32_t kHeight = 480;
+static constexpr uint32_t kPitch = kWidth * 4;
+
+// Compares the span based pattern generators with the original per-pixel loops.
+HOST_BENCHMARK(PatternGenerator640x480) {
+  static constexpr uint32_t kColors[] = {
+      0xFF0000FF, 0x660000FF, 0xFF00FF00, 0x6600FF00, 0xFFFF4444, 0x66FF4444, 0xFFFFFFFF, 0x66FFFFFF,
+  };
+  std::vector<uint32_t> buffer(kWidth * kHeight);
+
+  struct Case {
+    const char *name;
+    std::function<void()> reference;
+    std::function<void()> spans;
+  };
+  const Case cases[] = {
+      {"Checkerboard",
+       [&]() { ReferenceRGBACheckerboard(buffer.data(), 0, 0, kWidth, kHeight, kPitch, 0xFF00FFFF, 0xFF000000, 8); },
+       [&]() { GenerateRGBACheckerboard(buffer.data(), 0, 0, kWidth, kHeight, kPitch, 0xFF00FFFF, 0xFF000000, 8); }},
+      {"ColoredCheckerboard",
+       [&]() { ReferenceColoredCheckerboard(buffer.data(), 0, 0, kWidth, kHeight, kPitch, kColors, 8, 4); },
+       [&]() { GenerateColoredCheckerboard(buffer.data(), 0, 0, kWidth, kHeight, kPitch, kColors, 8, 4); }},
+      {"TestPattern", [&]() { ReferenceRGBATestPattern(buffer.data(), 0, 0, kWidth, kHeight, kPitch); },
+       [&]() { GenerateRGBATestPattern(buffer.data(), 0, 0, kWidth, kHeight, kPitch); }},
+      {"Bands", [&]() { ReferenceRGBABands(buffer.data(), 0, 0, kWidth, kHeight, kPitch, kColors, 8, 4, false); },
+       [&]() { GenerateRGBABands(buffer.data(), 0, 0, kWidth, kHeight, kPitch, kColors, 8, 4, false); }},
+      {"VerticalBands",
+       [&]() { ReferenceRGBABands(buffer.data(), 0, 0, kWidth, kHeight, kPitch, kColors, 8, 4, true); },
+       [&]() { GenerateRGBABands(buffer.data(), 0, 0, kWidth, kHeight, kPitch, kColors, 8, 4, true); }},
+  };
+
+  printf("%-20s %12s %12s\n", "pattern", "per-pixel ms", "spans ms");
+  for (const auto &test : cases) {
+    const double reference = TimeBest([&]() {
+      test.reference();
+      KeepAlive(buffer);
+    });
+    const double spans = TimeBest([&]() {
+      test.spans();
+      KeepAlive(buffer);
+    });
+    printf("%-20s %12.3f %12.3f\n", test.name, reference * 1000.0, spans * 1000.0);
+  }
+}
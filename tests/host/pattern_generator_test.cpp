@@ -0,0 +1,201 @@
+#include "pattern_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "pattern_reference.h"
+#include "swizzle.h"
+
+static constexpr uint32_t kSentinel = 0xDEADBEEF;
+
+struct Rect {
+  uint32_t x_offset;
+  uint32_t y_offset;
+  uint32_t width;
+  uint32_t height;
+  // Padding pixels at the end of every row, beyond the rectangle.
+  uint32_t padding;
+};
+
+// Odd offsets and widths cover every alignment of the 128-bit span stores and their scalar tails.
+static const Rect kRects[] = {
+    {0, 0, 1, 1, 0},   {0, 0, 3, 2, 0},    {0, 0, 16, 16, 0},  {1, 0, 17, 5, 3},   {2, 3, 31, 9, 1},
+    {3, 1, 64, 33, 4}, {5, 7, 100, 13, 0}, {0, 0, 640, 48, 0}, {7, 2, 257, 11, 5},
+};
+
+static const uint32_t kCheckerSizes[] = {1, 2, 3, 4, 7, 8, 24, 300};
+
+// Runs `generate` and `reference` over sentinel filled buffers covering `rect` and expects identical bytes, including
+// the untouched surroundings.
+template <typename Generate, typename Reference>
+static void ExpectIdentical(const Rect &rect, Generate generate, Reference reference) {
+  const uint32_t stride = rect.x_offset + rect.width + rect.padding;
+  const uint32_t pitch = stride * 4;
+  const uint32_t rows = rect.y_offset + rect.height + 1;
+  std::vector<uint32_t> actual(stride * rows, kSentinel);
+  std::vector<uint32_t> expected(actual);
+
+  generate(actual.data(), rect.x_offset, rect.y_offset, rect.width, rect.height, pitch);
+  reference(expected.data(), rect.x_offset, rect.y_offset, rect.width, rect.height, pitch);
+  ASSERT_EQ(actual, expected);
+}
+
+TEST(PatternGenerator, CheckerboardMatchesReference) {
+  for (const auto &rect : kRects) {
+    for (auto checker_size : kCheckerSizes) {
+      SCOPED_TRACE(testing::Message() << rect.x_offset << "," << rect.y_offset << " " << rect.width << "x"
+                                      << rect.height << " checker " << checker_size);
+      ExpectIdentical(
+          rect,
+          [&](void *target, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t pitch) {
+            GenerateRGBACheckerboard(target, x, y, w, h, pitch, 0xFF00FFFF, 0x7F102030, checker_size);
+          },
+          [&](void *target, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t pitch) {
+            ReferenceRGBACheckerboard(target, x, y, w, h, pitch, 0xFF00FFFF, 0x7F102030, checker_size);
+          });
+    }
+  }
+}
+
+TEST(PatternGenerator, ColoredCheckerboardMatchesReference) {
+  static constexpr uint32_t kColors[] = {0xFF0000FF, 0x660000FF, 0xFF00FF00, 0x6600FF00, 0xFFFF4444};
+  for (const auto &rect : kRects) {
+    for (auto checker_size : kCheckerSizes) {
+      for (uint32_t num_colors = 1; num_colors <= 5; ++num_colors) {
+        SCOPED_TRACE(testing::Message() << rect.x_offset << "," << rect.y_offset << " " << rect.width << "x"
+                                        << rect.height << " checker " << checker_size << " colors " << num_colors);
+        ExpectIdentical(
+            rect,
+            [&](void *target, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t pitch) {
+              GenerateColoredCheckerboard(target, x, y, w, h, pitch, kColors, num_colors, checker_size);
+            },
+            [&](void *target, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t pitch) {
+              ReferenceColoredCheckerboard(target, x, y, w, h, pitch, kColors, num_colors, checker_size);
+            });
+      }
+    }
+  }
+}
+
+TEST(PatternGenerator, TestPatternMatchesReference) {
+  for (const auto &rect : kRects) {
+    SCOPED_TRACE(testing::Message() << rect.x_offset << "," << rect.y_offset << " " << rect.width << "x"
+                                    << rect.height);
+    ExpectIdentical(
+        rect,
+        [](void *target, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t pitch) {
+          GenerateRGBATestPattern(target, x, y, w, h, pitch);
+        },
+        ReferenceRGBATestPattern);
+  }
+
+  // The packed overload is the same pattern with a tight pitch.
+  std::vector<uint32_t> actual(48 * 40);
+  std::vector<uint32_t> expected(actual.size());
+  GenerateRGBATestPattern(actual.data(), 48, 40);
+  ReferenceRGBATestPattern(expected.data(), 0, 0, 48, 40, 48 * 4);
+  EXPECT_EQ(actual, expected);
+}
+
+TEST(PatternGenerator, BandsMatchReference) {
+  static constexpr uint32_t kColors[] = {0xFF0000FF, 0x660000FF, 0xFF00FF00, 0x6600FF00};
+  for (const auto &rect : kRects) {
+    for (auto band_size : kCheckerSizes) {
+      for (uint32_t num_colors = 1; num_colors <= 4; ++num_colors) {
+        for (bool vertical : {false, true}) {
+          SCOPED_TRACE(testing::Message() << rect.x_offset << "," << rect.y_offset << " " << rect.width << "x"
+                                          << rect.height << " band " << band_size << " colors " << num_colors
+                                          << " vertical " << vertical);
+          ExpectIdentical(
+              rect,
+              [&](void *target, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t pitch) {
+                GenerateRGBABands(target, x, y, w, h, pitch, kColors, num_colors, band_size, vertical);
+              },
+              [&](void *target, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t pitch) {
+                ReferenceRGBABands(target, x, y, w, h, pitch, kColors, num_colors, band_size, vertical);
+              });
+        }
+      }
+    }
+  }
+}
+
+TEST(PatternGenerator, NoiseMatchesReference) {
+  for (const auto &rect : kRects) {
+    for (uint32_t seed : {0u, 1u, 0x12345678u}) {
+      for (bool opaque : {false, true}) {
+        SCOPED_TRACE(testing::Message() << rect.x_offset << "," << rect.y_offset << " " << rect.width << "x"
+                                        << rect.height << " seed " << seed << " opaque " << opaque);
+        ExpectIdentical(
+            rect,
+            [&](void *target, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t pitch) {
+              GenerateRGBANoise(target, x, y, w, h, pitch, seed, opaque);
+            },
+            [&](void *target, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t pitch) {
+              ReferenceRGBANoise(target, x, y, w, h, pitch, seed, opaque);
+            });
+      }
+    }
+  }
+}
+
+// The noise only depends on the position within the rectangle and the seed, not on where the rectangle is placed.
+TEST(PatternGenerator, NoiseIsIndependentOfPlacement) {
+  static constexpr uint32_t kWidth = 19;
+  static constexpr uint32_t kHeight = 7;
+  std::vector<uint32_t> packed(kWidth * kHeight);
+  GenerateRGBANoise(packed.data(), 0, 0, kWidth, kHeight, kWidth * 4, 42);
+
+  static constexpr uint32_t kStride = 32;
+  std::vector<uint32_t> placed(kStride * (kHeight + 3), kSentinel);
+  GenerateRGBANoise(placed.data(), 5, 3, kWidth, kHeight, kStride * 4, 42);
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    EXPECT_EQ(0, memcmp(packed.data() + y * kWidth, placed.data() + (y + 3) * kStride + 5, kWidth * 4)) << "row " << y;
+  }
+
+  std::vector<uint32_t> reseeded(packed.size());
+  GenerateRGBANoise(reseeded.data(), 0, 0, kWidth, kHeight, kWidth * 4, 43);
+  EXPECT_NE(packed, reseeded);
+}
+
+// Row generators are also used directly by the texture generators, one row at a time and in any order.
+TEST(PatternGenerator, RowGeneratorsAreIndependentOfOrder) {
+  static constexpr uint32_t kWidth = 37;
+  static constexpr uint32_t kHeight = 29;
+  static constexpr uint32_t kColors[] = {0xFF0000FF, 0xFF00FF00, 0xFFFF0000};
+  std::vector<uint32_t> checkerboard(kWidth * kHeight);
+  std::vector<uint32_t> gradient(kWidth * kHeight);
+  ReferenceColoredCheckerboard(checkerboard.data(), 0, 0, kWidth, kHeight, kWidth * 4, kColors, 3, 4);
+  ReferenceRGBATestPattern(gradient.data(), 0, 0, kWidth, kHeight, kWidth * 4);
+
+  const CheckerboardRowGenerator checkerboard_row(kWidth, kColors, 3, 4);
+  const GradientRowGenerator gradient_row(kWidth, kHeight);
+  std::vector<uint32_t> row(kWidth);
+  for (uint32_t y = kHeight; y-- > 0;) {
+    SCOPED_TRACE(y);
+    checkerboard_row(y, row.data());
+    EXPECT_EQ(0, memcmp(row.data(), checkerboard.data() + y * kWidth, kWidth * 4));
+    gradient_row(y, row.data());
+    EXPECT_EQ(0, memcmp(row.data(), gradient.data() + y * kWidth, kWidth * 4));
+  }
+}
+
+TEST(PatternGenerator, SwizzledCheckerboardMatchesReference) {
+  for (uint32_t size : {1u, 4u, 16u, 64u, 256u}) {
+    for (auto checker_size : {1u, 3u, 8u}) {
+      SCOPED_TRACE(testing::Message() << size << " checker " << checker_size);
+      const uint32_t pitch = size * 4;
+      std::vector<uint32_t> actual(size * size, kSentinel);
+      GenerateSwizzledRGBACheckerboard(actual.data(), 0, 0, size, size, pitch, 0xFF00FFFF, 0xFF000000, checker_size);
+
+      std::vector<uint32_t> linear(size * size, kSentinel);
+      ReferenceRGBACheckerboard(linear.data(), 0, 0, size, size, pitch, 0xFF00FFFF, 0xFF000000, checker_size);
+      std::vector<uint32_t> expected(size * size);
+      swizzle_rect(reinterpret_cast<const uint8_t *>(linear.data()), size, size,
+                   reinterpret_cast<uint8_t *>(expected.data()), pitch, 4);
+      ASSERT_EQ(actual, expected);
+    }
+  }
+}
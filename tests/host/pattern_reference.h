@@ -0,0 +1,109 @@
+#ifndef NXDK_PGRAPH_TESTS_HOST_PATTERN_REFERENCE_H
+#define NXDK_PGRAPH_TESTS_HOST_PATTERN_REFERENCE_H
+
+#include <cstdint>
+
+// The original per-pixel implementations of the pattern generators, used as the reference for the span based ones.
+
+inline void ReferenceRGBACheckerboard(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width,
+                                      uint32_t height, uint32_t pitch, uint32_t first_color, uint32_t second_color,
+                                      uint32_t checker_size) {
+  auto buffer = reinterpret_cast<uint8_t *>(target);
+  auto odd = first_color;
+  auto even = second_color;
+  buffer += y_offset * pitch;
+
+  for (uint32_t y = 0; y < height; ++y) {
+    auto pixel = reinterpret_cast<uint32_t *>(buffer);
+    pixel += x_offset;
+    buffer += pitch;
+
+    if (!(y % checker_size)) {
+      auto temp = odd;
+      odd = even;
+      even = temp;
+    }
+
+    for (uint32_t x = 0; x < width; ++x) {
+      *pixel++ = ((x / checker_size) & 0x01) ? odd : even;
+    }
+  }
+}
+
+inline void ReferenceColoredCheckerboard(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width,
+                                         uint32_t height, uint32_t pitch, const uint32_t *colors, uint32_t num_colors,
+                                         uint32_t checker_size) {
+  auto buffer = reinterpret_cast<uint8_t *>(target);
+  buffer += y_offset * pitch;
+
+  uint32_t row_color_index = 0;
+
+  for (uint32_t y = 0; y < height; ++y) {
+    auto pixel = reinterpret_cast<uint32_t *>(buffer);
+    pixel += x_offset;
+    buffer += pitch;
+
+    if (y && !(y % checker_size)) {
+      row_color_index = (row_color_index + 1) % num_colors;
+    }
+
+    auto color_index = row_color_index;
+    auto color = colors[color_index];
+    for (uint32_t x = 0; x < width; ++x) {
+      if (x && !(x % checker_size)) {
+        color_index = (color_index + 1) % num_colors;
+        color = colors[color_index];
+      }
+      *pixel++ = color;
+    }
+  }
+}
+
+// Matches the SDL_MapRGBA based gradient of GenerateSurface, in ABGR8888.
+inline void ReferenceRGBATestPattern(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width,
+                                     uint32_t height, uint32_t pitch) {
+  auto buffer = reinterpret_cast<uint8_t *>(target) + y_offset * pitch;
+  for (uint32_t y = 0; y < height; ++y, buffer += pitch) {
+    auto pixel = reinterpret_cast<uint32_t *>(buffer) + x_offset;
+    for (uint32_t x = 0; x < width; ++x) {
+      auto x_normal = static_cast<uint32_t>(static_cast<float>(x) * 255.0f / static_cast<float>(width));
+      auto y_normal = static_cast<uint32_t>(static_cast<float>(y) * 255.0f / static_cast<float>(height));
+      pixel[x] = y_normal | (x_normal << 8) | ((255 - y_normal) << 16) | (((x_normal + y_normal) & 0xFF) << 24);
+    }
+  }
+}
+
+inline void ReferenceRGBABands(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                               uint32_t pitch, const uint32_t *colors, uint32_t num_colors, uint32_t band_size,
+                               bool vertical) {
+  auto buffer = reinterpret_cast<uint8_t *>(target) + y_offset * pitch;
+  for (uint32_t y = 0; y < height; ++y, buffer += pitch) {
+    auto pixel = reinterpret_cast<uint32_t *>(buffer) + x_offset;
+    for (uint32_t x = 0; x < width; ++x) {
+      pixel[x] = colors[((vertical ? x : y) / band_size) % num_colors];
+    }
+  }
+}
+
+inline uint32_t ReferenceNoisePixel(uint32_t x, uint32_t y, uint32_t seed) {
+  uint32_t value = seed ^ (y * 0x9E3779B1) ^ (x * 0x85EBCA77);
+  value ^= value >> 16;
+  value *= 0x7FEB352D;
+  value ^= value >> 15;
+  value *= 0x846CA68B;
+  value ^= value >> 16;
+  return value;
+}
+
+inline void ReferenceRGBANoise(void *target, uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+                               uint32_t pitch, uint32_t seed, bool opaque) {
+  auto buffer = reinterpret_cast<uint8_t *>(target) + y_offset * pitch;
+  for (uint32_t y = 0; y < height; ++y, buffer += pitch) {
+    auto pixel = reinterpret_cast<uint32_t *>(buffer) + x_offset;
+    for (uint32_t x = 0; x < width; ++x) {
+      pixel[x] = ReferenceNoisePixel(x, y, seed) | (opaque ? 0xFF000000 : 0);
+    }
+  }
+}
+
+#endif  // NXDK_PGRAPH_TESTS_HOST_PATTERN_REFERENCE_H
@@ -0,0 +1,200 @@
+#include "resource_pack.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "image_util.h"
+#include "swizzle_reference.h"
+
+// Size of the DDS magic and header, which precede the mipmap chain in files without a DX10 header.
+static constexpr uint32_t kDDSHeaderSize = 128;
+
+static std::vector<uint8_t> ReadFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static bool EndsWith(const std::string &value, const char *suffix) {
+  const size_t suffix_len = strlen(suffix);
+  return value.size() >= suffix_len && !value.compare(value.size() - suffix_len, suffix_len, suffix);
+}
+
+// Runs tools/resource_packer over the resources directory once and keeps the bytes of the resulting pack.
+class ResourcePackTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    const std::string pack_path = ::testing::TempDir() + "resource_pack_test.pack";
+    const std::string command = std::string(HOST_TEST_RESOURCE_PACKER) + " " + HOST_TEST_RESOURCE_DIR + " " +
+                                HOST_TEST_RESOURCE_MANIFEST + " " + pack_path + " > /dev/null";
+    ASSERT_EQ(std::system(command.c_str()), 0) << command;
+    pack_bytes_ = ReadFile(pack_path);
+    std::remove(pack_path.c_str());
+  }
+
+  static void TearDownTestSuite() { pack_bytes_.clear(); }
+
+  static std::vector<uint8_t> pack_bytes_;
+};
+
+std::vector<uint8_t> ResourcePackTest::pack_bytes_;
+
+TEST_F(ResourcePackTest, ContainsEveryResource) {
+  ResourcePack pack;
+  ASSERT_TRUE(pack.Load(std::vector<uint8_t>(pack_bytes_)));
+
+  uint32_t num_resources = 0;
+  for (auto &file : std::filesystem::recursive_directory_iterator(HOST_TEST_RESOURCE_DIR)) {
+    const std::string name = std::filesystem::relative(file.path(), HOST_TEST_RESOURCE_DIR).generic_string();
+    if (!EndsWith(name, ".png") && !EndsWith(name, ".dds")) {
+      continue;
+    }
+    ++num_resources;
+    EXPECT_NE(pack.Find(name.c_str()), nullptr) << name;
+  }
+  EXPECT_EQ(pack.NumEntries(), num_resources);
+  EXPECT_EQ(pack.Find("does_not_exist.png"), nullptr);
+}
+
+// Every blob must match the source file, converted independently of the packer.
+TEST_F(ResourcePackTest, EntriesMatchSources) {
+  ResourcePack pack;
+  ASSERT_TRUE(pack.Load(std::vector<uint8_t>(pack_bytes_)));
+
+  for (uint32_t i = 0; i < pack.NumEntries(); ++i) {
+    const ResourcePack::Entry &entry = pack.GetEntries()[i];
+    SCOPED_TRACE(entry.name);
+    EXPECT_EQ(entry.offset % ResourcePack::kAlignment, 0u);
+    const std::string path = GetResourcePath(entry.name);
+
+    std::vector<uint8_t> expected;
+    if (EndsWith(entry.name, ".png")) {
+      HostImage image;
+      ASSERT_TRUE(LoadPNG(path, image));
+      EXPECT_EQ(entry.width, image.width);
+      EXPECT_EQ(entry.height, image.height);
+      EXPECT_EQ(entry.pitch, image.width * 4);
+      EXPECT_EQ(entry.levels, 1u);
+
+      if (entry.format == ResourcePack::FORMAT_ARGB8888) {
+        for (auto &pixel : image.pixels) {
+          pixel = (pixel & 0xFF00FF00) | ((pixel >> 16) & 0xFF) | ((pixel & 0xFF) << 16);
+        }
+      } else {
+        ASSERT_EQ(entry.format, static_cast<uint32_t>(ResourcePack::FORMAT_ABGR8888));
+      }
+
+      expected.resize(image.pixels.size() * 4);
+      if (entry.swizzled) {
+        ReferenceSwizzleBox(reinterpret_cast<const uint8_t *>(image.pixels.data()), image.width, image.height, 1,
+                            expected.data(), entry.pitch, 0, 4);
+      } else {
+        memcpy(expected.data(), image.pixels.data(), expected.size());
+      }
+    } else {
+      // The packer stores the full mipmap chain, which DDS files hold contiguously after the header.
+      auto file = ReadFile(path);
+      ASSERT_GT(file.size(), kDDSHeaderSize);
+      expected.assign(file.begin() + kDDSHeaderSize, file.end());
+      EXPECT_GE(entry.format, static_cast<uint32_t>(ResourcePack::FORMAT_DXT1));
+      EXPECT_LE(entry.format, static_cast<uint32_t>(ResourcePack::FORMAT_DXT5));
+      EXPECT_FALSE(entry.swizzled);
+    }
+
+    ASSERT_EQ(entry.size, expected.size());
+    EXPECT_EQ(memcmp(pack.GetData(entry), expected.data(), expected.size()), 0);
+  }
+}
+
+TEST_F(ResourcePackTest, ManifestOptionsApplied) {
+  ResourcePack pack;
+  ASSERT_TRUE(pack.Load(std::vector<uint8_t>(pack_bytes_)));
+
+  auto blit_image = pack.Find("image_blit/TestImage.png");
+  ASSERT_NE(blit_image, nullptr);
+  EXPECT_EQ(blit_image->format, static_cast<uint32_t>(ResourcePack::FORMAT_ARGB8888));
+  EXPECT_FALSE(blit_image->swizzled);
+
+  auto cubemap = pack.Find("texture_cubemap/cube_normals_object_space.png");
+  ASSERT_NE(cubemap, nullptr);
+  EXPECT_EQ(cubemap->format, static_cast<uint32_t>(ResourcePack::FORMAT_ABGR8888));
+  EXPECT_TRUE(cubemap->swizzled);
+
+  // Unlisted PNGs default to linear ABGR8888.
+  auto plasma = pack.Find("dxt_images/plasma_original.png");
+  ASSERT_NE(plasma, nullptr);
+  EXPECT_EQ(plasma->format, static_cast<uint32_t>(ResourcePack::FORMAT_ABGR8888));
+  EXPECT_FALSE(plasma->swizzled);
+
+  auto dxt5 = pack.Find("dxt_images/plasma_dxt5.dds");
+  ASSERT_NE(dxt5, nullptr);
+  EXPECT_EQ(dxt5->format, static_cast<uint32_t>(ResourcePack::FORMAT_DXT5));
+  EXPECT_GT(dxt5->levels, 1u);
+}
+
+TEST_F(ResourcePackTest, LoadFileMatchesLoad) {
+  const std::string pack_path = ::testing::TempDir() + "resource_pack_test_load_file.pack";
+  {
+    std::ofstream file(pack_path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(pack_bytes_.data()), static_cast<std::streamsize>(pack_bytes_.size()));
+  }
+
+  ResourcePack pack;
+  EXPECT_TRUE(pack.LoadFile(pack_path.c_str()));
+  std::remove(pack_path.c_str());
+  EXPECT_TRUE(pack.IsLoaded());
+  EXPECT_GT(pack.NumEntries(), 0u);
+
+  ResourcePack missing;
+  EXPECT_FALSE(missing.LoadFile((pack_path + ".missing").c_str()));
+  EXPECT_FALSE(missing.IsLoaded());
+}
+
+// Applies `corrupt` to a copy of the pack and checks that it is rejected.
+template <typename Corruption>
+static void ExpectRejected(const std::vector<uint8_t> &pack_bytes, Corruption corrupt) {
+  std::vector<uint8_t> data = pack_bytes;
+  corrupt(data);
+  ResourcePack pack;
+  EXPECT_FALSE(pack.Load(std::move(data)));
+  EXPECT_FALSE(pack.IsLoaded());
+  EXPECT_EQ(pack.NumEntries(), 0u);
+}
+
+static ResourcePack::Entry *FirstEntry(std::vector<uint8_t> &data) {
+  return reinterpret_cast<ResourcePack::Entry *>(data.data() + sizeof(ResourcePack::Header));
+}
+
+static ResourcePack::Header *GetHeader(std::vector<uint8_t> &data) {
+  return reinterpret_cast<ResourcePack::Header *>(data.data());
+}
+
+TEST_F(ResourcePackTest, RejectsMalformedPacks) {
+  ASSERT_GT(pack_bytes_.size(), sizeof(ResourcePack::Header));
+
+  ExpectRejected(pack_bytes_, [](std::vector<uint8_t> &data) { data.resize(sizeof(ResourcePack::Header) - 1); });
+  ExpectRejected(pack_bytes_, [](std::vector<uint8_t> &data) { data.pop_back(); });
+  ExpectRejected(pack_bytes_, [](std::vector<uint8_t> &data) { GetHeader(data)->magic ^= 1; });
+  ExpectRejected(pack_bytes_, [](std::vector<uint8_t> &data) { ++GetHeader(data)->version; });
+  ExpectRejected(pack_bytes_, [](std::vector<uint8_t> &data) { GetHeader(data)->num_entries = 0x10000000; });
+  ExpectRejected(pack_bytes_, [](std::vector<uint8_t> &data) { FirstEntry(data)->offset += 4; });
+  ExpectRejected(pack_bytes_, [](std::vector<uint8_t> &data) { FirstEntry(data)->offset = 0; });
+  ExpectRejected(pack_bytes_, [](std::vector<uint8_t> &data) { FirstEntry(data)->size = 0xFFFFFF00; });
+  ExpectRejected(pack_bytes_, [](std::vector<uint8_t> &data) {
+    memset(FirstEntry(data)->name, 'a', sizeof(FirstEntry(data)->name));
+  });
+
+  // An empty pack is valid.
+  ResourcePack::Header header{ResourcePack::kMagic, ResourcePack::kVersion, 0, sizeof(ResourcePack::Header)};
+  std::vector<uint8_t> empty(sizeof(header));
+  memcpy(empty.data(), &header, sizeof(header));
+  ResourcePack pack;
+  EXPECT_TRUE(pack.Load(std::move(empty)));
+  EXPECT_EQ(pack.NumEntries(), 0u);
+}
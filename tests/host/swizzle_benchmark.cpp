@@ -0,0 +1,57 @@
+#include <cstdio>
+#include <vector>
+
+#include "benchmark.h"
+#include "swizzle.h"
+#include "swizzle_reference.h"
+
+// Compares swizzle_box and unswizzle_box with the original per-pixel loops.
+HOST_BENCHMARK(Swizzle) {
+  struct Shape {
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+  };
+  const Shape shapes[] = {{1024, 1024, 1}, {640, 480, 1}, {64, 64, 64}};
+
+  printf("%-12s %4s %14s %14s %14s %14s\n", "shape", "bpp", "swz ref ms", "swz ms", "unswz ref ms", "unswz ms");
+  for (const auto &shape : shapes) {
+    for (uint32_t bpp : {1u, 2u, 4u, 8u}) {
+      const uint32_t row_pitch = shape.width * bpp;
+      const uint32_t slice_pitch = row_pitch * shape.height;
+      std::vector<uint8_t> linear(slice_pitch * shape.depth, 0x5A);
+      std::vector<uint8_t> swizzled(ReferenceSwizzledSize(shape.width, shape.height, shape.depth) * bpp);
+
+      const uint32_t repeats = 3;
+      const double swizzle_reference = TimeBest(
+          [&]() {
+            ReferenceSwizzleBox(linear.data(), shape.width, shape.height, shape.depth, swizzled.data(), row_pitch,
+                                slice_pitch, bpp);
+            KeepAlive(swizzled);
+          },
+          repeats);
+      const double swizzle = TimeBest([&]() {
+        swizzle_box(linear.data(), shape.width, shape.height, shape.depth, swizzled.data(), row_pitch, slice_pitch,
+                    bpp);
+        KeepAlive(swizzled);
+      });
+      const double unswizzle_reference = TimeBest(
+          [&]() {
+            ReferenceUnswizzleBox(swizzled.data(), shape.width, shape.height, shape.depth, linear.data(), row_pitch,
+                                  slice_pitch, bpp);
+            KeepAlive(linear);
+          },
+          repeats);
+      const double unswizzle = TimeBest([&]() {
+        unswizzle_box(swizzled.data(), shape.width, shape.height, shape.depth, linear.data(), row_pitch,
+                      slice_pitch, bpp);
+        KeepAlive(linear);
+      });
+
+      char label[32];
+      snprintf(label, sizeof(label), "%ux%ux%u", shape.width, shape.height, shape.depth);
+      printf("%-12s %4u %14.3f %14.3f %14.3f %14.3f\n", label, bpp, swizzle_reference * 1000.0, swizzle * 1000.0,
+             unswizzle_reference * 1000.0, unswizzle * 1000.0);
+    }
+  }
+}
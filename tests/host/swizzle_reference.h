@@ -0,0 +1,87 @@
+#ifndef NXDK_PGRAPH_TESTS_HOST_SWIZZLE_REFERENCE_H
+#define NXDK_PGRAPH_TESTS_HOST_SWIZZLE_REFERENCE_H
+
+#include <cstdint>
+#include <cstring>
+
+// The original per-pixel implementation of swizzle_box/unswizzle_box, used as the reference for the optimized kernels.
+
+struct ReferenceSwizzleMasks {
+  uint32_t x{0};
+  uint32_t y{0};
+  uint32_t z{0};
+
+  ReferenceSwizzleMasks(uint32_t width, uint32_t height, uint32_t depth) {
+    uint32_t bit = 1;
+    uint32_t mask_bit = 1;
+    bool done;
+    do {
+      done = true;
+      if (bit < width) {
+        x |= mask_bit;
+        mask_bit <<= 1;
+        done = false;
+      }
+      if (bit < height) {
+        y |= mask_bit;
+        mask_bit <<= 1;
+        done = false;
+      }
+      if (bit < depth) {
+        z |= mask_bit;
+        mask_bit <<= 1;
+        done = false;
+      }
+      bit <<= 1;
+    } while (!done);
+  }
+
+  static uint32_t Fill(uint32_t pattern, uint32_t value) {
+    uint32_t result = 0;
+    uint32_t bit = 1;
+    while (value) {
+      if (pattern & bit) {
+        result |= value & 1 ? bit : 0;
+        value >>= 1;
+      }
+      bit <<= 1;
+    }
+    return result;
+  }
+
+  uint32_t Offset(uint32_t px, uint32_t py, uint32_t pz) const { return Fill(x, px) | Fill(y, py) | Fill(z, pz); }
+};
+
+// Returns the number of pixels spanned by a swizzled box, which is padded to power of two dimensions.
+inline uint32_t ReferenceSwizzledSize(uint32_t width, uint32_t height, uint32_t depth) {
+  ReferenceSwizzleMasks masks(width, height, depth);
+  return (masks.x | masks.y | masks.z) + 1;
+}
+
+inline void ReferenceSwizzleBox(const uint8_t *src, uint32_t width, uint32_t height, uint32_t depth, uint8_t *dst,
+                                uint32_t row_pitch, uint32_t slice_pitch, uint32_t bytes_per_pixel) {
+  ReferenceSwizzleMasks masks(width, height, depth);
+  for (uint32_t z = 0; z < depth; ++z) {
+    for (uint32_t y = 0; y < height; ++y) {
+      for (uint32_t x = 0; x < width; ++x) {
+        memcpy(dst + masks.Offset(x, y, z) * bytes_per_pixel,
+               src + z * slice_pitch + y * row_pitch + x * bytes_per_pixel, bytes_per_pixel);
+      }
+    }
+  }
+}
+
+inline void ReferenceUnswizzleBox(const uint8_t *src, uint32_t width, uint32_t height, uint32_t depth, uint8_t *dst,
+                                  uint32_t row_pitch, uint32_t slice_pitch, uint32_t bytes_per_pixel) {
+  ReferenceSwizzleMasks masks(width, height, depth);
+  for (uint32_t z = 0; z < depth; ++z) {
+    for (uint32_t y = 0; y < height; ++y) {
+      for (uint32_t x = 0; x < width; ++x) {
+        memcpy(dst + z * slice_pitch + y * row_pitch + x * bytes_per_pixel,
+               src + masks.Offset(x, y, z) * bytes_per_pixel, bytes_per_pixel);
+      }
+    }
+  }
+}
+
+#endif  // NXDK_PGRAPH_TESTS_HOST_SWIZZLE_REFERENCE_H
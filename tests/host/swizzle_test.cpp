@@ -0,0 +1,148 @@
+#include "swizzle.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "swizzle_reference.h"
+
+struct SwizzleCase {
+  uint32_t width;
+  uint32_t height;
+  uint32_t depth;
+  uint32_t bytes_per_pixel;
+  // Extra bytes at the end of each linear row.
+  uint32_t row_padding;
+};
+
+static void PrintTo(const SwizzleCase &param, std::ostream *os) {
+  *os << param.width << "x" << param.height << "x" << param.depth << "@" << param.bytes_per_pixel << "+"
+      << param.row_padding;
+}
+
+static std::vector<uint8_t> MakePattern(size_t size) {
+  std::vector<uint8_t> ret(size);
+  uint32_t state = static_cast<uint32_t>(size);
+  for (auto &value : ret) {
+    state = state * 1664525 + 1013904223;
+    value = static_cast<uint8_t>(state >> 24);
+  }
+  return ret;
+}
+
+class SwizzleTest : public ::testing::TestWithParam<SwizzleCase> {};
+
+TEST_P(SwizzleTest, SwizzleMatchesReference) {
+  const auto &p = GetParam();
+  const uint32_t row_pitch = p.width * p.bytes_per_pixel + p.row_padding;
+  const uint32_t slice_pitch = row_pitch * p.height;
+  const auto linear = MakePattern(slice_pitch * p.depth);
+  const uint32_t swizzled_size = ReferenceSwizzledSize(p.width, p.height, p.depth) * p.bytes_per_pixel;
+
+  std::vector<uint8_t> expected(swizzled_size, 0xCD);
+  ReferenceSwizzleBox(linear.data(), p.width, p.height, p.depth, expected.data(), row_pitch, slice_pitch,
+                      p.bytes_per_pixel);
+  std::vector<uint8_t> actual(swizzled_size, 0xCD);
+  swizzle_box(linear.data(), p.width, p.height, p.depth, actual.data(), row_pitch, slice_pitch, p.bytes_per_pixel);
+  ASSERT_EQ(actual, expected);
+}
+
+TEST_P(SwizzleTest, UnswizzleMatchesReference) {
+  const auto &p = GetParam();
+  const uint32_t row_pitch = p.width * p.bytes_per_pixel + p.row_padding;
+  const uint32_t slice_pitch = row_pitch * p.height;
+  const auto swizzled = MakePattern(ReferenceSwizzledSize(p.width, p.height, p.depth) * p.bytes_per_pixel);
+
+  std::vector<uint8_t> expected(slice_pitch * p.depth, 0xCD);
+  ReferenceUnswizzleBox(swizzled.data(), p.width, p.height, p.depth, expected.data(), row_pitch, slice_pitch,
+                        p.bytes_per_pixel);
+  std::vector<uint8_t> actual(slice_pitch * p.depth, 0xCD);
+  unswizzle_box(swizzled.data(), p.width, p.height, p.depth, actual.data(), row_pitch, slice_pitch,
+                p.bytes_per_pixel);
+  ASSERT_EQ(actual, expected);
+}
+
+// Swizzling the slices of a volume one at a time from separate buffers must assemble the same box as swizzle_box.
+TEST_P(SwizzleTest, SliceMatchesReference) {
+  const auto &p = GetParam();
+  const uint32_t row_pitch = p.width * p.bytes_per_pixel + p.row_padding;
+  const uint32_t slice_pitch = row_pitch * p.height;
+  const auto linear = MakePattern(slice_pitch * p.depth);
+  const uint32_t swizzled_size = ReferenceSwizzledSize(p.width, p.height, p.depth) * p.bytes_per_pixel;
+
+  std::vector<uint8_t> expected(swizzled_size, 0xCD);
+  ReferenceSwizzleBox(linear.data(), p.width, p.height, p.depth, expected.data(), row_pitch, slice_pitch,
+                      p.bytes_per_pixel);
+
+  std::vector<uint8_t> actual(swizzled_size, 0xCD);
+  for (uint32_t slice = 0; slice < p.depth; ++slice) {
+    std::vector<uint8_t> slice_data(linear.begin() + slice * slice_pitch, linear.begin() + (slice + 1) * slice_pitch);
+    swizzle_box_slice(slice_data.data(), p.width, p.height, p.depth, slice, actual.data(), row_pitch,
+                      p.bytes_per_pixel);
+  }
+  ASSERT_EQ(actual, expected);
+}
+
+// A single slice only writes the texels that belong to it.
+TEST_P(SwizzleTest, SliceLeavesOtherSlicesUntouched) {
+  const auto &p = GetParam();
+  const uint32_t row_pitch = p.width * p.bytes_per_pixel + p.row_padding;
+  const uint32_t slice_pitch = row_pitch * p.height;
+  const uint32_t slice = p.depth / 2;
+  const auto slice_data = MakePattern(slice_pitch);
+  const uint32_t swizzled_size = ReferenceSwizzledSize(p.width, p.height, p.depth) * p.bytes_per_pixel;
+
+  std::vector<uint8_t> linear(slice_pitch * p.depth, 0xCD);
+  std::copy(slice_data.begin(), slice_data.end(), linear.begin() + slice * slice_pitch);
+  std::vector<uint8_t> expected(swizzled_size, 0xCD);
+  ReferenceSwizzleBox(linear.data(), p.width, p.height, p.depth, expected.data(), row_pitch, slice_pitch,
+                      p.bytes_per_pixel);
+
+  std::vector<uint8_t> actual(swizzled_size, 0xCD);
+  swizzle_box_slice(slice_data.data(), p.width, p.height, p.depth, slice, actual.data(), row_pitch,
+                    p.bytes_per_pixel);
+  ASSERT_EQ(actual, expected);
+}
+
+static std::vector<SwizzleCase> MakeCases() {
+  std::vector<SwizzleCase> ret;
+  // Power of two rectangles, including the degenerate 1 and 2 pixel edges that skip the tiled path.
+  for (uint32_t width = 1; width <= 256; width *= 2) {
+    for (uint32_t height = 1; height <= 256; height *= 4) {
+      for (uint32_t bpp : {1, 2, 3, 4, 8, 16}) {
+        ret.push_back({width, height, 1, bpp, 0});
+      }
+    }
+  }
+  // Padded pitches and non power of two sizes.
+  for (uint32_t bpp : {1, 2, 4, 8}) {
+    ret.push_back({64, 64, 1, bpp, 12});
+    ret.push_back({640, 480, 1, bpp, 0});
+    ret.push_back({3, 5, 1, bpp, 0});
+    ret.push_back({17, 33, 1, bpp, 4});
+  }
+  // Volumes.
+  for (uint32_t bpp : {1, 2, 4}) {
+    ret.push_back({16, 16, 16, bpp, 0});
+    ret.push_back({32, 8, 4, bpp, 0});
+    ret.push_back({4, 4, 64, bpp, 0});
+    ret.push_back({8, 16, 2, bpp, 8});
+    ret.push_back({5, 3, 6, bpp, 0});
+    ret.push_back({1, 1, 256, bpp, 0});
+  }
+  return ret;
+}
+
+INSTANTIATE_TEST_SUITE_P(Shapes, SwizzleTest, ::testing::ValuesIn(MakeCases()));
+
+TEST(Swizzle, RectRoundTrips) {
+  const uint32_t pitch = 128 * 4;
+  const auto linear = MakePattern(pitch * 64);
+  std::vector<uint8_t> swizzled(linear.size());
+  std::vector<uint8_t> restored(linear.size());
+  swizzle_rect(linear.data(), 128, 64, swizzled.data(), pitch, 4);
+  unswizzle_rect(swizzled.data(), 128, 64, restored.data(), pitch, 4);
+  EXPECT_EQ(restored, linear);
+  EXPECT_NE(swizzled, linear);
+}
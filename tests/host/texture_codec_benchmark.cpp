@@ -0,0 +1,71 @@
+#include <cstdio>
+#include <vector>
+
+#include "benchmark.h"
+#include "image_util.h"
+#include "texture_codec.h"
+
+static constexpr uint32_t kSize = 512;
+
+static const struct {
+  TextureCodecFormat format;
+  const char *name;
+} kFormats[] = {
+    {TEXTURE_CODEC_A8B8G8R8, "A8B8G8R8"},
+    {TEXTURE_CODEC_R8G8B8A8, "R8G8B8A8"},
+    {TEXTURE_CODEC_A8R8G8B8, "A8R8G8B8"},
+    {TEXTURE_CODEC_X8R8G8B8, "X8R8G8B8"},
+    {TEXTURE_CODEC_B8G8R8A8, "B8G8R8A8"},
+    {TEXTURE_CODEC_R5G6B5, "R5G6B5"},
+    {TEXTURE_CODEC_A1R5G5B5, "A1R5G5B5"},
+    {TEXTURE_CODEC_X1R5G5B5, "X1R5G5B5"},
+    {TEXTURE_CODEC_A4R4G4B4, "A4R4G4B4"},
+    {TEXTURE_CODEC_Y8, "Y8"},
+    {TEXTURE_CODEC_AY8, "AY8"},
+    {TEXTURE_CODEC_A8Y8, "A8Y8"},
+    {TEXTURE_CODEC_Y16, "Y16"},
+    {TEXTURE_CODEC_G8B8, "G8B8"},
+    {TEXTURE_CODEC_R8B8, "R8B8"},
+    {TEXTURE_CODEC_YUY2, "YUY2"},
+    {TEXTURE_CODEC_UYVY, "UYVY"},
+    {TEXTURE_CODEC_DEPTH_Y16_FIXED, "D_Y16_FIXED"},
+    {TEXTURE_CODEC_DEPTH_Y16_FLOAT, "D_Y16_FLOAT"},
+    {TEXTURE_CODEC_DEPTH_X8_Y24_FIXED, "D_X8Y24_FIXED"},
+    {TEXTURE_CODEC_DEPTH_X8_Y24_FLOAT, "D_X8Y24_FLOAT"},
+    {TEXTURE_CODEC_DXT1, "DXT1"},
+    {TEXTURE_CODEC_DXT3, "DXT3"},
+    {TEXTURE_CODEC_DXT5, "DXT5"},
+    {TEXTURE_CODEC_I8_A8R8G8B8, "I8_A8R8G8B8"},
+};
+
+// Reports the encode and decode throughput of every format in megapixels per second.
+HOST_BENCHMARK(TextureCodec512x512) {
+  const HostImage image = MakeGradientImage(kSize, kSize);
+  std::vector<uint8_t> encoded(kSize * kSize * 4);
+  std::vector<uint32_t> decoded(kSize * kSize);
+  uint32_t palette[256];
+
+#ifdef __SSE__
+  printf("%-14s %12s %12s   (SSE)\n", "format", "encode MP/s", "decode MP/s");
+#else
+  printf("%-14s %12s %12s\n", "format", "encode MP/s", "decode MP/s");
+#endif
+  for (const auto &entry : kFormats) {
+    const uint32_t pitch = GetTextureCodecPitch(entry.format, kSize);
+    // The quantizer is orders of magnitude slower than the other encoders.
+    const uint32_t repeats = entry.format == TEXTURE_CODEC_I8_A8R8G8B8 ? 1 : 5;
+    const double encode = TimeBest(
+        [&]() {
+          EncodeTexture(encoded.data(), pitch, image.pixels.data(), kSize * 4, kSize, kSize, entry.format, palette);
+          KeepAlive(encoded);
+        },
+        repeats);
+    const double decode = TimeBest([&]() {
+      DecodeTexture(decoded.data(), kSize * 4, encoded.data(), pitch, kSize, kSize, entry.format, palette);
+      KeepAlive(decoded);
+    });
+
+    const double megapixels = kSize * kSize / 1e6;
+    printf("%-14s %12.1f %12.1f\n", entry.name, megapixels / encode, megapixels / decode);
+  }
+}
@@ -0,0 +1,225 @@
+#include "texture_codec.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "image_util.h"
+#include "pixel_packer.h"
+
+// Odd dimensions exercise the scalar tails of the vectorized rows.
+static constexpr uint32_t kWidth = 38;
+static constexpr uint32_t kHeight = 9;
+
+enum RoundTrip {
+  // Encoding the decoded image reproduces the encoding exactly.
+  ROUND_TRIP_STABLE,
+  // Decodes to the gray level of the source luminance (within 1, as the float formats round).
+  ROUND_TRIP_LUMINANCE,
+  // Decodes to within `min_psnr` of the source.
+  ROUND_TRIP_LOSSY,
+};
+
+struct CodecCase {
+  TextureCodecFormat format;
+  const char *name;
+  RoundTrip round_trip;
+  double min_psnr;
+};
+
+static void PrintTo(const CodecCase &param, std::ostream *os) { *os << param.name; }
+
+static const CodecCase kCases[] = {
+    {TEXTURE_CODEC_A8B8G8R8, "A8B8G8R8", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_R8G8B8A8, "R8G8B8A8", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_A8R8G8B8, "A8R8G8B8", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_X8R8G8B8, "X8R8G8B8", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_B8G8R8A8, "B8G8R8A8", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_R5G6B5, "R5G6B5", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_A1R5G5B5, "A1R5G5B5", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_X1R5G5B5, "X1R5G5B5", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_A4R4G4B4, "A4R4G4B4", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_Y8, "Y8", ROUND_TRIP_LUMINANCE, 0.0},
+    {TEXTURE_CODEC_AY8, "AY8", ROUND_TRIP_LUMINANCE, 0.0},
+    {TEXTURE_CODEC_A8Y8, "A8Y8", ROUND_TRIP_LUMINANCE, 0.0},
+    {TEXTURE_CODEC_Y16, "Y16", ROUND_TRIP_LUMINANCE, 0.0},
+    {TEXTURE_CODEC_G8B8, "G8B8", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_R8B8, "R8B8", ROUND_TRIP_STABLE, 0.0},
+    {TEXTURE_CODEC_YUY2, "YUY2", ROUND_TRIP_LOSSY, 30.0},
+    {TEXTURE_CODEC_UYVY, "UYVY", ROUND_TRIP_LOSSY, 30.0},
+    {TEXTURE_CODEC_DEPTH_Y16_FIXED, "D_Y16_FIXED", ROUND_TRIP_LUMINANCE, 0.0},
+    {TEXTURE_CODEC_DEPTH_Y16_FLOAT, "D_Y16_FLOAT", ROUND_TRIP_LUMINANCE, 0.0},
+    {TEXTURE_CODEC_DEPTH_X8_Y24_FIXED, "D_X8Y24_FIXED", ROUND_TRIP_LUMINANCE, 0.0},
+    {TEXTURE_CODEC_DEPTH_X8_Y24_FLOAT, "D_X8Y24_FLOAT", ROUND_TRIP_LUMINANCE, 0.0},
+    {TEXTURE_CODEC_DXT1, "DXT1", ROUND_TRIP_LOSSY, 30.0},
+    {TEXTURE_CODEC_DXT3, "DXT3", ROUND_TRIP_LOSSY, 30.0},
+    {TEXTURE_CODEC_DXT5, "DXT5", ROUND_TRIP_LOSSY, 30.0},
+    {TEXTURE_CODEC_I8_A8R8G8B8, "I8_A8R8G8B8", ROUND_TRIP_LOSSY, 30.0},
+};
+
+// The luminance computed by the encoders (and TextureStage::SetTexture), which truncates.
+static uint32_t Luminance(uint32_t color) {
+  return static_cast<uint32_t>(0.299f * (color & 0xFF) + 0.587f * ((color >> 8) & 0xFF) +
+                               0.114f * ((color >> 16) & 0xFF));
+}
+
+class TextureCodecTest : public ::testing::TestWithParam<CodecCase> {
+ protected:
+  // Encodes `source` into a buffer with a padded pitch (for uncompressed formats), returning the pitch.
+  uint32_t Encode(const HostImage &source, std::vector<uint8_t> &encoded) {
+    const auto format = GetParam().format;
+    const uint32_t pitch = GetTextureCodecPitch(format, source.width) + (IsCompressed() ? 0 : 4);
+    encoded.assign(pitch * source.height + GetTextureCodecSize(format, source.width, source.height), 0xCD);
+    EXPECT_EQ(
+        EncodeTexture(encoded.data(), pitch, source.pixels.data(), source.width * 4, source.width, source.height,
+                      format, palette_),
+        0);
+    return pitch;
+  }
+
+  HostImage Decode(const std::vector<uint8_t> &encoded, uint32_t pitch, uint32_t width, uint32_t height) {
+    HostImage ret{width, height, std::vector<uint32_t>(width * height)};
+    EXPECT_EQ(DecodeTexture(ret.pixels.data(), width * 4, encoded.data(), pitch, width, height, GetParam().format,
+                            palette_),
+              0);
+    return ret;
+  }
+
+  bool IsCompressed() const {
+    const auto format = GetParam().format;
+    return format == TEXTURE_CODEC_DXT1 || format == TEXTURE_CODEC_DXT3 || format == TEXTURE_CODEC_DXT5;
+  }
+
+  uint32_t palette_[256];
+};
+
+TEST_P(TextureCodecTest, RoundTrip) {
+  const auto &param = GetParam();
+  // Formats without alpha decode as opaque, so only opaque sources can be compared directly.
+  HostImage source = MakeGradientImage(kWidth, kHeight);
+  for (auto &pixel : source.pixels) {
+    pixel |= 0xFF000000;
+  }
+
+  std::vector<uint8_t> encoded;
+  const uint32_t pitch = Encode(source, encoded);
+  const HostImage decoded = Decode(encoded, pitch, kWidth, kHeight);
+
+  switch (param.round_trip) {
+    case ROUND_TRIP_STABLE: {
+      // Decoding loses exactly what encoding discarded, so the decoded image encodes to the same texels.
+      std::vector<uint8_t> reencoded;
+      Encode(decoded, reencoded);
+      const uint32_t row_size = GetTextureCodecPitch(param.format, kWidth);
+      for (uint32_t y = 0; y < kHeight; ++y) {
+        ASSERT_EQ(memcmp(encoded.data() + y * pitch, reencoded.data() + y * pitch, row_size), 0) << "row " << y;
+      }
+    } break;
+
+    case ROUND_TRIP_LUMINANCE:
+      for (uint32_t i = 0; i < decoded.pixels.size(); ++i) {
+        const uint32_t expected = Luminance(source.pixels[i]);
+        const uint32_t gray = decoded.pixels[i] & 0xFF;
+        ASSERT_EQ((decoded.pixels[i] >> 8) & 0xFFFF, gray | (gray << 8)) << "pixel " << i;
+        ASSERT_LE(gray > expected ? gray - expected : expected - gray, 1u) << "pixel " << i;
+      }
+      break;
+
+    case ROUND_TRIP_LOSSY:
+      EXPECT_GE(CompareImages(decoded.pixels.data(), source.pixels.data(), kWidth * kHeight).psnr, param.min_psnr);
+      break;
+  }
+}
+
+// The bytes beyond the populated width of each row are left untouched.
+TEST_P(TextureCodecTest, EncodeHonorsPitch) {
+  if (IsCompressed()) {
+    GTEST_SKIP() << "Compressed rows are written contiguously";
+  }
+  const auto format = GetParam().format;
+  std::vector<uint8_t> encoded;
+  const uint32_t pitch = Encode(MakeNoiseImage(kWidth, kHeight), encoded);
+  const uint32_t row_size = GetTextureCodecPitch(format, kWidth);
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    for (uint32_t x = row_size; x < pitch; ++x) {
+      ASSERT_EQ(encoded[y * pitch + x], 0xCD) << "row " << y;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, TextureCodecTest, ::testing::ValuesIn(kCases),
+                         [](const ::testing::TestParamInfo<CodecCase> &info) { return std::string(info.param.name); });
+
+// Packed RGB formats must match PixelPacker pixel for pixel, whether or not a vectorized path handles the row.
+TEST(TextureCodec, PackedFormatsMatchPixelPacker) {
+  const HostImage source = MakeNoiseImage(kWidth, kHeight);
+  for (const auto &param : kCases) {
+    SCOPED_TRACE(param.name);
+    WithPixelPacker(param.format, [&](auto packer) {
+      typedef decltype(packer) Packer;
+      typedef typename Packer::Pixel Pixel;
+      std::vector<Pixel> encoded(kWidth * kHeight);
+      ASSERT_EQ(EncodeTexture(reinterpret_cast<uint8_t *>(encoded.data()), kWidth * sizeof(Pixel),
+                              source.pixels.data(), kWidth * 4, kWidth, kHeight, param.format),
+                0);
+      for (uint32_t i = 0; i < encoded.size(); ++i) {
+        ASSERT_EQ(encoded[i], Packer::Pack(source.pixels[i])) << "pixel " << i;
+      }
+
+      // Decode arbitrary texels, not just those produced by the encoder.
+      std::vector<Pixel> texels(kWidth * kHeight);
+      memcpy(texels.data(), source.pixels.data(), texels.size() * sizeof(Pixel));
+      std::vector<uint32_t> decoded(kWidth * kHeight);
+      ASSERT_EQ(DecodeTexture(decoded.data(), kWidth * 4, reinterpret_cast<const uint8_t *>(texels.data()),
+                              kWidth * sizeof(Pixel), kWidth, kHeight, param.format),
+                0);
+      const bool opaque = param.format == TEXTURE_CODEC_X8R8G8B8 || param.format == TEXTURE_CODEC_X1R5G5B5;
+      for (uint32_t i = 0; i < decoded.size(); ++i) {
+        ASSERT_EQ(decoded[i], Packer::Unpack(texels[i]) | (opaque ? 0xFF000000 : 0)) << "pixel " << i;
+      }
+    });
+  }
+}
+
+// The 8888 layouts only reorder components, so they round trip exactly.
+TEST(TextureCodec, EightBitFormatsAreLossless) {
+  const HostImage source = MakeNoiseImage(kWidth, kHeight);
+  for (auto format : {TEXTURE_CODEC_A8B8G8R8, TEXTURE_CODEC_R8G8B8A8, TEXTURE_CODEC_A8R8G8B8, TEXTURE_CODEC_B8G8R8A8,
+                      TEXTURE_CODEC_X8R8G8B8}) {
+    SCOPED_TRACE(format);
+    std::vector<uint32_t> encoded(kWidth * kHeight);
+    std::vector<uint32_t> decoded(kWidth * kHeight);
+    ASSERT_EQ(EncodeTexture(reinterpret_cast<uint8_t *>(encoded.data()), kWidth * 4, source.pixels.data(), kWidth * 4,
+                            kWidth, kHeight, format),
+              0);
+    ASSERT_EQ(DecodeTexture(decoded.data(), kWidth * 4, reinterpret_cast<const uint8_t *>(encoded.data()), kWidth * 4,
+                            kWidth, kHeight, format),
+              0);
+
+    const uint32_t alpha = format == TEXTURE_CODEC_X8R8G8B8 ? 0xFF000000 : 0;
+    for (uint32_t i = 0; i < decoded.size(); ++i) {
+      ASSERT_EQ(decoded[i], source.pixels[i] | alpha) << "pixel " << i;
+    }
+  }
+}
+
+TEST(TextureCodec, Sizes) {
+  EXPECT_EQ(GetTextureCodecPitch(TEXTURE_CODEC_A8R8G8B8, 10), 40u);
+  EXPECT_EQ(GetTextureCodecPitch(TEXTURE_CODEC_R5G6B5, 10), 20u);
+  EXPECT_EQ(GetTextureCodecPitch(TEXTURE_CODEC_Y8, 10), 10u);
+  EXPECT_EQ(GetTextureCodecPitch(TEXTURE_CODEC_DXT1, 10), 24u);
+  EXPECT_EQ(GetTextureCodecPitch(TEXTURE_CODEC_DXT5, 10), 48u);
+  EXPECT_EQ(GetTextureCodecSize(TEXTURE_CODEC_DXT1, 10, 5), 48u);
+  EXPECT_EQ(GetTextureCodecSize(TEXTURE_CODEC_A8Y8, 10, 5), 100u);
+  EXPECT_EQ(GetTextureCodecBitsPerPixel(TEXTURE_CODEC_NONE), 0u);
+}
+
+TEST(TextureCodec, RejectsInvalidArguments) {
+  uint32_t source[16] = {};
+  uint8_t dest[64];
+  EXPECT_NE(EncodeTexture(dest, 16, source, 16, 4, 4, TEXTURE_CODEC_NONE), 0);
+  EXPECT_NE(EncodeTexture(dest, 16, source, 16, 4, 4, TEXTURE_CODEC_I8_A8R8G8B8), 0);
+  EXPECT_NE(DecodeTexture(source, 16, dest, 16, 4, 4, TEXTURE_CODEC_NONE), 0);
+  EXPECT_NE(DecodeTexture(source, 16, dest, 16, 4, 4, TEXTURE_CODEC_I8_A8R8G8B8), 0);
+}
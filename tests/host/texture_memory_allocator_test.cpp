@@ -0,0 +1,182 @@
+#include "texture_memory_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using Handle = TextureMemoryAllocator::Handle;
+static constexpr Handle kInvalid = TextureMemoryAllocator::kInvalidHandle;
+
+TEST(TextureMemoryAllocatorTest, AllocationsUseDefaultAlignment) {
+  TextureMemoryAllocator allocator(1024);
+  const Handle a = allocator.Allocate(1);
+  const Handle b = allocator.Allocate(1, 16);
+  ASSERT_NE(a, kInvalid);
+  ASSERT_NE(b, kInvalid);
+  EXPECT_NE(a, b);
+
+  EXPECT_EQ(allocator.GetOffset(a), 0u);
+  EXPECT_EQ(allocator.GetSize(a), 1u);
+  // Alignments below the hardware minimum are raised to it.
+  EXPECT_EQ(allocator.GetOffset(b), 128u);
+}
+
+TEST(TextureMemoryAllocatorTest, StricterAlignmentLeavesPaddingFree) {
+  TextureMemoryAllocator allocator(0x4000);
+  const Handle a = allocator.Allocate(100);
+  const Handle b = allocator.Allocate(200, 0x1000);
+  ASSERT_NE(b, kInvalid);
+  EXPECT_EQ(allocator.GetOffset(b), 0x1000u);
+
+  auto stats = allocator.GetStats();
+  EXPECT_EQ(stats.num_allocations, 2u);
+  EXPECT_EQ(stats.allocated_bytes, 300u);
+  EXPECT_EQ(stats.num_free_blocks, 2u);
+  EXPECT_EQ(stats.free_bytes, 0x4000u - 300u);
+
+  // The padding before b is used by the next allocation that fits in it.
+  const Handle c = allocator.Allocate(0x100);
+  EXPECT_EQ(allocator.GetOffset(c), 128u);
+  EXPECT_LT(allocator.GetOffset(c) + allocator.GetSize(c), allocator.GetOffset(b));
+  EXPECT_NE(allocator.GetOffset(a), allocator.GetOffset(c));
+}
+
+TEST(TextureMemoryAllocatorTest, RejectsInvalidRequests) {
+  TextureMemoryAllocator allocator(1024);
+  EXPECT_EQ(allocator.Allocate(0), kInvalid);
+  EXPECT_EQ(allocator.Allocate(16, 0), kInvalid);
+  EXPECT_EQ(allocator.Allocate(16, 384), kInvalid);
+  EXPECT_EQ(allocator.Allocate(1025), kInvalid);
+  EXPECT_EQ(allocator.GetStats().num_allocations, 0u);
+
+  // Freeing an unknown handle is ignored.
+  allocator.Free(kInvalid);
+  allocator.Free(1234);
+  EXPECT_EQ(allocator.GetStats().free_bytes, 1024u);
+}
+
+TEST(TextureMemoryAllocatorTest, FreedSpaceIsReused) {
+  TextureMemoryAllocator allocator(1024);
+  const Handle a = allocator.Allocate(256);
+  const Handle b = allocator.Allocate(256);
+  const Handle c = allocator.Allocate(256);
+  const Handle d = allocator.Allocate(256);
+  ASSERT_NE(d, kInvalid);
+  EXPECT_EQ(allocator.Allocate(1), kInvalid);
+
+  allocator.Free(b);
+  EXPECT_FALSE(allocator.IsValid(b));
+  EXPECT_TRUE(allocator.IsValid(a));
+
+  // First fit places the new allocation in the hole left by b, under a new handle.
+  const Handle e = allocator.Allocate(200);
+  ASSERT_NE(e, kInvalid);
+  EXPECT_NE(e, b);
+  EXPECT_EQ(allocator.GetOffset(e), 256u);
+  EXPECT_EQ(allocator.GetOffset(c), 512u);
+}
+
+TEST(TextureMemoryAllocatorTest, FreeCoalescesNeighbors) {
+  TextureMemoryAllocator allocator(1024);
+  const Handle a = allocator.Allocate(256);
+  const Handle b = allocator.Allocate(256);
+  const Handle c = allocator.Allocate(256);
+
+  allocator.Free(a);
+  allocator.Free(c);
+  EXPECT_EQ(allocator.GetStats().num_free_blocks, 2u);
+
+  // Freeing b merges it with the blocks on both sides.
+  allocator.Free(b);
+  const auto stats = allocator.GetStats();
+  EXPECT_EQ(stats.num_allocations, 0u);
+  EXPECT_EQ(stats.num_free_blocks, 1u);
+  EXPECT_EQ(stats.largest_free_block, 1024u);
+  EXPECT_EQ(allocator.GetOffset(allocator.Allocate(1024)), 0u);
+}
+
+// Freeing every other allocation leaves enough free bytes for a larger texture but no block large enough to hold it,
+// until the allocator is compacted.
+TEST(TextureMemoryAllocatorTest, CompactUndoesFragmentation) {
+  static constexpr uint32_t kRegionSize = 1024;
+  static constexpr uint32_t kBlockSize = 128;
+  TextureMemoryAllocator allocator(kRegionSize);
+  std::vector<uint8_t> memory(kRegionSize, 0);
+
+  std::vector<Handle> handles;
+  for (uint32_t i = 0; i < kRegionSize / kBlockSize; ++i) {
+    const Handle handle = allocator.Allocate(kBlockSize);
+    ASSERT_NE(handle, kInvalid);
+    memset(memory.data() + allocator.GetOffset(handle), static_cast<int>(handle), kBlockSize);
+    handles.push_back(handle);
+  }
+
+  std::vector<Handle> kept;
+  for (uint32_t i = 0; i < handles.size(); ++i) {
+    if (i & 0x01) {
+      allocator.Free(handles[i]);
+    } else {
+      kept.push_back(handles[i]);
+    }
+  }
+
+  auto stats = allocator.GetStats();
+  EXPECT_EQ(stats.free_bytes, kRegionSize / 2);
+  EXPECT_EQ(stats.largest_free_block, kBlockSize);
+  EXPECT_EQ(allocator.Allocate(kBlockSize * 2), kInvalid);
+
+  uint32_t num_callbacks = 0;
+  const uint32_t num_moved = allocator.Compact([&](uint32_t dest, uint32_t source, uint32_t size) {
+    EXPECT_LT(dest, source);
+    memmove(memory.data() + dest, memory.data() + source, size);
+    ++num_callbacks;
+  });
+  // The first allocation is already in place.
+  EXPECT_EQ(num_moved, kept.size() - 1);
+  EXPECT_EQ(num_callbacks, num_moved);
+
+  for (uint32_t i = 0; i < kept.size(); ++i) {
+    ASSERT_TRUE(allocator.IsValid(kept[i]));
+    const uint32_t offset = allocator.GetOffset(kept[i]);
+    EXPECT_EQ(offset, i * kBlockSize);
+    for (uint32_t byte = 0; byte < kBlockSize; ++byte) {
+      ASSERT_EQ(memory[offset + byte], static_cast<uint8_t>(kept[i])) << "allocation " << i << " byte " << byte;
+    }
+  }
+
+  stats = allocator.GetStats();
+  EXPECT_EQ(stats.num_free_blocks, 1u);
+  EXPECT_EQ(stats.largest_free_block, kRegionSize / 2);
+
+  const Handle large = allocator.Allocate(kBlockSize * 4);
+  ASSERT_NE(large, kInvalid);
+  EXPECT_EQ(allocator.GetOffset(large), kRegionSize / 2);
+}
+
+TEST(TextureMemoryAllocatorTest, CompactPreservesAlignment) {
+  TextureMemoryAllocator allocator(0x4000);
+  const Handle a = allocator.Allocate(0x100);
+  const Handle b = allocator.Allocate(0x100);
+  const Handle aligned = allocator.Allocate(0x100, 0x1000);
+  ASSERT_EQ(allocator.GetOffset(aligned), 0x1000u);
+  allocator.Free(a);
+
+  allocator.Compact([](uint32_t, uint32_t, uint32_t) {});
+  EXPECT_EQ(allocator.GetOffset(b), 0u);
+  EXPECT_EQ(allocator.GetOffset(aligned), 0x1000u);
+
+  // The padding needed to keep the aligned allocation in place is returned to the free list.
+  const auto stats = allocator.GetStats();
+  EXPECT_EQ(stats.num_free_blocks, 2u);
+  EXPECT_EQ(stats.free_bytes, 0x4000u - 0x200u);
+}
+
+TEST(TextureMemoryAllocatorTest, ResetDiscardsAllocations) {
+  TextureMemoryAllocator allocator(1024);
+  const Handle a = allocator.Allocate(512);
+  allocator.Reset(2048);
+  EXPECT_FALSE(allocator.IsValid(a));
+  EXPECT_EQ(allocator.GetRegionSize(), 2048u);
+  EXPECT_EQ(allocator.GetStats().largest_free_block, 2048u);
+}
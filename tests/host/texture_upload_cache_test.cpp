@@ -0,0 +1,114 @@
+#include "texture_upload_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(TextureUploadCacheTest, LookupMatchesOffsetAndKey) {
+  TextureUploadCache cache;
+  cache.Insert(0x1000, 0x100, 42);
+
+  EXPECT_TRUE(cache.Lookup(0x1000, 42));
+  EXPECT_FALSE(cache.Lookup(0x1000, 43));
+  EXPECT_FALSE(cache.Lookup(0x1004, 42));
+  EXPECT_EQ(cache.GetStats().hits, 1u);
+  EXPECT_EQ(cache.GetStats().misses, 2u);
+}
+
+TEST(TextureUploadCacheTest, InsertDiscardsOverlappingEntries) {
+  TextureUploadCache cache;
+  cache.Insert(0x0000, 0x100, 1);
+  cache.Insert(0x0100, 0x100, 2);
+  cache.Insert(0x0200, 0x100, 3);
+
+  // Overlaps the tail of the first entry and the head of the second.
+  cache.Insert(0x00F0, 0x20, 4);
+
+  EXPECT_FALSE(cache.Lookup(0x0000, 1));
+  EXPECT_FALSE(cache.Lookup(0x0100, 2));
+  EXPECT_TRUE(cache.Lookup(0x0200, 3));
+  EXPECT_TRUE(cache.Lookup(0x00F0, 4));
+  EXPECT_EQ(cache.NumEntries(), 2u);
+}
+
+// Entries cover only the bytes actually written, so small uploads packed into a region do not evict each other.
+TEST(TextureUploadCacheTest, AdjacentEntriesSurvive) {
+  TextureUploadCache cache;
+  cache.Insert(0x0000, 0x40, 1);
+  cache.Insert(0x0040, 0x40, 2);
+
+  EXPECT_TRUE(cache.Lookup(0x0000, 1));
+  EXPECT_TRUE(cache.Lookup(0x0040, 2));
+}
+
+TEST(TextureUploadCacheTest, InvalidateRegion) {
+  TextureUploadCache cache;
+  cache.Insert(0x0000, 0x100, 1);
+  cache.Insert(0x0100, 0x100, 2);
+
+  cache.Invalidate(0x00FF, 1);
+  EXPECT_FALSE(cache.Lookup(0x0000, 1));
+  EXPECT_TRUE(cache.Lookup(0x0100, 2));
+
+  // Empty and non-overlapping regions leave entries alone.
+  cache.Invalidate(0x0200, 0x100);
+  cache.Invalidate(0x0150, 0);
+  EXPECT_TRUE(cache.Lookup(0x0100, 2));
+
+  cache.Invalidate();
+  EXPECT_EQ(cache.NumEntries(), 0u);
+}
+
+TEST(TextureUploadCacheTest, InvalidateNearAddressLimit) {
+  TextureUploadCache cache;
+  cache.Insert(0xFFFFFF00, 0x100, 1);
+
+  cache.Invalidate(0xFFFFFFF0, 0x100);
+  EXPECT_FALSE(cache.Lookup(0xFFFFFF00, 1));
+}
+
+TEST(TextureUploadCacheTest, EvictsLeastRecentlyUsed) {
+  TextureUploadCache cache(3);
+  cache.Insert(0x0000, 0x10, 1);
+  cache.Insert(0x0100, 0x10, 2);
+  cache.Insert(0x0200, 0x10, 3);
+
+  // Touch the oldest entry so that the second becomes the eviction candidate.
+  EXPECT_TRUE(cache.Lookup(0x0000, 1));
+  cache.Insert(0x0300, 0x10, 4);
+
+  EXPECT_EQ(cache.NumEntries(), 3u);
+  EXPECT_TRUE(cache.Lookup(0x0000, 1));
+  EXPECT_FALSE(cache.Lookup(0x0100, 2));
+  EXPECT_TRUE(cache.Lookup(0x0200, 3));
+  EXPECT_TRUE(cache.Lookup(0x0300, 4));
+}
+
+TEST(TextureUploadCacheTest, ZeroCapacityNeverHits) {
+  TextureUploadCache cache(0);
+  cache.Insert(0x0000, 0x10, 1);
+
+  EXPECT_EQ(cache.NumEntries(), 0u);
+  EXPECT_FALSE(cache.Lookup(0x0000, 1));
+}
+
+TEST(TextureUploadCacheTest, HashDependsOnContentAndSeed) {
+  std::vector<uint8_t> data(37);
+  for (uint32_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+
+  const uint64_t hash = TextureUploadCache::Hash(data.data(), data.size());
+  EXPECT_EQ(hash, TextureUploadCache::Hash(data.data(), data.size()));
+  EXPECT_NE(hash, TextureUploadCache::Hash(data.data(), data.size(), 1));
+  EXPECT_NE(hash, TextureUploadCache::Hash(data.data(), data.size() - 1));
+
+  // Every byte, including the unaligned tail, contributes.
+  for (uint32_t i = 0; i < data.size(); ++i) {
+    data[i] ^= 0x01;
+    EXPECT_NE(hash, TextureUploadCache::Hash(data.data(), data.size())) << "byte " << i;
+    data[i] ^= 0x01;
+  }
+
+  EXPECT_NE(TextureUploadCache::Hash(1, hash), TextureUploadCache::Hash(2, hash));
+}
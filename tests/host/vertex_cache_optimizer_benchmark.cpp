@@ -0,0 +1,38 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+#include "benchmark.h"
+#include "vertex_cache_optimizer.h"
+
+// Reports the reorder time and the simulated ACMR before and after Tipsify for shuffled grids of increasing size.
+HOST_BENCHMARK(TipsifyShuffledGrid) {
+  printf("%10s %10s %14s %14s %10s\n", "grid", "triangles", "shuffled ACMR", "optimized ACMR", "ms");
+
+  for (uint32_t size : {32u, 128u, 512u}) {
+    std::vector<uint32_t> indices;
+    const uint32_t stride = size + 1;
+    for (uint32_t y = 0; y < size; ++y) {
+      for (uint32_t x = 0; x < size; ++x) {
+        const uint32_t top_left = y * stride + x;
+        indices.insert(indices.end(), {top_left, top_left + 1, top_left + stride});
+        indices.insert(indices.end(), {top_left + 1, top_left + stride + 1, top_left + stride});
+      }
+    }
+
+    std::mt19937 rng(size);
+    const uint32_t num_triangles = indices.size() / 3;
+    for (uint32_t i = num_triangles - 1; i > 0; --i) {
+      const uint32_t j = rng() % (i + 1);
+      std::swap_ranges(indices.begin() + i * 3, indices.begin() + i * 3 + 3, indices.begin() + j * 3);
+    }
+
+    std::vector<uint32_t> optimized;
+    const double seconds = TimeBest([&]() { optimized = OptimizeVertexCacheOrder(indices, stride * stride); });
+
+    char label[32];
+    snprintf(label, sizeof(label), "%ux%u", size, size);
+    printf("%10s %10u %14.3f %14.3f %10.2f\n", label, num_triangles, SimulateVertexCache(indices).ACMR(),
+           SimulateVertexCache(optimized).ACMR(), seconds * 1000.0);
+  }
+}
@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <vector>
+
+#include "benchmark.h"
+#include "yuv_conversion.h"
+
+// The float loop that the texture and PVIDEO paths used before yuv_conversion was introduced.
+static void ReferenceRGBToYUY2(uint8_t *dest, const uint32_t *source, uint32_t num_pixels) {
+  for (uint32_t x = 0; x < num_pixels; x += 2, source += 2, dest += 4) {
+    const auto R0 = static_cast<float>(source[0] & 0xFF);
+    const auto G0 = static_cast<float>((source[0] >> 8) & 0xFF);
+    const auto B0 = static_cast<float>((source[0] >> 16) & 0xFF);
+    const auto R1 = static_cast<float>(source[1] & 0xFF);
+    const auto G1 = static_cast<float>((source[1] >> 8) & 0xFF);
+    const auto B1 = static_cast<float>((source[1] >> 16) & 0xFF);
+
+    dest[0] = static_cast<uint8_t>((0.257f * R0) + (0.504f * G0) + (0.098f * B0) + 16);
+    dest[1] = static_cast<uint8_t>(-(0.148f * R1) - (0.291f * G1) + (0.439f * B1) + 128);
+    dest[2] = static_cast<uint8_t>((0.257f * R1) + (0.504f * G1) + (0.098f * B1) + 16);
+    dest[3] = static_cast<uint8_t>((0.439f * R1) - (0.368f * G1) - (0.071f * B1) + 128);
+  }
+}
+
+// Compares the time to encode a 640x480 frame with the original float loop and with ConvertRGBToYUY2.
+HOST_BENCHMARK(YUY2Encode640x480) {
+  static constexpr uint32_t kWidth = 640;
+  static constexpr uint32_t kHeight = 480;
+  std::vector<uint32_t> source(kWidth * kHeight);
+  uint32_t state = 1;
+  for (auto &pixel : source) {
+    state = state * 1664525 + 1013904223;
+    pixel = state;
+  }
+  std::vector<uint8_t> dest(kWidth * kHeight * 2);
+
+  const double reference = TimeBest([&]() {
+    ReferenceRGBToYUY2(dest.data(), source.data(), source.size());
+    KeepAlive(dest);
+  });
+  const double converter = TimeBest([&]() {
+    ConvertRGBToYUY2(dest.data(), kWidth * 2, source.data(), kWidth * 4, kWidth, kHeight);
+    KeepAlive(dest);
+  });
+
+  printf("%-24s %10s\n", "implementation", "ms/frame");
+  printf("%-24s %10.3f\n", "reference float loop", reference * 1000.0);
+#ifdef __SSE__
+  printf("%-24s %10.3f\n", "ConvertRGBToYUY2 (SSE)", converter * 1000.0);
+#else
+  printf("%-24s %10.3f\n", "ConvertRGBToYUY2", converter * 1000.0);
+#endif
+}
@@ -0,0 +1,109 @@
+#include "yuv_conversion.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// The float loop that the texture and PVIDEO paths used before yuv_conversion was introduced.
+static void ReferenceRGBToYUY2(uint8_t *dest, const uint32_t *source, uint32_t num_pixels) {
+  for (uint32_t x = 0; x < num_pixels; x += 2, source += 2, dest += 4) {
+    const auto R0 = static_cast<float>(source[0] & 0xFF);
+    const auto G0 = static_cast<float>((source[0] >> 8) & 0xFF);
+    const auto B0 = static_cast<float>((source[0] >> 16) & 0xFF);
+    const auto R1 = static_cast<float>(source[1] & 0xFF);
+    const auto G1 = static_cast<float>((source[1] >> 8) & 0xFF);
+    const auto B1 = static_cast<float>((source[1] >> 16) & 0xFF);
+
+    dest[0] = static_cast<uint8_t>((0.257f * R0) + (0.504f * G0) + (0.098f * B0) + 16);
+    dest[1] = static_cast<uint8_t>(-(0.148f * R1) - (0.291f * G1) + (0.439f * B1) + 128);
+    dest[2] = static_cast<uint8_t>((0.257f * R1) + (0.504f * G1) + (0.098f * B1) + 16);
+    dest[3] = static_cast<uint8_t>((0.439f * R1) - (0.368f * G1) - (0.071f * B1) + 128);
+  }
+}
+
+// Encodes every 24-bit color in both the even and odd position of a pair and compares against the reference loop.
+TEST(YUVConversion, EncoderMatchesReferenceForAllColors) {
+  static constexpr uint32_t kWidth = 65536;
+  std::vector<uint32_t> row(kWidth + 2);
+  std::vector<uint8_t> expected(kWidth * 2 + 4);
+  std::vector<uint8_t> actual(expected.size());
+
+  for (uint32_t offset = 0; offset < 2; ++offset) {
+    for (uint32_t base = 0; base < (1 << 24); base += kWidth) {
+      for (uint32_t i = 0; i < row.size(); ++i) {
+        row[i] = 0xFF000000 | ((base + i + offset) & 0xFFFFFF);
+      }
+
+      ReferenceRGBToYUY2(expected.data(), row.data(), row.size());
+      ConvertRGBToYUY2(actual.data(), actual.size(), row.data(), row.size() * 4, row.size(), 1);
+      ASSERT_EQ(actual, expected) << "Mismatch in colors starting at 0x" << std::hex << base + offset;
+    }
+  }
+}
+
+TEST(YUVConversion, UYVYIsReorderedYUY2) {
+  // 10 pixels exercises both the batched path and the trailing pairs.
+  const uint32_t pixels[] = {0xFF0000FF, 0xFF00FF00, 0xFFFF0000, 0xFFFFFFFF, 0xFF000000,
+                             0xFF123456, 0xFF808080, 0xFFFEDCBA, 0xFF010203, 0xFFA0B0C0};
+  uint8_t yuy2[20];
+  uint8_t uyvy[20];
+  ConvertRGBToYUY2(yuy2, sizeof(yuy2), pixels, sizeof(pixels), 10, 1);
+  ConvertRGBToUYVY(uyvy, sizeof(uyvy), pixels, sizeof(pixels), 10, 1);
+
+  for (uint32_t i = 0; i < sizeof(yuy2); i += 4) {
+    EXPECT_EQ(uyvy[i + 0], yuy2[i + 1]);
+    EXPECT_EQ(uyvy[i + 1], yuy2[i + 0]);
+    EXPECT_EQ(uyvy[i + 2], yuy2[i + 3]);
+    EXPECT_EQ(uyvy[i + 3], yuy2[i + 2]);
+  }
+}
+
+TEST(YUVConversion, HonorsShiftsAndPitch) {
+  // BGRA source with padding at the end of each row.
+  static constexpr uint32_t kWidth = 12;
+  static constexpr uint32_t kSourcePitch = (kWidth + 3) * 4;
+  static constexpr uint32_t kDestPitch = kWidth * 2 + 8;
+  std::vector<uint32_t> abgr(kWidth * 2);
+  std::vector<uint32_t> argb((kSourcePitch / 4) * 2, 0xDEADBEEF);
+  for (uint32_t i = 0; i < abgr.size(); ++i) {
+    const uint32_t r = i * 17 & 0xFF;
+    const uint32_t g = i * 53 & 0xFF;
+    const uint32_t b = i * 101 & 0xFF;
+    abgr[i] = 0xFF000000 | (b << 16) | (g << 8) | r;
+    argb[(i / kWidth) * (kSourcePitch / 4) + i % kWidth] = 0xFF000000 | (r << 16) | (g << 8) | b;
+  }
+
+  std::vector<uint8_t> expected(kWidth * 2 * 2);
+  ConvertRGBToYUY2(expected.data(), kWidth * 2, abgr.data(), kWidth * 4, kWidth, 2);
+  std::vector<uint8_t> actual(kDestPitch * 2);
+  ConvertRGBToYUY2(actual.data(), kDestPitch, argb.data(), kSourcePitch, kWidth, 2, 16, 8, 0);
+
+  for (uint32_t y = 0; y < 2; ++y) {
+    for (uint32_t x = 0; x < kWidth * 2; ++x) {
+      EXPECT_EQ(actual[y * kDestPitch + x], expected[y * kWidth * 2 + x]) << x << ", " << y;
+    }
+  }
+}
+
+TEST(YUVConversion, DecodesStudioSwingExtremes) {
+  // Black, white and mid grey, followed by the primaries as produced by the encoder.
+  const uint8_t yuy2[] = {16, 128, 235, 128, 126, 128, 126, 128};
+  uint32_t rgb[4];
+  ConvertYUY2ToRGB(rgb, sizeof(rgb), yuy2, sizeof(yuy2), 4, 1);
+  EXPECT_EQ(rgb[0], 0xFF000000u);
+  EXPECT_EQ(rgb[1], 0xFFFFFFFFu);
+  EXPECT_EQ(rgb[2], 0xFF808080u);
+
+  const uint32_t primaries[] = {0xFF0000FF, 0xFF0000FF, 0xFF00FF00, 0xFF00FF00, 0xFFFF0000, 0xFFFF0000};
+  uint8_t encoded[12];
+  ConvertRGBToYUY2(encoded, sizeof(encoded), primaries, sizeof(primaries), 6, 1);
+  uint32_t decoded[6];
+  ConvertYUY2ToRGB(decoded, sizeof(decoded), encoded, sizeof(encoded), 6, 1);
+  for (uint32_t i = 0; i < 6; ++i) {
+    for (uint32_t shift = 0; shift < 24; shift += 8) {
+      const int expected = (primaries[i] >> shift) & 0xFF;
+      const int actual = (decoded[i] >> shift) & 0xFF;
+      EXPECT_NEAR(actual, expected, 3) << "pixel " << i << " shift " << shift;
+    }
+  }
+}
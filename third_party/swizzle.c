@@ -24,6 +24,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 /* This should be pretty straightforward.
@@ -88,47 +89,282 @@ static unsigned int get_swizzled_offset(unsigned int x, unsigned int y,
                             fill_pattern(mask_z, z));
 }
 
-void swizzle_box(const uint8_t *src_buf, unsigned int width,
-                 unsigned int height, unsigned int depth, uint8_t *dst_buf,
-                 unsigned int row_pitch, unsigned int slice_pitch,
-                 unsigned int bytes_per_pixel) {
+/* Given the swizzled value of some coordinate v, returns the swizzled value of
+ * v + 1 (i.e., fill_pattern(mask, v + 1)) by propagating the carry through the
+ * bits that are not part of the mask.
+ */
+static inline uint32_t next_swizzled(uint32_t swizzled, uint32_t mask) {
+  return ((swizzled | ~mask) + 1) & mask;
+}
+
+/* Removes the lowest `count` set bits from `mask`. */
+static inline uint32_t drop_low_bits(uint32_t mask, unsigned int count) {
+  while (count--) {
+    mask &= mask - 1;
+  }
+  return mask;
+}
+
+static inline bool is_power_of_two(unsigned int value) {
+  return value && !(value & (value - 1));
+}
+
+/* Kernels are forced inline into the dispatchers below so that each common
+ * bytes_per_pixel value gets a specialization in which the pixel copy is a
+ * single load/store.
+ */
+#define SWIZZLE_KERNEL static inline __attribute__((always_inline)) void
+
+/* Side length of the square tiles that are contiguous in swizzled memory. */
+#define TILE_SIZE 4
+
+/* For 2D surfaces with power of two dimensions of at least TILE_SIZE, the low
+ * 4 bits of the swizzled offset are always x0 y0 x1 y1, so each 4x4 tile of
+ * pixels occupies a contiguous run of 16 pixels. Copying a tile at a time
+ * keeps the accesses to the swizzled side sequential (which matters when it
+ * is write-combined texture memory) while touching only 4 linear rows.
+ */
+static inline bool can_use_tiles(unsigned int width, unsigned int height,
+                                 unsigned int depth) {
+  return depth == 1 && is_power_of_two(width) && is_power_of_two(height) &&
+         width >= TILE_SIZE && height >= TILE_SIZE;
+}
+
+/* Builds the table of linear offsets for each pixel of a tile, in swizzled
+ * order.
+ */
+static void generate_tile_offsets(uint32_t *offsets, unsigned int pitch,
+                                  unsigned int bytes_per_pixel) {
+  unsigned int i;
+  for (i = 0; i < TILE_SIZE * TILE_SIZE; ++i) {
+    unsigned int x = (i & 1) | ((i >> 1) & 2);
+    unsigned int y = ((i >> 1) & 1) | ((i >> 2) & 2);
+    offsets[i] = y * pitch + x * bytes_per_pixel;
+  }
+}
+
+SWIZZLE_KERNEL tiled_kernel(const uint8_t *src_buf, unsigned int width,
+                            unsigned int height, uint8_t *dst_buf,
+                            unsigned int pitch, unsigned int bytes_per_pixel,
+                            bool swizzle) {
   uint32_t mask_x, mask_y, mask_z;
-  generate_swizzle_masks(width, height, depth, &mask_x, &mask_y, &mask_z);
+  generate_swizzle_masks(width, height, 1, &mask_x, &mask_y, &mask_z);
+
+  uint32_t tile_offsets[TILE_SIZE * TILE_SIZE];
+  generate_tile_offsets(tile_offsets, pitch, bytes_per_pixel);
+
+  /* The masks for the coordinates of each tile exclude the bits covered by
+   * the tile itself.
+   */
+  const uint32_t tile_mask_x = drop_low_bits(mask_x, 2);
+  const uint32_t tile_mask_y = drop_low_bits(mask_y, 2);
+
+  uint32_t swizzled_y = 0;
+  unsigned int x, y, i;
+  for (y = 0; y < height; y += TILE_SIZE) {
+    uint8_t *linear_row = (uint8_t *)(swizzle ? src_buf : dst_buf) + y * pitch;
+    uint32_t swizzled_x = 0;
+    for (x = 0; x < width; x += TILE_SIZE) {
+      uint8_t *linear = linear_row + x * bytes_per_pixel;
+      uint8_t *swizzled =
+          (uint8_t *)(swizzle ? dst_buf : src_buf) +
+          (swizzled_x | swizzled_y) * bytes_per_pixel;
+      if (swizzle) {
+        for (i = 0; i < TILE_SIZE * TILE_SIZE; ++i) {
+          memcpy(swizzled + i * bytes_per_pixel, linear + tile_offsets[i],
+                 bytes_per_pixel);
+        }
+      } else {
+        for (i = 0; i < TILE_SIZE * TILE_SIZE; ++i) {
+          memcpy(linear + tile_offsets[i], swizzled + i * bytes_per_pixel,
+                 bytes_per_pixel);
+        }
+      }
+      swizzled_x = next_swizzled(swizzled_x, tile_mask_x);
+    }
+    swizzled_y = next_swizzled(swizzled_y, tile_mask_y);
+  }
+}
+
+/* General case: the swizzled offset of each column is looked up in a table
+ * that is built once and shared by every row and slice.
+ */
+SWIZZLE_KERNEL row_kernel(const uint8_t *src_buf, unsigned int width,
+                          unsigned int height, unsigned int depth,
+                          uint8_t *dst_buf, unsigned int row_pitch,
+                          unsigned int slice_pitch,
+                          unsigned int bytes_per_pixel,
+                          const uint32_t *column_offsets, uint32_t mask_y,
+                          uint32_t mask_z, bool swizzle) {
+  uint32_t swizzled_z = 0;
+  unsigned int x, y, z;
+  for (z = 0; z < depth; ++z) {
+    uint8_t *linear_slice =
+        (uint8_t *)(swizzle ? src_buf : dst_buf) + z * slice_pitch;
+    uint32_t swizzled_y = 0;
+    for (y = 0; y < height; ++y) {
+      uint8_t *linear = linear_slice + y * row_pitch;
+      uint8_t *swizzled = (uint8_t *)(swizzle ? dst_buf : src_buf) +
+                          (swizzled_y | swizzled_z) * bytes_per_pixel;
+      if (swizzle) {
+        for (x = 0; x < width; ++x) {
+          memcpy(swizzled + column_offsets[x], linear + x * bytes_per_pixel,
+                 bytes_per_pixel);
+        }
+      } else {
+        for (x = 0; x < width; ++x) {
+          memcpy(linear + x * bytes_per_pixel, swizzled + column_offsets[x],
+                 bytes_per_pixel);
+        }
+      }
+      swizzled_y = next_swizzled(swizzled_y, mask_y);
+    }
+    swizzled_z = next_swizzled(swizzled_z, mask_z);
+  }
+}
 
-  int x, y, z;
+/* Original per-pixel implementation, used if the column table cannot be
+ * allocated.
+ */
+static void pixel_kernel(const uint8_t *src_buf, unsigned int width,
+                         unsigned int height, unsigned int depth,
+                         uint8_t *dst_buf, unsigned int row_pitch,
+                         unsigned int slice_pitch,
+                         unsigned int bytes_per_pixel, uint32_t mask_x,
+                         uint32_t mask_y, uint32_t mask_z, bool swizzle) {
+  unsigned int x, y, z;
   for (z = 0; z < depth; z++) {
     for (y = 0; y < height; y++) {
       for (x = 0; x < width; x++) {
-        const uint8_t *src = src_buf + y * row_pitch + x * bytes_per_pixel;
-        uint8_t *dst = dst_buf + get_swizzled_offset(x, y, z, mask_x, mask_y, mask_z,
-                                                     bytes_per_pixel);
-        memcpy(dst, src, bytes_per_pixel);
+        unsigned int linear = z * slice_pitch + y * row_pitch + x * bytes_per_pixel;
+        unsigned int swizzled = get_swizzled_offset(x, y, z, mask_x, mask_y,
+                                                    mask_z, bytes_per_pixel);
+        if (swizzle) {
+          memcpy(dst_buf + swizzled, src_buf + linear, bytes_per_pixel);
+        } else {
+          memcpy(dst_buf + linear, src_buf + swizzled, bytes_per_pixel);
+        }
       }
     }
-    src_buf += slice_pitch;
   }
 }
 
+/* Builds the table of swizzled offsets for each column, returning NULL if it
+ * cannot be allocated.
+ */
+static uint32_t *generate_column_offsets(unsigned int width, uint32_t mask_x,
+                                         unsigned int bytes_per_pixel) {
+  uint32_t *column_offsets = (uint32_t *)malloc(width * sizeof(uint32_t));
+  if (!column_offsets) {
+    return NULL;
+  }
+
+  uint32_t swizzled_x = 0;
+  unsigned int x;
+  for (x = 0; x < width; ++x) {
+    column_offsets[x] = swizzled_x * bytes_per_pixel;
+    swizzled_x = next_swizzled(swizzled_x, mask_x);
+  }
+  return column_offsets;
+}
+
+#define DISPATCH_BPP(bytes_per_pixel, call_with_bpp) \
+  switch (bytes_per_pixel) {                         \
+    case 1:                                          \
+      call_with_bpp(1);                              \
+      break;                                         \
+    case 2:                                          \
+      call_with_bpp(2);                              \
+      break;                                         \
+    case 4:                                          \
+      call_with_bpp(4);                              \
+      break;                                         \
+    case 8:                                          \
+      call_with_bpp(8);                              \
+      break;                                         \
+    default:                                         \
+      call_with_bpp(bytes_per_pixel);                \
+      break;                                         \
+  }
+
+static void swizzle_impl(const uint8_t *src_buf, unsigned int width,
+                         unsigned int height, unsigned int depth,
+                         uint8_t *dst_buf, unsigned int row_pitch,
+                         unsigned int slice_pitch,
+                         unsigned int bytes_per_pixel, bool swizzle) {
+  if (can_use_tiles(width, height, depth)) {
+#define TILED(bpp) \
+  tiled_kernel(src_buf, width, height, dst_buf, row_pitch, bpp, swizzle)
+    DISPATCH_BPP(bytes_per_pixel, TILED)
+#undef TILED
+    return;
+  }
+
+  uint32_t mask_x, mask_y, mask_z;
+  generate_swizzle_masks(width, height, depth, &mask_x, &mask_y, &mask_z);
+
+  uint32_t *column_offsets =
+      generate_column_offsets(width, mask_x, bytes_per_pixel);
+  if (!column_offsets) {
+    pixel_kernel(src_buf, width, height, depth, dst_buf, row_pitch,
+                 slice_pitch, bytes_per_pixel, mask_x, mask_y, mask_z,
+                 swizzle);
+    return;
+  }
+
+#define ROWS(bpp)                                                        \
+  row_kernel(src_buf, width, height, depth, dst_buf, row_pitch,          \
+             slice_pitch, bpp, column_offsets, mask_y, mask_z, swizzle)
+  DISPATCH_BPP(bytes_per_pixel, ROWS)
+#undef ROWS
+
+  free(column_offsets);
+}
+
+void swizzle_box(const uint8_t *src_buf, unsigned int width,
+                 unsigned int height, unsigned int depth, uint8_t *dst_buf,
+                 unsigned int row_pitch, unsigned int slice_pitch,
+                 unsigned int bytes_per_pixel) {
+  swizzle_impl(src_buf, width, height, depth, dst_buf, row_pitch, slice_pitch,
+               bytes_per_pixel, true);
+}
+
 void unswizzle_box(const uint8_t *src_buf, unsigned int width,
                    unsigned int height, unsigned int depth, uint8_t *dst_buf,
                    unsigned int row_pitch, unsigned int slice_pitch,
                    unsigned int bytes_per_pixel) {
+  swizzle_impl(src_buf, width, height, depth, dst_buf, row_pitch, slice_pitch,
+               bytes_per_pixel, false);
+}
+
+void swizzle_box_slice(const uint8_t *src_buf, unsigned int width,
+                       unsigned int height, unsigned int depth,
+                       unsigned int slice, uint8_t *dst_buf,
+                       unsigned int row_pitch, unsigned int bytes_per_pixel) {
   uint32_t mask_x, mask_y, mask_z;
   generate_swizzle_masks(width, height, depth, &mask_x, &mask_y, &mask_z);
 
-  int x, y, z;
-  for (z = 0; z < depth; z++) {
-    for (y = 0; y < height; y++) {
-      for (x = 0; x < width; x++) {
-        const uint8_t *src =
-            src_buf + get_swizzled_offset(x, y, z, mask_x, mask_y, mask_z,
-                                          bytes_per_pixel);
-        uint8_t *dst = dst_buf + y * row_pitch + x * bytes_per_pixel;
-        memcpy(dst, src, bytes_per_pixel);
-      }
-    }
-    dst_buf += slice_pitch;
+  /* The z bits are disjoint from the x and y bits, so the slice is a 2D
+   * swizzle with the x/y masks of the full box, offset by the slice's z bits.
+   */
+  uint8_t *slice_buf =
+      dst_buf + fill_pattern(mask_z, slice) * bytes_per_pixel;
+
+  uint32_t *column_offsets =
+      generate_column_offsets(width, mask_x, bytes_per_pixel);
+  if (!column_offsets) {
+    pixel_kernel(src_buf, width, height, 1, slice_buf, row_pitch, 0,
+                 bytes_per_pixel, mask_x, mask_y, 0, true);
+    return;
   }
+
+#define ROWS(bpp)                                                        \
+  row_kernel(src_buf, width, height, 1, slice_buf, row_pitch, 0, bpp,   \
+             column_offsets, mask_y, 0, true)
+  DISPATCH_BPP(bytes_per_pixel, ROWS)
+#undef ROWS
+
+  free(column_offsets);
 }
 
 void unswizzle_rect(const uint8_t *src_buf, unsigned int width,
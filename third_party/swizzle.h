@@ -37,6 +37,15 @@ void unswizzle_box(const uint8_t *src_buf, unsigned int width,
                    unsigned int row_pitch, unsigned int slice_pitch,
                    unsigned int bytes_per_pixel);
 
+/* Swizzles a single `slice` of a `width` x `height` x `depth` box from
+ * `src_buf` into its final position in `dst_buf`, allowing volumes to be
+ * swizzled one slice at a time without a linear copy of the entire box.
+ */
+void swizzle_box_slice(const uint8_t *src_buf, unsigned int width,
+                       unsigned int height, unsigned int depth,
+                       unsigned int slice, uint8_t *dst_buf,
+                       unsigned int row_pitch, unsigned int bytes_per_pixel);
+
 void unswizzle_rect(const uint8_t *src_buf, unsigned int width,
                     unsigned int height, uint8_t *dst_buf, unsigned int pitch,
                     unsigned int bytes_per_pixel);
@@ -0,0 +1,141 @@
+// Decodes each mipmap level of a DDS file to a PNG, using the same software decoders that may be used to predict the
+// output of the texture tests. DXT data is decoded by dxt_decoder and uncompressed data by texture_codec.
+//
+// Output files are named <output_prefix>_<level>.png (with a _<slice> suffix for volume textures).
+
+#include <fpng/src/fpng.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "dds_image.h"
+#include "debug_output.h"
+#include "dxt_decoder.h"
+#include "texture_codec.h"
+
+void PrintAssertAndWaitForever(const char *assert_code, const char *filename, uint32_t line) {
+  fprintf(stderr, "ASSERT FAILED: '%s' at %s:%d\n", assert_code, filename, line);
+  exit(1);
+}
+
+// Returns the codec used to decode uncompressed sub-images of the given format.
+static TextureCodecFormat GetCodecFormat(DDSImage::Format format) {
+  switch (format) {
+    case DDSImage::Format::A8R8G8B8:
+      return TEXTURE_CODEC_A8R8G8B8;
+    case DDSImage::Format::X8R8G8B8:
+      return TEXTURE_CODEC_X8R8G8B8;
+    case DDSImage::Format::A8B8G8R8:
+      return TEXTURE_CODEC_A8B8G8R8;
+    case DDSImage::Format::R8G8B8A8:
+      return TEXTURE_CODEC_R8G8B8A8;
+    case DDSImage::Format::B8G8R8A8:
+      return TEXTURE_CODEC_B8G8R8A8;
+    case DDSImage::Format::R5G6B5:
+      return TEXTURE_CODEC_R5G6B5;
+    case DDSImage::Format::A1R5G5B5:
+      return TEXTURE_CODEC_A1R5G5B5;
+    case DDSImage::Format::X1R5G5B5:
+      return TEXTURE_CODEC_X1R5G5B5;
+    case DDSImage::Format::A4R4G4B4:
+      return TEXTURE_CODEC_A4R4G4B4;
+    case DDSImage::Format::L8:
+      return TEXTURE_CODEC_Y8;
+    case DDSImage::Format::A8L8:
+      return TEXTURE_CODEC_A8Y8;
+    case DDSImage::Format::L16:
+      return TEXTURE_CODEC_Y16;
+    case DDSImage::Format::YUY2:
+      return TEXTURE_CODEC_YUY2;
+    case DDSImage::Format::UYVY:
+      return TEXTURE_CODEC_UYVY;
+    case DDSImage::Format::D16:
+      return TEXTURE_CODEC_DEPTH_Y16_FIXED;
+    case DDSImage::Format::D16F:
+      return TEXTURE_CODEC_DEPTH_Y16_FLOAT;
+    case DDSImage::Format::D24S8:
+      return TEXTURE_CODEC_DEPTH_X8_Y24_FIXED;
+    case DDSImage::Format::D24FS8:
+      return TEXTURE_CODEC_DEPTH_X8_Y24_FLOAT;
+    default:
+      return TEXTURE_CODEC_NONE;
+  }
+}
+
+static bool Decode(std::vector<uint32_t> &pixels, const DDSImage::SubImage &image, const uint8_t *data,
+                   DXTInterpolation interpolation) {
+  pixels.resize(image.width * image.height);
+  const uint32_t pitch = image.width * 4;
+  switch (image.format) {
+    case DDSImage::SubImage::Format::DXT1:
+      DecompressDXT1(pixels.data(), pitch, data, image.width, image.height, interpolation);
+      return true;
+
+    case DDSImage::SubImage::Format::DXT3:
+      DecompressDXT3(pixels.data(), pitch, data, image.width, image.height, interpolation);
+      return true;
+
+    case DDSImage::SubImage::Format::DXT5:
+      DecompressDXT5(pixels.data(), pitch, data, image.width, image.height, interpolation);
+      return true;
+
+    default:
+      return !DecodeTexture(pixels.data(), pitch, data, image.pitch, image.width, image.height,
+                            GetCodecFormat(image.format));
+  }
+}
+
+int main(int argc, const char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "Usage: %s <input.dds> <output_prefix> [--reference]\n", argv[0]);
+    fprintf(stderr, "  --reference: Use reference interpolation instead of matching the NV2A.\n");
+    return 1;
+  }
+
+  DXTInterpolation interpolation = DXT_INTERPOLATE_NV2A;
+  if (argc > 3 && !strcmp(argv[3], "--reference")) {
+    interpolation = DXT_INTERPOLATE_REFERENCE;
+  }
+
+  DDSImage image;
+  if (!image.LoadFile(argv[1], true)) {
+    fprintf(stderr, "Failed to load '%s'\n", argv[1]);
+    return 1;
+  }
+
+  fpng::fpng_init();
+
+  std::vector<uint32_t> pixels;
+  for (auto &sub_image : image.GetSubImages()) {
+    const uint32_t slice_size = sub_image->pitch * sub_image->compressed_height;
+    for (uint32_t slice = 0; slice < sub_image->depth; ++slice) {
+      auto start_time = std::chrono::high_resolution_clock::now();
+      if (!Decode(pixels, *sub_image, sub_image->data.data() + slice * slice_size, interpolation)) {
+        fprintf(stderr, "Unsupported sub-image format.\n");
+        return 1;
+      }
+      auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() -
+                                                                           start_time)
+                         .count();
+
+      std::string filename = std::string(argv[2]) + "_" + std::to_string(sub_image->level);
+      if (sub_image->depth > 1) {
+        filename += "_" + std::to_string(slice);
+      }
+      filename += ".png";
+
+      if (!fpng::fpng_encode_image_to_file(filename.c_str(), pixels.data(), sub_image->width, sub_image->height, 4)) {
+        fprintf(stderr, "Failed to write '%s'\n", filename.c_str());
+        return 1;
+      }
+      printf("%s: %ux%u decoded in %lldus\n", filename.c_str(), sub_image->width, sub_image->height,
+             static_cast<long long>(elapsed));
+    }
+  }
+
+  return 0;
+}
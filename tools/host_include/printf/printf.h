@@ -0,0 +1,10 @@
+#ifndef NXDK_PGRAPH_TESTS_TOOLS_HOST_PRINTF_H
+#define NXDK_PGRAPH_TESTS_TOOLS_HOST_PRINTF_H
+
+// Routes the embedded printf library used on the XBOX to the host C library.
+
+#include <cstdio>
+
+#define snprintf_ snprintf
+
+#endif  // NXDK_PGRAPH_TESTS_TOOLS_HOST_PRINTF_H
@@ -0,0 +1,10 @@
+#ifndef NXDK_PGRAPH_TESTS_TOOLS_HOST_WINDOWS_H
+#define NXDK_PGRAPH_TESTS_TOOLS_HOST_WINDOWS_H
+
+// Minimal stand-in for the nxdk windows.h, allowing debug_output.h to be used by host tools.
+
+#include <cstdio>
+
+#define DbgPrint(...) fprintf(stderr, __VA_ARGS__)
+
+#endif  // NXDK_PGRAPH_TESTS_TOOLS_HOST_WINDOWS_H
@@ -0,0 +1,349 @@
+// Converts the contents of the resources directory into a single ResourcePack file, holding each resource in the exact
+// form it is uploaded to texture memory.
+//
+// PNG files are converted to the format given by the manifest (linear ABGR8888 if not listed) and optionally swizzled.
+// DDS files are stored with all of their mipmap levels in the NV2A layout. After writing, the pack is read back via
+// ResourcePack and every entry is compared against the converted data.
+
+#include <dirent.h>
+#include <png.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dds_image.h"
+#include "debug_output.h"
+#include "resource_pack.h"
+#include "swizzle.h"
+
+void PrintAssertAndWaitForever(const char *assert_code, const char *filename, uint32_t line) {
+  fprintf(stderr, "ASSERT FAILED: '%s' at %s:%d\n", assert_code, filename, line);
+  exit(1);
+}
+
+struct ManifestEntry {
+  ResourcePack::Format format{ResourcePack::FORMAT_ABGR8888};
+  bool swizzled{false};
+};
+
+struct Resource {
+  ResourcePack::Entry entry{};
+  std::vector<uint8_t> data;
+};
+
+static bool LoadManifest(const char *filename, std::map<std::string, ManifestEntry> &manifest) {
+  std::ifstream file(filename);
+  if (!file) {
+    fprintf(stderr, "Failed to open manifest '%s'\n", filename);
+    return false;
+  }
+
+  std::string line;
+  uint32_t line_number = 0;
+  while (std::getline(file, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::istringstream fields(line);
+    std::string path;
+    std::string format;
+    std::string option;
+    fields >> path >> format;
+
+    ManifestEntry entry;
+    if (format == "ABGR8888") {
+      entry.format = ResourcePack::FORMAT_ABGR8888;
+    } else if (format == "ARGB8888") {
+      entry.format = ResourcePack::FORMAT_ARGB8888;
+    } else {
+      fprintf(stderr, "%s:%u: Unknown format '%s'\n", filename, line_number, format.c_str());
+      return false;
+    }
+
+    while (fields >> option) {
+      if (option == "swizzled") {
+        entry.swizzled = true;
+      } else {
+        fprintf(stderr, "%s:%u: Unknown option '%s'\n", filename, line_number, option.c_str());
+        return false;
+      }
+    }
+
+    manifest[path] = entry;
+  }
+
+  return true;
+}
+
+static void FindFiles(const std::string &root, const std::string &relative_dir, std::vector<std::string> &files) {
+  const std::string dir_path = relative_dir.empty() ? root : root + "/" + relative_dir;
+  DIR *dir = opendir(dir_path.c_str());
+  if (!dir) {
+    return;
+  }
+
+  while (auto dirent = readdir(dir)) {
+    if (dirent->d_name[0] == '.') {
+      continue;
+    }
+
+    const std::string relative_path = relative_dir.empty() ? dirent->d_name : relative_dir + "/" + dirent->d_name;
+    struct stat info {};
+    if (stat((root + "/" + relative_path).c_str(), &info)) {
+      continue;
+    }
+
+    if (S_ISDIR(info.st_mode)) {
+      FindFiles(root, relative_path, files);
+    } else if (S_ISREG(info.st_mode)) {
+      files.push_back(relative_path);
+    }
+  }
+  closedir(dir);
+}
+
+static bool EndsWith(const std::string &value, const char *suffix) {
+  const size_t suffix_len = strlen(suffix);
+  return value.size() >= suffix_len && !strcasecmp(value.c_str() + value.size() - suffix_len, suffix);
+}
+
+static bool ConvertPNG(const std::string &path, const ManifestEntry &options, Resource &resource) {
+  png_image image{};
+  image.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_file(&image, path.c_str())) {
+    fprintf(stderr, "Failed to read '%s': %s\n", path.c_str(), image.message);
+    return false;
+  }
+
+  image.format = options.format == ResourcePack::FORMAT_ARGB8888 ? PNG_FORMAT_BGRA : PNG_FORMAT_RGBA;
+  const uint32_t pitch = image.width * 4;
+  std::vector<uint8_t> pixels(pitch * image.height);
+  if (!png_image_finish_read(&image, nullptr, pixels.data(), static_cast<png_int_32>(pitch), nullptr)) {
+    fprintf(stderr, "Failed to decode '%s': %s\n", path.c_str(), image.message);
+    return false;
+  }
+
+  auto &entry = resource.entry;
+  entry.format = options.format;
+  entry.swizzled = options.swizzled;
+  entry.width = image.width;
+  entry.height = image.height;
+  entry.levels = 1;
+  entry.pitch = pitch;
+
+  if (options.swizzled) {
+    resource.data.resize(pixels.size());
+    swizzle_rect(pixels.data(), image.width, image.height, resource.data.data(), pitch, 4);
+  } else {
+    resource.data = std::move(pixels);
+  }
+  return true;
+}
+
+static bool ConvertDDS(const std::string &path, Resource &resource) {
+  DDSImage image;
+  if (!image.Open(path.c_str())) {
+    fprintf(stderr, "Failed to read '%s'\n", path.c_str());
+    return false;
+  }
+
+  auto &entry = resource.entry;
+  switch (image.GetFormat()) {
+    case DDSImage::Format::DXT1:
+      entry.format = ResourcePack::FORMAT_DXT1;
+      break;
+
+    case DDSImage::Format::DXT3:
+      entry.format = ResourcePack::FORMAT_DXT3;
+      break;
+
+    case DDSImage::Format::DXT5:
+      entry.format = ResourcePack::FORMAT_DXT5;
+      break;
+
+    default:
+      fprintf(stderr, "Unsupported DDS format in '%s'\n", path.c_str());
+      return false;
+  }
+
+  if (image.IsCubemap() || image.IsVolume()) {
+    fprintf(stderr, "Cubemap and volume DDS files are not supported in '%s'\n", path.c_str());
+    return false;
+  }
+
+  const auto &primary = image.GetLevelInfo(0);
+  entry.swizzled = 0;
+  entry.width = primary.width;
+  entry.height = primary.height;
+  entry.levels = image.NumFileLevels();
+  entry.pitch = primary.pitch;
+
+  // DDS files store the mipmap chain in the same layout as the NV2A, so all levels are read at once.
+  resource.data.resize(image.GetFaceSize(entry.levels));
+  if (!image.ReadLevels(resource.data.data(), 0, entry.levels)) {
+    fprintf(stderr, "Failed to read mipmap levels from '%s'\n", path.c_str());
+    return false;
+  }
+  return true;
+}
+
+static inline uint32_t Align(uint32_t value) {
+  return (value + ResourcePack::kAlignment - 1) & ~(ResourcePack::kAlignment - 1);
+}
+
+static std::vector<uint8_t> BuildPack(std::vector<Resource> &resources) {
+  ResourcePack::Header header{};
+  header.magic = ResourcePack::kMagic;
+  header.version = ResourcePack::kVersion;
+  header.num_entries = resources.size();
+
+  uint32_t offset = Align(sizeof(header) + resources.size() * sizeof(ResourcePack::Entry));
+  for (auto &resource : resources) {
+    resource.entry.offset = offset;
+    resource.entry.size = resource.data.size();
+    offset = Align(offset + resource.entry.size);
+  }
+  header.total_size = offset;
+
+  std::vector<uint8_t> pack(offset, 0);
+  memcpy(pack.data(), &header, sizeof(header));
+  auto entries = pack.data() + sizeof(header);
+  for (auto &resource : resources) {
+    memcpy(entries, &resource.entry, sizeof(resource.entry));
+    entries += sizeof(resource.entry);
+    memcpy(pack.data() + resource.entry.offset, resource.data.data(), resource.data.size());
+  }
+  return pack;
+}
+
+static bool Verify(const char *filename, const std::vector<Resource> &resources) {
+  ResourcePack pack;
+  if (!pack.LoadFile(filename)) {
+    fprintf(stderr, "Failed to read back '%s'\n", filename);
+    return false;
+  }
+
+  if (pack.NumEntries() != resources.size()) {
+    fprintf(stderr, "Entry count mismatch in '%s'\n", filename);
+    return false;
+  }
+
+  for (auto &resource : resources) {
+    auto entry = pack.Find(resource.entry.name);
+    if (!entry || memcmp(entry, &resource.entry, sizeof(*entry)) ||
+        memcmp(pack.GetData(*entry), resource.data.data(), resource.data.size())) {
+      fprintf(stderr, "Mismatch reading back '%s' from '%s'\n", resource.entry.name, filename);
+      return false;
+    }
+  }
+  return true;
+}
+
+static const char *FormatName(uint32_t format) {
+  switch (format) {
+    case ResourcePack::FORMAT_ABGR8888:
+      return "ABGR8888";
+    case ResourcePack::FORMAT_ARGB8888:
+      return "ARGB8888";
+    case ResourcePack::FORMAT_DXT1:
+      return "DXT1";
+    case ResourcePack::FORMAT_DXT3:
+      return "DXT3";
+    case ResourcePack::FORMAT_DXT5:
+      return "DXT5";
+    default:
+      return "<<INVALID>>";
+  }
+}
+
+static int List(const char *filename) {
+  ResourcePack pack;
+  if (!pack.LoadFile(filename)) {
+    fprintf(stderr, "Failed to read '%s'\n", filename);
+    return 1;
+  }
+
+  for (uint32_t i = 0; i < pack.NumEntries(); ++i) {
+    const auto &entry = pack.GetEntries()[i];
+    printf("%-48s %-8s %s %4ux%-4u levels: %u offset: 0x%08X size: %u\n", entry.name, FormatName(entry.format),
+           entry.swizzled ? "SZ" : "LU", entry.width, entry.height, entry.levels, entry.offset, entry.size);
+  }
+  return 0;
+}
+
+int main(int argc, const char **argv) {
+  if (argc == 3 && !strcmp(argv[1], "--list")) {
+    return List(argv[2]);
+  }
+
+  if (argc != 4) {
+    fprintf(stderr, "Usage: %s <resource_dir> <manifest> <output_pack>\n", argv[0]);
+    fprintf(stderr, "       %s --list <pack>\n", argv[0]);
+    return 1;
+  }
+
+  const std::string root = argv[1];
+  std::map<std::string, ManifestEntry> manifest;
+  if (!LoadManifest(argv[2], manifest)) {
+    return 1;
+  }
+
+  std::vector<std::string> files;
+  FindFiles(root, "", files);
+  std::sort(files.begin(), files.end());
+
+  std::vector<Resource> resources;
+  for (auto &file : files) {
+    Resource resource;
+    if (file.size() >= ResourcePack::kMaxNameLength) {
+      fprintf(stderr, "Resource path '%s' is too long\n", file.c_str());
+      return 1;
+    }
+    strncpy(resource.entry.name, file.c_str(), sizeof(resource.entry.name) - 1);
+
+    const std::string path = root + "/" + file;
+    bool converted;
+    if (EndsWith(file, ".png")) {
+      auto options = manifest.find(file);
+      converted = ConvertPNG(path, options == manifest.end() ? ManifestEntry() : options->second, resource);
+    } else if (EndsWith(file, ".dds")) {
+      converted = ConvertDDS(path, resource);
+    } else {
+      printf("Skipping '%s'\n", file.c_str());
+      continue;
+    }
+
+    if (!converted) {
+      return 1;
+    }
+    resources.push_back(std::move(resource));
+  }
+
+  auto pack = BuildPack(resources);
+  FILE *f = fopen(argv[3], "wb");
+  if (!f || fwrite(pack.data(), 1, pack.size(), f) != pack.size()) {
+    fprintf(stderr, "Failed to write '%s'\n", argv[3]);
+    if (f) {
+      fclose(f);
+    }
+    return 1;
+  }
+  fclose(f);
+
+  if (!Verify(argv[3], resources)) {
+    return 1;
+  }
+
+  printf("Wrote %zu resources (%zu bytes) to '%s'\n", resources.size(), pack.size(), argv[3]);
+  return 0;
+}